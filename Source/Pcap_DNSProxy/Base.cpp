@@ -81,6 +81,33 @@ bool CheckEmptyBuffer(
 	return true;
 }
 
+#if defined(ENABLE_SIMD_AVX2)
+//Check AVX2 support of processor and operating system
+bool CheckProcessorFeature_AVX2(
+	void)
+{
+#if defined(_MSC_VER)
+//CPUID leaf 7 must exist, AVX2 flag is bit 5 of EBX in leaf 7.
+	std::array<int, 4U> ProcessorInfo{};
+	__cpuid(ProcessorInfo.data(), 0);
+	if (ProcessorInfo.at(0) < 7)
+		return false;
+
+//Operating system must save YMM registers, OSXSAVE flag is bit 27 and AVX flag is bit 28 of ECX in leaf 1.
+	__cpuid(ProcessorInfo.data(), 1);
+	if ((ProcessorInfo.at(2U) & (1 << 27U)) == 0 || (ProcessorInfo.at(2U) & (1 << 28U)) == 0 || (_xgetbv(0) & 6U) != 6U)
+		return false;
+	__cpuidex(ProcessorInfo.data(), 7, 0);
+
+	return (ProcessorInfo.at(1U) & (1 << 5U)) != 0;
+#else
+//Processor features must be initialized when it is called before constructors of runtime library.
+	__builtin_cpu_init();
+	return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+#endif
+
 //Convert multiple bytes to wide char string
 bool MBS_To_WCS_String(
 	const uint8_t * const Buffer, 
@@ -170,42 +197,112 @@ bool WCS_To_MBS_String(
 }
 
 //Convert lowercase/uppercase words to uppercase/lowercase words(C-Style version)
+//Domain names are ASCII only, bytes out of the letter range are never changed.
 void CaseConvert(
 	uint8_t * const Buffer, 
 	const size_t Length, 
 	const bool IsLowerToUpper)
 {
-	if (Buffer != nullptr)
+	if (Buffer == nullptr)
+		return;
+
+//Letter range of source case
+	const uint8_t RangeBegin = IsLowerToUpper ? ASCII_LOWERCASE_A : ASCII_UPPERCASE_A;
+	const uint8_t RangeEnd = IsLowerToUpper ? ASCII_LOWERCASE_Z : ASCII_UPPERCASE_Z;
+	size_t Index = 0;
+
+//Convert words in vector blocks by the widest instruction set which is supported by processor.
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+	Index = CaseConvert_Block(Buffer, Length, RangeBegin, RangeEnd);
+#endif
+
+//Convert remaining words.
+	for (;Index < Length;++Index)
 	{
-	//Convert words.
-		for (size_t Index = 0;Index < Length;++Index)
-		{
-		//Lowercase to uppercase
-			if (IsLowerToUpper)
-				Buffer[Index] = static_cast<const uint8_t>(toupper(Buffer[Index]));
-		//Uppercase to lowercase
-			else 
-				Buffer[Index] = static_cast<const uint8_t>(tolower(Buffer[Index]));
-		}
+		if (Buffer[Index] >= RangeBegin && Buffer[Index] <= RangeEnd)
+			Buffer[Index] ^= ASCII_CASE_BIT;
 	}
 
 	return;
 }
 
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+//Select function of converting words in vector blocks
+CASE_CONVERT_BLOCK_FUNCTION CaseConvert_BlockSelect(
+	void)
+{
+#if defined(ENABLE_SIMD_AVX2)
+	if (CheckProcessorFeature_AVX2())
+		return CaseConvert_Block_AVX2;
+#endif
+
+	return CaseConvert_Block_Vector;
+}
+
+#if defined(ENABLE_SIMD_AVX2)
+//Convert lowercase/uppercase words in AVX2 vector blocks, the last block which is shorter than 256 bits is converted in 128 bits vector.
+SIMD_TARGET_AVX2 size_t CaseConvert_Block_AVX2(
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint8_t RangeBegin, 
+	const uint8_t RangeEnd)
+{
+	const auto RangeBegin_AVX2 = _mm256_set1_epi8(static_cast<const char>(RangeBegin - 1U));
+	const auto RangeEnd_AVX2 = _mm256_set1_epi8(static_cast<const char>(RangeEnd + 1U));
+	const auto CaseBit_AVX2 = _mm256_set1_epi8(ASCII_CASE_BIT);
+	size_t Index = 0;
+	for (;Index + sizeof(__m256i) <= Length;Index += sizeof(__m256i))
+	{
+		const auto Block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Buffer + Index));
+		const auto Mask = _mm256_and_si256(_mm256_cmpgt_epi8(Block, RangeBegin_AVX2), _mm256_cmpgt_epi8(RangeEnd_AVX2, Block));
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(Buffer + Index), _mm256_xor_si256(Block, _mm256_and_si256(Mask, CaseBit_AVX2)));
+	}
+
+	return Index + CaseConvert_Block_Vector(Buffer + Index, Length - Index, RangeBegin, RangeEnd);
+}
+#endif
+
+//Convert lowercase/uppercase words in 128 bits vector blocks
+size_t CaseConvert_Block_Vector(
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint8_t RangeBegin, 
+	const uint8_t RangeEnd)
+{
+	size_t Index = 0;
+#if defined(ENABLE_SIMD_SSE2)
+	const auto RangeBegin_SSE2 = _mm_set1_epi8(static_cast<const char>(RangeBegin - 1U));
+	const auto RangeEnd_SSE2 = _mm_set1_epi8(static_cast<const char>(RangeEnd + 1U));
+	const auto CaseBit_SSE2 = _mm_set1_epi8(ASCII_CASE_BIT);
+	for (;Index + sizeof(__m128i) <= Length;Index += sizeof(__m128i))
+	{
+		const auto Block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Buffer + Index));
+		const auto Mask = _mm_and_si128(_mm_cmpgt_epi8(Block, RangeBegin_SSE2), _mm_cmpgt_epi8(RangeEnd_SSE2, Block));
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(Buffer + Index), _mm_xor_si128(Block, _mm_and_si128(Mask, CaseBit_SSE2)));
+	}
+#elif defined(ENABLE_SIMD_NEON)
+	const auto RangeBegin_NEON = vdupq_n_u8(RangeBegin);
+	const auto RangeEnd_NEON = vdupq_n_u8(RangeEnd);
+	const auto CaseBit_NEON = vdupq_n_u8(ASCII_CASE_BIT);
+	for (;Index + sizeof(uint8x16_t) <= Length;Index += sizeof(uint8x16_t))
+	{
+		const auto Block = vld1q_u8(Buffer + Index);
+		const auto Mask = vandq_u8(vcgeq_u8(Block, RangeBegin_NEON), vcleq_u8(Block, RangeEnd_NEON));
+		vst1q_u8(Buffer + Index, veorq_u8(Block, vandq_u8(Mask, CaseBit_NEON)));
+	}
+#endif
+
+	return Index;
+}
+#endif
+
 //Convert lowercase/uppercase words to uppercase/lowercase words(C++ string version)
 void CaseConvert(
 	std::string &Buffer, 
 	const bool IsLowerToUpper)
 {
-	for (auto &StringIter:Buffer)
-	{
-	//Lowercase to uppercase
-		if (IsLowerToUpper)
-			StringIter = static_cast<const char>(toupper(StringIter));
-	//Uppercase to lowercase
-		else 
-			StringIter = static_cast<const char>(tolower(StringIter));
-	}
+	if (!Buffer.empty())
+		CaseConvert(reinterpret_cast<uint8_t *>(&Buffer.front()), Buffer.length(), IsLowerToUpper);
 
 	return;
 }
@@ -234,13 +331,34 @@ void MakeStringReversed(
 {
 	if (String.length() > 1U)
 	{
-	//Make string reversed
-		for (size_t Index = 0;Index < String.length() / 2U;++Index)
+		const auto Buffer = reinterpret_cast<uint8_t *>(&String.front());
+		size_t Head = 0, Tail = String.length();
+
+	//Swap and reverse blocks from both ends.
+	#if (defined(ENABLE_SIMD_SSSE3) || defined(ENABLE_SIMD_NEON))
+	#if defined(ENABLE_SIMD_SSSE3)
+		const auto ReverseMask = _mm_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+		for (;Tail - Head >= sizeof(__m128i) * 2U;Head += sizeof(__m128i), Tail -= sizeof(__m128i))
 		{
-			uint8_t StringIter = String.at(String.length() - 1U - Index);
-			String.at(String.length() - 1U - Index) = String.at(Index);
-			String.at(Index) = StringIter;
+			const auto HeadBlock = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Buffer + Head));
+			const auto TailBlock = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Buffer + Tail - sizeof(__m128i)));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Buffer + Head), _mm_shuffle_epi8(TailBlock, ReverseMask));
+			_mm_storeu_si128(reinterpret_cast<__m128i *>(Buffer + Tail - sizeof(__m128i)), _mm_shuffle_epi8(HeadBlock, ReverseMask));
 		}
+	#elif defined(ENABLE_SIMD_NEON)
+		for (;Tail - Head >= sizeof(uint8x16_t) * 2U;Head += sizeof(uint8x16_t), Tail -= sizeof(uint8x16_t))
+		{
+			const auto HeadBlock = vrev64q_u8(vld1q_u8(Buffer + Head));
+			const auto TailBlock = vrev64q_u8(vld1q_u8(Buffer + Tail - sizeof(uint8x16_t)));
+			vst1q_u8(Buffer + Head, vextq_u8(TailBlock, TailBlock, 8));
+			vst1q_u8(Buffer + Tail - sizeof(uint8x16_t), vextq_u8(HeadBlock, HeadBlock, 8));
+		}
+	#endif
+	#endif
+
+	//Swap remaining words.
+		for (;Tail - Head > 1U;++Head, --Tail)
+			std::swap(Buffer[Head], Buffer[Tail - 1U]);
 	}
 
 	return;
@@ -251,15 +369,7 @@ void MakeStringReversed(
 	std::wstring &String)
 {
 	if (String.length() > 1U)
-	{
-	//Make string reversed
-		for (size_t Index = 0;Index < String.length() / 2U;++Index)
-		{
-			wchar_t StringIter = String.at(String.length() - 1U - Index);
-			String.at(String.length() - 1U - Index) = String.at(Index);
-			String.at(Index) = StringIter;
-		}
-	}
+		std::reverse(String.begin(), String.end());
 
 	return;
 }
@@ -271,7 +381,7 @@ bool CompareStringReversed(
 {
 	if (!RuleItem.empty() && !TestItem.empty() && 
 		TestItem.length() >= RuleItem.length() && 
-		TestItem.compare(0, RuleItem.length(), RuleItem) == 0)
+		memcmp(TestItem.c_str(), RuleItem.c_str(), RuleItem.length()) == 0)
 			return true;
 
 	return false;
@@ -285,17 +395,12 @@ bool CompareStringReversed(
 //Buffer and length check
 	if (RuleItem != nullptr && TestItem != nullptr)
 	{
-		std::wstring InnerRuleItem(RuleItem), InnerTestItem(TestItem);
-		if (!InnerRuleItem.empty() && !InnerTestItem.empty() && InnerTestItem.length() >= InnerRuleItem.length())
-		{
-		//Make string reversed to compare.
-			MakeStringReversed(InnerRuleItem);
-			MakeStringReversed(InnerTestItem);
+		const auto RuleLength = wcslen(RuleItem), TestLength = wcslen(TestItem);
 
-		//Compare each other.
-			if (InnerTestItem.compare(0, InnerRuleItem.length(), InnerRuleItem) == 0)
+	//Reversed prefix of both is the same as the suffix of both, compare in place without copying.
+		if (RuleLength > 0 && TestLength >= RuleLength && 
+			wmemcmp(TestItem + (TestLength - RuleLength), RuleItem, RuleLength) == 0)
 				return true;
-		}
 	}
 
 	return false;
@@ -448,10 +553,8 @@ HUFFMAN_RETURN_TYPE HPACK_HuffmanEncoding(
 	size_t Length, 
 	size_t *Produced)
 {
-	uint8_t Shift = 0, BitLength = 0;
-	uint64_t Mask = 0, Value = 0, BitQueue = 0;
-	HUFFMAN_NODE Huffman_Node;
-	memset(&Huffman_Node, 0, sizeof(Huffman_Node));
+	uint8_t BitLength = 0;
+	uint64_t BitQueue = 0;
 	size_t _Produced = 0, _Consumed = 0;
 	if (!Produced)
 		Produced = &_Produced;
@@ -460,54 +563,58 @@ HUFFMAN_RETURN_TYPE HPACK_HuffmanEncoding(
 	*Produced = *Consumed = 0;
 	while (ByteSize > 0)
 	{
-		if (Buffer && Length < 1U)
-			return HUFFMAN_RETURN_TYPE::ERROR_OVERFLOW;
-		Huffman_Node = HuffmanCodes[*String];
+		BitQueue = ((BitQueue << HuffmanCodes[*String].BitSize) | HuffmanCodes[*String].Bits); //Max 61 bits wide
+		BitLength += HuffmanCodes[*String].BitSize;
 		++String;
 		++(*Consumed);
 		--ByteSize;
-		BitQueue = ((BitQueue << Huffman_Node.BitSize) | Huffman_Node.Bits); //Max 33 bits wide
-		BitLength += Huffman_Node.BitSize;
 
-	//Canibalise the top bytes.
-		while (BitLength >= BYTES_TO_BITS)
+	//Canibalise the top 4 bytes at once.
+		if (BitLength >= sizeof(uint32_t) * BYTES_TO_BITS)
 		{
+			BitLength -= sizeof(uint32_t) * BYTES_TO_BITS;
 			if (Buffer)
 			{
-				Shift = BitLength - BYTES_TO_BITS;
-				Mask = static_cast<const uint64_t>(0xFF) << Shift;
-				Value = (BitQueue & Mask);
-				*Buffer = static_cast<const uint8_t>(Value >> Shift);
-				++Buffer;
-				--Length;
-				BitQueue ^= Value;
+				if (Length < sizeof(uint32_t))
+					return HUFFMAN_RETURN_TYPE::ERROR_OVERFLOW;
+				const auto Value = hton32(static_cast<const uint32_t>(BitQueue >> BitLength));
+				memcpy_s(Buffer, Length, &Value, sizeof(Value));
+				Buffer += sizeof(uint32_t);
+				Length -= sizeof(uint32_t);
 			}
 
-			++(*Produced);
-			BitLength -= BYTES_TO_BITS;
+			BitQueue &= (static_cast<const uint64_t>(1U) << BitLength) - 1U;
+			*Produced += sizeof(uint32_t);
 		}
 	}
 
-//Pad with EOS(incidentally all 1s).
-	if (BitLength > 0)
+//Canibalise the rest bytes and pad with EOS(incidentally all 1s).
+	while (BitLength > 0)
 	{
 		if (Buffer)
 		{
-			Shift = BYTES_TO_BITS - BitLength;
-			Mask = (static_cast<const uint64_t>(1U) << Shift) - 1U;
-			*Buffer = static_cast<const uint8_t>((BitQueue << Shift) | Mask);
+			if (Length < 1U)
+				return HUFFMAN_RETURN_TYPE::ERROR_OVERFLOW;
+			else if (BitLength >= BYTES_TO_BITS)
+				*Buffer = static_cast<const uint8_t>(BitQueue >> (BitLength - BYTES_TO_BITS));
+			else 
+				*Buffer = static_cast<const uint8_t>((BitQueue << (BYTES_TO_BITS - BitLength)) | ((static_cast<const uint64_t>(1U) << (BYTES_TO_BITS - BitLength)) - 1U));
 			++Buffer;
 			--Length;
 		}
 
 		++(*Produced);
+		if (BitLength >= BYTES_TO_BITS)
+			BitLength -= BYTES_TO_BITS;
+		else 
+			BitLength = 0;
 	}
 
 	return HUFFMAN_RETURN_TYPE::NONE;
 }
 
 //HTTP version 2 HPACK Header Compression huffman decoding
-//HPACK huffman encoding and decoding, please visit https://github.com/phluid61/mk-hpack.
+//Decoding is driven by state table which is generated from static huffman code, each byte is decoded in 2 state transitions.
 HUFFMAN_RETURN_TYPE HPACK_HuffmanDecoding(
 	uint8_t *HuffmanBuffer, 
 	size_t ByteSize, 
@@ -516,9 +623,6 @@ HUFFMAN_RETURN_TYPE HPACK_HuffmanDecoding(
 	size_t Length, 
 	size_t *Produced)
 {
-	auto TC = *HuffmanDecodes;
-	uint16_t Temp = 0;
-	uint8_t ByteIter = 0, BC = 0, Mask = 0;
 	size_t _Produced = 0, _Consumed = 0;
 	if (!Produced)
 		Produced = &_Produced;
@@ -530,73 +634,43 @@ HUFFMAN_RETURN_TYPE HPACK_HuffmanDecoding(
 	else if (TargetBuffer && Length < 1U)
 		return HUFFMAN_RETURN_TYPE::ERROR_OVERFLOW;
 
-#define ZERO(TC)      static_cast<const uint16_t>((TC) >> 16U)
-#define ONE(TC)       static_cast<const uint16_t>((TC) & 0xFFFF)
-#define IS_INT(x)     (((x) & 0x8000) == 0x8000)
-#define VALUE_OF(x)   ((x) & 0x7FFF)
-
+	uint8_t State = 0;
+	auto IsAccepted = true;
 	while (ByteSize > 0)
 	{
-		ByteIter = *HuffmanBuffer;
-		++HuffmanBuffer;
-		++(*Consumed);
-		--ByteSize;
-		BC = 0x80; //Bit cursor
-		Mask = 0x7F; //Padding mask
-		while (BC > 0)
+	//High 4 bits and low 4 bits
+		for (size_t Index = 0;Index < sizeof(uint8_t) * BYTES_TO_BITS / HTTP_2_HEADERS_HUFFMAN_NIBBLE_BITS;++Index)
 		{
-			if ((ByteIter & BC) == BC)
-				Temp = ONE(TC);
-			else 
-				Temp = ZERO(TC);
-			if (IS_INT(Temp))
+			const auto &Entry = HuffmanDecodeList.EntryList[State][Index == 0 ? (*HuffmanBuffer >> HTTP_2_HEADERS_HUFFMAN_NIBBLE_BITS) : (*HuffmanBuffer & (HTTP_2_HEADERS_HUFFMAN_NIBBLE_NUM - 1U))];
+			if ((Entry.Flags & HTTP_2_HEADERS_HUFFMAN_FLAGS_FAILED) != 0)
 			{
-				Temp = VALUE_OF(Temp);
-				if (Temp > 0xFF)
+				return HUFFMAN_RETURN_TYPE::ERROR_EOS;
+			}
+			else if ((Entry.Flags & HTTP_2_HEADERS_HUFFMAN_FLAGS_SYMBOL) != 0)
+			{
+				if (TargetBuffer)
 				{
-					return HUFFMAN_RETURN_TYPE::ERROR_EOS;
-				}
-				else {
-					if (TargetBuffer)
-					{
-						*TargetBuffer = static_cast<const uint8_t>(Temp);
-						++TargetBuffer;
-						--Length;
-					}
-					++(*Produced);
-					if (ByteSize < 1 && (ByteIter & Mask) == Mask)
-					{
-						TC = 0;
-						goto Completed;
-					}
-					else if (TargetBuffer && Length < 1U)
-					{
+					if (Length < 1U)
 						return HUFFMAN_RETURN_TYPE::ERROR_OVERFLOW;
-					}
-					else {
-						TC = *HuffmanDecodes;
-					}
+					*TargetBuffer = Entry.Symbol;
+					++TargetBuffer;
+					--Length;
 				}
-			}
-			else {
-				if (Temp < sizeof(HuffmanDecodes) / sizeof(uint32_t))
-					TC = HuffmanDecodes[Temp];
-				else 
-					return HUFFMAN_RETURN_TYPE::ERROR_TRUNCATED;
+
+				++(*Produced);
 			}
 
-			BC >>= 1U;
-			Mask >>= 1U;
+			State = Entry.State;
+			IsAccepted = (Entry.Flags & HTTP_2_HEADERS_HUFFMAN_FLAGS_ACCEPTED) != 0;
 		}
-	}
 
-#undef ZERO
-#undef ONE
-#undef IS_INT
-#undef VALUE_OF
+		++HuffmanBuffer;
+		++(*Consumed);
+		--ByteSize;
+	}
 
-Completed:
-	if (TC)
+//Padding must be the most significant bits of EOS and less than 8 bits.
+	if (!IsAccepted)
 		return HUFFMAN_RETURN_TYPE::ERROR_TRUNCATED;
 
 	return HUFFMAN_RETURN_TYPE::NONE;
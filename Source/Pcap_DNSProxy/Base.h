@@ -30,13 +30,32 @@ typedef struct _huffman_node_
 	uint8_t                              BitSize;
 }HuffmanNode, HUFFMAN_NODE;
 
+//Huffman decoding state transition
+typedef struct _huffman_decode_entry_
+{
+	uint8_t                              State;
+	uint8_t                              Flags;
+	uint8_t                              Symbol;
+}HuffmanDecodeEntry, HUFFMAN_DECODE_ENTRY;
+
+//Huffman decoding state table, each state is an internal node of huffman tree.
+typedef struct _huffman_decode_table_
+{
+	HUFFMAN_DECODE_ENTRY                 EntryList[HTTP_2_HEADERS_HUFFMAN_STATE_NUM][HTTP_2_HEADERS_HUFFMAN_NIBBLE_NUM];
+}HuffmanDecodeTable, HUFFMAN_DECODE_TABLE;
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
 
+//Function pointer of converting words in vector blocks
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+typedef size_t(*CASE_CONVERT_BLOCK_FUNCTION)(uint8_t * const, const size_t, const uint8_t, const uint8_t);
+#endif
+
 //Local variables
 //HTTP version 2 HPACK Header Compression static huffman coding node
-static const HUFFMAN_NODE HuffmanCodes[] = 
+static constexpr HUFFMAN_NODE HuffmanCodes[] = 
 {
 	{0x1FF8, 13}, {0x7FFFD8, 23}, 
 	{0xFFFFFE2, 28}, {0xFFFFFE3, 28}, 
@@ -153,266 +172,76 @@ static const HUFFMAN_NODE HuffmanCodes[] =
 	{0x3FFFFEE, 26}, {0x3FFFFFFF, 30}
 };
 
-//HTTP version 2 HPACK Header Compression static huffman decoding array
-static const uint32_t HuffmanDecodes[256U] =
+//HTTP version 2 HPACK Header Compression static huffman decoding table generation
+constexpr HUFFMAN_DECODE_TABLE HPACK_HuffmanDecodeTableGenerate(
+	const HUFFMAN_NODE * const CodeList)
 {
-	static_cast<const uint32_t>(65538U), 
-	static_cast<const uint32_t>(196612U), 
-	static_cast<const uint32_t>(1507352U), 
-	static_cast<const uint32_t>(327686U), 
-	static_cast<const uint32_t>(720908U), 
-	static_cast<const uint32_t>(458760U), 
-	static_cast<const uint32_t>(589834U), 
-	static_cast<const uint32_t>(2150662193U), 
-	static_cast<const uint32_t>(2150793313U), 
-	static_cast<const uint32_t>(2154004581U), 
-	static_cast<const uint32_t>(2154397807U), 
-	static_cast<const uint32_t>(851982U), 
-	static_cast<const uint32_t>(1114130U), 
-	static_cast<const uint32_t>(2155053172U), 
-	static_cast<const uint32_t>(983056U), 
-	static_cast<const uint32_t>(2149613605U), 
-	static_cast<const uint32_t>(2150465582U), 
-	static_cast<const uint32_t>(1245204U), 
-	static_cast<const uint32_t>(1376278U), 
-	static_cast<const uint32_t>(2150596659U), 
-	static_cast<const uint32_t>(2150924341U), 
-	static_cast<const uint32_t>(2151055415U), 
-	static_cast<const uint32_t>(2151186489U), 
-	static_cast<const uint32_t>(1638426U), 
-	static_cast<const uint32_t>(2687018U), 
-	static_cast<const uint32_t>(1769500U), 
-	static_cast<const uint32_t>(2162722U), 
-	static_cast<const uint32_t>(1900574U), 
-	static_cast<const uint32_t>(2031648U), 
-	static_cast<const uint32_t>(2151514177U), 
-	static_cast<const uint32_t>(2153742434U), 
-	static_cast<const uint32_t>(2154070118U), 
-	static_cast<const uint32_t>(2154266728U), 
-	static_cast<const uint32_t>(2293796U), 
-	static_cast<const uint32_t>(2424870U), 
-	static_cast<const uint32_t>(2154594413U), 
-	static_cast<const uint32_t>(2154725488U), 
-	static_cast<const uint32_t>(2154987637U), 
-	static_cast<const uint32_t>(2555944U), 
-	static_cast<const uint32_t>(2151317570U), 
-	static_cast<const uint32_t>(2151907396U), 
-	static_cast<const uint32_t>(2818092U), 
-	static_cast<const uint32_t>(3735610U), 
-	static_cast<const uint32_t>(2949166U), 
-	static_cast<const uint32_t>(3342388U), 
-	static_cast<const uint32_t>(3080240U), 
-	static_cast<const uint32_t>(3211314U), 
-	static_cast<const uint32_t>(2152038470U), 
-	static_cast<const uint32_t>(2152169544U), 
-	static_cast<const uint32_t>(2152300618U), 
-	static_cast<const uint32_t>(2152431692U), 
-	static_cast<const uint32_t>(3473462U), 
-	static_cast<const uint32_t>(3604536U), 
-	static_cast<const uint32_t>(2152562766U), 
-	static_cast<const uint32_t>(2152693840U), 
-	static_cast<const uint32_t>(2152824914U), 
-	static_cast<const uint32_t>(2152955988U), 
-	static_cast<const uint32_t>(3866684U), 
-	static_cast<const uint32_t>(4259906U), 
-	static_cast<const uint32_t>(3997758U), 
-	static_cast<const uint32_t>(4128832U), 
-	static_cast<const uint32_t>(2153087062U), 
-	static_cast<const uint32_t>(2153218137U), 
-	static_cast<const uint32_t>(2154463339U), 
-	static_cast<const uint32_t>(2154922102U), 
-	static_cast<const uint32_t>(4390980U), 
-	static_cast<const uint32_t>(4522054U), 
-	static_cast<const uint32_t>(2155315320U), 
-	static_cast<const uint32_t>(2155446394U), 
-	static_cast<const uint32_t>(4653128U), 
-	static_cast<const uint32_t>(4784202U), 
-	static_cast<const uint32_t>(2150006826U), 
-	static_cast<const uint32_t>(2150400059U), 
-	static_cast<const uint32_t>(2153283674U), 
-	static_cast<const uint32_t>(4915276U), 
-	static_cast<const uint32_t>(5046350U), 
-	static_cast<const uint32_t>(5177424U), 
-	static_cast<const uint32_t>(2149679138U), 
-	static_cast<const uint32_t>(2150137897U), 
-	static_cast<const uint32_t>(2151612497U), 
-	static_cast<const uint32_t>(5374035U), 
-	static_cast<const uint32_t>(2150072363U), 
-	static_cast<const uint32_t>(2155610196U), 
-	static_cast<const uint32_t>(5570646U), 
-	static_cast<const uint32_t>(2149810238U), 
-	static_cast<const uint32_t>(5701720U), 
-	static_cast<const uint32_t>(5832794U), 
-	static_cast<const uint32_t>(2147516452U), 
-	static_cast<const uint32_t>(2151710811U), 
-	static_cast<const uint32_t>(2153611390U), 
-	static_cast<const uint32_t>(5963868U), 
-	static_cast<const uint32_t>(2153676925U), 
-	static_cast<const uint32_t>(6094942U), 
-	static_cast<const uint32_t>(2151448672U), 
-	static_cast<const uint32_t>(2155544671U), 
-	static_cast<const uint32_t>(6291553U), 
-	static_cast<const uint32_t>(6422627U), 
-	static_cast<const uint32_t>(7274608U), 
-	static_cast<const uint32_t>(6553701U), 
-	static_cast<const uint32_t>(6750312U), 
-	static_cast<const uint32_t>(2153545923U), 
-	static_cast<const uint32_t>(2161115238U), 
-	static_cast<const uint32_t>(2155905154U), 
-	static_cast<const uint32_t>(6881386U), 
-	static_cast<const uint32_t>(7012460U), 
-	static_cast<const uint32_t>(2156101794U), 
-	static_cast<const uint32_t>(2159575234U), 
-	static_cast<const uint32_t>(2162196706U), 
-	static_cast<const uint32_t>(7143534U), 
-	static_cast<const uint32_t>(2157543585U), 
-	static_cast<const uint32_t>(2158461100U), 
-	static_cast<const uint32_t>(7405682U), 
-	static_cast<const uint32_t>(8781959U), 
-	static_cast<const uint32_t>(7536756U), 
-	static_cast<const uint32_t>(7929978U), 
-	static_cast<const uint32_t>(7667830U), 
-	static_cast<const uint32_t>(7798904U), 
-	static_cast<const uint32_t>(2159050929U), 
-	static_cast<const uint32_t>(2159247569U), 
-	static_cast<const uint32_t>(2161672409U), 
-	static_cast<const uint32_t>(2162393317U), 
-	static_cast<const uint32_t>(8061052U), 
-	static_cast<const uint32_t>(8388737U), 
-	static_cast<const uint32_t>(2162557053U), 
-	static_cast<const uint32_t>(8257663U), 
-	static_cast<const uint32_t>(2155970692U), 
-	static_cast<const uint32_t>(2156232838U), 
-	static_cast<const uint32_t>(2156429458U), 
-	static_cast<const uint32_t>(8519811U), 
-	static_cast<const uint32_t>(8650885U), 
-	static_cast<const uint32_t>(2157609116U), 
-	static_cast<const uint32_t>(2158002339U), 
-	static_cast<const uint32_t>(2158264489U), 
-	static_cast<const uint32_t>(2158657709U), 
-	static_cast<const uint32_t>(8913033U), 
-	static_cast<const uint32_t>(10092699U), 
-	static_cast<const uint32_t>(9044107U), 
-	static_cast<const uint32_t>(9437329U), 
-	static_cast<const uint32_t>(9175181U), 
-	static_cast<const uint32_t>(9306255U), 
-	static_cast<const uint32_t>(2159182005U), 
-	static_cast<const uint32_t>(2159640762U), 
-	static_cast<const uint32_t>(2159771837U), 
-	static_cast<const uint32_t>(2159968452U), 
-	static_cast<const uint32_t>(9568403U), 
-	static_cast<const uint32_t>(9699477U), 
-	static_cast<const uint32_t>(2160492772U), 
-	static_cast<const uint32_t>(2162721001U), 
-	static_cast<const uint32_t>(9830551U), 
-	static_cast<const uint32_t>(9961625U), 
-	static_cast<const uint32_t>(2147582087U), 
-	static_cast<const uint32_t>(2156494986U), 
-	static_cast<const uint32_t>(2156626060U), 
-	static_cast<const uint32_t>(2156757135U), 
-	static_cast<const uint32_t>(10223773U), 
-	static_cast<const uint32_t>(11141291U), 
-	static_cast<const uint32_t>(10354847U), 
-	static_cast<const uint32_t>(10748069U), 
-	static_cast<const uint32_t>(10485921U), 
-	static_cast<const uint32_t>(10616995U), 
-	static_cast<const uint32_t>(2157150357U), 
-	static_cast<const uint32_t>(2157346967U), 
-	static_cast<const uint32_t>(2157478043U), 
-	static_cast<const uint32_t>(2157805726U), 
-	static_cast<const uint32_t>(10879143U), 
-	static_cast<const uint32_t>(11010217U), 
-	static_cast<const uint32_t>(2158330022U), 
-	static_cast<const uint32_t>(2158526638U), 
-	static_cast<const uint32_t>(2158985396U), 
-	static_cast<const uint32_t>(2159444151U), 
-	static_cast<const uint32_t>(11272365U), 
-	static_cast<const uint32_t>(11862198U), 
-	static_cast<const uint32_t>(11403439U), 
-	static_cast<const uint32_t>(11534513U), 
-	static_cast<const uint32_t>(2159837375U), 
-	static_cast<const uint32_t>(2160427239U), 
-	static_cast<const uint32_t>(2163146930U), 
-	static_cast<const uint32_t>(11731124U), 
-	static_cast<const uint32_t>(2148106382U), 
-	static_cast<const uint32_t>(2156953745U), 
-	static_cast<const uint32_t>(2157215903U), 
-	static_cast<const uint32_t>(11993272U), 
-	static_cast<const uint32_t>(12517568U), 
-	static_cast<const uint32_t>(12124346U), 
-	static_cast<const uint32_t>(12255420U), 
-	static_cast<const uint32_t>(2158723278U), 
-	static_cast<const uint32_t>(2161606881U), 
-	static_cast<const uint32_t>(2162983149U), 
-	static_cast<const uint32_t>(12386494U), 
-	static_cast<const uint32_t>(2160558287U), 
-	static_cast<const uint32_t>(2162852075U), 
-	static_cast<const uint32_t>(12648642U), 
-	static_cast<const uint32_t>(13631697U), 
-	static_cast<const uint32_t>(12779716U), 
-	static_cast<const uint32_t>(13172938U), 
-	static_cast<const uint32_t>(12910790U), 
-	static_cast<const uint32_t>(13041864U), 
-	static_cast<const uint32_t>(2160099521U), 
-	static_cast<const uint32_t>(2160623817U), 
-	static_cast<const uint32_t>(2160754893U), 
-	static_cast<const uint32_t>(2161279189U), 
-	static_cast<const uint32_t>(13304012U), 
-	static_cast<const uint32_t>(13435086U), 
-	static_cast<const uint32_t>(2161803483U), 
-	static_cast<const uint32_t>(2163114224U), 
-	static_cast<const uint32_t>(2163376371U), 
-	static_cast<const uint32_t>(2164195535U), 
-	static_cast<const uint32_t>(2160820428U), 
-	static_cast<const uint32_t>(13762771U), 
-	static_cast<const uint32_t>(14680289U), 
-	static_cast<const uint32_t>(13893845U), 
-	static_cast<const uint32_t>(14287067U), 
-	static_cast<const uint32_t>(14024919U), 
-	static_cast<const uint32_t>(14155993U), 
-	static_cast<const uint32_t>(2161344724U), 
-	static_cast<const uint32_t>(2161541341U), 
-	static_cast<const uint32_t>(2162065631U), 
-	static_cast<const uint32_t>(2163310836U), 
-	static_cast<const uint32_t>(14418141U), 
-	static_cast<const uint32_t>(14549215U), 
-	static_cast<const uint32_t>(2163572982U), 
-	static_cast<const uint32_t>(2163704056U), 
-	static_cast<const uint32_t>(2163900667U), 
-	static_cast<const uint32_t>(2164031741U), 
-	static_cast<const uint32_t>(14811363U), 
-	static_cast<const uint32_t>(15663344U), 
-	static_cast<const uint32_t>(14942437U), 
-	static_cast<const uint32_t>(15270122U), 
-	static_cast<const uint32_t>(2164130022U), 
-	static_cast<const uint32_t>(15139048U), 
-	static_cast<const uint32_t>(2147647491U), 
-	static_cast<const uint32_t>(2147778565U), 
-	static_cast<const uint32_t>(2147909639U), 
-	static_cast<const uint32_t>(15401196U), 
-	static_cast<const uint32_t>(15532270U), 
-	static_cast<const uint32_t>(2148040715U), 
-	static_cast<const uint32_t>(2148302862U), 
-	static_cast<const uint32_t>(2148499472U), 
-	static_cast<const uint32_t>(2148630546U), 
-	static_cast<const uint32_t>(15794418U), 
-	static_cast<const uint32_t>(16187640U), 
-	static_cast<const uint32_t>(15925492U), 
-	static_cast<const uint32_t>(16056566U), 
-	static_cast<const uint32_t>(2148761620U), 
-	static_cast<const uint32_t>(2148892695U), 
-	static_cast<const uint32_t>(2149089305U), 
-	static_cast<const uint32_t>(2149220379U), 
-	static_cast<const uint32_t>(16318714U), 
-	static_cast<const uint32_t>(16449788U), 
-	static_cast<const uint32_t>(2149351453U), 
-	static_cast<const uint32_t>(2149482527U), 
-	static_cast<const uint32_t>(2155839708U), 
-	static_cast<const uint32_t>(2163802365U), 
-	static_cast<const uint32_t>(16646399U), 
-	static_cast<const uint32_t>(2148171789U), 
-	static_cast<const uint32_t>(2148958464U)
-};
+//Build huffman tree, internal nodes are numbered from root and leaves are marked by symbol plus number of internal nodes.
+	HUFFMAN_DECODE_TABLE DecodeTable{};
+	uint16_t ChildList[HTTP_2_HEADERS_HUFFMAN_STATE_NUM][2U]{};
+	bool AcceptList[HTTP_2_HEADERS_HUFFMAN_STATE_NUM]{};
+	uint16_t NodeNum = 1U;
+	for (uint16_t Symbol = 0;Symbol <= HTTP_2_HEADERS_HUFFMAN_EOS;++Symbol)
+	{
+		uint16_t Node = 0;
+		for (auto Index = CodeList[Symbol].BitSize;Index > 1U;--Index)
+		{
+			const auto Bit = (CodeList[Symbol].Bits >> (Index - 1U)) & 1U;
+			if (ChildList[Node][Bit] == 0)
+				ChildList[Node][Bit] = NodeNum++;
+			Node = ChildList[Node][Bit];
+		}
+
+		ChildList[Node][CodeList[Symbol].Bits & 1U] = static_cast<uint16_t>(HTTP_2_HEADERS_HUFFMAN_STATE_NUM + Symbol);
+	}
+
+//Padding is accepted only when all bits from the last symbol are 1.
+	uint16_t AcceptNode = 0;
+	AcceptList[AcceptNode] = true;
+	for (size_t Index = 0;Index < HTTP_2_HEADERS_HUFFMAN_PADDING_MAXSIZE;++Index)
+	{
+		AcceptNode = ChildList[AcceptNode][1U];
+		AcceptList[AcceptNode] = true;
+	}
+
+//Walk 4 bits from each state, the shortest code is 5 bits so each transition emits 1 symbol at most.
+	for (size_t State = 0;State < HTTP_2_HEADERS_HUFFMAN_STATE_NUM;++State)
+	{
+		for (size_t Nibble = 0;Nibble < HTTP_2_HEADERS_HUFFMAN_NIBBLE_NUM;++Nibble)
+		{
+			auto &Entry = DecodeTable.EntryList[State][Nibble];
+			auto Node = static_cast<uint16_t>(State);
+			for (auto Index = HTTP_2_HEADERS_HUFFMAN_NIBBLE_BITS;Index > 0;--Index)
+			{
+				Node = ChildList[Node][(Nibble >> (Index - 1U)) & 1U];
+				if (Node >= HTTP_2_HEADERS_HUFFMAN_STATE_NUM)
+				{
+				//EOS in string literal is a decoding error.
+					if (Node - HTTP_2_HEADERS_HUFFMAN_STATE_NUM == HTTP_2_HEADERS_HUFFMAN_EOS)
+					{
+						Entry.Flags = HTTP_2_HEADERS_HUFFMAN_FLAGS_FAILED;
+						Node = 0;
+
+						break;
+					}
+
+					Entry.Flags |= HTTP_2_HEADERS_HUFFMAN_FLAGS_SYMBOL;
+					Entry.Symbol = static_cast<uint8_t>(Node - HTTP_2_HEADERS_HUFFMAN_STATE_NUM);
+					Node = 0;
+				}
+			}
+
+			Entry.State = static_cast<uint8_t>(Node);
+			if ((Entry.Flags & HTTP_2_HEADERS_HUFFMAN_FLAGS_FAILED) == 0 && AcceptList[Node])
+				Entry.Flags |= HTTP_2_HEADERS_HUFFMAN_FLAGS_ACCEPTED;
+		}
+	}
+
+	return DecodeTable;
+}
+
+//HTTP version 2 HPACK Header Compression static huffman decoding table, it is generated when compiling.
+static constexpr HUFFMAN_DECODE_TABLE HuffmanDecodeList = HPACK_HuffmanDecodeTableGenerate(HuffmanCodes);
 
 //Functions
 HUFFMAN_RETURN_TYPE HPACK_HuffmanEncoding(
@@ -422,4 +251,23 @@ HUFFMAN_RETURN_TYPE HPACK_HuffmanEncoding(
 	uint8_t *Buffer, 
 	size_t Length, 
 	size_t *Produced);
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+CASE_CONVERT_BLOCK_FUNCTION CaseConvert_BlockSelect(
+	void);
+#if defined(ENABLE_SIMD_AVX2)
+SIMD_TARGET_AVX2 size_t CaseConvert_Block_AVX2(
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint8_t RangeBegin, 
+	const uint8_t RangeEnd);
+#endif
+size_t CaseConvert_Block_Vector(
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint8_t RangeBegin, 
+	const uint8_t RangeEnd);
+
+//Function of converting words in vector blocks, it is selected by processor at startup.
+CASE_CONVERT_BLOCK_FUNCTION CaseConvert_Block = CaseConvert_BlockSelect();
+#endif
 #endif
@@ -31,9 +31,22 @@ void CaptureInit(
 		return;
 	}
 
+//Receive waiting monitor initialization
+	if (Parameter.ReceiveWaiting > 0)
+	{
+		std::thread Thread_ReceiveWaiting(Capture_ReceiveWaitingMonitor);
+		Thread_ReceiveWaiting.detach();
+	}
+
+//Capture event loops initialization
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (!Capture_EventLoopInit())
+		return;
+#endif
+
 //Initialization
 	std::array<uint8_t, PCAP_ERRBUF_SIZE + MEMORY_RESERVED_BYTES> ErrorBuffer{};
-	pcap_if *CaptureDriveList = nullptr, *CaptureDriveItem = nullptr;
+	pcap_if *CaptureDriveList = nullptr;
 	std::wstring Message;
 	std::string CaptureName, CaptureDescription;
 	auto IsDeviceFound = true;
@@ -72,76 +85,70 @@ void CaptureInit(
 		}
 	//Mark captures.
 		else {
-			CaptureMutex.lock();
-			if (PcapRunningList.empty())
+			for (auto CaptureDriveItem = CaptureDriveList;CaptureDriveItem != nullptr;CaptureDriveItem = CaptureDriveItem->next)
 			{
-				CaptureMutex.unlock();
+			//Devices name, addresses and type check
+			#if defined(PLATFORM_WIN)
+				if (CaptureDriveItem->name == nullptr || 
+					CaptureDriveItem->addresses == nullptr || 
+					CaptureDriveItem->addresses->netmask == nullptr || 
+					CaptureDriveItem->flags == PCAP_IF_LOOPBACK)
+			#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+				if (CaptureDriveItem->name == nullptr || 
+					CaptureDriveItem->addresses == nullptr || 
+					CaptureDriveItem->flags == PCAP_IF_LOOPBACK)
+			#endif
+						continue;
 
-				std::thread Thread_Capture(std::bind(Capture_MainProcess, CaptureDriveList, true));
-				Thread_Capture.detach();
-			}
-			else {
-				CaptureMutex.unlock();
-				CaptureDriveItem = CaptureDriveList;
+			//Capture name and description initialization
+				CaptureName = CaptureDriveItem->name;
+				CaseConvert(CaptureName, false);
+				if (CaptureDriveItem->description != nullptr && strnlen_s(CaptureDriveItem->description, PCAP_CAPTURE_STRING_MAXNUM) > 0)
+				{
+					CaptureDescription = CaptureDriveItem->description;
+					CaseConvert(CaptureDescription, false);
+				}
+				else {
+					CaptureDescription.clear();
+				}
 
-			//Scan all devices.
-				while (CaptureDriveItem != nullptr)
+			//Capture device blacklist check
+				IsDeviceFound = true;
+				for (const auto &CaptureItem:*Parameter.PcapDevicesBlacklist)
 				{
-					if (CaptureDriveItem->name != nullptr)
+					if (CaptureName.find(CaptureItem) != std::string::npos || 
+						(!CaptureDescription.empty() && CaptureDescription.find(CaptureItem) != std::string::npos))
 					{
-					//Capture name and description initialization
-						CaptureName = CaptureDriveItem->name;
-						CaseConvert(CaptureName, false);
-						if (CaptureDriveItem->description != nullptr && strnlen_s(CaptureDriveItem->description, PCAP_CAPTURE_STRING_MAXNUM) > 0)
-						{
-							CaptureDescription = CaptureDriveItem->description;
-							CaseConvert(CaptureDescription, false);
-						}
-						else {
-							CaptureDescription.clear();
-						}
-
-					//Capture device blacklist check
-						IsDeviceFound = true;
-						for (const auto &CaptureItem:*Parameter.PcapDevicesBlacklist)
-						{
-							if (CaptureName.find(CaptureItem) != std::string::npos || 
-								(!CaptureDescription.empty() && CaptureDescription.find(CaptureItem) != std::string::npos))
-							{
-								IsDeviceFound = false;
-								break;
-							}
-						}
-
-					//Skip this capture.
-						if (!IsDeviceFound)
-						{
-							CaptureDriveItem = CaptureDriveItem->next;
-							continue;
-						}
+						IsDeviceFound = false;
+						break;
+					}
+				}
 
-					//Capture monitor
-						IsDeviceFound = true;
-						CaptureMutex.lock();
-						for (const auto &CaptureItem:PcapRunningList)
-						{
-							if (CaptureItem == CaptureDriveItem->name)
-							{
-								IsDeviceFound = false;
-								break;
-							}
-						}
-						CaptureMutex.unlock();
+			//Skip this capture.
+				if (!IsDeviceFound)
+					continue;
 
-					//Start a capture monitor.
-						if (IsDeviceFound)
-						{
-							std::thread Thread_Capture(std::bind(Capture_MainProcess, CaptureDriveItem, false));
-							Thread_Capture.detach();
-						}
+			//Capture monitor
+				CaptureMutex.lock();
+				for (const auto &CaptureItem:PcapRunningList)
+				{
+					if (CaptureItem == CaptureDriveItem->name)
+					{
+						IsDeviceFound = false;
+						break;
 					}
+				}
+				CaptureMutex.unlock();
 
-					CaptureDriveItem = CaptureDriveItem->next;
+			//Start capture of device, devices in Windows are captured by their own thread and others are registered to capture event loops.
+				if (IsDeviceFound)
+				{
+				#if defined(PLATFORM_WIN)
+					std::thread Thread_Capture(std::bind(Capture_MainProcess, std::string(CaptureDriveItem->name)));
+					Thread_Capture.detach();
+				#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+					Capture_RegisterDevice(CaptureDriveItem->name);
+				#endif
 				}
 			}
 		}
@@ -335,96 +342,394 @@ bool Capture_FilterRulesInit(
 	return true;
 }
 
-//Capture main process
+#if defined(PLATFORM_WIN)
+//Capture main process of device
 bool Capture_MainProcess(
-	const pcap_if * const DriveInterface, 
-	const bool IsCaptureList)
+	const std::string DeviceName)
 {
-//Devices name, addresses and type check
-	if (DriveInterface == nullptr)
-	{
+//Initialization(Part 1)
+	CAPTURE_DEVICE_TABLE DeviceTable;
+	const auto Buffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	memset(Buffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	*DeviceTable.DeviceName = DeviceName;
+	DeviceTable.DeviceName->shrink_to_fit();
+
+//Open device.
+	if (!Capture_OpenDevice(DeviceName.c_str(), DeviceTable, Buffer.get(), false))
 		return false;
+
+//Mark capture of device.
+	std::unique_lock<std::mutex> CaptureMutex(CaptureLock);
+	PcapRunningList.push_back(*DeviceTable.DeviceName);
+	CaptureMutex.unlock();
+
+//Initialization(Part 2)
+	CAPTURE_HANDLER_PARAM ParamList;
+	memset(&ParamList, 0, sizeof(ParamList));
+	ParamList.DeviceType = DeviceTable.DeviceType;
+	ParamList.Buffer = Buffer.get();
+	ParamList.BufferSize = Parameter.LargeBufferSize;
+	ssize_t ResultValue = 0;
+
+//Start Pcap Monitor.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Loop process.
+		ResultValue = pcap_loop(
+			DeviceTable.DeviceHandle, 
+			PCAP_LOOP_INFINITY, 
+			Capture_CallbackHandler, 
+			reinterpret_cast<unsigned char *>(&ParamList));
+		if (ResultValue < 0)
+		{
+		//Remove this capture from device list.
+			CaptureMutex.lock();
+			Capture_RemoveRunningList(*DeviceTable.DeviceName);
+
+			return false;
+		}
+
+	//Next loop
+		Sleep(Parameter.FileRefreshTime);
 	}
-#if defined(PLATFORM_WIN)
-	else if (DriveInterface->name == nullptr || 
-		DriveInterface->addresses == nullptr || 
-		DriveInterface->addresses->netmask == nullptr || 
-		DriveInterface->flags == PCAP_IF_LOOPBACK)
+
+//Loop terminated
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Capture module Monitor terminated", 0, nullptr, 0);
+	return true;
+}
 #elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-	else if (DriveInterface->name == nullptr || 
-		DriveInterface->addresses == nullptr || 
-		DriveInterface->flags == PCAP_IF_LOOPBACK)
-#endif
+//Capture event loops initialization
+bool Capture_EventLoopInit(
+	void)
+{
+//Number of event loops
+	CaptureEventLoopNum = static_cast<const size_t>(std::thread::hardware_concurrency());
+	if (CaptureEventLoopNum == 0)
+		CaptureEventLoopNum = 1U;
+	else if (CaptureEventLoopNum > PCAP_CAPTURE_LOOP_MAXNUM)
+		CaptureEventLoopNum = PCAP_CAPTURE_LOOP_MAXNUM;
+
+//Every event loop has its own buffer which is shared by all devices in it.
+	for (size_t Index = 0;Index < CaptureEventLoopNum;++Index)
 	{
-		if (IsCaptureList && DriveInterface->next != nullptr)
+		auto &EventLoop = CaptureEventLoopList.at(Index);
+		EventLoop.Buffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		memset(EventLoop.Buffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		memset(&EventLoop.IntervalTimeout, 0, sizeof(EventLoop.IntervalTimeout));
+		EventLoop.IntervalTimeout.tv_sec = Parameter.PcapReadingTimeout / SECOND_TO_MILLISECOND;
+		EventLoop.IntervalTimeout.tv_usec = Parameter.PcapReadingTimeout % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND;
+
+	//Event base and timer event of registration
+		EventLoop.EventBase = event_base_new();
+		if (EventLoop.EventBase != nullptr)
+			EventLoop.TimerEvent = event_new(EventLoop.EventBase, RETURN_ERROR, EV_PERSIST, TimerCallback_Capture, &EventLoop);
+		if (EventLoop.EventBase == nullptr || EventLoop.TimerEvent == nullptr || 
+			event_add(EventLoop.TimerEvent, &EventLoop.IntervalTimeout) == RETURN_ERROR)
 		{
-			std::thread Thread_Capture(std::bind(Capture_MainProcess, DriveInterface->next, true));
-			Thread_Capture.detach();
+			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::PCAP, L"Capture event initialization error", 0, nullptr, 0);
+			if (EventLoop.TimerEvent != nullptr)
+			{
+				event_free(EventLoop.TimerEvent);
+				EventLoop.TimerEvent = nullptr;
+			}
+			if (EventLoop.EventBase != nullptr)
+			{
+				event_base_free(EventLoop.EventBase);
+				EventLoop.EventBase = nullptr;
+			}
+
+		//Run with event loops which are already started.
+			if (Index == 0)
+				return false;
+			CaptureEventLoopNum = Index;
+			break;
 		}
 
-		return true;
+	//Start event loop.
+		std::thread Thread_CaptureEventLoop(std::bind(Capture_EventLoopProcess, Index));
+		Thread_CaptureEventLoop.detach();
 	}
 
+	return true;
+}
+
+//Open device and register its capture sockets to capture event loops
+bool Capture_RegisterDevice(
+	const char * const DeviceName)
+{
 //Initialization
-	CAPTURE_DEVICE_TABLE DeviceTable;
+	std::array<uint8_t, PCAP_ERRBUF_SIZE + MEMORY_RESERVED_BYTES> ErrorBuffer{};
+	std::vector<std::unique_ptr<CAPTURE_EVENT_DEVICE>> DeviceList;
+	size_t SocketNum = 1U;
+#if (defined(PLATFORM_LINUX) && defined(PACKET_FANOUT))
+	const auto FanoutGroup = static_cast<uint16_t>((static_cast<const size_t>(getpid()) + if_nametoindex(DeviceName)) & UINT16_MAX);
+	SocketNum = CaptureEventLoopNum;
+#endif
 
-//Pcap device blacklist check
-	if (IsCaptureList)
+//Open capture sockets, each event loop gets one socket of fanout group of device in Linux.
+	for (size_t Index = 0;Index < SocketNum;++Index)
 	{
-	//Capture name and description initialization
-		*DeviceTable.DeviceName = DriveInterface->name;
-		CaseConvert(*DeviceTable.DeviceName, false);
-		std::string CaptureDescription;
-		if (DriveInterface->description != nullptr && strnlen_s(DriveInterface->description, PCAP_CAPTURE_STRING_MAXNUM) > 0)
+		auto DeviceItem = std::make_unique<CAPTURE_EVENT_DEVICE>();
+		*DeviceItem->DeviceTable.DeviceName = DeviceName;
+		DeviceItem->DeviceTable.DeviceName->shrink_to_fit();
+		if (!Capture_OpenDevice(DeviceName, DeviceItem->DeviceTable, ErrorBuffer.data(), false))
+			break;
+
+	//Socket of event loop must be nonblocking.
+		if (pcap_setnonblock(
+				DeviceItem->DeviceTable.DeviceHandle, 
+				1, 
+				reinterpret_cast<char *>(ErrorBuffer.data())) == PCAP_ERROR)
 		{
-			CaptureDescription = DriveInterface->description;
-			CaseConvert(CaptureDescription, false);
+			std::wstring Message;
+			if (MBS_To_WCS_String(ErrorBuffer.data(), PCAP_ERRBUF_SIZE, Message))
+			{
+				Message.append(L"\n");
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::PCAP, Message.c_str(), 0, nullptr, 0);
+			}
+			else {
+				PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Convert multiple byte or wide char string error", 0, nullptr, 0);
+			}
+
+			break;
 		}
 
-	//Check process.
-		for (const auto &CaptureItem:*Parameter.PcapDevicesBlacklist)
+	//Handler parameters, buffer is set by event loop.
+		DeviceItem->ParamList.DeviceType = DeviceItem->DeviceTable.DeviceType;
+
+	//Spread packets of device to all capture sockets, the first socket is still captured without fanout group.
+	#if (defined(PLATFORM_LINUX) && defined(PACKET_FANOUT))
+		if (SocketNum > 1U && !Capture_JoinFanout(DeviceItem->DeviceTable.DeviceHandle, FanoutGroup))
 		{
-			if (DeviceTable.DeviceName->find(CaptureItem) != std::string::npos || 
-				(!CaptureDescription.empty() && CaptureDescription.find(CaptureItem) != std::string::npos))
-			{
-				if (DriveInterface->next != nullptr)
-				{
-					std::thread Thread_Capture(std::bind(Capture_MainProcess, DriveInterface->next, true));
-					Thread_Capture.detach();
-				}
+		//Fanout is degraded, packets of device are only captured by sockets which have been opened.
+			const auto ErrorCode = errno;
+			std::wstring Message(L"Capture fanout group joining error of device ");
+			std::wstring InnerMessage;
+			if (MBS_To_WCS_String(reinterpret_cast<const uint8_t *>(DeviceItem->DeviceTable.DeviceName->c_str()), DeviceItem->DeviceTable.DeviceName->length(), InnerMessage))
+				Message.append(InnerMessage);
+			Message.append(L", fanout is degraded to ");
+			Message.append(std::to_wstring(Index == 0 ? 1U : Index));
+			Message.append(L" capture socket(s)");
+			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::PCAP, Message.c_str(), ErrorCode, nullptr, 0);
+			if (Index == 0)
+				DeviceList.push_back(std::move(DeviceItem));
 
-				return true;
-			}
+			break;
 		}
+	#endif
+
+		DeviceList.push_back(std::move(DeviceItem));
 	}
+	if (DeviceList.empty())
+		return false;
 
-//Initialization(Part 1)
-	const auto Buffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	memset(Buffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	*DeviceTable.DeviceName = DriveInterface->name;
-	DeviceTable.DeviceName->shrink_to_fit();
+//Register all sockets to event loops.
+	std::lock_guard<std::mutex> CaptureMutex(CaptureLock);
+	for (auto &DeviceItem:DeviceList)
+	{
+	//Skip event loops which are terminated.
+		for (size_t Index = 0;Index < CaptureEventLoopNum;++Index)
+		{
+			if (CaptureEventLoopList.at(CaptureEventLoopIndex % CaptureEventLoopNum).EventBase != nullptr)
+				break;
+			else 
+				++CaptureEventLoopIndex;
+		}
+		if (CaptureEventLoopList.at(CaptureEventLoopIndex % CaptureEventLoopNum).EventBase == nullptr)
+			return false;
 
-//Open device
-#if defined(PLATFORM_WIN)
-	DeviceTable.DeviceHandle = pcap_open(
-		DriveInterface->name, 
-		static_cast<const int>(Parameter.LargeBufferSize), 
-		0, 
-		static_cast<const int>(Parameter.PcapReadingTimeout), 
-		nullptr, 
-		reinterpret_cast<char *>(Buffer.get()));
-#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-	DeviceTable.DeviceHandle = pcap_open_live(
-		DriveInterface->name, 
-		static_cast<const int>(Parameter.LargeBufferSize), 
-		0, 
-		static_cast<const int>(Parameter.PcapReadingTimeout), 
-		reinterpret_cast<char *>(Buffer.get()));
+		PcapRunningList.push_back(DeviceName);
+		CaptureEventLoopList.at(CaptureEventLoopIndex % CaptureEventLoopNum).PendingList.push_back(std::move(DeviceItem));
+		++CaptureEventLoopIndex;
+	}
+
+	return true;
+}
+
+//Capture event loop process
+void Capture_EventLoopProcess(
+	const size_t LoopIndex)
+{
+//Event loop
+	auto &EventLoop = CaptureEventLoopList.at(LoopIndex);
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		if (event_base_dispatch(EventLoop.EventBase) == RETURN_ERROR)
+			break;
+	}
+
+//Free all devices and events.
+	std::unique_lock<std::mutex> CaptureMutex(CaptureLock);
+	for (auto &DeviceItem:EventLoop.DeviceList)
+	{
+		event_free(DeviceItem->ReadEvent);
+		DeviceItem->ReadEvent = nullptr;
+		Capture_RemoveRunningList(*DeviceItem->DeviceTable.DeviceName);
+	}
+	for (auto &DeviceItem:EventLoop.PendingList)
+		Capture_RemoveRunningList(*DeviceItem->DeviceTable.DeviceName);
+	EventLoop.DeviceList.clear();
+	EventLoop.PendingList.clear();
+	event_free(EventLoop.TimerEvent);
+	EventLoop.TimerEvent = nullptr;
+	event_base_free(EventLoop.EventBase);
+	EventLoop.EventBase = nullptr;
+	CaptureMutex.unlock();
+
+//Loop terminated
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Capture module Monitor terminated", 0, nullptr, 0);
+	return;
+}
+
+//Capture event loop timer callback, remove closed devices and register new devices.
+void TimerCallback_Capture(
+	evutil_socket_t Socket, 
+	short EventType, 
+	void *Argument)
+{
+//Mark arguments.
+	if (Argument == nullptr)
+		return;
+	const auto EventLoop = reinterpret_cast<CAPTURE_EVENT_LOOP *>(Argument);
+	if (GlobalRunningStatus.IsNeedExit)
+	{
+		event_base_loopbreak(EventLoop->EventBase);
+		return;
+	}
+
+//Remove closed devices.
+	std::lock_guard<std::mutex> CaptureMutex(CaptureLock);
+	for (auto DeviceItem = EventLoop->DeviceList.begin();DeviceItem != EventLoop->DeviceList.end();)
+	{
+		if ((*DeviceItem)->IsClosed)
+		{
+			event_free((*DeviceItem)->ReadEvent);
+			Capture_RemoveRunningList(*(*DeviceItem)->DeviceTable.DeviceName);
+			DeviceItem = EventLoop->DeviceList.erase(DeviceItem);
+		}
+		else {
+			++DeviceItem;
+		}
+	}
+
+//Register new devices.
+	while (!EventLoop->PendingList.empty())
+	{
+		auto &DeviceItem = EventLoop->PendingList.front();
+		DeviceItem->ParamList.Buffer = EventLoop->Buffer.get();
+		DeviceItem->ParamList.BufferSize = Parameter.LargeBufferSize;
+		const auto DeviceSocket = pcap_get_selectable_fd(DeviceItem->DeviceTable.DeviceHandle);
+		if (DeviceSocket != PCAP_ERROR)
+			DeviceItem->ReadEvent = event_new(EventLoop->EventBase, DeviceSocket, EV_READ | EV_PERSIST, ReadCallback_Capture, DeviceItem.get());
+		if (DeviceItem->ReadEvent == nullptr || event_add(DeviceItem->ReadEvent, nullptr) == RETURN_ERROR)
+		{
+			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::PCAP, L"Capture event error", 0, nullptr, 0);
+			if (DeviceItem->ReadEvent != nullptr)
+				event_free(DeviceItem->ReadEvent);
+			Capture_RemoveRunningList(*DeviceItem->DeviceTable.DeviceName);
+		}
+		else {
+			EventLoop->DeviceList.push_back(std::move(DeviceItem));
+		}
+
+		EventLoop->PendingList.pop_front();
+	}
+
+	return;
+}
+
+//Capture event loop read callback, packets in capture socket are dispatched in batch.
+void ReadCallback_Capture(
+	evutil_socket_t Socket, 
+	short EventType, 
+	void *Argument)
+{
+//Mark arguments.
+	if (Argument == nullptr)
+		return;
+	const auto DeviceItem = reinterpret_cast<CAPTURE_EVENT_DEVICE *>(Argument);
+
+//Device is closed by timer callback when it is not available.
+	if (pcap_dispatch(
+			DeviceItem->DeviceTable.DeviceHandle, 
+			PCAP_CAPTURE_DISPATCH_NUM, 
+			Capture_CallbackHandler, 
+			reinterpret_cast<unsigned char *>(&DeviceItem->ParamList)) == PCAP_ERROR)
+	{
+		event_del(DeviceItem->ReadEvent);
+		DeviceItem->IsClosed = true;
+	}
+
+	return;
+}
 #endif
+
+//Remove a capture socket of device from running list, capture lock must be held.
+void Capture_RemoveRunningList(
+	const std::string &DeviceName)
+{
+	for (auto CaptureItem = PcapRunningList.begin();CaptureItem != PcapRunningList.end();++CaptureItem)
+	{
+		if (*CaptureItem == DeviceName)
+		{
+			PcapRunningList.erase(CaptureItem);
+			break;
+		}
+	}
+
+	return;
+}
+
+//Open device or offline capture file, set filter and check device type
+bool Capture_OpenDevice(
+	const char * const DeviceName, 
+	CAPTURE_DEVICE_TABLE &DeviceTable, 
+	uint8_t * const Buffer, 
+	const bool IsOfflineFile)
+{
+//Open device
+	if (IsOfflineFile)
+	{
+		DeviceTable.DeviceHandle = pcap_open_offline(
+			DeviceName, 
+			reinterpret_cast<char *>(Buffer));
+	}
+	else {
+	#if defined(PLATFORM_WIN)
+		DeviceTable.DeviceHandle = pcap_open(
+			DeviceName, 
+			static_cast<const int>(Parameter.LargeBufferSize), 
+			0, 
+			static_cast<const int>(Parameter.PcapReadingTimeout), 
+			nullptr, 
+			reinterpret_cast<char *>(Buffer));
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	//Create handle and activate it with immediate mode and large kernel buffer, packets are delivered from the ring(TPACKET_V3 memory mapped ring in Linux) without waiting for the reading timeout.
+		DeviceTable.DeviceHandle = pcap_create(
+			DeviceName, 
+			reinterpret_cast<char *>(Buffer));
+		if (DeviceTable.DeviceHandle != nullptr)
+		{
+			if (pcap_set_snaplen(DeviceTable.DeviceHandle, static_cast<const int>(Parameter.LargeBufferSize)) != 0 || 
+				pcap_set_promisc(DeviceTable.DeviceHandle, 0) != 0 || 
+				pcap_set_timeout(DeviceTable.DeviceHandle, static_cast<const int>(Parameter.PcapReadingTimeout)) != 0 || 
+				pcap_set_immediate_mode(DeviceTable.DeviceHandle, 1) != 0 || 
+				pcap_set_buffer_size(DeviceTable.DeviceHandle, static_cast<const int>(PCAP_CAPTURE_BUFFER_SIZE)) != 0 || 
+				pcap_activate(DeviceTable.DeviceHandle) < 0)
+			{
+				strncpy_s(reinterpret_cast<char *>(Buffer), PCAP_ERRBUF_SIZE, pcap_geterr(DeviceTable.DeviceHandle), PCAP_ERRBUF_SIZE - NULL_TERMINATE_LENGTH);
+				pcap_close(DeviceTable.DeviceHandle);
+				DeviceTable.DeviceHandle = nullptr;
+			}
+		}
+	#endif
+	}
 	if (DeviceTable.DeviceHandle == nullptr)
 	{
 		std::wstring Message;
-		if (MBS_To_WCS_String(Buffer.get(), PCAP_ERRBUF_SIZE, Message))
+		if (MBS_To_WCS_String(Buffer, PCAP_ERRBUF_SIZE, Message))
 		{
 			Message.append(L"\n");
 			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::PCAP, Message.c_str(), 0, nullptr, 0);
@@ -499,59 +804,202 @@ bool Capture_MainProcess(
 		return false;
 	}
 
-//Start capture with other devices.
-	std::unique_lock<std::mutex> CaptureMutex(CaptureLock);
-	PcapRunningList.push_back(*DeviceTable.DeviceName);
-	CaptureMutex.unlock();
-	if (IsCaptureList && DriveInterface->next != nullptr)
+	return true;
+}
+
+#if (defined(PLATFORM_LINUX) && defined(PACKET_FANOUT))
+//Join capture socket to packet fanout group, packets of the same flow and fragments of the same datagram are always delivered to the same socket.
+//Errors are printed by caller with name of device, errno is kept.
+bool Capture_JoinFanout(
+	pcap_t * const DeviceHandle, 
+	const uint16_t FanoutGroup)
+{
+	const int FanoutArgument = static_cast<const int>(FanoutGroup) | ((PACKET_FANOUT_HASH | PACKET_FANOUT_FLAG_DEFRAG) << (sizeof(uint16_t) * BYTES_TO_BITS));
+	if (setsockopt(pcap_fileno(DeviceHandle), SOL_PACKET, PACKET_FANOUT, &FanoutArgument, sizeof(FanoutArgument)) == SOCKET_ERROR)
+		return false;
+
+	return true;
+}
+#endif
+
+//Replay offline capture file through capture process and print statistics of each stage
+bool Capture_ReplayProcess(
+	const std::string &FileName)
+{
+//Capture filter initialization
+	if (!Capture_FilterRulesInit(PcapFilterRules))
 	{
-		std::thread Thread_Capture(std::bind(Capture_MainProcess, DriveInterface->next, true));
-		Thread_Capture.detach();
+		PcapFilterRules.clear();
+		return false;
 	}
 
+//Initialization
+	CAPTURE_DEVICE_TABLE DeviceTable;
+	const auto Buffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	memset(Buffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	*DeviceTable.DeviceName = FileName;
+
+//Open capture file.
+	if (!Capture_OpenDevice(FileName.c_str(), DeviceTable, Buffer.get(), true))
+		return false;
+
 //Initialization(Part 2)
 	CAPTURE_HANDLER_PARAM ParamList;
 	memset(&ParamList, 0, sizeof(ParamList));
 	ParamList.DeviceType = DeviceTable.DeviceType;
 	ParamList.Buffer = Buffer.get();
 	ParamList.BufferSize = Parameter.LargeBufferSize;
-	ssize_t ResultValue = 0;
-
-//Start Pcap Monitor.
-	while (!GlobalRunningStatus.IsNeedExit)
+	CAPTURE_REPLAY_STATISTICS ReplayStatistics;
+	memset(&ReplayStatistics, 0, sizeof(ReplayStatistics));
+	CaptureReplayCounter = &ReplayStatistics;
+
+//Replay all frames in file.
+	const auto BeginTime = std::chrono::steady_clock::now();
+	const auto ResultValue = pcap_loop(
+		DeviceTable.DeviceHandle, 
+		PCAP_LOOP_INFINITY, 
+		Capture_ReplayCallbackHandler, 
+		reinterpret_cast<unsigned char *>(&ParamList));
+	const auto ElapsedTime = Capture_ReplayTimeDifference(BeginTime);
+	CaptureReplayCounter = nullptr;
+	if (ResultValue < 0)
 	{
-	//Loop process.
-		ResultValue = pcap_loop(
-			DeviceTable.DeviceHandle, 
-			PCAP_LOOP_INFINITY, 
-			Capture_CallbackHandler, 
-			reinterpret_cast<unsigned char *>(&ParamList));
-		if (ResultValue < 0)
+		std::wstring Message;
+		if (MBS_To_WCS_String(reinterpret_cast<const uint8_t *>(pcap_geterr(DeviceTable.DeviceHandle)), PCAP_ERRBUF_SIZE, Message))
 		{
-		//Remove this capture from device list.
-			CaptureMutex.lock();
-			for (auto CaptureItem = PcapRunningList.begin();CaptureItem != PcapRunningList.end();)
-			{
-				if (*CaptureItem == *DeviceTable.DeviceName)
-					CaptureItem = PcapRunningList.erase(CaptureItem);
-				else 
-					++CaptureItem;
-			}
-
-			return false;
+			Message.append(L"\n");
+			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::PCAP, Message.c_str(), 0, nullptr, 0);
+		}
+		else {
+			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Convert multiple byte or wide char string error", 0, nullptr, 0);
 		}
 
-	//Next loop
-		Sleep(Parameter.FileRefreshTime);
+		return false;
 	}
 
-//Loop terminated
-	if (!GlobalRunningStatus.IsNeedExit)
-		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Capture module Monitor terminated", 0, nullptr, 0);
+//Link layer time is the rest of frame time, network layer time does not include port matching and query registering.
+	const auto LinkLayerTime = ReplayStatistics.TotalTime - ReplayStatistics.NetworkLayerTime - ReplayStatistics.RegisterTime;
+	const auto AnalyzeTime = ReplayStatistics.NetworkLayerTime - ReplayStatistics.MatchTime;
+
+//Print statistics.
+	PrintToScreen(true, false, L"[Notice] Replay of capture file is finished.\n");
+	PrintToScreen(true, false, L"Frames:          %llu in %.3f ms, %.0f frames/s\n", 
+		static_cast<const unsigned long long>(ReplayStatistics.FrameNum), 
+		static_cast<const double>(ElapsedTime) / static_cast<const double>(NANOSECOND_TO_MILLISECOND), 
+		ElapsedTime == 0 ? 0 : static_cast<const double>(ReplayStatistics.FrameNum) * static_cast<const double>(NANOSECOND_TO_SECOND) / static_cast<const double>(ElapsedTime));
+	PrintToScreen(true, false, L"Link layer:      %llu IP packets, %.1f ns/frame\n", 
+		static_cast<const unsigned long long>(ReplayStatistics.NetworkLayerNum), 
+		ReplayStatistics.FrameNum == 0 ? 0 : static_cast<const double>(LinkLayerTime) / static_cast<const double>(ReplayStatistics.FrameNum));
+	PrintToScreen(true, false, L"Network layer:   %llu accepted(%.2f%%), %.1f ns/packet\n", 
+		static_cast<const unsigned long long>(ReplayStatistics.AcceptedNum), 
+		ReplayStatistics.NetworkLayerNum == 0 ? 0 : static_cast<const double>(ReplayStatistics.AcceptedNum) * 100.0 / static_cast<const double>(ReplayStatistics.NetworkLayerNum), 
+		ReplayStatistics.NetworkLayerNum == 0 ? 0 : static_cast<const double>(AnalyzeTime) / static_cast<const double>(ReplayStatistics.NetworkLayerNum));
+	PrintToScreen(true, false, L"Query register:  %llu queries, %.1f ns/query\n", 
+		static_cast<const unsigned long long>(ReplayStatistics.RegisterNum), 
+		ReplayStatistics.RegisterNum == 0 ? 0 : static_cast<const double>(ReplayStatistics.RegisterTime) / static_cast<const double>(ReplayStatistics.RegisterNum));
+	PrintToScreen(true, false, L"Port matching:   %llu responses, %llu matched(%.2f%%), %.1f ns/response\n", 
+		static_cast<const unsigned long long>(ReplayStatistics.MatchNum), 
+		static_cast<const unsigned long long>(ReplayStatistics.MatchedNum), 
+		ReplayStatistics.MatchNum == 0 ? 0 : static_cast<const double>(ReplayStatistics.MatchedNum) * 100.0 / static_cast<const double>(ReplayStatistics.MatchNum), 
+		ReplayStatistics.MatchNum == 0 ? 0 : static_cast<const double>(ReplayStatistics.MatchTime) / static_cast<const double>(ReplayStatistics.MatchNum));
+
 	return true;
 }
 
+//Handler of offline replay loop function
+void Capture_ReplayCallbackHandler(
+	uint8_t * const ProcParameter, 
+	const pcap_pkthdr * const PacketHeader, 
+	const uint8_t * const PacketData)
+{
+	const auto BeginTime = std::chrono::steady_clock::now();
+	Capture_CallbackHandler(ProcParameter, PacketHeader, PacketData);
+	CaptureReplayCounter->TotalTime += Capture_ReplayTimeDifference(BeginTime);
+	++CaptureReplayCounter->FrameNum;
+
+	return;
+}
+
+//Register UDP queries in capture file to port table, responses of them in file can be matched like requests which are sent by this process.
+//Sockets of requesters are empty, matched responses are dropped after matching.
+void Capture_ReplayRegisterQuery(
+	const uint16_t Protocol, 
+	const uint8_t * const Buffer, 
+	const size_t Length)
+{
+//Initialization
+	const udp_hdr *UDP_Header = nullptr;
+	size_t DataLength = 0;
+	SOCKET_DATA SocketDataTemp;
+	memset(&SocketDataTemp, 0, sizeof(SocketDataTemp));
+	SocketDataTemp.Socket = INVALID_SOCKET;
+
+//IPv6, only packets without extension headers are registered.
+	if (Protocol == PPP_IPV6 || Protocol == OSI_L2_IPV6)
+	{
+		const auto IPv6_Header = reinterpret_cast<const ipv6_hdr *>(Buffer);
+		if (IPv6_Header->NextHeader != IPPROTO_UDP || sizeof(ipv6_hdr) + ntoh16(IPv6_Header->PayloadLength) > Length || 
+			ntoh16(IPv6_Header->PayloadLength) < sizeof(udp_hdr) + DNS_PACKET_MINSIZE)
+				return;
+
+		UDP_Header = reinterpret_cast<const udp_hdr *>(Buffer + sizeof(ipv6_hdr));
+		DataLength = ntoh16(IPv6_Header->PayloadLength) - sizeof(udp_hdr);
+		SocketDataTemp.SockAddr.ss_family = AF_INET6;
+		reinterpret_cast<sockaddr_in6 *>(&SocketDataTemp.SockAddr)->sin6_port = UDP_Header->SourcePort;
+		SocketDataTemp.AddrLen = sizeof(sockaddr_in6);
+	}
+//IPv4, fragments are not registered.
+	else if (Protocol == PPP_IPV4 || Protocol == OSI_L2_IPV4)
+	{
+		const auto IPv4_Header = reinterpret_cast<const ipv4_hdr *>(Buffer);
+		const auto HeaderLength = static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET;
+		if (IPv4_Header->Protocol != IPPROTO_UDP || HeaderLength < sizeof(ipv4_hdr) || ntoh16(IPv4_Header->Length) > Length || 
+			ntoh16(IPv4_Header->Length) < HeaderLength + sizeof(udp_hdr) + DNS_PACKET_MINSIZE || 
+			(ntoh16(IPv4_Header->Flags) & (IPV4_FLAG_GET_BIT_MF | IPV4_FLAG_GET_FRAGMENT_OFFSET)) != 0)
+				return;
+
+		UDP_Header = reinterpret_cast<const udp_hdr *>(Buffer + HeaderLength);
+		DataLength = ntoh16(IPv4_Header->Length) - HeaderLength - sizeof(udp_hdr);
+		SocketDataTemp.SockAddr.ss_family = AF_INET;
+		reinterpret_cast<sockaddr_in *>(&SocketDataTemp.SockAddr)->sin_port = UDP_Header->SourcePort;
+		SocketDataTemp.AddrLen = sizeof(sockaddr_in);
+	}
+	else {
+		return;
+	}
+
+//Responses are not registered.
+	const auto DNS_Header = reinterpret_cast<const dns_hdr *>(reinterpret_cast<const uint8_t *>(UDP_Header) + sizeof(udp_hdr));
+	if (DataLength < DNS_PACKET_MINSIZE || (ntoh16(DNS_Header->Flags) & DNS_FLAG_GET_BIT_RESPONSE) != 0)
+		return;
+
+//Register to port table.
+	const auto BeginTime = std::chrono::steady_clock::now();
+	auto PortItem = std::make_shared<OUTPUT_PACKET_TABLE>();
+	PortItem->SocketData_Output.push_back(SocketDataTemp);
+	PortItem->Protocol_Network = IPPROTO_UDP;
+	PortItem->DNS_ID = DNS_Header->ID;
+#if defined(PLATFORM_WIN)
+	PortItem->ClearPortTime = GetCurrentSystemTime() + Parameter.SocketTimeout_Unreliable_Once;
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	PortItem->ClearPortTime = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Unreliable_Once);
+#endif
+	OutputPacketList.Register(PortItem);
+	CaptureReplayCounter->RegisterTime += Capture_ReplayTimeDifference(BeginTime);
+	++CaptureReplayCounter->RegisterNum;
+
+	return;
+}
+
+//Get nanoseconds from begin time to now
+uint64_t Capture_ReplayTimeDifference(
+	const std::chrono::steady_clock::time_point &BeginTime)
+{
+	return static_cast<const uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - BeginTime).count());
+}
+
 //Handler of WinPcap/LibPcap loop function
+//Frame headers are parsed in place, only DNS payload of responses which need to be checked is copied to buffer of handler.
 void Capture_CallbackHandler(
 	uint8_t * const ProcParameter, 
 	const pcap_pkthdr * const PacketHeader, 
@@ -559,7 +1007,7 @@ void Capture_CallbackHandler(
 {
 //Initialization
 	const auto ParamList = reinterpret_cast<const CAPTURE_HANDLER_PARAM *>(ProcParameter);
-	memset(ParamList->Buffer, 0, Parameter.LargeBufferSize);
+	const uint8_t *NetworkBuffer = PacketData;
 	size_t DataLength = PacketHeader->caplen;
 	uint16_t Protocol = 0;
 
@@ -571,8 +1019,8 @@ void Capture_CallbackHandler(
 			return;
 		}
 		else {
-			memcpy_s(ParamList->Buffer, Parameter.LargeBufferSize, PacketData + sizeof(eth_hdr), DataLength - sizeof(eth_hdr));
-			Protocol = reinterpret_cast<const eth_hdr *>(PacketData)->Type;
+			Protocol = reinterpret_cast<const eth_hdr *>(NetworkBuffer)->Type;
+			NetworkBuffer += sizeof(eth_hdr);
 			DataLength -= sizeof(eth_hdr);
 		}
 	}
@@ -583,8 +1031,8 @@ void Capture_CallbackHandler(
 			return;
 		}
 		else {
-			memcpy_s(ParamList->Buffer, Parameter.LargeBufferSize, PacketData + sizeof(ieee_1394_hdr), DataLength - sizeof(ieee_1394_hdr));
-			Protocol = reinterpret_cast<const ieee_1394_hdr *>(PacketData)->Type;
+			Protocol = reinterpret_cast<const ieee_1394_hdr *>(NetworkBuffer)->Type;
+			NetworkBuffer += sizeof(ieee_1394_hdr);
 			DataLength -= sizeof(ieee_1394_hdr);
 		}
 	}
@@ -600,8 +1048,8 @@ void Capture_CallbackHandler(
 			return;
 		}
 		else {
-			Protocol = reinterpret_cast<const ieee_8021q_hdr *>(ParamList->Buffer)->Type;
-			memmove_s(ParamList->Buffer, Parameter.LargeBufferSize, ParamList->Buffer + sizeof(ieee_8021q_hdr), DataLength - sizeof(ieee_8021q_hdr));
+			Protocol = reinterpret_cast<const ieee_8021q_hdr *>(NetworkBuffer)->Type;
+			NetworkBuffer += sizeof(ieee_8021q_hdr);
 			DataLength -= sizeof(ieee_8021q_hdr);
 		}
 	}
@@ -614,8 +1062,8 @@ void Capture_CallbackHandler(
 			return;
 		}
 		else {
-			Protocol = reinterpret_cast<const ppp_hdr *>(ParamList->Buffer)->Protocol;
-			memmove_s(ParamList->Buffer, Parameter.LargeBufferSize, ParamList->Buffer + sizeof(ppp_hdr), DataLength - sizeof(ppp_hdr));
+			Protocol = reinterpret_cast<const ppp_hdr *>(NetworkBuffer)->Protocol;
+			NetworkBuffer += sizeof(ppp_hdr);
 			DataLength -= sizeof(ppp_hdr);
 		}
 	}
@@ -623,7 +1071,21 @@ void Capture_CallbackHandler(
 //LAN, WLAN and IEEE 802.1X, some Mobile Communications Standard/MCS devices which disguise as a LAN
 	if (((ntoh16(Protocol) == OSI_L2_IPV6 || ntoh16(Protocol) == PPP_IPV6) && DataLength > sizeof(ipv6_hdr)) || //IPv6
 		((ntoh16(Protocol) == OSI_L2_IPV4 || ntoh16(Protocol) == PPP_IPV4) && DataLength > sizeof(ipv4_hdr))) //IPv4
-			Capture_AnalyzeNetworkLayer(ntoh16(Protocol), ParamList->Buffer, DataLength, ParamList->BufferSize);
+	{
+	//Offline replay statistics
+		if (CaptureReplayCounter != nullptr)
+		{
+			Capture_ReplayRegisterQuery(ntoh16(Protocol), NetworkBuffer, DataLength);
+			const auto BeginTime = std::chrono::steady_clock::now();
+			++CaptureReplayCounter->NetworkLayerNum;
+			if (Capture_AnalyzeNetworkLayer(ntoh16(Protocol), NetworkBuffer, DataLength, ParamList->Buffer, ParamList->BufferSize))
+				++CaptureReplayCounter->AcceptedNum;
+			CaptureReplayCounter->NetworkLayerTime += Capture_ReplayTimeDifference(BeginTime);
+		}
+		else {
+			Capture_AnalyzeNetworkLayer(ntoh16(Protocol), NetworkBuffer, DataLength, ParamList->Buffer, ParamList->BufferSize);
+		}
+	}
 
 	return;
 }
@@ -633,7 +1095,8 @@ bool Capture_AnalyzeNetworkLayer(
 	const uint16_t Protocol, 
 	const uint8_t * const Buffer, 
 	const size_t Length, 
-	const size_t BufferSize)
+	uint8_t * const DNS_Buffer, 
+	const size_t DNS_BufferSize)
 {
 //Initialization
 	DNS_SERVER_DATA *PacketSource = nullptr;
@@ -649,11 +1112,6 @@ bool Capture_AnalyzeNetworkLayer(
 		if (sizeof(ipv6_hdr) + ntoh16(IPv6_Header->PayloadLength) > Length)
 			return false;
 
-	//Fragment check
-		const auto PayloadOffset = Capture_AnalyzeFragment(AF_INET6, Buffer, ntoh16(IPv6_Header->PayloadLength) + sizeof(ipv6_hdr), IsNeedTruncated);
-		if (PayloadOffset < 0)
-			return false;
-
 	//Mark source of packet.
 		if (memcmp(&IPv6_Header->Source, &Parameter.Target_Server_Main_IPv6.AddressData.IPv6.sin6_addr, sizeof(IPv6_Header->Source)) == 0)
 		{
@@ -682,6 +1140,22 @@ bool Capture_AnalyzeNetworkLayer(
 			return false;
 		}
 
+	//Reassemble fragments of UDP datagram, whole datagram is analyzed again.
+		std::unique_ptr<uint8_t[]> PacketBuffer;
+		size_t PacketLength = 0;
+		if (Capture_ReassembleFragment(AF_INET6, Buffer, ntoh16(IPv6_Header->PayloadLength) + sizeof(ipv6_hdr), PacketBuffer, PacketLength))
+		{
+			if (PacketLength > 0)
+				return Capture_AnalyzeNetworkLayer(Protocol, PacketBuffer.get(), PacketLength, DNS_Buffer, DNS_BufferSize);
+			else 
+				return true;
+		}
+
+	//Fragment check
+		const auto PayloadOffset = Capture_AnalyzeFragment(AF_INET6, Buffer, ntoh16(IPv6_Header->PayloadLength) + sizeof(ipv6_hdr), IsNeedTruncated);
+		if (PayloadOffset < 0)
+			return false;
+
 	//Get Hop Limits from IPv6 DNS server.
 	//ICMPv6
 		if (!IsNeedTruncated && Parameter.ICMP_Speed > 0 && IPv6_Header->NextHeader == IPPROTO_ICMPV6 && 
@@ -692,7 +1166,10 @@ bool Capture_AnalyzeNetworkLayer(
 				return false;
 		//ICMPv6 check
 			else if (Capture_AnalyzeICMP(AF_INET6, Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset), ntoh16(IPv6_Header->PayloadLength) - static_cast<const size_t>(PayloadOffset)))
+			{
+				std::lock_guard<std::mutex> CaptureStatusMutex(CaptureStatusLock);
 				PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark = IPv6_Header->HopLimit;
+			}
 
 			return true;
 		}
@@ -706,7 +1183,10 @@ bool Capture_AnalyzeNetworkLayer(
 				return false;
 		//TCP packet check
 			else if (Capture_AnalyzeTCP(Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset)))
+			{
+				std::lock_guard<std::mutex> CaptureStatusMutex(CaptureStatusLock);
 				PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark = IPv6_Header->HopLimit;
+			}
 
 			return true;
 		}
@@ -740,52 +1220,68 @@ bool Capture_AnalyzeNetworkLayer(
 
 			//Response check
 				size_t DataLength = ntoh16(IPv6_Header->PayloadLength) - static_cast<const size_t>(PayloadOffset) - sizeof(udp_hdr), PacketEDNS_Offset = 0, PacketEDNS_Length = 0;
+
+			//Copy DNS payload to buffer of handler, it may be rewritten in next steps.
+				if (DataLength > DNS_BufferSize)
+					return false;
+				else 
+					memcpy_s(DNS_Buffer, DNS_BufferSize, Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr), DataLength);
+
+				std::unique_lock<std::mutex> CaptureStatusMutex(CaptureStatusLock, std::defer_lock);
+				DNS_MESSAGE_INDEX MessageIndex;
+				MessageIndex.Length = 0;
 				if (!IsNeedTruncated)
 				{
 				//Check response data process.
 					DataLength = CheckResponseData(
 						REQUEST_PROCESS_TYPE::UDP_NORMAL, 
-						const_cast<uint8_t *>(Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr)), 
+						DNS_Buffer, 
 						DataLength, 
-						BufferSize - sizeof(ipv6_hdr) - static_cast<const size_t>(PayloadOffset) - sizeof(udp_hdr), 
+						DNS_BufferSize, 
 						&PacketEDNS_Offset, 
-						&PacketEDNS_Length);
+						&PacketEDNS_Length, 
+						&MessageIndex);
 					if (DataLength < DNS_PACKET_MINSIZE)
 						return false;
 
-				//DNS packet check
+				//DNS packet check, status of server is shared by all capture threads of fanout group.
 					if (Parameter.PacketCheck_DNS)
 					{
 					//DNS header options and data check
 						auto IsRegisterStatus = false;
-						if (Capture_AnalyzeDNS(Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr), BufferSize - (sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr)), IsRegisterStatus))
+						CaptureStatusMutex.lock();
+						if (Capture_AnalyzeDNS(DNS_Buffer, DNS_BufferSize, IsRegisterStatus))
 						{
 							PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark = IPv6_Header->HopLimit;
 
 						//Mark packet status.
-							if (IsRegisterStatus && Capture_PacketStatusCheck(AF_INET6, Buffer, sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr), DataLength, PacketEDNS_Offset, PacketEDNS_Length, true, PacketSource))
+							if (IsRegisterStatus && Capture_PacketStatusCheck(AF_INET6, Buffer, DNS_Buffer, DataLength, PacketEDNS_Offset, PacketEDNS_Length, true, PacketSource))
 								PacketSource->ServerPacketStatus.IsMarkDetail = true;
 						}
 
 					//Packet status check
 						if (!IsRegisterStatus && PacketSource->ServerPacketStatus.IsMarkDetail && 
-							!Capture_PacketStatusCheck(AF_INET6, Buffer, sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr), DataLength, PacketEDNS_Offset, PacketEDNS_Length, false, PacketSource))
+							!Capture_PacketStatusCheck(AF_INET6, Buffer, DNS_Buffer, DataLength, PacketEDNS_Offset, PacketEDNS_Length, false, PacketSource))
 								return false;
 					}
 				}
 
 			//Hop Limits value must not a random value.
-				if ((PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_StaticLoad > 0 && 
+				if (!CaptureStatusMutex.owns_lock())
+					CaptureStatusMutex.lock();
+				const auto IsHopLimitsValid = (PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_StaticLoad > 0 && 
 					static_cast<const size_t>(IPv6_Header->HopLimit) + static_cast<const size_t>(Parameter.HopLimitsFluctuation) >= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_StaticLoad) && 
 					static_cast<const size_t>(IPv6_Header->HopLimit) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_StaticLoad) + static_cast<const size_t>(Parameter.HopLimitsFluctuation)) || 
 					(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_StaticLoad == 0 && 
 					static_cast<const size_t>(IPv6_Header->HopLimit) + static_cast<const size_t>(Parameter.HopLimitsFluctuation) >= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark) && 
-					static_cast<const size_t>(IPv6_Header->HopLimit) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark) + static_cast<const size_t>(Parameter.HopLimitsFluctuation)))
+					static_cast<const size_t>(IPv6_Header->HopLimit) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv6_HeaderStatus.HopLimit_DynamicMark) + static_cast<const size_t>(Parameter.HopLimitsFluctuation));
+				CaptureStatusMutex.unlock();
+				if (IsHopLimitsValid)
 				{
 				//Mark DNS Flags Truncated bit.
 					if (IsNeedTruncated)
 					{
-						const_cast<dns_hdr *>(reinterpret_cast<const dns_hdr *>(Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr)))->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr))->Flags) | DNS_FLAG_GET_BIT_TC);
+						reinterpret_cast<dns_hdr *>(DNS_Buffer)->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(DNS_Buffer)->Flags) | DNS_FLAG_GET_BIT_TC);
 					}
 				//Calculate EDNS Label options length.
 /* EDNS Label operations are different between DNS servers.
@@ -799,7 +1295,7 @@ bool Capture_AnalyzeNetworkLayer(
 */
 
 				//Match port in global list.
-					Capture_MatchPortToSend(AF_INET6, Buffer + sizeof(ipv6_hdr) + static_cast<const size_t>(PayloadOffset) + sizeof(udp_hdr), DataLength, BufferSize - sizeof(ipv6_hdr) - static_cast<const size_t>(PayloadOffset) - sizeof(udp_hdr), UDP_Header->DestinationPort /* , IsNeedTruncated, PacketEDNS_Length */ );
+					Capture_MatchPortToSend(AF_INET6, DNS_Buffer, DataLength, DNS_BufferSize, UDP_Header->DestinationPort, MessageIndex /* , IsNeedTruncated, PacketEDNS_Length */ );
 					return true;
 				}
 			}
@@ -816,10 +1312,6 @@ bool Capture_AnalyzeNetworkLayer(
 			GetChecksum_Internet(reinterpret_cast<const uint16_t *>(Buffer), sizeof(ipv4_hdr)) != CHECKSUM_SUCCESS)
 				return false;
 
-	//Fragment check
-		if (Capture_AnalyzeFragment(AF_INET, Buffer, ntoh16(IPv4_Header->Length), IsNeedTruncated) == RETURN_ERROR)
-			return false;
-
 	//Mark source of packet.
 		if (IPv4_Header->Source.s_addr == Parameter.Target_Server_Main_IPv4.AddressData.IPv4.sin_addr.s_addr)
 		{
@@ -848,6 +1340,21 @@ bool Capture_AnalyzeNetworkLayer(
 			return false;
 		}
 
+	//Reassemble fragments of UDP datagram, whole datagram is analyzed again.
+		std::unique_ptr<uint8_t[]> PacketBuffer;
+		size_t PacketLength = 0;
+		if (Capture_ReassembleFragment(AF_INET, Buffer, ntoh16(IPv4_Header->Length), PacketBuffer, PacketLength))
+		{
+			if (PacketLength > 0)
+				return Capture_AnalyzeNetworkLayer(Protocol, PacketBuffer.get(), PacketLength, DNS_Buffer, DNS_BufferSize);
+			else 
+				return true;
+		}
+
+	//Fragment check
+		if (Capture_AnalyzeFragment(AF_INET, Buffer, ntoh16(IPv4_Header->Length), IsNeedTruncated) == RETURN_ERROR)
+			return false;
+
 	//Get TTL from IPv4 DNS server.
 	//ICMP
 		if (!IsNeedTruncated && Parameter.ICMP_Speed > 0 && IPv4_Header->Protocol == IPPROTO_ICMP && 
@@ -858,7 +1365,10 @@ bool Capture_AnalyzeNetworkLayer(
 				return false;
 		//ICMP Check
 			else if (Capture_AnalyzeICMP(AF_INET, Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET, ntoh16(IPv4_Header->Length) - static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET))
+			{
+				std::lock_guard<std::mutex> CaptureStatusMutex(CaptureStatusLock);
 				PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark = IPv4_Header->TTL;
+			}
 
 			return true;
 		}
@@ -872,7 +1382,10 @@ bool Capture_AnalyzeNetworkLayer(
 				return false;
 		//Packet check
 			else if (Capture_AnalyzeTCP(Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET))
+			{
+				std::lock_guard<std::mutex> CaptureStatusMutex(CaptureStatusLock);
 				PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark = IPv4_Header->TTL;
+			}
 
 			return true;
 		}
@@ -906,52 +1419,68 @@ bool Capture_AnalyzeNetworkLayer(
 
 			//Response check
 				size_t DataLength = ntoh16(IPv4_Header->Length) - static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET - sizeof(udp_hdr), PacketEDNS_Offset = 0, PacketEDNS_Length = 0;
+
+			//Copy DNS payload to buffer of handler, it may be rewritten in next steps.
+				if (DataLength > DNS_BufferSize)
+					return false;
+				else 
+					memcpy_s(DNS_Buffer, DNS_BufferSize, Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr), DataLength);
+
+				std::unique_lock<std::mutex> CaptureStatusMutex(CaptureStatusLock, std::defer_lock);
+				DNS_MESSAGE_INDEX MessageIndex;
+				MessageIndex.Length = 0;
 				if (!IsNeedTruncated)
 				{
 				//Check response data process.
 					DataLength = CheckResponseData(
 						REQUEST_PROCESS_TYPE::UDP_NORMAL, 
-						const_cast<uint8_t *>(Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr)), 
+						DNS_Buffer, 
 						DataLength, 
-						BufferSize - static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET - sizeof(udp_hdr), 
+						DNS_BufferSize, 
 						&PacketEDNS_Offset, 
-						&PacketEDNS_Length);
+						&PacketEDNS_Length, 
+						&MessageIndex);
 					if (DataLength < DNS_PACKET_MINSIZE)
 						return false;
 
-				//DNS packet check
+				//DNS packet check, status of server is shared by all capture threads of fanout group.
 					if (Parameter.PacketCheck_DNS)
 					{
 					//DNS header options and data check
 						auto IsRegisterStatus = false;
-						if (Capture_AnalyzeDNS(Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr), BufferSize - (static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr)), IsRegisterStatus))
+						CaptureStatusMutex.lock();
+						if (Capture_AnalyzeDNS(DNS_Buffer, DNS_BufferSize, IsRegisterStatus))
 						{
 							PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark = IPv4_Header->TTL;
 
 						//Mark packet status.
-							if (IsRegisterStatus && Capture_PacketStatusCheck(AF_INET, Buffer, static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr), DataLength, PacketEDNS_Offset, PacketEDNS_Length, true, PacketSource))
+							if (IsRegisterStatus && Capture_PacketStatusCheck(AF_INET, Buffer, DNS_Buffer, DataLength, PacketEDNS_Offset, PacketEDNS_Length, true, PacketSource))
 								PacketSource->ServerPacketStatus.IsMarkDetail = true;
 						}
 
 					//Packet status check
 						if (!IsRegisterStatus && PacketSource->ServerPacketStatus.IsMarkDetail && 
-							!Capture_PacketStatusCheck(AF_INET, Buffer, static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr), DataLength, PacketEDNS_Offset, PacketEDNS_Length, false, PacketSource))
+							!Capture_PacketStatusCheck(AF_INET, Buffer, DNS_Buffer, DataLength, PacketEDNS_Offset, PacketEDNS_Length, false, PacketSource))
 								return false;
 					}
 				}
 
 			//TTL value must not a random value.
-				if ((PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_StaticLoad > 0 && 
+				if (!CaptureStatusMutex.owns_lock())
+					CaptureStatusMutex.lock();
+				const auto IsTTL_Valid = (PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_StaticLoad > 0 && 
 					static_cast<const size_t>(IPv4_Header->TTL) + static_cast<const size_t>(Parameter.HopLimitsFluctuation) >= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_StaticLoad) && 
 					static_cast<const size_t>(IPv4_Header->TTL) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_StaticLoad) + static_cast<const size_t>(Parameter.HopLimitsFluctuation)) || 
 					(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_StaticLoad == 0 && 
 					static_cast<const size_t>(IPv4_Header->TTL) + static_cast<const size_t>(Parameter.HopLimitsFluctuation) >= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark) && 
-					static_cast<const size_t>(IPv4_Header->TTL) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark) + static_cast<const size_t>(Parameter.HopLimitsFluctuation)))
+					static_cast<const size_t>(IPv4_Header->TTL) <= static_cast<const size_t>(PacketSource->ServerPacketStatus.NetworkLayerStatus.IPv4_HeaderStatus.TTL_DynamicMark) + static_cast<const size_t>(Parameter.HopLimitsFluctuation));
+				CaptureStatusMutex.unlock();
+				if (IsTTL_Valid)
 				{
 				//Mark DNS Flags Truncated bit.
 					if (IsNeedTruncated)
 					{
-						const_cast<dns_hdr *>(reinterpret_cast<const dns_hdr *>(Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr)))->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr))->Flags) | DNS_FLAG_GET_BIT_TC);
+						reinterpret_cast<dns_hdr *>(DNS_Buffer)->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(DNS_Buffer)->Flags) | DNS_FLAG_GET_BIT_TC);
 					}
 				//Calculate EDNS Label options length.
 /* EDNS Label operations are different between DNS servers.
@@ -965,7 +1494,7 @@ bool Capture_AnalyzeNetworkLayer(
 */
 
 				//Match port in global list.
-					Capture_MatchPortToSend(AF_INET, Buffer + static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET + sizeof(udp_hdr), DataLength, BufferSize - static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET - sizeof(udp_hdr), UDP_Header->DestinationPort /* , IsNeedTruncated, PacketEDNS_Length */ );
+					Capture_MatchPortToSend(AF_INET, DNS_Buffer, DataLength, DNS_BufferSize, UDP_Header->DestinationPort, MessageIndex /* , IsNeedTruncated, PacketEDNS_Length */ );
 					return true;
 				}
 			}
@@ -978,6 +1507,192 @@ bool Capture_AnalyzeNetworkLayer(
 	return true;
 }
 
+//Reassemble fragments of UDP datagram in table
+//Return true when fragment is taken by table, and whole datagram without fragment is rebuilt when the last hole of datagram is filled.
+bool Capture_ReassembleFragment(
+	const uint16_t Protocol, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	std::unique_ptr<uint8_t[]> &PacketBuffer, 
+	size_t &PacketLength)
+{
+//Initialization
+	PacketLength = 0;
+	in6_addr Source, Destination;
+	memset(&Source, 0, sizeof(Source));
+	memset(&Destination, 0, sizeof(Destination));
+	uint32_t ID = 0;
+	uint8_t UpperProtocol = 0;
+	size_t HeaderLength = 0, NextHeaderOffset = 0, DataOffset = 0, FragmentOffset = 0;
+	auto IsMoreFragment = false;
+
+//IPv6
+	if (Protocol == AF_INET6)
+	{
+	//Scan Hop-by-Hop Options, Routing and Destination Options Headers which are in front of Fragment Header.
+		auto NextHeader = reinterpret_cast<const ipv6_hdr *>(Buffer)->NextHeader;
+		NextHeaderOffset = reinterpret_cast<const uint8_t *>(&reinterpret_cast<const ipv6_hdr *>(Buffer)->NextHeader) - Buffer;
+		HeaderLength = sizeof(ipv6_hdr);
+		while (NextHeader == IPPROTO_HOPOPTS || NextHeader == IPPROTO_ROUTING || NextHeader == IPPROTO_DSTOPTS)
+		{
+			if (HeaderLength + sizeof(ipv6_extension_hop_by_hop) > Length)
+				return false;
+
+		//Next Header and length fields are in the same place of these headers.
+			const auto IPv6_ExtensionHeader = reinterpret_cast<const ipv6_extension_hop_by_hop *>(Buffer + HeaderLength);
+			NextHeader = IPv6_ExtensionHeader->NextHeader;
+			NextHeaderOffset = HeaderLength;
+			HeaderLength += sizeof(ipv6_extension_hop_by_hop) + static_cast<const size_t>(IPv6_ExtensionHeader->ExtensionLength) * UNITS_IN_8_OCTETS;
+		}
+
+	//Fragment Header
+		if (NextHeader != IPPROTO_FRAGMENT || HeaderLength + sizeof(ipv6_extension_fragment) > Length)
+			return false;
+		const auto IPv6_FragmentHeader = reinterpret_cast<const ipv6_extension_fragment *>(Buffer + HeaderLength);
+		UpperProtocol = IPv6_FragmentHeader->NextHeader;
+		ID = IPv6_FragmentHeader->ID;
+		FragmentOffset = ntoh16(IPv6_FragmentHeader->Flags) & IPV6_FRAGMENT_HEADER_GET_FRAGMENT_OFFSET;
+		IsMoreFragment = (ntoh16(IPv6_FragmentHeader->Flags) & IPV6_FRAGMENT_HEADER_GET_BIT_MF) != 0;
+		DataOffset = HeaderLength + sizeof(ipv6_extension_fragment);
+		memcpy_s(&Source, sizeof(Source), &reinterpret_cast<const ipv6_hdr *>(Buffer)->Source, sizeof(in6_addr));
+		memcpy_s(&Destination, sizeof(Destination), &reinterpret_cast<const ipv6_hdr *>(Buffer)->Destination, sizeof(in6_addr));
+	}
+//IPv4
+	else if (Protocol == AF_INET)
+	{
+		const auto IPv4_Header = reinterpret_cast<const ipv4_hdr *>(Buffer);
+		if ((ntoh16(IPv4_Header->Flags) & (IPV4_FLAG_GET_BIT_MF | IPV4_FLAG_GET_FRAGMENT_OFFSET)) == 0)
+			return false;
+
+	//Fragment Offset is set in 8 octets.
+		UpperProtocol = IPv4_Header->Protocol;
+		ID = IPv4_Header->ID;
+		FragmentOffset = static_cast<const size_t>(ntoh16(IPv4_Header->Flags) & IPV4_FLAG_GET_FRAGMENT_OFFSET) * UNITS_IN_8_OCTETS;
+		IsMoreFragment = (ntoh16(IPv4_Header->Flags) & IPV4_FLAG_GET_BIT_MF) != 0;
+		HeaderLength = static_cast<const size_t>(IPv4_Header->IHL) * IPV4_IHL_BYTES_SET;
+		DataOffset = HeaderLength;
+		memcpy_s(&Source, sizeof(Source), &IPv4_Header->Source, sizeof(in_addr));
+		memcpy_s(&Destination, sizeof(Destination), &IPv4_Header->Destination, sizeof(in_addr));
+	}
+	else {
+		return false;
+	}
+
+//Only UDP datagram is reassembled, all fragments without the last must be multiple of 8 octets and whole datagram must be fit in buffer.
+	if (UpperProtocol != IPPROTO_UDP || DataOffset >= Length || HeaderLength > CAPTURE_FRAGMENT_HEADER_MAXSIZE || 
+		(IsMoreFragment && (Length - DataOffset) % UNITS_IN_8_OCTETS != 0) || 
+		HeaderLength + FragmentOffset + Length - DataOffset > Parameter.LargeBufferSize)
+			return false;
+	const auto FragmentLength = Length - DataOffset;
+
+//Find datagram in table and remove all expired datagrams.
+	const auto CurrentTime = GetCurrentSystemTime();
+	std::lock_guard<std::mutex> CaptureFragmentMutex(CaptureFragmentLock);
+	auto FragmentItem = CaptureFragmentList.end();
+	for (auto ListItem = CaptureFragmentList.begin();ListItem != CaptureFragmentList.end();)
+	{
+		if (ListItem->ClearTime <= CurrentTime)
+		{
+			ListItem = CaptureFragmentList.erase(ListItem);
+		}
+		else {
+			if (ListItem->Protocol == Protocol && ListItem->ID == ID && ListItem->UpperProtocol == UpperProtocol && 
+				memcmp(&ListItem->Source, &Source, sizeof(Source)) == 0 && memcmp(&ListItem->Destination, &Destination, sizeof(Destination)) == 0)
+					FragmentItem = ListItem;
+
+			++ListItem;
+		}
+	}
+
+//Register new datagram to table.
+	if (FragmentItem == CaptureFragmentList.end())
+	{
+		if (CaptureFragmentList.size() >= CAPTURE_FRAGMENT_MAXNUM)
+			return false;
+
+		CAPTURE_FRAGMENT_DATA FragmentData;
+		FragmentData.Protocol = Protocol;
+		FragmentData.UpperProtocol = UpperProtocol;
+		FragmentData.ID = ID;
+		FragmentData.Source = Source;
+		FragmentData.Destination = Destination;
+		FragmentData.Buffer = std::make_unique<uint8_t[]>(CAPTURE_FRAGMENT_HEADER_MAXSIZE + Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		memset(FragmentData.Buffer.get(), 0, CAPTURE_FRAGMENT_HEADER_MAXSIZE + Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		FragmentData.HeaderLength = 0;
+		FragmentData.NextHeaderOffset = 0;
+		FragmentData.ReceivedLength = 0;
+		FragmentData.TotalLength = 0;
+		FragmentData.ClearTime = CurrentTime + CAPTURE_FRAGMENT_TIMEOUT;
+		CaptureFragmentList.push_back(std::move(FragmentData));
+		FragmentItem = std::prev(CaptureFragmentList.end());
+	}
+
+//Overlapping, duplicate or out of range fragments are not allowed, drop whole datagram.
+	auto IsDropDatagram = (!IsMoreFragment && FragmentItem->TotalLength > 0) || 
+		(FragmentItem->TotalLength > 0 && FragmentOffset + FragmentLength > FragmentItem->TotalLength);
+	for (const auto &RangeItem:FragmentItem->RangeList)
+	{
+		if ((FragmentOffset < RangeItem.second && RangeItem.first < FragmentOffset + FragmentLength) || 
+			(!IsMoreFragment && RangeItem.second > FragmentOffset + FragmentLength))
+		{
+			IsDropDatagram = true;
+			break;
+		}
+	}
+	if (IsDropDatagram)
+	{
+		CaptureFragmentList.erase(FragmentItem);
+		return true;
+	}
+
+//Copy unfragmentable headers of the first fragment, and data of fragment.
+	if (FragmentOffset == 0)
+	{
+		memcpy_s(FragmentItem->Buffer.get(), CAPTURE_FRAGMENT_HEADER_MAXSIZE, Buffer, HeaderLength);
+		FragmentItem->HeaderLength = HeaderLength;
+		FragmentItem->NextHeaderOffset = NextHeaderOffset;
+	}
+	if (!IsMoreFragment)
+		FragmentItem->TotalLength = FragmentOffset + FragmentLength;
+	memcpy_s(FragmentItem->Buffer.get() + CAPTURE_FRAGMENT_HEADER_MAXSIZE + FragmentOffset, Parameter.LargeBufferSize - FragmentOffset, Buffer + DataOffset, FragmentLength);
+	FragmentItem->RangeList.push_back(std::make_pair(FragmentOffset, FragmentOffset + FragmentLength));
+	FragmentItem->ReceivedLength += FragmentLength;
+
+//Wait for other fragments.
+	if (FragmentItem->HeaderLength == 0 || FragmentItem->TotalLength == 0 || FragmentItem->ReceivedLength < FragmentItem->TotalLength)
+		return true;
+
+//Rebuild whole datagram.
+	if (FragmentItem->HeaderLength + FragmentItem->TotalLength <= Parameter.LargeBufferSize)
+	{
+		PacketLength = FragmentItem->HeaderLength + FragmentItem->TotalLength;
+		PacketBuffer = std::make_unique<uint8_t[]>(PacketLength + MEMORY_RESERVED_BYTES);
+		memset(PacketBuffer.get(), 0, PacketLength + MEMORY_RESERVED_BYTES);
+		memcpy_s(PacketBuffer.get(), PacketLength, FragmentItem->Buffer.get(), FragmentItem->HeaderLength);
+		memcpy_s(PacketBuffer.get() + FragmentItem->HeaderLength, PacketLength - FragmentItem->HeaderLength, FragmentItem->Buffer.get() + CAPTURE_FRAGMENT_HEADER_MAXSIZE, FragmentItem->TotalLength);
+
+	//Remove Fragment Header from IPv6 header chain.
+		if (Protocol == AF_INET6)
+		{
+			const auto IPv6_Header = reinterpret_cast<ipv6_hdr *>(PacketBuffer.get());
+			IPv6_Header->PayloadLength = hton16(static_cast<const uint16_t>(PacketLength - sizeof(ipv6_hdr)));
+			PacketBuffer.get()[FragmentItem->NextHeaderOffset] = UpperProtocol;
+		}
+	//Clear More Fragment bit and Fragment Offset of IPv4 header.
+		else {
+			const auto IPv4_Header = reinterpret_cast<ipv4_hdr *>(PacketBuffer.get());
+			IPv4_Header->Length = hton16(static_cast<const uint16_t>(PacketLength));
+			IPv4_Header->Flags = hton16(ntoh16(IPv4_Header->Flags) & IPV4_FLAG_GET_BIT_RES_DF);
+			IPv4_Header->Checksum = 0;
+			IPv4_Header->Checksum = GetChecksum_Internet(reinterpret_cast<const uint16_t *>(PacketBuffer.get()), FragmentItem->HeaderLength);
+		}
+	}
+
+//Remove datagram from table.
+	CaptureFragmentList.erase(FragmentItem);
+	return true;
+}
+
 //IP header fragment check
 ssize_t Capture_AnalyzeFragment(
 	const uint16_t Protocol, 
@@ -1238,11 +1953,11 @@ bool Capture_AnalyzeDNS(
 	return false;
 }
 
-//Mark and check server packet status
+//Mark and check server packet status, CaptureStatusLock must be held by caller.
 bool Capture_PacketStatusCheck(
 	const uint16_t Protocol, 
 	const uint8_t * const Buffer, 
-	const size_t DNS_DataOffset, 
+	const uint8_t * const DNS_Buffer, 
 	const size_t DNS_DataLength, 
 	const size_t EDNS_Offset, 
 	const size_t EDNS_Length, 
@@ -1253,10 +1968,10 @@ bool Capture_PacketStatusCheck(
 	if (IsRegisterStatus)
 	{
 	//Application layer
-		if (DNS_DataOffset != 0)
+		if (DNS_Buffer != nullptr)
 		{
 		//Mark DNS header flags.
-			PacketSource->ServerPacketStatus.ApplicationLayerStatus.DNS_Header_Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(Buffer + DNS_DataOffset)->Flags) & DNS_FLAG_GET_BIT_SERVER_FIXED);
+			PacketSource->ServerPacketStatus.ApplicationLayerStatus.DNS_Header_Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(DNS_Buffer)->Flags) & DNS_FLAG_GET_BIT_SERVER_FIXED);
 
 		//Mark EDNS Label record.
 			if (Parameter.EDNS_Label && EDNS_Offset != 0 && EDNS_Length != 0)
@@ -1268,12 +1983,12 @@ bool Capture_PacketStatusCheck(
 					PacketSource->ServerPacketStatus.ApplicationLayerStatus.IsNeedCheck_EDNS = true;
 
 			//EDNS Label resource record
-				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_UDP_PayloadSize = ntoh16(reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->UDP_PayloadSize);
-				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Version = reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->Version;
+				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_UDP_PayloadSize = ntoh16(reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->UDP_PayloadSize);
+				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Version = reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->Version;
 
 			//DNSSEC OK bit in Z field
 				if (Parameter.DNSSEC_Request)
-					PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Z_Field = ntoh16(reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->Z_Field);
+					PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Z_Field = ntoh16(reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->Z_Field);
 
 			//EDNS option length will be checked in next step.
 			}
@@ -1312,10 +2027,10 @@ bool Capture_PacketStatusCheck(
 //Check packet status.
 	else {
 	//Application layer
-		if (DNS_DataOffset != 0)
+		if (DNS_Buffer != nullptr)
 		{
 		//DNS header flags check
-			if (PacketSource->ServerPacketStatus.ApplicationLayerStatus.DNS_Header_Flags != hton16((ntoh16(reinterpret_cast<const dns_hdr *>(Buffer + DNS_DataOffset)->Flags) & DNS_FLAG_GET_BIT_SERVER_FIXED)))
+			if (PacketSource->ServerPacketStatus.ApplicationLayerStatus.DNS_Header_Flags != hton16((ntoh16(reinterpret_cast<const dns_hdr *>(DNS_Buffer)->Flags) & DNS_FLAG_GET_BIT_SERVER_FIXED)))
 				return false;
 
 		//EDNS Label record check
@@ -1326,9 +2041,9 @@ bool Capture_PacketStatusCheck(
 					return false;
 
 			//EDNS Label resource record and DNSSEC OK bit in Z field
-			if (PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_UDP_PayloadSize != ntoh16(reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->UDP_PayloadSize) || 
-				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Version != reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->Version || 
-				(Parameter.DNSSEC_Request && PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Z_Field != ntoh16(reinterpret_cast<const edns_header *>(Buffer + DNS_DataOffset + EDNS_Offset)->Z_Field)))
+			if (PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_UDP_PayloadSize != ntoh16(reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->UDP_PayloadSize) || 
+				PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Version != reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->Version || 
+				(Parameter.DNSSEC_Request && PacketSource->ServerPacketStatus.ApplicationLayerStatus.EDNS_Z_Field != ntoh16(reinterpret_cast<const edns_header *>(DNS_Buffer + EDNS_Offset)->Z_Field)))
 					return false;
 			}
 		}
@@ -1379,140 +2094,105 @@ bool Capture_MatchPortToSend(
 	const uint8_t * const Buffer, 
 	const size_t Length, 
 	const size_t BufferSize, 
-	const uint16_t Port
+	const uint16_t Port, 
+	DNS_MESSAGE_INDEX &MessageIndex
 //	const bool IsNeedTruncated, 
 //	const size_t EDNS_Length_Output
 )
 {
-//Initialization
-	SOCKET_DATA SocketData_Input;
-	memset(&SocketData_Input, 0, sizeof(SocketData_Input));
-	SocketData_Input.Socket = INVALID_SOCKET;
-	std::string DomainString_Original, DomainString_Request;
-	uint16_t SystemProtocol = 0;
-	size_t ReceiveIndex = 0;
-
-//Match port.
-	std::unique_lock<std::mutex> OutputPacketListMutex(OutputPacketListLock);
-	for (auto &PortItem:OutputPacketList)
+//Match port and DNS ID.
+	std::chrono::steady_clock::time_point BeginTime;
+	if (CaptureReplayCounter != nullptr)
+		BeginTime = std::chrono::steady_clock::now();
+	const auto PortItem = OutputPacketList.Match(Protocol, Port, reinterpret_cast<const dns_hdr *>(Buffer)->ID);
+	if (CaptureReplayCounter != nullptr)
 	{
-		for (const auto &SocketDataItem:PortItem.SocketData_Output)
-		{
-			if ((PortItem.ClearPortTime > 0 && //Do not scan expired data.
-				Protocol == AF_INET6 && SocketDataItem.AddrLen == sizeof(sockaddr_in6) && SocketDataItem.SockAddr.ss_family == AF_INET6 && 
-				Port == reinterpret_cast<const sockaddr_in6 *>(&SocketDataItem.SockAddr)->sin6_port) || //IPv6
-				(Protocol == AF_INET && SocketDataItem.AddrLen == sizeof(sockaddr_in) && SocketDataItem.SockAddr.ss_family == AF_INET && 
-				Port == reinterpret_cast<const sockaddr_in *>(&SocketDataItem.SockAddr)->sin_port)) //IPv4
-			{
-				if (Parameter.ReceiveWaiting > 0)
-				{
-					++PortItem.ReceiveIndex;
-					ReceiveIndex = PortItem.ReceiveIndex;
+		CaptureReplayCounter->MatchTime += Capture_ReplayTimeDifference(BeginTime);
+		++CaptureReplayCounter->MatchNum;
+		if (PortItem)
+			++CaptureReplayCounter->MatchedNum;
+	}
+	if (!PortItem)
+	{
+		OutputPacketList.ClearExpired();
+		return false;
+	}
 
-					OutputPacketListMutex.unlock();
-					goto StopLoop;
-				}
-				else {
-				//EDNS options check
+//EDNS options check
 /* EDNS Label operations are different between DNS servers.
-				//EDNS Label options are exist in input packet rather than output packet.
-					if (!IsNeedTruncated && Parameter.PacketCheck_DNS && 
-						PortItem.EDNS_Length >= sizeof(edns_header) && PortItem.EDNS_Length - sizeof(edns_header) != 0 && 
-						EDNS_Length_Output == 0)
-							return false;
+//EDNS Label options are exist in input packet rather than output packet.
+	if (!IsNeedTruncated && Parameter.PacketCheck_DNS && 
+		PortItem->EDNS_Length >= sizeof(edns_header) && PortItem->EDNS_Length - sizeof(edns_header) != 0 && 
+		EDNS_Length_Output == 0)
+			return false;
 */
 
-				//Copy socket data from global list.
-					SocketData_Input = PortItem.SocketData_Input;
-					DomainString_Original = PortItem.DomainString_Original;
-					DomainString_Request = PortItem.DomainString_Request;
-					SystemProtocol = PortItem.Protocol_Network;
-					PortItem.ClearPortTime = 0;
-
-				//Clear item in global list.
-					memset(&PortItem.SocketData_Input, 0, sizeof(PortItem.SocketData_Input));
-					PortItem.SocketData_Input.Socket = INVALID_SOCKET;
-					goto ClearListData;
-				}
-			}
-		}
-	}
-
-	goto ClearListData;
-
-//Jump here to stop loop, wait receiving and match port again.
-StopLoop:
-	Sleep(Parameter.ReceiveWaiting);
-	OutputPacketListMutex.lock();
-	for (auto &PortItem:OutputPacketList)
+//Park response in receive waiting window, only the last response in waiting time will be taken by receive waiting monitor.
+	if (Parameter.ReceiveWaiting > 0)
 	{
-		for (const auto &SocketDataItem:PortItem.SocketData_Output)
+	//Buffer only keeps response and length field which is added when it is sent by TCP.
+		CAPTURE_WAITING_DATA WaitingData;
+		WaitingData.PortItem = PortItem;
+		WaitingData.BufferSize = Length + sizeof(uint16_t) + MEMORY_RESERVED_BYTES;
+		WaitingData.Buffer = std::make_unique<uint8_t[]>(WaitingData.BufferSize);
+		memset(WaitingData.Buffer.get(), 0, WaitingData.BufferSize);
+		memcpy_s(WaitingData.Buffer.get(), WaitingData.BufferSize, Buffer, Length);
+		WaitingData.Length = Length;
+		WaitingData.MessageIndex = std::move(MessageIndex);
+		WaitingData.FinalizeTime = GetCurrentSystemTime() + Parameter.ReceiveWaiting;
+
+	//Register to waiting list, response is dropped when list is full and earlier response of the same request is still taken.
+		std::unique_lock<std::mutex> CaptureWaitingMutex(CaptureWaitingLock);
+		if (CaptureWaitingList.size() >= CAPTURE_WAITING_MAXNUM)
 		{
-			if (PortItem.ClearPortTime > 0 && //Do not scan expired data.
-				((Protocol == AF_INET6 && SocketDataItem.AddrLen == sizeof(sockaddr_in6) && SocketDataItem.SockAddr.ss_family == AF_INET6 && 
-				Port == reinterpret_cast<const sockaddr_in6 *>(&SocketDataItem.SockAddr)->sin6_port) || //IPv6
-				(Protocol == AF_INET && SocketDataItem.AddrLen == sizeof(sockaddr_in) && SocketDataItem.SockAddr.ss_family == AF_INET && 
-				Port == reinterpret_cast<const sockaddr_in *>(&SocketDataItem.SockAddr)->sin_port))) //IPv4
-			{
-			//Waiting ends.
-				if (PortItem.ReceiveIndex == ReceiveIndex)
-				{
-				//EDNS options check
-/* EDNS Label operations are different between DNS servers.
-				//EDNS Label options are exist in input packet rather than output packet.
-					if (!IsNeedTruncated && Parameter.PacketCheck_DNS && 
-						PortItem.EDNS_Length >= sizeof(edns_header) && PortItem.EDNS_Length - sizeof(edns_header) != 0 && 
-						EDNS_Length_Output == 0)
-							return false;
-*/
+			CaptureWaitingMutex.unlock();
+			Statistics_AddCounter(STATISTICS_COUNTER_CAPTURE_WAITING_DROP);
+			OutputPacketList.ClearExpired();
 
-				//Copy socket data from global list.
-					SocketData_Input = PortItem.SocketData_Input;
-					DomainString_Original = PortItem.DomainString_Original;
-					DomainString_Request = PortItem.DomainString_Request;
-					SystemProtocol = PortItem.Protocol_Network;
-					PortItem.ClearPortTime = 0;
-
-				//Clear item in global list.
-					memset(&PortItem.SocketData_Input, 0, sizeof(PortItem.SocketData_Input));
-					PortItem.SocketData_Input.Socket = INVALID_SOCKET;
-					goto ClearListData;
-				}
-			//Drop all packets which in the top.
-				else {
-					return false;
-				}
-			}
+			return false;
 		}
+		WaitingData.ReceiveIndex = ++PortItem->ReceiveIndex;
+		CaptureWaitingList.push_back(std::move(WaitingData));
+		CaptureWaitingMutex.unlock();
+		CaptureWaitingCondition.notify_one();
+		OutputPacketList.ClearExpired();
+
+		return true;
 	}
 
-//Jump here to stop loop and clear expired data.
-ClearListData:
-	while (!OutputPacketList.empty() && OutputPacketList.front().ClearPortTime <= GetCurrentSystemTime())
-	{
-	//Mark timeout.
-		if (OutputPacketList.front().ClearPortTime > 0)
-		{
-			if (OutputPacketList.front().Protocol_Network == AF_INET6)
-			{
-				if (OutputPacketList.front().Protocol_Transport == IPPROTO_TCP)
-					++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV6);
-				else if (OutputPacketList.front().Protocol_Transport == IPPROTO_UDP)
-					++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV6);
-			}
-			else if (OutputPacketList.front().Protocol_Network == AF_INET)
-			{
-				if (OutputPacketList.front().Protocol_Transport == IPPROTO_TCP)
-					++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV4);
-				else if (OutputPacketList.front().Protocol_Transport == IPPROTO_UDP)
-					++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV4);
-			}
-		}
+//Send response now.
+	return Capture_TakePortToSend(PortItem, const_cast<uint8_t *>(Buffer), Length, BufferSize, &MessageIndex);
+}
+
+//Take matched socket information and send response to system sockets process
+bool Capture_TakePortToSend(
+	const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem, 
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const size_t BufferSize, 
+	const DNS_MESSAGE_INDEX * const MessageIndex)
+{
+//Initialization
+	SOCKET_DATA SocketData_Input;
+	memset(&SocketData_Input, 0, sizeof(SocketData_Input));
+	SocketData_Input.Socket = INVALID_SOCKET;
+	uint8_t DomainString_Original[DOMAIN_MAXSIZE], DomainString_Request[DOMAIN_MAXSIZE];
+	memset(DomainString_Original, 0, sizeof(DomainString_Original));
+	memset(DomainString_Request, 0, sizeof(DomainString_Request));
+	uint16_t SystemProtocol = 0;
 
-		OutputPacketList.pop_front();
+//Take item from global list and copy socket data, upstream latency is recorded from the time when request was sent.
+	if (OutputPacketList.Take(PortItem))
+	{
+		Statistics_AddLatency(static_cast<const uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - PortItem->SendTime).count()));
+		SocketData_Input = PortItem->SocketData_Input;
+		memcpy_s(DomainString_Original, DOMAIN_MAXSIZE, PortItem->DomainString_Original, DOMAIN_MAXSIZE);
+		memcpy_s(DomainString_Request, DOMAIN_MAXSIZE, PortItem->DomainString_Request, DOMAIN_MAXSIZE);
+		SystemProtocol = PortItem->Protocol_Network;
 	}
 
-	OutputPacketListMutex.unlock();
+//Clear expired data.
+	OutputPacketList.ClearExpired();
 
 //Drop resopnses which are not in OutputPacketList.
 	if (SocketData_Input.AddrLen == 0 || SocketData_Input.SockAddr.ss_family == 0 || SystemProtocol == 0 || 
@@ -1521,10 +2201,10 @@ ClearListData:
 
 //Mark domain cache.
 	if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-		MarkDomainCache(Buffer, Length, &SocketData_Input);
+		MarkDomainCache(Buffer, Length, MessageIndex, &SocketData_Input);
 
 //Send to requester.
-	SendToRequester(SystemProtocol, const_cast<uint8_t *>(Buffer), Length, BufferSize, &DomainString_Original, &DomainString_Request, SocketData_Input);
+	SendToRequester(SystemProtocol, Buffer, Length, BufferSize, DomainString_Original, DomainString_Request, SocketData_Input);
 	if (SystemProtocol == IPPROTO_TCP)
 	{
 		return true;
@@ -1542,4 +2222,45 @@ ClearListData:
 	SocketSetting(SocketData_Input.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 	return true;
 }
+
+//Monitor of responses which are parked in receive waiting window
+//Capture threads never sleep in waiting window, responses are finalized here when their windows are closed.
+void Capture_ReceiveWaitingMonitor(
+	void)
+{
+	std::unique_lock<std::mutex> CaptureWaitingMutex(CaptureWaitingLock);
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Waiting window is the same for all responses, so the front of list is always the earliest one.
+		if (CaptureWaitingList.empty())
+		{
+			CaptureWaitingCondition.wait_for(CaptureWaitingMutex, std::chrono::milliseconds(STANDARD_TIMEOUT));
+			continue;
+		}
+		else {
+			const auto CurrentTime = GetCurrentSystemTime();
+			if (CaptureWaitingList.front().FinalizeTime > CurrentTime)
+			{
+				CaptureWaitingCondition.wait_for(CaptureWaitingMutex, std::chrono::milliseconds(CaptureWaitingList.front().FinalizeTime - CurrentTime));
+				continue;
+			}
+		}
+
+	//Take response from list.
+		auto WaitingData = std::move(CaptureWaitingList.front());
+		CaptureWaitingList.pop_front();
+		CaptureWaitingMutex.unlock();
+
+	//Drop response if a later one has been received in its waiting window.
+		if (WaitingData.PortItem->ReceiveIndex == WaitingData.ReceiveIndex)
+			Capture_TakePortToSend(WaitingData.PortItem, WaitingData.Buffer.get(), WaitingData.Length, WaitingData.BufferSize, &WaitingData.MessageIndex);
+
+		CaptureWaitingMutex.lock();
+	}
+
+//Loop terminated
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Capture module Monitor terminated", 0, nullptr, 0);
+	return;
+}
 #endif
@@ -31,6 +31,72 @@ typedef struct _capture_handler_param_
 	size_t        BufferSize;
 }Capture_CallbackHandlerParam, CAPTURE_HANDLER_PARAM;
 
+//Statistics of offline capture replay, time is in nanoseconds.
+typedef struct _capture_replay_statistics_
+{
+	uint64_t      FrameNum;
+	uint64_t      NetworkLayerNum;
+	uint64_t      AcceptedNum;
+	uint64_t      MatchNum;
+	uint64_t      MatchedNum;
+	uint64_t      RegisterNum;
+	uint64_t      TotalTime;
+	uint64_t      NetworkLayerTime;
+	uint64_t      MatchTime;
+	uint64_t      RegisterTime;
+}CaptureReplayStatistics, CAPTURE_REPLAY_STATISTICS;
+
+//Response which is parked in receive waiting window
+typedef struct _capture_waiting_data_
+{
+	std::shared_ptr<OUTPUT_PACKET_TABLE>   PortItem;
+	std::unique_ptr<uint8_t[]>             Buffer;
+	size_t                                 Length;
+	size_t                                 BufferSize;
+	DNS_MESSAGE_INDEX                      MessageIndex;
+	size_t                                 ReceiveIndex;
+	uint64_t                               FinalizeTime;
+}CaptureWaitingData, CAPTURE_WAITING_DATA;
+
+//Datagram in fragment reassembly table
+typedef struct _capture_fragment_data_
+{
+	uint16_t                                 Protocol;
+	uint8_t                                  UpperProtocol;
+	uint32_t                                 ID;
+	in6_addr                                 Source;
+	in6_addr                                 Destination;
+	std::unique_ptr<uint8_t[]>               Buffer;
+	size_t                                   HeaderLength;
+	size_t                                   NextHeaderOffset;
+	size_t                                   ReceivedLength;
+	size_t                                   TotalLength;
+	std::vector<std::pair<size_t, size_t>>   RangeList;
+	uint64_t                                 ClearTime;
+}CaptureFragmentData, CAPTURE_FRAGMENT_DATA;
+
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//Capture socket of device in capture event loop
+typedef struct _capture_event_device_
+{
+	CAPTURE_DEVICE_TABLE                                  DeviceTable;
+	CAPTURE_HANDLER_PARAM                                 ParamList;
+	event                                                 *ReadEvent;
+	bool                                                  IsClosed;
+}CaptureEventDevice, CAPTURE_EVENT_DEVICE;
+
+//Capture event loop, devices are registered and removed by timer event in its own thread.
+typedef struct _capture_event_loop_
+{
+	event_base                                            *EventBase;
+	event                                                 *TimerEvent;
+	timeval                                               IntervalTimeout;
+	std::unique_ptr<uint8_t[]>                            Buffer;
+	std::list<std::unique_ptr<CAPTURE_EVENT_DEVICE>>      DeviceList;
+	std::list<std::unique_ptr<CAPTURE_EVENT_DEVICE>>      PendingList;
+}CaptureEventLoop, CAPTURE_EVENT_LOOP;
+#endif
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
@@ -38,28 +104,84 @@ extern ALTERNATE_SWAP_TABLE AlternateSwapList;
 #if defined(ENABLE_LIBSODIUM)
 extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter;
 #endif
-extern std::deque<OUTPUT_PACKET_TABLE> OutputPacketList;
-extern std::mutex CaptureLock, OutputPacketListLock;
+extern OUTPUT_PACKET_PORT_TABLE OutputPacketList;
+extern std::mutex CaptureLock;
 
 //Local variables
 std::string PcapFilterRules;
 std::list<std::string> PcapRunningList;
+std::deque<CAPTURE_WAITING_DATA> CaptureWaitingList;
+std::mutex CaptureWaitingLock;
+std::condition_variable CaptureWaitingCondition;
+CAPTURE_REPLAY_STATISTICS *CaptureReplayCounter = nullptr;
+std::list<CAPTURE_FRAGMENT_DATA> CaptureFragmentList;
+std::mutex CaptureFragmentLock;
+std::mutex CaptureStatusLock;
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+std::array<CAPTURE_EVENT_LOOP, PCAP_CAPTURE_LOOP_MAXNUM> CaptureEventLoopList;
+size_t CaptureEventLoopNum = 0, CaptureEventLoopIndex = 0;
+#endif
 
 //Functions
 bool Capture_FilterRulesInit(
 	std::string &FilterRules);
+#if defined(PLATFORM_WIN)
 bool Capture_MainProcess(
-	const pcap_if * const DriveInterface, 
-	const bool IsCaptureList);
+	const std::string DeviceName);
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+bool Capture_EventLoopInit(
+	void);
+bool Capture_RegisterDevice(
+	const char * const DeviceName);
+void Capture_EventLoopProcess(
+	const size_t LoopIndex);
+void TimerCallback_Capture(
+	evutil_socket_t Socket, 
+	short EventType, 
+	void *Argument);
+void ReadCallback_Capture(
+	evutil_socket_t Socket, 
+	short EventType, 
+	void *Argument);
+#endif
+void Capture_RemoveRunningList(
+	const std::string &DeviceName);
+bool Capture_OpenDevice(
+	const char * const DeviceName, 
+	CAPTURE_DEVICE_TABLE &DeviceTable, 
+	uint8_t * const Buffer, 
+	const bool IsOfflineFile);
+#if (defined(PLATFORM_LINUX) && defined(PACKET_FANOUT))
+bool Capture_JoinFanout(
+	pcap_t * const DeviceHandle, 
+	const uint16_t FanoutGroup);
+#endif
 void Capture_CallbackHandler(
 	uint8_t * const ProcParameter, 
 	const pcap_pkthdr * const PacketHeader, 
 	const uint8_t * const PacketData);
+void Capture_ReplayCallbackHandler(
+	uint8_t * const ProcParameter, 
+	const pcap_pkthdr * const PacketHeader, 
+	const uint8_t * const PacketData);
+void Capture_ReplayRegisterQuery(
+	const uint16_t Protocol, 
+	const uint8_t * const Buffer, 
+	const size_t Length);
+uint64_t Capture_ReplayTimeDifference(
+	const std::chrono::steady_clock::time_point &BeginTime);
 bool Capture_AnalyzeNetworkLayer(
 	const uint16_t Protocol, 
 	const uint8_t * const Buffer, 
 	const size_t Length, 
-	const size_t BufferSize);
+	uint8_t * const DNS_Buffer, 
+	const size_t DNS_BufferSize);
+bool Capture_ReassembleFragment(
+	const uint16_t Protocol, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	std::unique_ptr<uint8_t[]> &PacketBuffer, 
+	size_t &PacketLength);
 ssize_t Capture_AnalyzeFragment(
 	const uint16_t Protocol, 
 	const uint8_t * const Buffer, 
@@ -78,7 +200,7 @@ bool Capture_AnalyzeDNS(
 bool Capture_PacketStatusCheck(
 	const uint16_t Protocol, 
 	const uint8_t * const Buffer, 
-	const size_t DNS_DataOffset, 
+	const uint8_t * const DNS_Buffer, 
 	const size_t DNS_DataLength, 
 	const size_t EDNS_Offset, 
 	const size_t EDNS_Length, 
@@ -89,9 +211,18 @@ bool Capture_MatchPortToSend(
 	const uint8_t * const Buffer, 
 	const size_t Length, 
 	const size_t BufferSize, 
-	const uint16_t Port
+	const uint16_t Port, 
+	DNS_MESSAGE_INDEX &MessageIndex
 //	const bool IsNeedTruncated, 
 //	const size_t EDNS_Length_Output
 );
+bool Capture_TakePortToSend(
+	const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem, 
+	uint8_t * const Buffer, 
+	const size_t Length, 
+	const size_t BufferSize, 
+	const DNS_MESSAGE_INDEX * const MessageIndex);
+void Capture_ReceiveWaitingMonitor(
+	void);
 #endif
 #endif
@@ -177,6 +177,24 @@ bool ReadParameterData_Proxy(
 	const size_t Line, 
 	CONFIGURATION_TABLE * const ParameterPointer, 
 	bool &IsFoundParameter);
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+bool ReadParameterData_DNS_TLS(
+	const std::string &Data, 
+	const size_t FileIndex, 
+	const bool IsFirstRead, 
+	const size_t Line, 
+//	CONFIGURATION_TABLE * const ParameterPointer, 
+	bool &IsFoundParameter);
+bool ReadParameterData_DNS_HTTPS(
+	const std::string &Data, 
+	const size_t FileIndex, 
+	const bool IsFirstRead, 
+	const size_t Line, 
+//	CONFIGURATION_TABLE * const ParameterPointer, 
+	bool &IsFoundParameter);
+#endif
+#endif
 #if defined(ENABLE_LIBSODIUM)
 bool ReadParameterData_DNSCurve_Main(
 	const std::string &Data, 
@@ -269,6 +269,34 @@ bool DNSCurve_PrecomputationKeySetting(
 		memset(Client_PublicKey, 0, crypto_box_PUBLICKEYBYTES);
 	}
 
+//Take a pooled key pair which is precomputed with the same server fingerprint, each key pair is only used once.
+	std::unique_lock<std::mutex> KeyPairPoolMutex(DNSCurveKeyPairPoolLock);
+	for (auto &PoolItem:DNSCurveKeyPairPoolList)
+	{
+		if (PoolItem.ItemNum > 0 && PoolItem.KeyBuffer.Buffer != nullptr && 
+			sodium_memcmp(PoolItem.ServerFingerprint, ServerFingerprint, crypto_box_PUBLICKEYBYTES) == 0)
+		{
+			--PoolItem.ItemNum;
+			const auto KeyPairItem = PoolItem.KeyBuffer.Buffer + PoolItem.ItemNum * DNSCRYPT_KEYPAIR_POOL_ITEM_LEN;
+			memcpy_s(Client_PublicKey, crypto_box_PUBLICKEYBYTES, KeyPairItem, crypto_box_PUBLICKEYBYTES);
+			memcpy_s(PrecomputationKey, crypto_box_BEFORENMBYTES, KeyPairItem + crypto_box_PUBLICKEYBYTES, crypto_box_BEFORENMBYTES);
+			sodium_memzero(KeyPairItem, DNSCRYPT_KEYPAIR_POOL_ITEM_LEN);
+
+		//Wake up monitor when pool is half empty.
+			if (PoolItem.ItemNum <= DNSCRYPT_KEYPAIR_POOL_SIZE / 2U)
+			{
+				KeyPairPoolMutex.unlock();
+				DNSCurveKeyPairPoolCondition.notify_one();
+			}
+
+			return true;
+		}
+	}
+
+//Pool is empty or server fingerprint is changed, make it in place.
+	KeyPairPoolMutex.unlock();
+	DNSCurveKeyPairPoolCondition.notify_one();
+
 //Make a client ephemeral key pair and a precomputation key.
 	DNSCURVE_HEAP_BUFFER_TABLE<uint8_t> Client_SecretKey(crypto_box_SECRETKEYBYTES);
 	if (crypto_box_keypair(
@@ -283,6 +311,90 @@ bool DNSCurve_PrecomputationKeySetting(
 	return true;
 }
 
+//DNSCurve client ephemeral key pair pool monitor
+void DNSCurve_KeyPairPoolMonitor(
+	void)
+{
+//Initialization
+	DNSCURVE_HEAP_BUFFER_TABLE<uint8_t> Client_SecretKey(crypto_box_SECRETKEYBYTES), KeyPairItem(DNSCRYPT_KEYPAIR_POOL_ITEM_LEN);
+	uint8_t ServerFingerprint[crypto_box_PUBLICKEYBYTES]{0};
+	DNSCURVE_SERVER_DATA *PacketTarget = nullptr;
+	std::unique_lock<std::mutex> KeyPairPoolMutex(DNSCurveKeyPairPoolLock, std::defer_lock);
+
+//Start monitor.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		for (size_t Index = 0;Index < DNSCurveKeyPairPoolList.size();++Index)
+		{
+		//Server check
+			if (!DNSCurve_PacketTargetSetting(static_cast<const DNSCURVE_SERVER_TYPE>(Index + 1U), &PacketTarget) || 
+				PacketTarget->AddressData.Storage.ss_family == 0 || PacketTarget->ServerFingerprint == nullptr)
+					continue;
+
+		//Server fingerprint check
+			memcpy_s(ServerFingerprint, crypto_box_PUBLICKEYBYTES, PacketTarget->ServerFingerprint, crypto_box_PUBLICKEYBYTES);
+			if (CheckEmptyBuffer(ServerFingerprint, crypto_box_PUBLICKEYBYTES))
+				continue;
+
+		//Reset pool when server fingerprint is changed, all key pairs which are precomputed with old fingerprint are invalid.
+			auto &PoolItem = DNSCurveKeyPairPoolList.at(Index);
+			KeyPairPoolMutex.lock();
+			if (PoolItem.KeyBuffer.Buffer == nullptr)
+			{
+				DNSCURVE_HEAP_BUFFER_TABLE<uint8_t> KeyBufferTemp(DNSCRYPT_KEYPAIR_POOL_SIZE, DNSCRYPT_KEYPAIR_POOL_ITEM_LEN);
+				KeyBufferTemp.Swap(PoolItem.KeyBuffer);
+			}
+			if (memcmp(PoolItem.ServerFingerprint, ServerFingerprint, crypto_box_PUBLICKEYBYTES) != 0)
+			{
+				sodium_memzero(PoolItem.KeyBuffer.Buffer, PoolItem.KeyBuffer.BufferSize);
+				memcpy_s(PoolItem.ServerFingerprint, crypto_box_PUBLICKEYBYTES, ServerFingerprint, crypto_box_PUBLICKEYBYTES);
+				PoolItem.ItemNum = 0;
+			}
+
+		//Refill pool, key pairs are made without locking.
+			while (PoolItem.ItemNum < DNSCRYPT_KEYPAIR_POOL_SIZE)
+			{
+				KeyPairPoolMutex.unlock();
+				if (crypto_box_keypair(
+						KeyPairItem.Buffer, 
+						Client_SecretKey.Buffer) != 0 || 
+					crypto_box_beforenm(
+						KeyPairItem.Buffer + crypto_box_PUBLICKEYBYTES, 
+						ServerFingerprint, 
+						Client_SecretKey.Buffer) != 0)
+				{
+					KeyPairPoolMutex.lock();
+					break;
+				}
+				else {
+					sodium_memzero(Client_SecretKey.Buffer, Client_SecretKey.BufferSize);
+				}
+
+			//Pool may be filled by others during making.
+				KeyPairPoolMutex.lock();
+				if (PoolItem.ItemNum >= DNSCRYPT_KEYPAIR_POOL_SIZE)
+					break;
+				memcpy_s(PoolItem.KeyBuffer.Buffer + PoolItem.ItemNum * DNSCRYPT_KEYPAIR_POOL_ITEM_LEN, DNSCRYPT_KEYPAIR_POOL_ITEM_LEN, KeyPairItem.Buffer, DNSCRYPT_KEYPAIR_POOL_ITEM_LEN);
+				++PoolItem.ItemNum;
+			}
+
+			KeyPairPoolMutex.unlock();
+			sodium_memzero(Client_SecretKey.Buffer, Client_SecretKey.BufferSize);
+			sodium_memzero(KeyPairItem.Buffer, KeyPairItem.BufferSize);
+		}
+
+	//Wait for taking or next checking.
+		KeyPairPoolMutex.lock();
+		DNSCurveKeyPairPoolCondition.wait_for(KeyPairPoolMutex, std::chrono::milliseconds(DNSCURVE_KEYPAIR_POOL_REFILL_TIME));
+		KeyPairPoolMutex.unlock();
+	}
+
+//Monitor loop terminated
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"DNSCurve Key Pair Pool module Monitor terminated", 0, nullptr, 0);
+	return;
+}
+
 //DNSCurve packet precomputation
 void DNSCurve_SocketPrecomputation(
 	const uint16_t Protocol, 
@@ -751,7 +863,8 @@ ssize_t DNSCurve_PacketDecryption(
 	const uint8_t * const PrecomputationKey, 
 	uint8_t * const OriginalRecv, 
 	const size_t RecvSize, 
-	const ssize_t Length)
+	const ssize_t Length, 
+	DNS_MESSAGE_INDEX * const MessageIndex)
 {
 	auto DataLength = Length;
 
@@ -793,7 +906,8 @@ ssize_t DNSCurve_PacketDecryption(
 		DataLength, 
 		RecvSize, 
 		nullptr, 
-		nullptr);
+		nullptr, 
+		MessageIndex);
 	if (DataLength < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
 		return EXIT_FAILURE;
 
@@ -895,4 +1009,128 @@ bool DNSCruve_GetSignatureData(
 
 	return false;
 }
+
+//DNSCurve load signature data from certificate cache
+bool DNSCurve_LoadCertificateCache(
+	const DNSCURVE_SERVER_TYPE ServerType)
+{
+//Server type check
+	if (ServerType == DNSCURVE_SERVER_TYPE::NONE)
+		return false;
+
+//Read cache file at first time.
+	std::array<uint8_t, DNSCURVE_CERTIFICATE_CACHE_ITEM_LEN> CertificateItem{};
+	std::unique_lock<std::mutex> CertificateCacheMutex(DNSCurveCertificateCacheLock);
+	if (!IsDNSCurveCertificateCacheRead)
+	{
+		IsDNSCurveCertificateCacheRead = true;
+		if (!DNSCurve_ReadCertificateCacheFile())
+		{
+			for (auto &CacheItem:DNSCurveCertificateCacheList)
+				CacheItem.fill(0);
+		}
+	}
+
+	CertificateItem = DNSCurveCertificateCacheList.at(static_cast<const size_t>(ServerType) - 1U);
+	CertificateCacheMutex.unlock();
+
+//Cached certificate is verified again with server public key and its available time, same as certificate from server.
+	if (CheckEmptyBuffer(CertificateItem.data(), CertificateItem.size()))
+		return false;
+	else 
+		return DNSCruve_GetSignatureData(CertificateItem.data(), ServerType);
+}
+
+//DNSCurve store signature data to certificate cache
+void DNSCurve_StoreCertificateCache(
+	const uint8_t * const Buffer, 
+	const DNSCURVE_SERVER_TYPE ServerType)
+{
+//Server type check
+	if (ServerType == DNSCURVE_SERVER_TYPE::NONE)
+		return;
+
+//Rewrite cache file only when certificate is changed.
+	std::lock_guard<std::mutex> CertificateCacheMutex(DNSCurveCertificateCacheLock);
+	auto &CacheItem = DNSCurveCertificateCacheList.at(static_cast<const size_t>(ServerType) - 1U);
+	if (memcmp(CacheItem.data(), Buffer, CacheItem.size()) != 0)
+	{
+		memcpy_s(CacheItem.data(), CacheItem.size(), Buffer, CacheItem.size());
+		DNSCurve_WriteCertificateCacheFile();
+	}
+
+	return;
+}
+
+//DNSCurve read certificate cache file
+bool DNSCurve_ReadCertificateCacheFile(
+	void)
+{
+//Open cache file.
+	FILE *FileHandle = nullptr;
+#if defined(PLATFORM_WIN)
+	std::wstring FileName(GlobalRunningStatus.Path_Global->front());
+	FileName.append(DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_WCS);
+	if (_wfopen_s(&FileHandle, FileName.c_str(), L"rb") != 0 || FileHandle == nullptr)
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	std::string FileName(GlobalRunningStatus.Path_Global_MBS->front());
+	FileName.append(DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_MBS);
+	FileHandle = fopen(FileName.c_str(), "rb");
+	if (FileHandle == nullptr)
+#endif
+		return false;
+
+//Read all items, cache file is only available when its size is the same as all items.
+	auto IsReadError = false;
+	for (auto &CacheItem:DNSCurveCertificateCacheList)
+	{
+		if (fread_s(CacheItem.data(), CacheItem.size(), sizeof(uint8_t), CacheItem.size(), FileHandle) != CacheItem.size())
+		{
+			IsReadError = true;
+			break;
+		}
+	}
+	if (!IsReadError && fgetc(FileHandle) != EOF)
+		IsReadError = true;
+
+	fclose(FileHandle);
+	return !IsReadError;
+}
+
+//DNSCurve write certificate cache file
+bool DNSCurve_WriteCertificateCacheFile(
+	void)
+{
+//Open cache file.
+	FILE *FileHandle = nullptr;
+#if defined(PLATFORM_WIN)
+	std::wstring FileName(GlobalRunningStatus.Path_Global->front());
+	FileName.append(DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_WCS);
+	if (_wfopen_s(&FileHandle, FileName.c_str(), L"wb") != 0 || FileHandle == nullptr)
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	std::string FileName(GlobalRunningStatus.Path_Global_MBS->front());
+	FileName.append(DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_MBS);
+	FileHandle = fopen(FileName.c_str(), "wb");
+	if (FileHandle == nullptr)
+#endif
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::DNSCURVE, L"DNSCurve certificate cache file writing error", 0, nullptr, 0);
+		return false;
+	}
+
+//Write all items.
+	for (const auto &CacheItem:DNSCurveCertificateCacheList)
+	{
+		if (fwrite(CacheItem.data(), sizeof(uint8_t), CacheItem.size(), FileHandle) != CacheItem.size())
+		{
+			fclose(FileHandle);
+			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::DNSCURVE, L"DNSCurve certificate cache file writing error", 0, nullptr, 0);
+
+			return false;
+		}
+	}
+
+	fclose(FileHandle);
+	return true;
+}
 #endif
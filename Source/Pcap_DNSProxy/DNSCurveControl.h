@@ -23,6 +23,15 @@
 #include "Include.h"
 
 #if defined(ENABLE_LIBSODIUM)
+//Structure definitions
+//Client ephemeral key pairs which are precomputed with server fingerprint, each item is public key and precomputation key.
+typedef struct _dnscurve_keypair_pool_
+{
+	uint8_t                                  ServerFingerprint[crypto_box_PUBLICKEYBYTES];
+	DNSCURVE_HEAP_BUFFER_TABLE<uint8_t>      KeyBuffer;
+	size_t                                   ItemNum;
+}DNSCurveKeyPairPool, DNSCURVE_KEYPAIR_POOL;
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
@@ -31,16 +40,23 @@ extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter;
 extern std::deque<SOCKET_REGISTER_DATA> SocketRegisterList;
 extern std::mutex SocketRegisterLock;
 
+//Local variables
+std::array<DNSCURVE_KEYPAIR_POOL, DNSCURVE_SERVER_NUM> DNSCurveKeyPairPoolList;
+std::mutex DNSCurveKeyPairPoolLock;
+std::condition_variable DNSCurveKeyPairPoolCondition;
+std::array<std::array<uint8_t, DNSCURVE_CERTIFICATE_CACHE_ITEM_LEN>, DNSCURVE_SERVER_NUM> DNSCurveCertificateCacheList;
+bool IsDNSCurveCertificateCacheRead = false;
+std::mutex DNSCurveCertificateCacheLock;
+
 //Functions
 size_t DNSCurve_PaddingData(
 	const bool IsSetPadding, 
 	uint8_t * const Buffer, 
 	const size_t Length, 
 	const size_t BufferSize);
-uint16_t DNSCurve_SelectTargetSocket(
-	const uint16_t Protocol, 
-	const uint16_t QueryType, 
-	const SOCKET_DATA &LocalSocketData, 
-	bool ** const IsAlternate);
+bool DNSCurve_ReadCertificateCacheFile(
+	void);
+bool DNSCurve_WriteCertificateCacheFile(
+	void);
 #endif
 #endif
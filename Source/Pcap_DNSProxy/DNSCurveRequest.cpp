@@ -46,6 +46,13 @@ Using TCP protocol:
 void DNSCurveInit(
 	void)
 {
+//Client ephemeral key pair pool
+	if (DNSCurveParameter.IsEncryption && DNSCurveParameter.IsClientEphemeralKey)
+	{
+		std::thread Thread_DNSCurve_KeyPairPool(std::bind(DNSCurve_KeyPairPoolMonitor));
+		Thread_DNSCurve_KeyPairPool.detach();
+	}
+
 //DNSCurve signature request TCP Mode
 	if (DNSCurveParameter.DNSCurveProtocol_Transport == REQUEST_MODE_TRANSPORT::FORCE_TCP || DNSCurveParameter.DNSCurveProtocol_Transport == REQUEST_MODE_TRANSPORT::TCP)
 	{
@@ -221,6 +228,9 @@ bool DNSCurve_SignatureRequest_TCP(
 		return false;
 	}
 
+//Load verified certificate from cache to serve requests before the first signature request is finished.
+	DNSCurve_LoadCertificateCache(ServerType);
+
 //Send request.
 	while (!GlobalRunningStatus.IsNeedExit)
 	{
@@ -274,6 +284,9 @@ bool DNSCurve_SignatureRequest_TCP(
 				CheckEmptyBuffer(PacketTarget->ServerFingerprint, crypto_box_PUBLICKEYBYTES) || 
 				CheckEmptyBuffer(PacketTarget->SendMagicNumber, DNSCURVE_MAGIC_QUERY_LEN))
 					goto JumpTo_Restart;
+
+		//Store certificate to cache.
+			DNSCurve_StoreCertificateCache(RecvBuffer.get() + DNS_PACKET_RR_LOCATE(RecvBuffer.get(), Parameter.LargeBufferSize), ServerType);
 		}
 
 	//Wait for sending again.
@@ -379,6 +392,9 @@ bool DNSCurve_SignatureRequest_UDP(
 		return false;
 	}
 
+//Load verified certificate from cache to serve requests before the first signature request is finished.
+	DNSCurve_LoadCertificateCache(ServerType);
+
 //Send request.
 	while (!GlobalRunningStatus.IsNeedExit)
 	{
@@ -432,6 +448,9 @@ bool DNSCurve_SignatureRequest_UDP(
 				CheckEmptyBuffer(PacketTarget->ServerFingerprint, crypto_box_PUBLICKEYBYTES) || 
 				CheckEmptyBuffer(PacketTarget->SendMagicNumber, DNSCURVE_MAGIC_QUERY_LEN))
 					goto JumpTo_Restart;
+
+		//Store certificate to cache.
+			DNSCurve_StoreCertificateCache(RecvBuffer.get() + DNS_PACKET_RR_LOCATE(RecvBuffer.get(), PACKET_NORMAL_MAXSIZE), ServerType);
 		}
 
 	//Wait for sending again.
@@ -867,4 +886,441 @@ size_t DNSCurve_UDP_RequestMultiple(
 
 	return RecvLen;
 }
+
+//DNSCurve check keys of server
+bool DNSCurve_CheckServerKeys(
+	const DNSCURVE_SERVER_DATA * const PacketTarget)
+{
+	if (PacketTarget->AddressData.Storage.ss_family == 0 || 
+		(!DNSCurveParameter.IsClientEphemeralKey && sodium_is_zero(PacketTarget->PrecomputationKey, crypto_box_BEFORENMBYTES) != 0) || 
+		(DNSCurveParameter.IsClientEphemeralKey && CheckEmptyBuffer(PacketTarget->ServerFingerprint, crypto_box_PUBLICKEYBYTES)) || 
+		CheckEmptyBuffer(PacketTarget->SendMagicNumber, DNSCURVE_MAGIC_QUERY_LEN))
+			return false;
+
+	return true;
+}
+
+//DNSCurve select target server of persistent transport
+DNSCURVE_SERVER_DATA *DNSCurve_SelectTransportTarget(
+	const uint16_t Protocol, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData, 
+	DNSCURVE_SERVER_TYPE &ServerType, 
+	size_t ** const AlternateTimeoutTimes)
+{
+//Select network protocol.
+	bool *IsAlternate = nullptr;
+	const auto NetworkSpecific = DNSCurve_SelectTargetSocket(Protocol, QueryType, LocalSocketData, &IsAlternate);
+	if (IsAlternate == nullptr)
+		return nullptr;
+
+//IPv6
+	if (NetworkSpecific == AF_INET6)
+	{
+		if (Protocol == IPPROTO_TCP)
+			*AlternateTimeoutTimes = &AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_DNSCURVE_TCP_IPV6);
+		else 
+			*AlternateTimeoutTimes = &AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_DNSCURVE_UDP_IPV6);
+
+	//Alternate server is also used when keys of Main server are not ready.
+		if (DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Alternate_IPv6) && 
+			(*IsAlternate || !DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Main_IPv6)))
+		{
+			ServerType = DNSCURVE_SERVER_TYPE::ALTERNATE_IPV6;
+			return &DNSCurveParameter.DNSCurve_Target_Server_Alternate_IPv6;
+		}
+		else if (DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Main_IPv6))
+		{
+			ServerType = DNSCURVE_SERVER_TYPE::MAIN_IPV6;
+			return &DNSCurveParameter.DNSCurve_Target_Server_Main_IPv6;
+		}
+	}
+//IPv4
+	else if (NetworkSpecific == AF_INET)
+	{
+		if (Protocol == IPPROTO_TCP)
+			*AlternateTimeoutTimes = &AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_DNSCURVE_TCP_IPV4);
+		else 
+			*AlternateTimeoutTimes = &AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_DNSCURVE_UDP_IPV4);
+
+	//Alternate server is also used when keys of Main server are not ready.
+		if (DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Alternate_IPv4) && 
+			(*IsAlternate || !DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Main_IPv4)))
+		{
+			ServerType = DNSCURVE_SERVER_TYPE::ALTERNATE_IPV4;
+			return &DNSCurveParameter.DNSCurve_Target_Server_Alternate_IPv4;
+		}
+		else if (DNSCurve_CheckServerKeys(&DNSCurveParameter.DNSCurve_Target_Server_Main_IPv4))
+		{
+			ServerType = DNSCURVE_SERVER_TYPE::MAIN_IPV4;
+			return &DNSCurveParameter.DNSCurve_Target_Server_Main_IPv4;
+		}
+	}
+
+	return nullptr;
+}
+
+//Transmission of DNSCurve persistent transport
+size_t DNSCurve_TransportRequest(
+	const uint16_t Protocol, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData)
+{
+//Select target server and its persistent transport.
+	DNSCURVE_SERVER_TYPE ServerType = DNSCURVE_SERVER_TYPE::NONE;
+	size_t *AlternateTimeoutTimes = nullptr;
+	const auto PacketTarget = DNSCurve_SelectTransportTarget(Protocol, QueryType, LocalSocketData, ServerType, &AlternateTimeoutTimes);
+	if (PacketTarget == nullptr || ServerType == DNSCURVE_SERVER_TYPE::NONE || (Protocol != IPPROTO_TCP && Protocol != IPPROTO_UDP))
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"DNSCurve persistent transport initialization error", 0, nullptr, 0);
+		return EXIT_FAILURE;
+	}
+	auto &Transport = (Protocol == IPPROTO_TCP ? DNSCurveTransportList_TCP : DNSCurveTransportList_UDP).at(static_cast<const size_t>(ServerType) - 1U);
+
+//Make Precomputation Key between client and server.
+	uint8_t *Client_PublicKey = nullptr, *PrecomputationKey = nullptr;
+	std::unique_ptr<uint8_t[]> Client_PublicKey_Buffer(nullptr);
+	DNSCURVE_HEAP_BUFFER_TABLE<uint8_t> PrecomputationKeyBuffer;
+	if (DNSCurveParameter.IsClientEphemeralKey)
+	{
+		auto Client_PublicKey_BufferTemp = std::make_unique<uint8_t[]>(crypto_box_PUBLICKEYBYTES);
+		std::swap(Client_PublicKey_Buffer, Client_PublicKey_BufferTemp);
+
+		DNSCURVE_HEAP_BUFFER_TABLE<uint8_t> PrecomputationKeyBufferTemp(crypto_box_BEFORENMBYTES);
+		PrecomputationKeyBufferTemp.Swap(PrecomputationKeyBuffer);
+		Client_PublicKey = Client_PublicKey_Buffer.get();
+		PrecomputationKey = PrecomputationKeyBuffer.Buffer;
+		if (!DNSCurve_PrecomputationKeySetting(PrecomputationKey, Client_PublicKey, PacketTarget->ServerFingerprint))
+			return EXIT_FAILURE;
+	}
+	else {
+		PrecomputationKey = PacketTarget->PrecomputationKey;
+		Client_PublicKey = DNSCurveParameter.Client_PublicKey;
+	}
+
+//Make encryption packet.
+	memset(OriginalRecv, 0, RecvSize);
+	const auto DataLength = DNSCurve_PacketEncryption(Protocol, PacketTarget->SendMagicNumber, Client_PublicKey, PrecomputationKey, OriginalSend, SendSize, OriginalRecv, RecvSize);
+	if (DataLength < DNS_PACKET_MINSIZE)
+		return EXIT_FAILURE;
+
+//Waiting item initialization, client nonce is located after magic number and client public key.
+	DNSCURVE_TRANSPORT_WAITING WaitingItem;
+	if (Protocol == IPPROTO_TCP)
+		memcpy_s(WaitingItem.ClientNonce, crypto_box_HALF_NONCEBYTES, OriginalRecv + sizeof(uint16_t) + DNSCURVE_MAGIC_QUERY_LEN + crypto_box_PUBLICKEYBYTES, crypto_box_HALF_NONCEBYTES);
+	else 
+		memcpy_s(WaitingItem.ClientNonce, crypto_box_HALF_NONCEBYTES, OriginalRecv + DNSCURVE_MAGIC_QUERY_LEN + crypto_box_PUBLICKEYBYTES, crypto_box_HALF_NONCEBYTES);
+	std::vector<uint8_t> SendBuffer(OriginalRecv, OriginalRecv + DataLength);
+	memset(OriginalRecv, 0, RecvSize);
+	WaitingItem.RecvBuffer = OriginalRecv;
+	WaitingItem.RecvSize = RecvSize;
+	WaitingItem.RecvLen = 0;
+	WaitingItem.IsDone = false;
+
+//Connect to server when there is no available connection.
+	std::unique_lock<std::mutex> TransportMutex(Transport.TransportLock);
+	if ((!Transport.Connection || Transport.Connection->IsClosed) && !DNSCurve_TransportConnect(Protocol, PacketTarget, Transport, TransportMutex))
+		return EXIT_FAILURE;
+	const auto Connection = Transport.Connection;
+
+//Queue request and send all queued requests.
+	Connection->WaitingList.push_back(&WaitingItem);
+	Connection->SendingQueue.push_back(std::move(SendBuffer));
+	DNSCurve_TransportFlush(Protocol, *Connection, TransportMutex);
+
+//Wait for response.
+#if defined(PLATFORM_WIN)
+	const uint64_t WaitingTime = (Protocol == IPPROTO_TCP ? DNSCurveParameter.DNSCurve_SocketTimeout_Reliable : DNSCurveParameter.DNSCurve_SocketTimeout_Unreliable);
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	const auto WaitingTime = IncreaseMillisecondTime(0, Protocol == IPPROTO_TCP ? DNSCurveParameter.DNSCurve_SocketTimeout_Reliable : DNSCurveParameter.DNSCurve_SocketTimeout_Unreliable);
+#endif
+	WaitingItem.WaitingCondition.wait_for(TransportMutex, std::chrono::milliseconds(WaitingTime), [&WaitingItem](){return WaitingItem.IsDone;});
+	if (!WaitingItem.IsDone)
+	{
+		Connection->WaitingList.remove(&WaitingItem);
+		TransportMutex.unlock();
+
+	//Mark timeout.
+		if (!Parameter.AlternateMultipleRequest && AlternateTimeoutTimes != nullptr)
+			++(*AlternateTimeoutTimes);
+
+		return EXIT_FAILURE;
+	}
+	else {
+		TransportMutex.unlock();
+	}
+
+//Decrypt response.
+	if (WaitingItem.RecvLen < DNS_PACKET_MINSIZE)
+		return EXIT_FAILURE;
+	const auto RecvLen = DNSCurve_PacketDecryption(PacketTarget->ReceiveMagicNumber, PrecomputationKey, OriginalRecv, RecvSize, WaitingItem.RecvLen, nullptr);
+	if (RecvLen < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
+		return EXIT_FAILURE;
+
+	return RecvLen;
+}
+
+//DNSCurve connect to server of persistent transport, lock of transport must be held by caller.
+bool DNSCurve_TransportConnect(
+	const uint16_t Protocol, 
+	const DNSCURVE_SERVER_DATA * const PacketTarget, 
+	DNSCURVE_TRANSPORT &Transport, 
+	std::unique_lock<std::mutex> &TransportMutex)
+{
+//Only one request connects at the same time, the others wait for it and use its connection.
+	if (Transport.IsConnecting)
+	{
+	#if defined(PLATFORM_WIN)
+		const uint64_t WaitingTime = DNSCurveParameter.DNSCurve_SocketTimeout_Reliable;
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		const auto WaitingTime = IncreaseMillisecondTime(0, DNSCurveParameter.DNSCurve_SocketTimeout_Reliable);
+	#endif
+		Transport.ConnectingCondition.wait_for(TransportMutex, std::chrono::milliseconds(WaitingTime), [&Transport](){return !Transport.IsConnecting;});
+		return Transport.Connection && !Transport.Connection->IsClosed;
+	}
+
+//Connection initialization
+	auto Connection = std::make_shared<DNSCURVE_TRANSPORT_CONNECTION>();
+	Connection->IsSending = false;
+	Connection->IsClosed = false;
+	socklen_t AddrLen = 0;
+	if (PacketTarget->AddressData.Storage.ss_family == AF_INET6)
+		AddrLen = sizeof(sockaddr_in6);
+	else if (PacketTarget->AddressData.Storage.ss_family == AF_INET)
+		AddrLen = sizeof(sockaddr_in);
+	else 
+		return false;
+
+//Connecting may be blocked until socket timeout, it is done without lock.
+	Transport.IsConnecting = true;
+	TransportMutex.unlock();
+
+//Socket initialization
+	auto IsConnected = false;
+	if (Protocol == IPPROTO_TCP)
+		Connection->Socket = socket(PacketTarget->AddressData.Storage.ss_family, SOCK_STREAM, IPPROTO_TCP);
+	else 
+		Connection->Socket = socket(PacketTarget->AddressData.Storage.ss_family, SOCK_DGRAM, IPPROTO_UDP);
+	if (!SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, true, nullptr) || 
+		(PacketTarget->AddressData.Storage.ss_family == AF_INET6 && !SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV6, true, nullptr)) || 
+		(PacketTarget->AddressData.Storage.ss_family == AF_INET && !SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV4, true, nullptr)) || 
+		(PacketTarget->AddressData.Storage.ss_family == AF_INET && Protocol == IPPROTO_UDP && !SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::DO_NOT_FRAGMENT, true, nullptr)) || 
+		(Protocol == IPPROTO_TCP && !SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::TIMEOUT, true, &DNSCurveParameter.DNSCurve_SocketTimeout_Reliable)) || 
+		(Protocol == IPPROTO_UDP && !SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::TIMEOUT, true, &DNSCurveParameter.DNSCurve_SocketTimeout_Unreliable)))
+	{
+		SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	}
+//Connect to server, socket stays in blocking mode and sending and receiving are limited by socket timeout.
+	else if (connect(Connection->Socket, reinterpret_cast<const sockaddr *>(&PacketTarget->AddressData.Storage), AddrLen) == SOCKET_ERROR)
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"DNSCurve persistent transport connecting error", WSAGetLastError(), nullptr, 0);
+		SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	}
+	else {
+		IsConnected = true;
+	}
+
+//Publish connection and wake up the others.
+	TransportMutex.lock();
+	Transport.IsConnecting = false;
+	Transport.ConnectingCondition.notify_all();
+	if (!IsConnected)
+		return false;
+
+//Start receiving monitor.
+	Transport.Connection = Connection;
+	std::thread Thread_DNSCurve_TransportReceive(std::bind(DNSCurve_TransportReceiveMonitor, Protocol, &Transport, Connection));
+	Thread_DNSCurve_TransportReceive.detach();
+
+	return true;
+}
+
+//DNSCurve send queued requests of persistent transport
+void DNSCurve_TransportFlush(
+	const uint16_t Protocol, 
+	DNSCURVE_TRANSPORT_CONNECTION &Connection, 
+	std::unique_lock<std::mutex> &TransportMutex)
+{
+//Only one thread is sending at the same time, requests which are queued during sending are taken by the same thread.
+	if (Connection.IsSending)
+		return;
+	else 
+		Connection.IsSending = true;
+
+//Take queued requests and send them outside the lock, all TCP frames in each batch are written in one call.
+	std::vector<std::vector<uint8_t>> SendingList;
+	std::vector<uint8_t> SendBuffer;
+	auto IsSendError = false;
+	while (!Connection.IsClosed && !Connection.SendingQueue.empty())
+	{
+		SendingList.clear();
+		while (!Connection.SendingQueue.empty() && SendingList.size() < DNSCURVE_TRANSPORT_BATCH_MAXNUM)
+		{
+			SendingList.push_back(std::move(Connection.SendingQueue.front()));
+			Connection.SendingQueue.pop_front();
+		}
+		TransportMutex.unlock();
+
+	//TCP
+		if (Protocol == IPPROTO_TCP)
+		{
+			SendBuffer.clear();
+			for (const auto &SendingItem:SendingList)
+				SendBuffer.insert(SendBuffer.end(), SendingItem.begin(), SendingItem.end());
+			for (size_t Index = 0;Index < SendBuffer.size();)
+			{
+				const ssize_t SendLen = send(Connection.Socket, reinterpret_cast<const char *>(SendBuffer.data() + Index), static_cast<const int>(SendBuffer.size() - Index), 0);
+				if (SendLen <= 0)
+				{
+					IsSendError = true;
+					break;
+				}
+				else {
+					Index += SendLen;
+				}
+			}
+		}
+	//UDP
+		else {
+			for (const auto &SendingItem:SendingList)
+			{
+				if (send(Connection.Socket, reinterpret_cast<const char *>(SendingItem.data()), static_cast<const int>(SendingItem.size()), 0) == SOCKET_ERROR)
+				{
+					IsSendError = true;
+					break;
+				}
+			}
+		}
+
+	//Shutdown connection and receiving monitor will close it.
+		TransportMutex.lock();
+		if (IsSendError)
+		{
+			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"DNSCurve persistent transport sending error", WSAGetLastError(), nullptr, 0);
+			Connection.IsClosed = true;
+			shutdown(Connection.Socket, SD_BOTH);
+		}
+	}
+
+	Connection.IsSending = false;
+	Connection.SendingCondition.notify_all();
+
+	return;
+}
+
+//DNSCurve receiving monitor of persistent transport
+void DNSCurve_TransportReceiveMonitor(
+	const uint16_t Protocol, 
+	DNSCURVE_TRANSPORT * const Transport, 
+	const std::shared_ptr<DNSCURVE_TRANSPORT_CONNECTION> Connection)
+{
+//Initialization
+	auto RecvBuffer = std::make_unique<uint8_t[]>(DNSCURVE_TRANSPORT_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	memset(RecvBuffer.get(), 0, DNSCURVE_TRANSPORT_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	std::unique_lock<std::mutex> TransportMutex(Transport->TransportLock, std::defer_lock);
+	size_t RecvLen = 0, DataLength = 0;
+	ssize_t ErrorCode = 0;
+
+//Receiving loop
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		const ssize_t Result = recv(Connection->Socket, reinterpret_cast<char *>(RecvBuffer.get() + RecvLen), static_cast<const int>(DNSCURVE_TRANSPORT_BUFFER_SIZE - RecvLen), 0);
+		if (Result <= 0)
+		{
+		//Receiving timeout only means there is no response now.
+			ErrorCode = WSAGetLastError();
+			TransportMutex.lock();
+			if (!Connection->IsClosed && Result == SOCKET_ERROR && 
+			#if defined(PLATFORM_WIN)
+				ErrorCode == WSAETIMEDOUT)
+			#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+				(ErrorCode == EAGAIN || ErrorCode == EWOULDBLOCK || ErrorCode == EINTR))
+			#endif
+			{
+				TransportMutex.unlock();
+				continue;
+			}
+			else {
+				TransportMutex.unlock();
+				break;
+			}
+		}
+
+	//TCP responses are split by length field.
+		if (Protocol == IPPROTO_TCP)
+		{
+			RecvLen += Result;
+			while (RecvLen >= sizeof(uint16_t))
+			{
+				DataLength = ntoh16(reinterpret_cast<const uint16_t *>(RecvBuffer.get())[0]);
+				if (RecvLen < sizeof(uint16_t) + DataLength)
+					break;
+
+				DNSCurve_TransportDispatch(*Transport, *Connection, RecvBuffer.get() + sizeof(uint16_t), DataLength);
+				memmove_s(RecvBuffer.get(), DNSCURVE_TRANSPORT_BUFFER_SIZE, RecvBuffer.get() + sizeof(uint16_t) + DataLength, RecvLen - sizeof(uint16_t) - DataLength);
+				RecvLen -= sizeof(uint16_t) + DataLength;
+			}
+		}
+	//UDP
+		else {
+			DNSCurve_TransportDispatch(*Transport, *Connection, RecvBuffer.get(), Result);
+		}
+	}
+
+//Wake up all waiting requests and remove connection.
+	TransportMutex.lock();
+	Connection->IsClosed = true;
+	for (auto &WaitingItem:Connection->WaitingList)
+	{
+		WaitingItem->IsDone = true;
+		WaitingItem->WaitingCondition.notify_one();
+	}
+	Connection->WaitingList.clear();
+	Connection->SendingQueue.clear();
+	if (Transport->Connection == Connection)
+		Transport->Connection.reset();
+
+//Wait sending thread, it will stop after current batch.
+	Connection->SendingCondition.wait(TransportMutex, [&Connection](){return !Connection->IsSending;});
+	TransportMutex.unlock();
+	SocketSetting(Connection->Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	return;
+}
+
+//DNSCurve match response to waiting request of persistent transport
+void DNSCurve_TransportDispatch(
+	DNSCURVE_TRANSPORT &Transport, 
+	DNSCURVE_TRANSPORT_CONNECTION &Connection, 
+	const uint8_t * const Buffer, 
+	const size_t Length)
+{
+//Length check
+	if (Length < DNSCURVE_MAGIC_QUERY_LEN + crypto_box_NONCEBYTES + DNS_PACKET_MINSIZE)
+		return;
+
+//Match client nonce.
+	std::lock_guard<std::mutex> TransportMutex(Transport.TransportLock);
+	for (auto WaitingItem = Connection.WaitingList.begin();WaitingItem != Connection.WaitingList.end();++WaitingItem)
+	{
+		if (memcmp((*WaitingItem)->ClientNonce, Buffer + DNSCURVE_MAGIC_QUERY_LEN, crypto_box_HALF_NONCEBYTES) == 0)
+		{
+			if (Length < (*WaitingItem)->RecvSize)
+			{
+				memcpy_s((*WaitingItem)->RecvBuffer, (*WaitingItem)->RecvSize, Buffer, Length);
+				(*WaitingItem)->RecvLen = Length;
+			}
+
+			(*WaitingItem)->IsDone = true;
+			(*WaitingItem)->WaitingCondition.notify_one();
+			Connection.WaitingList.erase(WaitingItem);
+			break;
+		}
+	}
+
+	return;
+}
 #endif
@@ -23,12 +23,47 @@
 #include "Include.h"
 
 #if defined(ENABLE_LIBSODIUM)
+//Structure definitions
+//Request which is waiting for response in persistent transport, response is matched by client nonce.
+typedef struct _dnscurve_transport_waiting_
+{
+	uint8_t                                          ClientNonce[crypto_box_HALF_NONCEBYTES];
+	uint8_t                                          *RecvBuffer;
+	size_t                                           RecvSize;
+	size_t                                           RecvLen;
+	bool                                             IsDone;
+	std::condition_variable                          WaitingCondition;
+}DNSCurveTransportWaiting, DNSCURVE_TRANSPORT_WAITING;
+
+//Connection of persistent transport, socket is only closed by its receiving monitor.
+typedef struct _dnscurve_transport_connection_
+{
+	SYSTEM_SOCKET                                    Socket;
+	std::list<DNSCURVE_TRANSPORT_WAITING *>          WaitingList;
+	std::deque<std::vector<uint8_t>>                 SendingQueue;
+	std::condition_variable                          SendingCondition;
+	bool                                             IsSending;
+	bool                                             IsClosed;
+}DNSCurveTransportConnection, DNSCURVE_TRANSPORT_CONNECTION;
+
+//Persistent transport of each DNSCurve server, connection is established without lock and only one request connects at the same time.
+typedef struct _dnscurve_transport_
+{
+	std::shared_ptr<DNSCURVE_TRANSPORT_CONNECTION>   Connection;
+	std::mutex                                       TransportLock;
+	std::condition_variable                          ConnectingCondition;
+	bool                                             IsConnecting;
+}DNSCurveTransport, DNSCURVE_TRANSPORT;
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
 extern ALTERNATE_SWAP_TABLE AlternateSwapList;
 extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter;
 
+//Local variables
+std::array<DNSCURVE_TRANSPORT, DNSCURVE_SERVER_NUM> DNSCurveTransportList_TCP, DNSCurveTransportList_UDP;
+
 //Functions
 bool DNSCurve_SignatureRequest_TCP(
 	const uint16_t Protocol, 
@@ -36,5 +71,31 @@ bool DNSCurve_SignatureRequest_TCP(
 bool DNSCurve_SignatureRequest_UDP(
 	const uint16_t Protocol, 
 	const bool IsAlternate);
+bool DNSCurve_CheckServerKeys(
+	const DNSCURVE_SERVER_DATA * const PacketTarget);
+DNSCURVE_SERVER_DATA *DNSCurve_SelectTransportTarget(
+	const uint16_t Protocol, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData, 
+	DNSCURVE_SERVER_TYPE &ServerType, 
+	size_t ** const AlternateTimeoutTimes);
+bool DNSCurve_TransportConnect(
+	const uint16_t Protocol, 
+	const DNSCURVE_SERVER_DATA * const PacketTarget, 
+	DNSCURVE_TRANSPORT &Transport, 
+	std::unique_lock<std::mutex> &TransportMutex);
+void DNSCurve_TransportFlush(
+	const uint16_t Protocol, 
+	DNSCURVE_TRANSPORT_CONNECTION &Connection, 
+	std::unique_lock<std::mutex> &TransportMutex);
+void DNSCurve_TransportReceiveMonitor(
+	const uint16_t Protocol, 
+	DNSCURVE_TRANSPORT * const Transport, 
+	const std::shared_ptr<DNSCURVE_TRANSPORT_CONNECTION> Connection);
+void DNSCurve_TransportDispatch(
+	DNSCURVE_TRANSPORT &Transport, 
+	DNSCURVE_TRANSPORT_CONNECTION &Connection, 
+	const uint8_t * const Buffer, 
+	const size_t Length);
 #endif
 #endif
@@ -89,6 +89,7 @@
 #define ASCII_BRACES_LEFT                             123                         //"{"
 #define ASCII_VERTICAL                                124                         //"|"
 #define ASCII_TILDE                                   126                         //"~"
+#define ASCII_CASE_BIT                                0x20                        //Difference bit between uppercase and lowercase letters
 #define ASCII_MAX_NUM                                 0x7F                        //Maximum number of ASCII
 #define UNICODE_NEXT_LINE                             0x0085                      //Next Line
 #define UNICODE_NO_BREAK_SPACE                        0x00A0                      //No-Break Space
@@ -126,11 +127,18 @@
 #define ADDRESS_STRING_IPV6_MINSIZE                   2U                                //The shortest IPv6 address strings(::)
 #define ADDRESS_STRING_MAXSIZE                        64U                               //Maximum size of addresses(IPv6/IPv4) words, in bytes
 #define ALTERNATE_SERVER_NUM                          12U                               //Alternate switching of Main(00: TCP/IPv6, 01: TCP/IPv4, 02: UDP/IPv6, 03: UDP/IPv4), Local(04: TCP/IPv6, 05: TCP/IPv4, 06: UDP/IPv6, 07: UDP/IPv4), DNSCurve(08: TCP/IPv6, 09: TCP/IPv4, 10: UDP/IPv6, 11: UDP/IPv4)
+#if defined(ENABLE_PCAP)
+	#define CAPTURE_FRAGMENT_HEADER_MAXSIZE               256U                              //Maximum size of unfragmentable headers of fragment in reassembly table, in bytes
+	#define CAPTURE_FRAGMENT_MAXNUM                       64U                               //Maximum number of datagrams in fragment reassembly table
+	#define CAPTURE_WAITING_MAXNUM                        4096U                             //Maximum number of responses which are parked in receive waiting window
+#endif
+#define CHECKSUM_SIMD_FLUSH_BLOCKS                    16384U                            //Maximum number of vector blocks summed before 32-bit lanes of checksum are flushed
 #define COMMAND_COUNT_MIN                             1                                 //Minimum count of commands
 #define DEFAULT_LARGE_BUFFER_SIZE                     4096U                             //Default size of large buffer, in bytes
 #define DEFAULT_LOG_READING_MAXSIZE                   8388608U                          //Default number of maximum log file size, in bytes
 #define DEFAULT_THREAD_POOL_MAXNUM                    256U                              //Default number of maximum thread pool size
 #define DIFFERNET_FILE_SET_NUM                        2U                                //Number of different file set
+#define DNS_QUERY_RECORD_RESERVED_NUM                 16U                               //Number of resource records which are reserved in each query descriptor
 #define DNS_RECORD_COUNT_AAAA_MAX                     43U                               //Maximum Record Resources size of whole AAAA answers, 28 bytes * 43 records = 1204 bytes
 #define DNS_RECORD_COUNT_A_MAX                        75U                               //Maximum Record Resources size of whole A answers, 16 bytes * 75 records = 1200 bytes
 #if defined(ENABLE_LIBSODIUM)
@@ -140,7 +148,10 @@
 	#define DNSCRYPT_DATABASE_PROVIDER_KEY_LOCATION       12U                               //Location of Provider Public Key in DNSCrypt database
 	#define DNSCRYPT_KEYPAIR_MESSAGE_LEN                  80U                               //DNScrypt keypair messages length
 	#define DNSCRYPT_KEYPAIR_INTERVAL                     4U                                //DNScrypt keypair interval length
+	#define DNSCRYPT_KEYPAIR_POOL_SIZE                    32U                               //Number of pooled client ephemeral key pairs of each DNSCurve server
 	#define DNSCRYPT_RECORD_TXT_LEN                       124U                              //Length of DNScrypt TXT Records
+	#define DNSCURVE_SERVER_NUM                           4U                                //Number of DNSCurve servers(Main/Alternate IPv6 and IPv4)
+	#define DNSCURVE_TRANSPORT_BATCH_MAXNUM               32U                               //Maximum number of queued packets which are sent in each batch of persistent transport
 #endif
 #define DOMAIN_DATA_MAXSIZE                           253U                              //Maximum data length of whole level domain, in bytes(Section 2.3.1 in RFC 1035)
 #define DOMAIN_MAXSIZE                                256U                              //Maximum size of whole level domain, in bytes(Section 2.3.1 in RFC 1035)
@@ -151,7 +162,9 @@
 #define ERROR_MESSAGE_MINSIZE                         3U                                //Minimum size of log message
 #define FILE_BUFFER_SIZE                              DEFAULT_LARGE_BUFFER_SIZE         //Size of file reading buffer
 #define FILE_READING_MAXSIZE                          268435456U                        //Maximum size of whole reading file, in bytes.
+#define HTTP_2_DNS_PATH_MAXSIZE                       256U                              //Maximum size of DNS over HTTPS request path
 #define HTTP_AUTHORIZATION_MAXSIZE                    DEFAULT_LARGE_BUFFER_SIZE         //Maximum size of HTTP proxy authorization string.
+#define HTTP_CONNECT_TUNNEL_POOL_MAXNUM               8U                                //Maximum number of established HTTP CONNECT tunnel connections which are kept in pool
 #define HTTP_VERSION_SUPPORT_COUNT                    2U                                //HTTP version 1.1 and 2 which are supported.
 #define HTTP_VERSION_MAXSIZE                          3U                                //Maximum size of HTTP version
 #define ICMP_PADDING_MAXSIZE                          1464U                             //Length of ICMP padding data must between 18 bytes and 1464 bytes(Ethernet MTU - IPv4 Standard Header - ICMP Header).
@@ -163,17 +176,27 @@
 	#define ICMP_PADDING_LENGTH_MACOS                     48U
 	#define ICMP_STRING_START_NUM_MACOS                   8U
 #endif
+#define LOG_EVENT_MESSAGE_MAXSIZE                     192U                              //Maximum size of log message which is queued to log writer, longer messages are written directly.
+#define LOG_EVENT_RATE_MAXNUM                         32U                               //Maximum number of log messages which are queued by each thread in each second
+#define LOG_EVENT_RING_MAXNUM                         64U                               //Maximum number of log messages in ring of each thread
 #define LOG_READING_MINSIZE                           DEFAULT_LARGE_BUFFER_SIZE         //Minimum size of whole log file
 #define MEMORY_BUFFER_EXPAND_BYTES                    1U                                //Memory buffer expanded bytes, in bytes
 #define MEMORY_RESERVED_BYTES                         2U                                //Memory buffer reserved bytes, in bytes
 #define MULTIPLE_REQUEST_MAXNUM                       32U                               //Maximum number of multiple request.
 #define NETWORK_LAYER_PARTNUM                         2U                                //Number of network layer protocols(IPv6 and IPv4)
 #define NULL_TERMINATE_LENGTH                         1U                                //Length of C style string null
+#if defined(ENABLE_PCAP)
+	#define OUTPUT_PACKET_SHARD_NUM                       64U                               //Number of locked shards of port hash table
+	#define OUTPUT_PACKET_TIMER_SLOT_NUM                  256U                              //Number of slots of port timer wheel
+#endif
 //#define PACKET_ORIGINAL_MAXSIZE                       1522U                             //Maximum size of original Ethernet frame, 6 bytes destination MAC + 6 bytes source MAC + 4 bytes 802.1Q tag(optional) + 2 bytes Ethertype + 1500 bytes payload + 4 bytes FCS/Frame Check Sequence
 #define PACKET_ORIGINAL_MAXSIZE                       2048U                             //Some DNS response length exceeds an Ethernet frame maximum payload, in bytes.
 //#define PACKET_NORMAL_MAXSIZE                         1480U                             //Maximum size of normal Ethernet frame, 1500 bytes maximum payload - 20 bytes IPv4 header(IPv6 header length is longer than IPv4) and ignore all other transport layer protocols.
 #define PACKET_NORMAL_MAXSIZE                         PACKET_ORIGINAL_MAXSIZE           //Some DNS response length exceeds an Ethernet frame maximum payload, in bytes.
 #if defined(ENABLE_PCAP)
+	#define PCAP_CAPTURE_BUFFER_SIZE                      8388608U                    //Kernel buffer size of pcap capture ring, in bytes
+	#define PCAP_CAPTURE_DISPATCH_NUM                     64U                         //Maximum number of packets which are processed in each capture dispatching
+	#define PCAP_CAPTURE_LOOP_MAXNUM                      8U                          //Maximum number of capture event loops and capture sockets in fanout group of each device
 	#define PCAP_CAPTURE_STRING_MAXNUM                    256U                        //Maximum length of pcap capture drive name and description
 #endif
 #if defined(PLATFORM_WIN)
@@ -182,6 +205,15 @@
 #if defined(PLATFORM_WIN)
 	#define SERVICE_TABLE_ENTRY_NUM                       2U                          //Service table entry number
 #endif
+#define SOCKS_TUNNEL_POOL_MAXNUM                      8U                          //Maximum number of established SOCKS tunnels which are kept in pool
+#define STATISTICS_CLIENT_TIMEOUT                     100U                        //Timeout of each statistics client, in ms
+#define STATISTICS_COUNTER_NUM                        9U                          //Number of statistics counters
+#define STATISTICS_LATENCY_BUCKET_NUM                 13U                         //Number of query duration histogram buckets, upper bounds are 1ms to 2048ms and the last one is unlimited.
+#define STATISTICS_PADDING_SIZE                       64U                         //Padding size around statistics counters of each thread, size of cache line in most platforms
+#define STREAM_CONNECTION_MAXNUM                      4U                          //Maximum number of persistent stream connections to each server in pool
+#define STREAM_CONNECTION_PIPELINE_MAXNUM             64U                         //Maximum number of pipelined requests in each persistent stream connection
+#define TCP_SESSION_PIPELINE_MAXNUM                   32U                         //Maximum number of pipelined queries which are waiting for responses in each client TCP connection
+#define TCP_SESSION_QUERY_MAXNUM                      1024U                       //Maximum number of queries in each client TCP connection
 #define THREAD_POOL_MAXNUM                            148809524U                  //Number of maximum packet buffer queues, 148809523pps in 100 Gigabit Ethernet
 #define THREAD_POOL_MINNUM                            8U                          //Number of minimum packet buffer queues
 #define TRANSPORT_LAYER_PARTNUM                       4U                          //Number of transport layer protocols(00: IPv6/UDP, 01: IPv4/UDP, 02: IPv6/TCP, 03: IPv4/TCP)
@@ -197,6 +229,9 @@
 	#define DNSCRYPT_BUFFER_RESERVED_TCP_LEN              (sizeof(uint16_t) + DNSCRYPT_BUFFER_RESERVED_LEN)
 	#define DNSCRYPT_PACKET_MINSIZE                       (DNSCURVE_MAGIC_QUERY_LEN + crypto_box_NONCEBYTES + DNS_PACKET_MINSIZE)
 	#define DNSCRYPT_HEADER_RESERVED_LEN                  (sizeof(ipv6_hdr) + sizeof(udp_hdr) + DNSCRYPT_BUFFER_RESERVED_LEN)
+	#define DNSCRYPT_KEYPAIR_POOL_ITEM_LEN                (crypto_box_PUBLICKEYBYTES + crypto_box_BEFORENMBYTES)                                                               //Client public key + precomputation key
+	#define DNSCURVE_CERTIFICATE_CACHE_ITEM_LEN           (sizeof(dns_record_txt) + DNSCRYPT_RECORD_TXT_LEN)                                                                    //Signed certificate record of each server in cache file
+	#define DNSCURVE_TRANSPORT_BUFFER_SIZE                (sizeof(uint16_t) + UINT16_MAX)                                                                                       //Receiving buffer of persistent transport, TCP length field + maximum DNSCurve message
 #endif
 #define HTTP1_RESPONSE_MINSIZE                        (strlen(" HTTP/") + HTTP_VERSION_MAXSIZE + HTTP_STATUS_CODE_SIZE)
 
@@ -214,6 +249,9 @@
 #endif
 
 //Time definitions
+#if defined(ENABLE_PCAP)
+	#define CAPTURE_FRAGMENT_TIMEOUT                      3000U                       //Time limit of datagram in fragment reassembly table, in ms
+#endif
 #define DEFAULT_ALTERNATE_RANGE_TIME                  60U                         //Default time of checking timeout, in seconds
 #define DEFAULT_ALTERNATE_RESET_TIME                  300U                        //Default time to reset switching of alternate servers, in seconds
 #define DEFAULT_ALTERNATE_TIMES                       10U                         //Default times of request timeout, in times
@@ -235,9 +273,13 @@
 	#define DNSCURVE_DEFAULT_RECHECK_TIME                 1800U                                    //Default DNSCurve keys recheck time, in seconds
 	#define DNSCURVE_DEFAULT_RELIABLE_SOCKET_TIMEOUT      DEFAULT_RELIABLE_ONCE_SOCKET_TIMEOUT     //Same as default timeout of reliable sockets
 	#define DNSCURVE_DEFAULT_UNRELIABLE_SOCKET_TIMEOUT    DEFAULT_UNRELIABLE_ONCE_SOCKET_TIMEOUT   //Same as default timeout of unreliable sockets
+	#define DNSCURVE_KEYPAIR_POOL_REFILL_TIME             1000U                                    //Time between every checking of client ephemeral key pair pools, in ms
 	#define DNSCURVE_SHORTEST_RECHECK_TIME                10U                                      //The shortest DNSCurve keys recheck time, in seconds
 #endif
 #define FLUSH_DOMAIN_CACHE_INTERVAL_TIME              5U                          //Time between every flushing domain cache, in seconds
+#define HTTP_CONNECT_TUNNEL_IDLE_TIME                 30000U                      //Time limit of idle HTTP CONNECT tunnels in pool, in ms
+#define LOG_EVENT_WRITE_INTERVAL_TIME                 100U                        //Time between every writing of queued log messages, in ms
+#define LOG_EVENT_DROP_INTERVAL_TIME                  60U                         //Time between every reporting of dropped log messages, in seconds
 #define LOOP_INTERVAL_TIME_DELAY                      20U                         //Delay mode loop interval time, in ms
 #if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
 	#define LOOP_INTERVAL_TIME_NO_DELAY                   20000U                         //No delay mode loop interval time, in us
@@ -245,6 +287,11 @@
 #define LOOP_MAX_LITTLE_TIMES                         4U                          //Little maximum of loop times, in times
 #define LOOP_MAX_LARGE_TIMES                          8U                          //Large maximum of loop times, in times
 #define MICROSECOND_TO_MILLISECOND                    1000U                       //1000 microseconds, in ms
+#define NANOSECOND_TO_MILLISECOND                     1000000U                    //1000000 nanoseconds, in ms
+#define NANOSECOND_TO_SECOND                          1000000000U                 //1000000000 nanoseconds, in seconds
+#if defined(ENABLE_PCAP)
+	#define OUTPUT_PACKET_TIMER_INTERVAL                  64U                         //Time between every slot of port timer wheel, in ms
+#endif
 #define SECOND_TO_MILLISECOND                         1000U                       //1000 milliseconds, in us
 #define SENDING_INTERVAL_TIME                         5000U                       //Time between every sending, in ms
 #define SENDING_ONCE_INTERVAL_TIMES                   3U                          //Repeat times between every sending, in times.
@@ -257,8 +304,11 @@
 #define SHORTEST_QUEUE_RESET_TIME                     5U                          //The shortest time to reset queue limit, in seconds
 #define SHORTEST_THREAD_POOL_RESET_TIME               5U                          //The shortest time to reset thread pool number, in seconds
 #define SOCKET_TIMEOUT_MIN                            500U                        //The shortest socket timeout, in ms
+#define SOCKS_TUNNEL_IDLE_TIME                        30000U                      //Time limit of idle SOCKS tunnels in pool, in ms
 #define STANDARD_THREAD_TIMEOUT                       2000U                       //Standard thread timeout, in ms
 #define STANDARD_TIMEOUT                              1000U                       //Standard timeout, in ms
+#define STREAM_CONNECTION_IDLE_TIME                   30000U                      //Time limit of idle persistent stream connections in pool, in ms
+#define TCP_SESSION_IDLE_TIME                         10000U                      //Time limit of idle client TCP connections and queries without any responses in them, in ms
 #if defined(PLATFORM_WIN)
 	#define UPDATE_SERVICE_TIME                           3000U                       //Update service timeout, in seconds
 #endif
@@ -273,13 +323,18 @@
 	#define COMMAND_LONG_LOG_FILE                         (L"--log-file")
 	#define COMMAND_LONG_PRINT_VERSION                    (L"--version")
 	#define COMMAND_LONG_SET_PATH                         (L"--config-path")
+#if defined(ENABLE_PCAP)
+	#define COMMAND_REPLAY_PCAP                           (L"--replay-pcap")
+#endif
 	#define COMMAND_SHORT_HELP                            (L"-h")
 	#define COMMAND_SHORT_LOG_FILE                        (L"-l")
 	#define COMMAND_SHORT_PRINT_VERSION                   (L"-v")
 	#define COMMAND_SHORT_SET_PATH                        (L"-c")
+	#define COMMAND_STATISTICS                            (L"--stats")
 	#define CONFIG_FILE_NAME_LIST_WCS                     {(L"Config.ini"), (L"Config.conf"), (L"Config.cfg"), (L"Config")}
 	#define DEFAULT_ICMP_PADDING_DATA                     ("abcdefghijklmnopqrstuvwabcdefghi")           //Windows: Default ICMP padding data
 #if defined(ENABLE_LIBSODIUM)
+	#define DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_WCS      (L"DNSCurveCertificate.dat")
 	#define DNSCURVE_KEY_PAIR_FILE_NAME                   (L"KeyPair.txt")
 #endif
 	#define ERROR_LOG_FILE_NAME_WCS                       (L"Error.log")
@@ -287,6 +342,7 @@
 	#define FLUSH_DOMAIN_MAILSLOT_MESSAGE_SPECIFIC        (L"Flush Pcap_DNSProxy domain cache: ")        //The mailslot message to flush specific domain cache
 	#define FLUSH_DOMAIN_MAILSLOT_NAME                    (L"\\\\.\\mailslot\\pcap_dnsproxy_mailslot")   //The mailslot name to flush domain cache
 	#define MUTEX_EXISTS_NAME                             (L"Global\\Pcap_DNSProxy Process Exists")      //Global mutex exists name
+	#define STATISTICS_PIPE_NAME                          (L"\\\\.\\pipe\\pcap_dnsproxy_statistics")    //The named pipe name to get statistics
 	#define SID_ADMINISTRATORS_GROUP                      (L"S-1-5-32-544")                              //Windows Administrators group SID header
 	#define SYSTEM_SERVICE_NAME                           (L"PcapDNSProxyService")                       //System service name
 #elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
@@ -300,13 +356,19 @@
 	#define COMMAND_LONG_LOG_FILE                         ("--log-file")
 	#define COMMAND_LONG_PRINT_VERSION                    ("--version")
 	#define COMMAND_LONG_SET_PATH                         ("--config-path")
+#if defined(ENABLE_PCAP)
+	#define COMMAND_REPLAY_PCAP                           ("--replay-pcap")
+#endif
 	#define COMMAND_SHORT_HELP                            ("-h")
 	#define COMMAND_SHORT_LOG_FILE                        ("-l")
 	#define COMMAND_SHORT_PRINT_VERSION                   ("-v")
 	#define COMMAND_SHORT_SET_PATH                        ("-c")
+	#define COMMAND_STATISTICS                            ("--stats")
 	#define CONFIG_FILE_NAME_LIST_WCS                     {(L"Config.conf"), (L"Config.ini"), (L"Config.cfg"), (L"Config")}
 	#define CONFIG_FILE_NAME_LIST_MBS                     {("Config.conf"), ("Config.ini"), ("Config.cfg"), ("Config")}
 #if defined(ENABLE_LIBSODIUM)
+	#define DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_WCS      (L"DNSCurveCertificate.dat")
+	#define DNSCURVE_CERTIFICATE_CACHE_FILE_NAME_MBS      ("DNSCurveCertificate.dat")
 	#define DNSCURVE_KEY_PAIR_FILE_NAME                   ("KeyPair.txt")
 #endif
 	#define ERROR_LOG_FILE_NAME_WCS                       (L"Error.log")
@@ -314,8 +376,10 @@
 	#define FLUSH_DOMAIN_PIPE_MESSAGE_ALL                 ("Flush Pcap_DNSProxy domain cache")         //The FIFO pipe message to flush all domain cache
 	#define FLUSH_DOMAIN_PIPE_MESSAGE_SPECIFIC            ("Flush Pcap_DNSProxy domain cache: ")       //The FIFO pipe message to flush specific domain cache
 	#define FLUSH_DOMAIN_PIPE_PATH_NAME                   ("/tmp/pcap_dnsproxy_fifo")                  //The FIFO pipe pathname to flush domain cache
+	#define STATISTICS_SOCKET_PATH_NAME                   ("/tmp/pcap_dnsproxy_statistics")            //The Unix domain socket pathname to get statistics
 #endif
 #define DEFAULT_LOCAL_SERVER_NAME                     ("pcap-dnsproxy.server")                     //Default Local DNS server name
+#define STATISTICS_MESSAGE                            ("Get Pcap_DNSProxy statistics")             //The message to get statistics, HTTP GET requests are also accepted.
 #define DNS_PACKET_QUERY_LOCATE(Buffer, BufferSize)   (sizeof(dns_hdr) + CheckQueryNameLength(reinterpret_cast<const uint8_t *>(Buffer) + sizeof(dns_hdr), BufferSize) + NULL_TERMINATE_LENGTH)                     //Locate the beginning of DNS query.
 #define DNS_PACKET_RR_LOCATE(Buffer, BufferSize)      (sizeof(dns_hdr) + CheckQueryNameLength(reinterpret_cast<const uint8_t *>(Buffer) + sizeof(dns_hdr), BufferSize) + NULL_TERMINATE_LENGTH + sizeof(dns_qry))   //Locate the beginning of DNS resource records.
 
@@ -31,6 +31,10 @@ bool CheckLibraryVersion(
 bool CheckEmptyBuffer(
 	const void * const Buffer, 
 	const size_t Length);
+#if defined(ENABLE_SIMD_AVX2)
+bool CheckProcessorFeature_AVX2(
+	void);
+#endif
 bool MBS_To_WCS_String(
 	const uint8_t * const Buffer, 
 	const size_t BufferSize, 
@@ -102,6 +106,8 @@ uint64_t GetCurrentSystemTime(
 #if defined(ENABLE_PCAP)
 void CaptureInit(
 	void);
+bool Capture_ReplayProcess(
+	const std::string &FileName);
 #endif
 
 //Configuration.h
@@ -117,6 +123,11 @@ void ReadHosts(
 bool DNSCurve_VerifyKeypair(
 	const uint8_t * const PublicKey, 
 	const uint8_t * const SecretKey);
+uint16_t DNSCurve_SelectTargetSocket(
+	const uint16_t Protocol, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData, 
+	bool ** const IsAlternate);
 DNSCURVE_SERVER_DATA *DNSCurve_SelectSignatureTargetSocket(
 	const uint16_t Protocol, 
 	const bool IsAlternate, 
@@ -129,6 +140,8 @@ bool DNSCurve_PrecomputationKeySetting(
 	uint8_t * const PrecomputationKey, 
 	uint8_t * const Client_PublicKey, 
 	const uint8_t * const ServerFingerprint);
+void DNSCurve_KeyPairPoolMonitor(
+	void);
 void DNSCurve_SocketPrecomputation(
 	const uint16_t Protocol, 
 	const uint8_t * const OriginalSend, 
@@ -159,10 +172,16 @@ ssize_t DNSCurve_PacketDecryption(
 	const uint8_t * const PrecomputationKey, 
 	uint8_t * const OriginalRecv, 
 	const size_t RecvSize, 
-	const ssize_t Length);
+	const ssize_t Length, 
+	DNS_MESSAGE_INDEX * const MessageIndex);
 bool DNSCruve_GetSignatureData(
 	const uint8_t * const Buffer, 
 	const DNSCURVE_SERVER_TYPE ServerType);
+bool DNSCurve_LoadCertificateCache(
+	const DNSCURVE_SERVER_TYPE ServerType);
+void DNSCurve_StoreCertificateCache(
+	const uint8_t * const Buffer, 
+	const DNSCURVE_SERVER_TYPE ServerType);
 
 //DNSCurveRequest.h
 void DNSCurveInit(
@@ -195,6 +214,14 @@ size_t DNSCurve_UDP_RequestMultiple(
 	const size_t RecvSize, 
 	const uint16_t QueryType, 
 	const SOCKET_DATA &LocalSocketData);
+size_t DNSCurve_TransportRequest(
+	const uint16_t Protocol, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData);
 #endif
 
 //Monitor.h
@@ -203,9 +230,16 @@ void MonitorLauncher(
 bool MonitorInit(
 	void);
 bool TCP_AcceptProcess(
-	MONITOR_QUEUE_DATA MonitorQueryData, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	uint8_t * const OriginalRecv, 
 	size_t RecvSize);
+bool TCP_SessionResponse(
+	SOCKET_DATA &LocalSocketData, 
+	const uint8_t * const Buffer, 
+	const size_t Length);
+void TCP_SessionFinish(
+	SOCKET_DATA &LocalSocketData, 
+	const uint8_t * const Buffer);
 
 //Network.h
 bool SocketSetting(
@@ -293,12 +327,19 @@ void RegisterPortToList(
 	const uint16_t Protocol, 
 	const SOCKET_DATA * const LocalSocketData, 
 	std::vector<SOCKET_DATA> &SocketDataList, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request
+	const uint16_t DNS_ID, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request
 //	size_t *EDNS_Length
 );
 
 //PacketData.h
+uint64_t GetChecksum_Accumulate(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	uint64_t ResultValue);
+uint16_t GetChecksum_Fold(
+	uint64_t ResultValue);
 uint16_t GetChecksum_Internet(
 	const uint16_t *Buffer, 
 	const size_t Length);
@@ -355,6 +396,7 @@ size_t MakeCompressionPointerMutation(
 bool MarkDomainCache(
 	const uint8_t * const Buffer, 
 	const size_t Length, 
+	const DNS_MESSAGE_INDEX * const MessageIndex, 
 	const SOCKET_DATA * const LocalSocketData);
 size_t CheckDomainCache(
 	uint8_t * const ResultBuffer, 
@@ -371,6 +413,12 @@ bool PrintError(
 	const ssize_t ErrorCode, 
 	const wchar_t * const FileName, 
 	const size_t Line);
+void PrintLogWriter(
+	void);
+void PrintLogFlush(
+	void);
+void PrintLogWriterStop(
+	void);
 void PrintToScreen(
 	const bool IsInnerLock, 
 	const bool IsStandardOut, 
@@ -396,11 +444,14 @@ void PrintLog_DNSCurve(
 
 //Process.h
 void MonitorRequestProvider(
-	const MONITOR_QUEUE_DATA &MonitorQueryData);
+	const size_t DescriptorIndex);
 void MonitorRequestConsumer(
-	void);
+	const size_t DescriptorIndex, 
+	uint8_t * const SendBuffer, 
+	uint8_t * const RecvBuffer, 
+	const size_t BufferSize);
 bool EnterRequestProcess(
-	MONITOR_QUEUE_DATA MonitorQueryData, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	uint8_t *RecvBuffer, 
 	size_t RecvSize);
 size_t CheckWhiteBannedHostsProcess(
@@ -418,8 +469,8 @@ bool SendToRequester(
 	uint8_t * const RecvBuffer, 
 	const size_t RecvSize, 
 	const size_t BufferSize, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	SOCKET_DATA &LocalSocketData);
 
 //Protocol.h
@@ -455,6 +506,10 @@ bool OperationModeFilter(
 size_t CheckQueryNameLength(
 	const uint8_t * const Buffer, 
 	const size_t BufferSize);
+bool BuildMessageIndex(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	DNS_MESSAGE_INDEX &MessageIndex);
 bool CheckQueryData(
 	DNS_PACKET_DATA * const PacketStructure, 
 	uint8_t * const SendBuffer, 
@@ -470,7 +525,8 @@ size_t CheckResponseData(
 	const size_t Length, 
 	const size_t BufferSize, 
 	size_t * const PacketEDNS_Offset, 
-	size_t * const PacketEDNS_Length);
+	size_t * const PacketEDNS_Length, 
+	DNS_MESSAGE_INDEX * const MessageIndex);
 
 //Proxy.h
 size_t SOCKS_TCP_Request(
@@ -494,6 +550,13 @@ size_t HTTP_CONNECT_TCP_Request(
 	size_t &RecvSize, 
 	const uint16_t QueryType, 
 	const SOCKET_DATA &LocalSocketData);
+void HTTP_CONNECT_2_IntegerEncoding(
+	std::vector<uint8_t> &BytesList, 
+	size_t IntegerValue);
+bool HTTP_CONNECT_2_HEADERS_ReadBytes(
+	std::vector<std::string> &HeaderList, 
+	const uint8_t *Buffer, 
+	const size_t Length);
 
 //Request.h
 #if defined(PLATFORM_WIN)
@@ -527,6 +590,18 @@ size_t TCP_RequestMultiple(
 	const size_t RecvSize, 
 	const uint16_t QueryType, 
 	const SOCKET_DATA * const LocalSocketData);
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+size_t TLS_RequestSingle(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData);
+#endif
+#endif
 #if defined(ENABLE_PCAP)
 size_t UDP_RequestSingle(
 	const REQUEST_PROCESS_TYPE RequestType, 
@@ -534,8 +609,8 @@ size_t UDP_RequestSingle(
 	const uint8_t * const OriginalSend, 
 	const size_t SendSize, 
 	const uint16_t QueryType, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	const SOCKET_DATA * const LocalSocketData
 //	size_t *EDNS_Length
 );
@@ -546,8 +621,8 @@ size_t UDP_RequestMultiple(
 	const uint8_t * const OriginalSend, 
 	const size_t SendSize, 
 	const uint16_t QueryType, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	const SOCKET_DATA * const LocalSocketData
 //	size_t *EDNS_Length
 );
@@ -594,6 +669,18 @@ bool FlushDomainCache_PipeSender(
 void FlushDomainCache_Main(
 	const uint8_t * const Domain);
 
+//Statistics.h
+void Statistics_AddCounter(
+	const STATISTICS_COUNTER_TYPE CounterType);
+uint64_t Statistics_GetCounter(
+	const STATISTICS_COUNTER_TYPE CounterType);
+void Statistics_AddLatency(
+	const uint64_t Latency);
+bool Statistics_Listener(
+	void);
+bool Statistics_Sender(
+	void);
+
 //TransportSecurity.h
 #if defined(ENABLE_TLS)
 #if defined(PLATFORM_WIN)
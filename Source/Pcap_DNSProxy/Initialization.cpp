@@ -136,6 +136,19 @@ ConfigurationTable::ConfigurationTable(
 	#else
 		HTTP_CONNECT_ProxyAuthorization = new uint8_t[HTTP_AUTHORIZATION_MAXSIZE + MEMORY_RESERVED_BYTES]();
 	#endif
+
+	//[DNS over TLS] block
+	#if defined(ENABLE_TLS)
+	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		DNS_TLS_AddressString_IPv6 = new std::string();
+		DNS_TLS_AddressString_IPv4 = new std::string();
+		DNS_TLS_SNI_MBS = new std::string();
+		DNS_HTTPS_AddressString_IPv6 = new std::string();
+		DNS_HTTPS_AddressString_IPv4 = new std::string();
+		DNS_HTTPS_SNI_MBS = new std::string();
+		DNS_HTTPS_Path = new std::string();
+	#endif
+	#endif
 	}
 	catch (std::bad_alloc &)
 	{
@@ -202,6 +215,17 @@ ConfigurationTable::ConfigurationTable(
 		sodium_free(HTTP_CONNECT_ProxyAuthorization);
 	#else
 		delete[] HTTP_CONNECT_ProxyAuthorization;
+	#endif
+	#if defined(ENABLE_TLS)
+	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		delete DNS_TLS_AddressString_IPv6;
+		delete DNS_TLS_AddressString_IPv4;
+		delete DNS_TLS_SNI_MBS;
+		delete DNS_HTTPS_AddressString_IPv6;
+		delete DNS_HTTPS_AddressString_IPv4;
+		delete DNS_HTTPS_SNI_MBS;
+		delete DNS_HTTPS_Path;
+	#endif
 	#endif
 		SOCKS_TargetDomain = nullptr;
 		SOCKS_Username = nullptr;
@@ -217,6 +241,17 @@ ConfigurationTable::ConfigurationTable(
 		HTTP_CONNECT_TargetDomain = nullptr;
 		HTTP_CONNECT_HeaderField = nullptr;
 		HTTP_CONNECT_ProxyAuthorization = nullptr;
+	#if defined(ENABLE_TLS)
+	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		DNS_TLS_AddressString_IPv6 = nullptr;
+		DNS_TLS_AddressString_IPv4 = nullptr;
+		DNS_TLS_SNI_MBS = nullptr;
+		DNS_HTTPS_AddressString_IPv6 = nullptr;
+		DNS_HTTPS_AddressString_IPv4 = nullptr;
+		DNS_HTTPS_SNI_MBS = nullptr;
+		DNS_HTTPS_Path = nullptr;
+	#endif
+	#endif
 
 	//Exit process.
 		exit(EXIT_FAILURE);
@@ -335,6 +370,22 @@ void ConfigurationTableSetting(
 	ConfigurationParameter->HTTP_CONNECT_Protocol = REQUEST_MODE_NETWORK::BOTH;
 	ConfigurationParameter->HTTP_CONNECT_Version = HTTP_VERSION_SELECTION::VERSION_AUTO;
 
+	//[DNS over TLS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	ConfigurationParameter->DNS_TLS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+#endif
+#endif
+
+	//[DNS over HTTPS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	ConfigurationParameter->DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+	if (ConfigurationParameter->DNS_HTTPS_Path != nullptr)
+		ConfigurationParameter->DNS_HTTPS_Path->append(HTTP_2_DNS_DEFAULT_PATH);
+#endif
+#endif
+
 	return;
 }
 
@@ -421,6 +472,32 @@ ConfigurationTable::~ConfigurationTable(
 	HTTP_CONNECT_HeaderField = nullptr;
 	HTTP_CONNECT_ProxyAuthorization = nullptr;
 
+//[DNS over TLS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	delete DNS_TLS_AddressString_IPv6;
+	delete DNS_TLS_AddressString_IPv4;
+	delete DNS_TLS_SNI_MBS;
+	DNS_TLS_AddressString_IPv6 = nullptr;
+	DNS_TLS_AddressString_IPv4 = nullptr;
+	DNS_TLS_SNI_MBS = nullptr;
+#endif
+#endif
+
+//[DNS over HTTPS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	delete DNS_HTTPS_AddressString_IPv6;
+	delete DNS_HTTPS_AddressString_IPv4;
+	delete DNS_HTTPS_SNI_MBS;
+	delete DNS_HTTPS_Path;
+	DNS_HTTPS_AddressString_IPv6 = nullptr;
+	DNS_HTTPS_AddressString_IPv4 = nullptr;
+	DNS_HTTPS_SNI_MBS = nullptr;
+	DNS_HTTPS_Path = nullptr;
+#endif
+#endif
+
 	return;
 }
 
@@ -731,8 +808,6 @@ GlobalStatus::GlobalStatus(
 	try {
 		LocalListeningSocket = new std::vector<SYSTEM_SOCKET>();
 		RandomEngine = new std::default_random_engine();
-		ThreadRunningNum = new std::atomic<size_t>();
-		ThreadRunningFreeNum = new std::atomic<size_t>();
 		Path_Global = new std::vector<std::wstring>();
 		Path_ErrorLog = new std::wstring();
 		FileList_Hosts = new std::vector<std::wstring>();
@@ -754,16 +829,12 @@ GlobalStatus::GlobalStatus(
 	{
 		delete LocalListeningSocket;
 		delete RandomEngine;
-		delete ThreadRunningNum;
-		delete ThreadRunningFreeNum;
 		delete Path_Global;
 		delete Path_ErrorLog;
 		delete FileList_Hosts;
 		delete FileList_IPFilter;
 		LocalListeningSocket = nullptr;
 		RandomEngine = nullptr;
-		ThreadRunningNum = nullptr;
-		ThreadRunningFreeNum = nullptr;
 		Path_Global = nullptr;
 		Path_ErrorLog = nullptr;
 		FileList_Hosts = nullptr;
@@ -1188,6 +1259,422 @@ SocketSelectingOnceTable::SocketSelectingOnceTable(
 	return;
 }
 
+//TaskExecutorTable class constructor
+TaskExecutorTable::TaskExecutorTable(
+	void)
+{
+	WorkerBaseNum = 0;
+	WorkerMaxNum = 0;
+	WorkerResetTime = 0;
+	WorkerBufferSize = 0;
+	WorkerRunningNum = 0;
+	WorkerIdleNum = 0;
+	TaskPendingNum = 0;
+	SubmitIndex = 0;
+	IsShutdown = false;
+
+	return;
+}
+
+//TaskExecutorTable class Initialize function
+bool TaskExecutorTable::Initialize(
+	const size_t BaseNum, 
+	const size_t MaxNum, 
+	const size_t ResetTime, 
+	const size_t BufferSize)
+{
+//Executor can only be initialized once.
+	if (WorkerSlotList || BaseNum == 0 || MaxNum < BaseNum || BufferSize == 0)
+		return false;
+
+//Allocate all slots, extra workers reuse slots after old threads exited.
+	try {
+		WorkerSlotList = std::make_unique<EXECUTOR_WORKER_SLOT[]>(MaxNum);
+	}
+	catch (std::bad_alloc &)
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Memory allocation error", 0, nullptr, 0);
+		return false;
+	}
+	for (size_t Index = 0;Index < MaxNum;++Index)
+	{
+		WorkerSlotList[Index].TaskCount = 0;
+		WorkerSlotList[Index].IsRunning = false;
+	}
+	WorkerBaseNum = BaseNum;
+	WorkerMaxNum = MaxNum;
+	WorkerResetTime = ResetTime;
+	WorkerBufferSize = BufferSize;
+
+//Start all base workers.
+	for (size_t Index = 0;Index < WorkerBaseNum;++Index)
+	{
+		if (!StartWorker(Index))
+			return false;
+	}
+
+	return true;
+}
+
+//TaskExecutorTable class Submit function
+bool TaskExecutorTable::Submit(
+	EXECUTOR_TASK &&Task)
+{
+	if (!WorkerSlotList || IsShutdown)
+		return false;
+
+//Workers push to the back of their own deque, other threads distribute tasks to all running workers in turn.
+	size_t SlotIndex = 0;
+	if (TaskExecutor_Current == this)
+	{
+		SlotIndex = TaskExecutor_WorkerIndex;
+	}
+	else {
+		SlotIndex = SubmitIndex++ % WorkerMaxNum;
+		if (!WorkerSlotList[SlotIndex].IsRunning)
+			SlotIndex %= WorkerBaseNum;
+	}
+
+//Pending number is changed together with deques, it is larger than 0 only when there are tasks in deques.
+	std::unique_lock<std::mutex> TaskQueueMutex(WorkerSlotList[SlotIndex].TaskQueueLock);
+	WorkerSlotList[SlotIndex].TaskQueue.push_back(std::move(Task));
+	++WorkerSlotList[SlotIndex].TaskCount;
+	++TaskPendingNum;
+	TaskQueueMutex.unlock();
+
+//Wake up one idle worker.
+	if (WorkerIdleNum.load() > 0)
+	{
+		std::unique_lock<std::mutex> WorkerIdleMutex(WorkerIdleLock);
+		WorkerIdleMutex.unlock();
+		WorkerIdleCondition.notify_one();
+	}
+//All workers are busy, start an extra worker.
+	else if (WorkerRunningNum.load() < WorkerMaxNum)
+	{
+		std::lock_guard<std::mutex> WorkerExtraMutex(WorkerExtraLock);
+		for (size_t Index = WorkerBaseNum;!IsShutdown && Index < WorkerMaxNum;++Index)
+		{
+			if (!WorkerSlotList[Index].IsRunning)
+			{
+				StartWorker(Index);
+				break;
+			}
+		}
+	}
+
+	return true;
+}
+
+//TaskExecutorTable class Shutdown function
+void TaskExecutorTable::Shutdown(
+	void)
+{
+	if (!WorkerSlotList || IsShutdown.exchange(true))
+		return;
+
+//Wake up all idle workers.
+	std::unique_lock<std::mutex> WorkerIdleMutex(WorkerIdleLock);
+	WorkerIdleMutex.unlock();
+	WorkerIdleCondition.notify_all();
+
+//Wait all running tasks and drop all tasks which are not started.
+	std::lock_guard<std::mutex> WorkerExtraMutex(WorkerExtraLock);
+	for (size_t Index = 0;Index < WorkerMaxNum;++Index)
+	{
+		if (WorkerSlotList[Index].WorkerThread.joinable())
+		{
+			if (WorkerSlotList[Index].WorkerThread.get_id() == std::this_thread::get_id())
+				WorkerSlotList[Index].WorkerThread.detach();
+			else 
+				WorkerSlotList[Index].WorkerThread.join();
+		}
+
+		std::lock_guard<std::mutex> TaskQueueMutex(WorkerSlotList[Index].TaskQueueLock);
+		WorkerSlotList[Index].TaskQueue.clear();
+		WorkerSlotList[Index].TaskCount = 0;
+	}
+
+	TaskPendingNum = 0;
+	return;
+}
+
+//TaskExecutorTable class Status function
+void TaskExecutorTable::Status(
+	size_t &RunningNum, 
+	size_t &IdleNum, 
+	size_t &PendingNum)
+{
+	RunningNum = WorkerRunningNum.load();
+	IdleNum = WorkerIdleNum.load();
+	PendingNum = TaskPendingNum.load();
+
+	return;
+}
+
+//TaskExecutorTable class destructor
+TaskExecutorTable::~TaskExecutorTable(
+	void)
+{
+	Shutdown();
+
+	return;
+}
+
+//TaskExecutorTable class StartWorker function
+bool TaskExecutorTable::StartWorker(
+	const size_t SlotIndex)
+{
+//Old thread in slot must be finished.
+	if (WorkerSlotList[SlotIndex].WorkerThread.joinable())
+		WorkerSlotList[SlotIndex].WorkerThread.join();
+
+//Start worker thread.
+	WorkerSlotList[SlotIndex].IsRunning = true;
+	++WorkerRunningNum;
+	try {
+		WorkerSlotList[SlotIndex].WorkerThread = std::thread(std::bind(&TaskExecutorTable::WorkerProcess, this, SlotIndex));
+	}
+	catch (std::system_error &Error)
+	{
+		WorkerSlotList[SlotIndex].IsRunning = false;
+		--WorkerRunningNum;
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Task executor worker initialization error", Error.code().value(), nullptr, 0);
+
+		return false;
+	}
+
+	return true;
+}
+
+//TaskExecutorTable class PopTask function
+bool TaskExecutorTable::PopTask(
+	const size_t SlotIndex, 
+	EXECUTOR_TASK &Task, 
+	const bool IsBlockingSteal)
+{
+//Pop from the back of own deque.
+	if (WorkerSlotList[SlotIndex].TaskCount.load() > 0)
+	{
+		std::lock_guard<std::mutex> TaskQueueMutex(WorkerSlotList[SlotIndex].TaskQueueLock);
+		if (!WorkerSlotList[SlotIndex].TaskQueue.empty())
+		{
+			Task = std::move(WorkerSlotList[SlotIndex].TaskQueue.back());
+			WorkerSlotList[SlotIndex].TaskQueue.pop_back();
+			--WorkerSlotList[SlotIndex].TaskCount;
+			--TaskPendingNum;
+
+			return true;
+		}
+	}
+
+//Steal from the front of other deques, skip deques which are locked by others unless blocking steal is required.
+	for (size_t Offset = 1U;Offset < WorkerMaxNum;++Offset)
+	{
+		auto &SlotItem = WorkerSlotList[(SlotIndex + Offset) % WorkerMaxNum];
+		if (SlotItem.TaskCount.load() > 0)
+		{
+			std::unique_lock<std::mutex> TaskQueueMutex(SlotItem.TaskQueueLock, std::defer_lock);
+			if (IsBlockingSteal)
+				TaskQueueMutex.lock();
+			else 
+				TaskQueueMutex.try_lock();
+			if (TaskQueueMutex.owns_lock() && !SlotItem.TaskQueue.empty())
+			{
+				Task = std::move(SlotItem.TaskQueue.front());
+				SlotItem.TaskQueue.pop_front();
+				--SlotItem.TaskCount;
+				--TaskPendingNum;
+
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+//TaskExecutorTable class WorkerProcess function
+void TaskExecutorTable::WorkerProcess(
+	const size_t SlotIndex)
+{
+//Initialization
+	TaskExecutor_Current = this;
+	TaskExecutor_WorkerIndex = SlotIndex;
+	const auto SendBuffer = std::make_unique<uint8_t[]>(WorkerBufferSize + MEMORY_RESERVED_BYTES);
+	const auto RecvBuffer = std::make_unique<uint8_t[]>(WorkerBufferSize + MEMORY_RESERVED_BYTES);
+	memset(SendBuffer.get(), 0, WorkerBufferSize + MEMORY_RESERVED_BYTES);
+	memset(RecvBuffer.get(), 0, WorkerBufferSize + MEMORY_RESERVED_BYTES);
+	EXECUTOR_TASK Task;
+
+//Start worker.
+	while (!IsShutdown)
+	{
+		if (PopTask(SlotIndex, Task, false) || PopTask(SlotIndex, Task, true))
+		{
+			Task(SendBuffer.get(), RecvBuffer.get(), WorkerBufferSize);
+			Task = nullptr;
+
+		//Reset parameters.
+			memset(SendBuffer.get(), 0, WorkerBufferSize + MEMORY_RESERVED_BYTES);
+			memset(RecvBuffer.get(), 0, WorkerBufferSize + MEMORY_RESERVED_BYTES);
+			continue;
+		}
+
+	//Wait for new tasks until Submit wakes up, extra workers exit after idle time is over.
+	//Blocking steal visits all deques, pending tasks which are still found here were submitted after it and they are taken in next round.
+		std::unique_lock<std::mutex> WorkerIdleMutex(WorkerIdleLock);
+		++WorkerIdleNum;
+		if (SlotIndex < WorkerBaseNum || WorkerResetTime == 0)
+		{
+			WorkerIdleCondition.wait(WorkerIdleMutex, [this](){return TaskPendingNum.load() > 0 || IsShutdown;});
+		}
+		else if (!WorkerIdleCondition.wait_for(WorkerIdleMutex, std::chrono::milliseconds(WorkerResetTime), [this](){return TaskPendingNum.load() > 0 || IsShutdown;}))
+		{
+			--WorkerIdleNum;
+			break;
+		}
+
+		--WorkerIdleNum;
+	}
+
+//Release slot.
+	--WorkerRunningNum;
+	WorkerSlotList[SlotIndex].IsRunning = false;
+	return;
+}
+
+//QueryDescriptorPoolTable class constructor
+QueryDescriptorPoolTable::QueryDescriptorPoolTable(
+	void)
+{
+	DescriptorNum = 0;
+	FreeIndexNum = 0;
+
+	return;
+}
+
+//QueryDescriptorPoolTable class Initialize function
+bool QueryDescriptorPoolTable::Initialize(
+	const size_t Num)
+{
+//Pool can only be initialized once.
+	if (DescriptorList || Num == 0)
+		return false;
+
+//Allocate all descriptors and packet buffers.
+	try {
+		DescriptorList = std::make_unique<MONITOR_QUEUE_DATA[]>(Num);
+		PacketBufferList = std::make_unique<uint8_t[]>((PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Num);
+		DomainBufferList = std::make_unique<uint8_t[]>(DOMAIN_MAXSIZE * 2U * Num);
+		FreeIndexList = std::make_unique<size_t[]>(Num);
+		for (size_t Index = 0;Index < Num;++Index)
+		{
+			DescriptorList[Index].MONITOR_QUEUE_DATA_DNS_PACKET.Records_Location.reserve(DNS_QUERY_RECORD_RESERVED_NUM);
+			DescriptorList[Index].MONITOR_QUEUE_DATA_DNS_PACKET.Records_Length.reserve(DNS_QUERY_RECORD_RESERVED_NUM);
+		}
+	}
+	catch (std::bad_alloc &)
+	{
+		DescriptorList.reset();
+		PacketBufferList.reset();
+		DomainBufferList.reset();
+		FreeIndexList.reset();
+		PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Memory allocation error", 0, nullptr, 0);
+
+		return false;
+	}
+	memset(PacketBufferList.get(), 0, (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Num);
+	memset(DomainBufferList.get(), 0, DOMAIN_MAXSIZE * 2U * Num);
+	for (size_t Index = 0;Index < Num;++Index)
+	{
+		auto &PacketStructure = DescriptorList[Index].MONITOR_QUEUE_DATA_DNS_PACKET;
+		PacketStructure.Buffer = nullptr;
+		PacketStructure.BufferSize = 0;
+		PacketStructure.Length = 0;
+		memset(&PacketStructure.LocalTarget, 0, sizeof(PacketStructure.LocalTarget));
+		PacketStructure.Protocol = 0;
+		PacketStructure.QueryType = 0;
+		PacketStructure.IsLocalRequest = false;
+		PacketStructure.IsLocalInWhite = false;
+		PacketStructure.Records_QuestionLen = 0;
+		PacketStructure.Records_AnswerCount = 0;
+		PacketStructure.Records_AuthorityCount = 0;
+		PacketStructure.Records_AdditionalCount = 0;
+		PacketStructure.Records_Num = 0;
+		PacketStructure.DomainString_Original = DomainBufferList.get() + DOMAIN_MAXSIZE * 2U * Index;
+		PacketStructure.DomainString_Request = PacketStructure.DomainString_Original + DOMAIN_MAXSIZE;
+		PacketStructure.EDNS_Location = 0;
+		PacketStructure.EDNS_Length = 0;
+		memset(&DescriptorList[Index].MONITOR_QUEUE_DATA_SOCKET, 0, sizeof(DescriptorList[Index].MONITOR_QUEUE_DATA_SOCKET));
+		DescriptorList[Index].MONITOR_QUEUE_DATA_SOCKET.Socket = INVALID_SOCKET;
+		FreeIndexList[Index] = Num - Index - 1U;
+	}
+	DescriptorNum = Num;
+	FreeIndexNum = Num;
+
+	return true;
+}
+
+//QueryDescriptorPoolTable class Acquire function
+bool QueryDescriptorPoolTable::Acquire(
+	size_t &Index, 
+	const bool IsWait)
+{
+	std::unique_lock<std::mutex> FreeIndexMutex(FreeIndexLock);
+	if (FreeIndexNum == 0)
+	{
+	//Wait for descriptors which are released by workers.
+		if (!IsWait || 
+			!FreeIndexCondition.wait_for(FreeIndexMutex, std::chrono::milliseconds(STANDARD_TIMEOUT), [this](){return FreeIndexNum > 0;}))
+				return false;
+	}
+
+//Pop from free list.
+	Index = FreeIndexList[--FreeIndexNum];
+	return true;
+}
+
+//QueryDescriptorPoolTable class Release function
+void QueryDescriptorPoolTable::Release(
+	const size_t Index)
+{
+	std::unique_lock<std::mutex> FreeIndexMutex(FreeIndexLock);
+	if (Index < DescriptorNum && FreeIndexNum < DescriptorNum)
+	{
+		FreeIndexList[FreeIndexNum++] = Index;
+		if (FreeIndexNum == 1U)
+		{
+			FreeIndexMutex.unlock();
+			FreeIndexCondition.notify_one();
+		}
+	}
+
+	return;
+}
+
+//QueryDescriptorPoolTable class Descriptor function
+MONITOR_QUEUE_DATA &QueryDescriptorPoolTable::Descriptor(
+	const size_t Index)
+{
+	return DescriptorList[Index];
+}
+
+//QueryDescriptorPoolTable class PacketBuffer function
+uint8_t *QueryDescriptorPoolTable::PacketBuffer(
+	const size_t Index)
+{
+	return PacketBufferList.get() + (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Index;
+}
+
+//QueryDescriptorPoolTable class UsedNum function
+size_t QueryDescriptorPoolTable::UsedNum(
+	void)
+{
+	std::lock_guard<std::mutex> FreeIndexMutex(FreeIndexLock);
+	return DescriptorNum - FreeIndexNum;
+}
+
 #if defined(ENABLE_PCAP)
 //CaptureDeviceTable class constructor
 CaptureDeviceTable::CaptureDeviceTable(
@@ -1238,13 +1725,187 @@ OutputPacketTable::OutputPacketTable(
 	memset(&SocketData_Input, 0, sizeof(SocketData_Input));
 	SocketData_Input.Socket = INVALID_SOCKET;
 	ReceiveIndex = 0;
+	IsMatched = false;
 	Protocol_Network = 0;
 	Protocol_Transport = 0;
+	DNS_ID = 0;
 	ClearPortTime = 0;
+	SendTime = std::chrono::steady_clock::now();
+	memset(DomainString_Original, 0, sizeof(DomainString_Original));
+	memset(DomainString_Request, 0, sizeof(DomainString_Request));
 //	EDNS_Length = 0;
 
 	return;
 }
+
+//OutputPacketPortTable class constructor
+OutputPacketPortTable::OutputPacketPortTable(
+	void)
+{
+	TimerTick = 0;
+	return;
+}
+
+//OutputPacketPortTable class GetPortKey function
+uint64_t OutputPacketPortTable::GetPortKey(
+	const uint16_t Protocol, 
+	const uint16_t Port, 
+	const uint16_t DNS_ID)
+{
+	return (static_cast<const uint64_t>(Protocol) << (sizeof(uint32_t) * BYTES_TO_BITS)) | 
+		(static_cast<const uint64_t>(Port) << (sizeof(uint16_t) * BYTES_TO_BITS)) | 
+		static_cast<const uint64_t>(DNS_ID);
+}
+
+//OutputPacketPortTable class GetShardIndex function
+size_t OutputPacketPortTable::GetShardIndex(
+	const uint64_t PortKey)
+{
+	return static_cast<const size_t>((PortKey ^ (PortKey >> (sizeof(uint16_t) * BYTES_TO_BITS))) % OUTPUT_PACKET_SHARD_NUM);
+}
+
+//OutputPacketPortTable class Register function
+void OutputPacketPortTable::Register(
+	const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem)
+{
+//Index all sending ports, the newest request always owns the port.
+	for (const auto &SocketDataItem:PortItem->SocketData_Output)
+	{
+		uint64_t PortKey = 0;
+		if (SocketDataItem.SockAddr.ss_family == AF_INET6)
+			PortKey = GetPortKey(AF_INET6, reinterpret_cast<const sockaddr_in6 *>(&SocketDataItem.SockAddr)->sin6_port, PortItem->DNS_ID);
+		else if (SocketDataItem.SockAddr.ss_family == AF_INET)
+			PortKey = GetPortKey(AF_INET, reinterpret_cast<const sockaddr_in *>(&SocketDataItem.SockAddr)->sin_port, PortItem->DNS_ID);
+		else 
+			continue;
+
+		const auto ShardIndex = GetShardIndex(PortKey);
+		std::lock_guard<std::mutex> ShardMutex(ShardLock.at(ShardIndex));
+		ShardPortMap.at(ShardIndex)[PortKey] = PortItem;
+	}
+
+//Add to timer wheel, slot which has been swept is never used.
+//Tick must be read under timer lock, or sweeping may pass the slot before the item is added.
+	std::lock_guard<std::mutex> TimerMutex(TimerLock);
+	const auto Tick = std::max(PortItem->ClearPortTime / OUTPUT_PACKET_TIMER_INTERVAL, TimerTick.load());
+	TimerWheel.at(Tick % OUTPUT_PACKET_TIMER_SLOT_NUM).push_back(PortItem);
+
+	return;
+}
+
+//OutputPacketPortTable class Match function
+std::shared_ptr<OUTPUT_PACKET_TABLE> OutputPacketPortTable::Match(
+	const uint16_t Protocol, 
+	const uint16_t Port, 
+	const uint16_t DNS_ID)
+{
+	const auto PortKey = GetPortKey(Protocol, Port, DNS_ID);
+	const auto ShardIndex = GetShardIndex(PortKey);
+	std::lock_guard<std::mutex> ShardMutex(ShardLock.at(ShardIndex));
+	const auto PortItem = ShardPortMap.at(ShardIndex).find(PortKey);
+	if (PortItem != ShardPortMap.at(ShardIndex).end() && !PortItem->second->IsMatched)
+		return PortItem->second;
+
+	return nullptr;
+}
+
+//OutputPacketPortTable class Take function
+bool OutputPacketPortTable::Take(
+	const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem)
+{
+//Only one response can take the item.
+	if (PortItem->IsMatched.exchange(true))
+		return false;
+
+	Unregister(PortItem);
+	return true;
+}
+
+//OutputPacketPortTable class Unregister function
+void OutputPacketPortTable::Unregister(
+	const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem)
+{
+	for (const auto &SocketDataItem:PortItem->SocketData_Output)
+	{
+		uint64_t PortKey = 0;
+		if (SocketDataItem.SockAddr.ss_family == AF_INET6)
+			PortKey = GetPortKey(AF_INET6, reinterpret_cast<const sockaddr_in6 *>(&SocketDataItem.SockAddr)->sin6_port, PortItem->DNS_ID);
+		else if (SocketDataItem.SockAddr.ss_family == AF_INET)
+			PortKey = GetPortKey(AF_INET, reinterpret_cast<const sockaddr_in *>(&SocketDataItem.SockAddr)->sin_port, PortItem->DNS_ID);
+		else 
+			continue;
+
+	//Port may be owned by a newer request.
+		const auto ShardIndex = GetShardIndex(PortKey);
+		std::lock_guard<std::mutex> ShardMutex(ShardLock.at(ShardIndex));
+		const auto PortKeyItem = ShardPortMap.at(ShardIndex).find(PortKey);
+		if (PortKeyItem != ShardPortMap.at(ShardIndex).end() && PortKeyItem->second == PortItem)
+			ShardPortMap.at(ShardIndex).erase(PortKeyItem);
+	}
+
+	return;
+}
+
+//OutputPacketPortTable class ClearExpired function
+void OutputPacketPortTable::ClearExpired(
+	void)
+{
+//Slots of current tick have been swept or other thread is sweeping.
+	const auto CurrentTime = GetCurrentSystemTime();
+	const auto CurrentTick = CurrentTime / OUTPUT_PACKET_TIMER_INTERVAL;
+	if (CurrentTick < TimerTick)
+		return;
+	std::unique_lock<std::mutex> TimerMutex(TimerLock, std::try_to_lock);
+	if (!TimerMutex.owns_lock())
+		return;
+
+//Sweep each slot from last tick to current tick, whole wheel is swept at most once.
+	auto Tick = TimerTick.load();
+	if (Tick == 0 || CurrentTick - Tick >= OUTPUT_PACKET_TIMER_SLOT_NUM)
+		Tick = CurrentTick + 1U - OUTPUT_PACKET_TIMER_SLOT_NUM;
+	for (;Tick <= CurrentTick;++Tick)
+	{
+		auto &TimerSlot = TimerWheel.at(Tick % OUTPUT_PACKET_TIMER_SLOT_NUM);
+		for (size_t Index = 0;Index < TimerSlot.size();)
+		{
+		//Item is in next rounds of wheel.
+			if (TimerSlot.at(Index)->ClearPortTime > CurrentTime)
+			{
+				++Index;
+				continue;
+			}
+
+		//Mark timeout.
+			if (!TimerSlot.at(Index)->IsMatched.exchange(true))
+			{
+				Statistics_AddCounter(STATISTICS_COUNTER_UPSTREAM_TIMEOUT);
+				if (TimerSlot.at(Index)->Protocol_Network == AF_INET6)
+				{
+					if (TimerSlot.at(Index)->Protocol_Transport == IPPROTO_TCP)
+						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV6);
+					else if (TimerSlot.at(Index)->Protocol_Transport == IPPROTO_UDP)
+						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV6);
+				}
+				else if (TimerSlot.at(Index)->Protocol_Network == AF_INET)
+				{
+					if (TimerSlot.at(Index)->Protocol_Transport == IPPROTO_TCP)
+						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV4);
+					else if (TimerSlot.at(Index)->Protocol_Transport == IPPROTO_UDP)
+						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV4);
+				}
+
+				Unregister(TimerSlot.at(Index));
+			}
+
+		//Remove item from slot.
+			std::swap(TimerSlot.at(Index), TimerSlot.back());
+			TimerSlot.pop_back();
+		}
+	}
+
+	TimerTick = CurrentTick + 1U;
+	return;
+}
 #endif
 
 #if defined(ENABLE_LIBSODIUM)
@@ -1761,6 +2422,7 @@ OpenSSLContextTable::OpenSSLContextTable(
 	MethodContext = nullptr;
 	SessionBIO = nullptr;
 	SessionData = nullptr;
+	RequestType = REQUEST_PROCESS_TYPE::HTTP_CONNECT_MAIN;
 	Protocol_Network = 0;
 	Protocol_Transport = 0;
 	Socket = INVALID_SOCKET;
@@ -26,7 +26,6 @@
 CONFIGURATION_TABLE Parameter, ParameterModificating;
 GLOBAL_STATUS GlobalRunningStatus;
 ALTERNATE_SWAP_TABLE AlternateSwapList;
-BLOCKING_QUEUE<MONITOR_QUEUE_DATA> MonitorBlockingQueue;
 #if defined(ENABLE_LIBSODIUM)
 DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter, DNSCurveParameterModificating;
 #endif
@@ -40,13 +39,20 @@ std::array<std::vector<DIFFERNET_FILE_SET_HOSTS>, DIFFERNET_FILE_SET_NUM> HostsF
 std::vector<DIFFERNET_FILE_SET_HOSTS> *HostsFileSetUsing = &HostsFileSet.at(0), *HostsFileSetModificating = &HostsFileSet.at(1U);
 std::deque<SOCKET_REGISTER_DATA> SocketRegisterList;
 #if defined(ENABLE_PCAP)
-std::deque<OUTPUT_PACKET_TABLE> OutputPacketList;
-std::mutex CaptureLock, OutputPacketListLock;
+OUTPUT_PACKET_PORT_TABLE OutputPacketList;
+std::mutex CaptureLock;
 #endif
 std::list<DNS_CACHE_DATA> DNSCacheList;
 std::unordered_multimap<std::string, std::list<DNS_CACHE_DATA>::iterator> DNSCacheIndexList;
 std::mutex ScreenLock, SocketRegisterLock, DNSCacheListLock, IPFilterFileLock, HostsFileLock;
 std::array<std::mutex, NETWORK_LAYER_PARTNUM> LocalAddressLock;
+TASK_EXECUTOR_TABLE TaskExecutor;
+thread_local const TASK_EXECUTOR_TABLE *TaskExecutor_Current = nullptr;
+thread_local size_t TaskExecutor_WorkerIndex = 0;
+//Listeners and workers are not joined when process is exiting, so descriptor pool is never destroyed and it is released by system.
+QUERY_DESCRIPTOR_POOL_TABLE &QueryDescriptorPool = *new QUERY_DESCRIPTOR_POOL_TABLE();
+std::unordered_map<SYSTEM_SOCKET, std::shared_ptr<TCP_SESSION_DATA>> TCP_SessionList;
+std::mutex TCP_SessionListLock;
 
 //Functions
 void ConfigurationTableSetting(
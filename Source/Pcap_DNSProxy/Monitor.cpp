@@ -23,6 +23,10 @@
 void MonitorLauncher(
 	void)
 {
+//Log writer
+	std::thread Thread_PrintLogWriter(std::bind(PrintLogWriter));
+	Thread_PrintLogWriter.detach();
+
 //Network monitor(Mark Local DNS address to PTR records)
 	ParameterModificating.SetToMonitorItem();
 	std::thread Thread_NetworkInformationMonitor(std::bind(NetworkInformationMonitor));
@@ -70,6 +74,14 @@ void MonitorLauncher(
 		!(Parameter.SOCKS_Proxy && Parameter.SOCKS_Only) && 
 	//HTTP CONNECT request only mode
 		!(Parameter.HTTP_CONNECT_Proxy && Parameter.HTTP_CONNECT_Only)
+	//DNS over TLS request only mode
+	#if defined(ENABLE_TLS)
+	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		&& !(Parameter.IsDNS_TLS && Parameter.DNS_TLS_Only)
+	//DNS over HTTPS request only mode
+		&& !(Parameter.IsDNS_HTTPS && Parameter.DNS_HTTPS_Only)
+	#endif
+	#endif
 	//DNSCurve request only mode
 	#if defined(ENABLE_LIBSODIUM)
 		&& !(Parameter.IsDNSCurve && DNSCurveParameter.IsEncryptionOnly)
@@ -130,7 +142,7 @@ void MonitorLauncher(
 		Thread_AlternateServerSwitcher.detach();
 	}
 
-//Mailslot and FIFO pipe listener
+//Mailslot, FIFO pipe and statistics listener
 	if (Parameter.IsProcessUnique)
 	{
 	#if defined(PLATFORM_WIN)
@@ -140,6 +152,10 @@ void MonitorLauncher(
 		std::thread Thread_FlushDomainCache_PipeListener(std::bind(FlushDomainCache_PipeListener));
 		Thread_FlushDomainCache_PipeListener.detach();
 	#endif
+
+	//Statistics listener
+		std::thread Thread_StatisticsListener(std::bind(Statistics_Listener));
+		Thread_StatisticsListener.detach();
 	}
 
 	return;
@@ -575,18 +591,33 @@ bool MonitorInit(
 	memset(&LocalSocketData, 0, sizeof(LocalSocketData));
 	LocalSocketData.Socket = INVALID_SOCKET;
 
-//Start monitor request consumer threads.
-	if (Parameter.ThreadPoolBaseNum > 0)
+//Allocate query descriptor pool, each listening socket owns the same number of descriptors as the old request ring.
+	if (!LocalSocketDataList.empty() && !QueryDescriptorPool.Initialize(Parameter.ThreadPoolMaxNum * LocalSocketDataList.size()))
 	{
-		for (size_t MonitorThreadIndex = 0;MonitorThreadIndex < Parameter.ThreadPoolBaseNum;++MonitorThreadIndex)
-		{
-		//Start monitor consumer thread.
-			std::thread Thread_MonitorConsumer(std::bind(MonitorRequestConsumer));
-			Thread_MonitorConsumer.detach();
-		}
+		for (auto &SocketDataItem:LocalSocketDataList)
+			SocketSetting(SocketDataItem.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Query descriptor pool initialization error", 0, nullptr, 0);
 
-		*GlobalRunningStatus.ThreadRunningNum += Parameter.ThreadPoolBaseNum;
-		*GlobalRunningStatus.ThreadRunningFreeNum += Parameter.ThreadPoolBaseNum;
+		return false;
+	}
+
+//Start task executor, base number is the number of hardware threads when it is not set.
+	auto ThreadPoolBaseNum = Parameter.ThreadPoolBaseNum;
+	if (ThreadPoolBaseNum == 0)
+	{
+		ThreadPoolBaseNum = std::thread::hardware_concurrency();
+		if (ThreadPoolBaseNum == 0)
+			ThreadPoolBaseNum = 1U;
+		else if (ThreadPoolBaseNum > Parameter.ThreadPoolMaxNum)
+			ThreadPoolBaseNum = Parameter.ThreadPoolMaxNum;
+	}
+	if (!TaskExecutor.Initialize(ThreadPoolBaseNum, Parameter.ThreadPoolMaxNum, Parameter.ThreadPoolResetTime, Parameter.LargeBufferSize))
+	{
+		for (auto &SocketDataItem:LocalSocketDataList)
+			SocketSetting(SocketDataItem.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Task executor initialization error", 0, nullptr, 0);
+
+		return false;
 	}
 
 //Start all threads.
@@ -659,6 +690,8 @@ bool MonitorInit(
 	for (auto &SocketDataItem:LocalSocketDataList)
 		SocketSetting(SocketDataItem.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
+//Stop task executor.
+	TaskExecutor.Shutdown();
 	return true;
 }
 
@@ -698,6 +731,10 @@ bool ListenMonitor_BindSocket(
 
 			return false;
 		}
+
+	//Accept connections when their first queries arrived.
+		if (!SocketSetting(LocalSocketData.Socket, SOCKET_SETTING_TYPE::TCP_DEFERRED_ACCEPT, true, nullptr))
+			return false;
 	}
 //UDP
 	else if (Protocol == IPPROTO_UDP)
@@ -734,53 +771,45 @@ bool ListenMonitor_UDP(
 	SOCKET_DATA LocalSocketData)
 {
 //Initialization
-	const auto RecvBuffer = std::make_unique<uint8_t[]>((PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Parameter.ThreadPoolMaxNum);
 	const auto SendBuffer = std::make_unique<uint8_t[]>(PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
-	memset(RecvBuffer.get(), 0, (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Parameter.ThreadPoolMaxNum);
 	memset(SendBuffer.get(), 0, PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
-	MONITOR_QUEUE_DATA MonitorQueryData;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = nullptr;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = PACKET_NORMAL_MAXSIZE;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = 0;
-	memset(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = IPPROTO_UDP;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original.clear();
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request.clear();
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
+	MONITOR_QUEUE_DATA *MonitorQueryData = nullptr;
+	size_t DescriptorIndex = 0;
 	fd_set ReadFDS;
 	memset(&ReadFDS, 0, sizeof(ReadFDS));
-	const auto SocketDataPointer = &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET;
 	uint64_t LastRegisterTime = 0, NowTime = 0;
 	if (Parameter.QueueResetTime > 0)
 		LastRegisterTime = GetCurrentSystemTime();
 	ssize_t RecvLen = 0;
-	size_t Index = 0;
+	size_t QueueRegisterNum = 0;
 	int OptionValue = 0;
 	socklen_t OptionSize = sizeof(OptionValue);
 
 //Listening module
 	while (!GlobalRunningStatus.IsNeedExit)
 	{
-	//Interval time between receive
-		if (Parameter.QueueResetTime > 0 && Index + 1U == Parameter.ThreadPoolMaxNum)
+	//Interval time between receive, only ThreadPoolMaxNum requests are registered in each reset time.
+		if (Parameter.QueueResetTime > 0 && QueueRegisterNum >= Parameter.ThreadPoolMaxNum)
 		{
 			NowTime = GetCurrentSystemTime();
 			if (LastRegisterTime + Parameter.QueueResetTime > NowTime)
 				Sleep(LastRegisterTime + Parameter.QueueResetTime - NowTime);
 
 			LastRegisterTime = GetCurrentSystemTime();
+			QueueRegisterNum = 0;
+		}
+
+	//Take a free descriptor, wait for workers when all descriptors are in use.
+		if (MonitorQueryData == nullptr)
+		{
+			if (!QueryDescriptorPool.Acquire(DescriptorIndex, true))
+				continue;
+
+			MonitorQueryData = &QueryDescriptorPool.Descriptor(DescriptorIndex);
 		}
 
 	//Reset parameters(Part 1).
-		MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET = LocalSocketData;
+		MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET = LocalSocketData;
 
 	//Select file descriptor set size and maximum socket index check
 	//Windows: The variable FD_SETSIZE determines the maximum number of descriptors in a set.
@@ -789,18 +818,18 @@ bool ListenMonitor_UDP(
 	//Linux and macOS: Select nfds is the highest-numbered file descriptor in any of the three sets, plus 1.
 	//Linux and macOS: An fd_set is a fixed size buffer.
 	//Linux and macOS: Executing FD_CLR() or FD_SET() with a value of fd that is negative or is equal to or larger than FD_SETSIZE will result in undefined behavior.
-		if (!SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr)
+		if (!SocketSetting(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr)
 		#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			|| MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket + 1U >= FD_SETSIZE
+			|| MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket + 1U >= FD_SETSIZE
 		#endif
 			)
 				break;
 
 	//Reset parameters(Part 2).
-		memset(RecvBuffer.get() + (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Index, 0, PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
+		memset(QueryDescriptorPool.PacketBuffer(DescriptorIndex), 0, PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
 		memset(SendBuffer.get(), 0, PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
 		FD_ZERO(&ReadFDS);
-		FD_SET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS);
+		FD_SET(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS);
 		OptionValue = 0;
 		OptionSize = sizeof(OptionValue);
 
@@ -808,15 +837,20 @@ bool ListenMonitor_UDP(
 	#if defined(PLATFORM_WIN)
 		ssize_t SelectResult = select(0, &ReadFDS, nullptr, nullptr, nullptr);
 	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-		ssize_t SelectResult = select(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket + 1U, &ReadFDS, nullptr, nullptr, nullptr);
+		ssize_t SelectResult = select(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket + 1U, &ReadFDS, nullptr, nullptr, nullptr);
 	#endif
-		if (SelectResult > 0)
+	//Listening sockets are closed when process is exiting, no any messages are printed.
+		if (GlobalRunningStatus.IsNeedExit)
+		{
+			break;
+		}
+		else if (SelectResult > 0)
 		{
-			if (FD_ISSET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS) != 0)
+			if (FD_ISSET(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS) != 0)
 			{
 			//Socket option check
 			//Select will set both reading and writing sets and set SO_ERROR to error code when connection was failed.
-				if (getsockopt(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&OptionValue), &OptionSize) == SOCKET_ERROR)
+				if (getsockopt(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&OptionValue), &OptionSize) == SOCKET_ERROR)
 				{
 					PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"UDP socket connecting error", WSAGetLastError(), nullptr, 0);
 					Sleep(LOOP_INTERVAL_TIME_DELAY);
@@ -832,45 +866,42 @@ bool ListenMonitor_UDP(
 				}
 
 			//Receive response and check DNS query data.
-				RecvLen = recvfrom(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, reinterpret_cast<char *>(RecvBuffer.get() + (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Index), PACKET_NORMAL_MAXSIZE, 0, reinterpret_cast<sockaddr *>(&SocketDataPointer->SockAddr), reinterpret_cast<socklen_t *>(&SocketDataPointer->AddrLen));
+				RecvLen = recvfrom(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, reinterpret_cast<char *>(QueryDescriptorPool.PacketBuffer(DescriptorIndex)), PACKET_NORMAL_MAXSIZE, 0, reinterpret_cast<sockaddr *>(&MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.SockAddr), reinterpret_cast<socklen_t *>(&MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.AddrLen));
 				if (RecvLen < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
 				{
 					continue;
 				}
 				else {
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = RecvBuffer.get() + (PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES) * Index;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = RecvLen;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
-					memset(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_Location.clear();
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_Length.clear();
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original.clear();
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request.clear();
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
-					MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = QueryDescriptorPool.PacketBuffer(DescriptorIndex);
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = PACKET_NORMAL_MAXSIZE;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Length = RecvLen;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = IPPROTO_UDP;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
+					memset(&MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Num = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Location.clear();
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Length.clear();
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original[0] = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request[0] = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
+					MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
 
 				//Check DNS query data.
-					if (!CheckQueryData(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET, SendBuffer.get(), PACKET_NORMAL_MAXSIZE, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET))
+					if (!CheckQueryData(&MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET, SendBuffer.get(), PACKET_NORMAL_MAXSIZE, MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET))
 						continue;
 				}
 
-			//Request process
-				if (Parameter.ThreadPoolBaseNum > 0) //Thread pool mode
-				{
-					MonitorRequestProvider(MonitorQueryData);
-				}
-				else { //New thread mode
-					std::thread Thread_RequestProcess(std::bind(EnterRequestProcess, MonitorQueryData, nullptr, 0));
-					Thread_RequestProcess.detach();
-				}
-
-				Index = (Index + 1U) % Parameter.ThreadPoolMaxNum;
+			//Request process, descriptor belongs to worker from now on.
+				MonitorRequestProvider(DescriptorIndex);
+				MonitorQueryData = nullptr;
+				if (Parameter.QueueResetTime > 0)
+					++QueueRegisterNum;
 			}
 			else {
 				Sleep(LOOP_INTERVAL_TIME_DELAY);
@@ -897,6 +928,8 @@ bool ListenMonitor_UDP(
 	}
 
 //Loop terminated
+	if (MonitorQueryData != nullptr)
+		QueryDescriptorPool.Release(DescriptorIndex);
 	SocketSetting(LocalSocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 	if (!GlobalRunningStatus.IsNeedExit)
 		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"UDP listening module Monitor terminated", 0, nullptr, 0);
@@ -908,44 +941,29 @@ bool ListenMonitor_TCP(
 	SOCKET_DATA LocalSocketData)
 {
 //Initialization
-	MONITOR_QUEUE_DATA MonitorQueryData;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = nullptr;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = Parameter.LargeBufferSize;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = 0;
-	memset(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = IPPROTO_TCP;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original.clear();
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request.clear();
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
+	MONITOR_QUEUE_DATA *MonitorQueryData = nullptr;
+	size_t DescriptorIndex = 0;
 	fd_set ReadFDS;
 	memset(&ReadFDS, 0, sizeof(ReadFDS));
-	const auto SocketDataPointer = &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET;
 	uint64_t LastRegisterTime = 0, NowTime = 0;
 	if (Parameter.QueueResetTime > 0)
 		LastRegisterTime = GetCurrentSystemTime();
-	size_t Index = 0;
+	size_t QueueRegisterNum = 0;
 	int OptionValue = 0;
 	socklen_t OptionSize = sizeof(OptionValue);
 
 //Start listening Monitor.
 	while (!GlobalRunningStatus.IsNeedExit)
 	{
-	//Interval time between receive
-		if (Parameter.QueueResetTime > 0 && Index + 1U == Parameter.ThreadPoolMaxNum)
+	//Interval time between receive, only ThreadPoolMaxNum requests are registered in each reset time.
+		if (Parameter.QueueResetTime > 0 && QueueRegisterNum >= Parameter.ThreadPoolMaxNum)
 		{
 			NowTime = GetCurrentSystemTime();
 			if (LastRegisterTime + Parameter.QueueResetTime > NowTime)
 				Sleep(LastRegisterTime + Parameter.QueueResetTime - NowTime);
 
 			LastRegisterTime = GetCurrentSystemTime();
+			QueueRegisterNum = 0;
 		}
 
 	//Select file descriptor set size and maximum socket index check
@@ -962,10 +980,23 @@ bool ListenMonitor_TCP(
 			)
 				break;
 
+	//Take a free descriptor, wait for workers when all descriptors are in use.
+		if (MonitorQueryData == nullptr)
+		{
+			if (!QueryDescriptorPool.Acquire(DescriptorIndex, true))
+				continue;
+
+			MonitorQueryData = &QueryDescriptorPool.Descriptor(DescriptorIndex);
+			MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = nullptr;
+			MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = Parameter.LargeBufferSize;
+			MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Length = 0;
+			MonitorQueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = IPPROTO_TCP;
+		}
+
 	//Reset parameters.
-		memset(&MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.SockAddr, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.SockAddr));
-		MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.AddrLen = LocalSocketData.AddrLen;
-		MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.SockAddr.ss_family = LocalSocketData.SockAddr.ss_family;
+		memset(&MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.SockAddr, 0, sizeof(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.SockAddr));
+		MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.AddrLen = LocalSocketData.AddrLen;
+		MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.SockAddr.ss_family = LocalSocketData.SockAddr.ss_family;
 		FD_ZERO(&ReadFDS);
 		FD_SET(LocalSocketData.Socket, &ReadFDS);
 		OptionValue = 0;
@@ -977,7 +1008,12 @@ bool ListenMonitor_TCP(
 	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
 		ssize_t SelectResult = select(LocalSocketData.Socket + 1U, &ReadFDS, nullptr, nullptr, nullptr);
 	#endif
-		if (SelectResult > 0)
+	//Listening sockets are closed when process is exiting, no any messages are printed.
+		if (GlobalRunningStatus.IsNeedExit)
+		{
+			break;
+		}
+		else if (SelectResult > 0)
 		{
 			if (FD_ISSET(LocalSocketData.Socket, &ReadFDS) != 0)
 			{
@@ -999,29 +1035,23 @@ bool ListenMonitor_TCP(
 				}
 
 			//Accept connection.
-				MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket = accept(LocalSocketData.Socket, reinterpret_cast<sockaddr *>(&SocketDataPointer->SockAddr), &SocketDataPointer->AddrLen);
-				if (!SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+				MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket = accept(LocalSocketData.Socket, reinterpret_cast<sockaddr *>(&MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.SockAddr), &MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.AddrLen);
+				if (!SocketSetting(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
 				{
 					continue;
 				}
 			//Check request address.
-				else if (!CheckQueryData(nullptr, nullptr, 0, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET))
+				else if (!CheckQueryData(nullptr, nullptr, 0, MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET))
 				{
-					SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+					SocketSetting(MonitorQueryData->MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 					continue;
 				}
 
-			//Accept process.
-				if (Parameter.ThreadPoolBaseNum > 0) //Thread pool mode
-				{
-					MonitorRequestProvider(MonitorQueryData);
-				}
-				else { //New thread mode
-					std::thread Thread_TCP_AcceptProcess(std::bind(TCP_AcceptProcess, MonitorQueryData, nullptr, 0));
-					Thread_TCP_AcceptProcess.detach();
-				}
-
-				Index = (Index + 1U) % Parameter.ThreadPoolMaxNum;
+			//Accept process, descriptor belongs to worker from now on.
+				MonitorRequestProvider(DescriptorIndex);
+				MonitorQueryData = nullptr;
+				if (Parameter.QueueResetTime > 0)
+					++QueueRegisterNum;
 			}
 			else {
 				Sleep(LOOP_INTERVAL_TIME_DELAY);
@@ -1048,6 +1078,8 @@ bool ListenMonitor_TCP(
 	}
 
 //Loop terminated
+	if (MonitorQueryData != nullptr)
+		QueryDescriptorPool.Release(DescriptorIndex);
 	SocketSetting(LocalSocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 	if (!GlobalRunningStatus.IsNeedExit)
 		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"TCP listening module Monitor terminated", 0, nullptr, 0);
@@ -1055,12 +1087,13 @@ bool ListenMonitor_TCP(
 }
 
 //TCP Monitor accept process
+//Connection is kept open for pipelined queries(RFC 7766), it is closed when it is idle, finished by requester or limits are reached.
 bool TCP_AcceptProcess(
-	MONITOR_QUEUE_DATA MonitorQueryData, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	uint8_t * const OriginalRecv, 
 	size_t RecvSize)
 {
-//Select file descriptor set size and maximum socket index check(Part 1)
+//Select file descriptor set size and maximum socket index check
 //Windows: The variable FD_SETSIZE determines the maximum number of descriptors in a set.
 //Windows: The default value of FD_SETSIZE is 64, which can be modified by defining FD_SETSIZE to another value before including Winsock2.h.
 //Windows: Internally, socket handles in an fd_set structure are not represented as bit flags as in Berkeley Unix.
@@ -1077,196 +1110,367 @@ bool TCP_AcceptProcess(
 		return false;
 	}
 
-//Initialization(Part 1)
+//Responses are sent by request workers, sending to requester which is not receiving must not block them.
+//Pipelined responses are small and must not wait for acknowledgements of previous ones.
+	if (!SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::TIMEOUT, false, &Parameter.SocketTimeout_Reliable_Once) || 
+		!SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::TCP_NO_DELAY, false, nullptr))
+			return false;
+
+//Initialization
 	const auto RecvBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	const auto QueryBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	const auto SendBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
 	memset(RecvBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	memset(QueryBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	const auto SessionData = std::make_shared<TCP_SESSION_DATA>();
+	SessionData->SocketData = MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET;
+	SessionData->LastActiveTime = GetCurrentSystemTime();
+	SessionData->IsFinished = false;
+	SessionData->IsClosed = false;
+	const auto Socket = SessionData->SocketData.Socket;
 	fd_set ReadFDS;
 	timeval Timeout;
 	memset(&ReadFDS, 0, sizeof(ReadFDS));
 	memset(&Timeout, 0, sizeof(Timeout));
-	ssize_t RecvLenFirst = 0, RecvLenSecond = 0;
+	size_t RecvLen = 0, QueryNum = 0, QueryMaxNum = TCP_SESSION_QUERY_MAXNUM;
+	uint64_t NowTime = 0, WaitTime = 0;
 	int OptionValue = 0;
 	socklen_t OptionSize = sizeof(OptionValue);
 
-//Socket selecting structure initialization(Part 1)
-#if defined(PLATFORM_WIN)
-	Timeout.tv_sec = Parameter.SocketTimeout_Reliable_Once / SECOND_TO_MILLISECOND;
-	Timeout.tv_usec = Parameter.SocketTimeout_Reliable_Once % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND;
-#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-	Timeout = Parameter.SocketTimeout_Reliable_Once;
-#endif
-	FD_ZERO(&ReadFDS);
-	FD_SET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS);
+//Register session, each session holds a worker and connections over the limit only have one request like normal TCP connections.
+	std::unique_lock<std::mutex> SessionListMutex(TCP_SessionListLock);
+	if (TCP_SessionList.size() >= Parameter.ThreadPoolMaxNum / 2U)
+		QueryMaxNum = 1U;
+	TCP_SessionList[Socket] = SessionData;
+	SessionListMutex.unlock();
 
 //Receive process
-//Only receive 2 times data sending operations from sender when accepting, reject all connections which have more than 2 times sending operations.
-#if defined(PLATFORM_WIN)
-	RecvLenFirst = select(0, &ReadFDS, nullptr, nullptr, &Timeout);
-#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-	RecvLenFirst = select(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket + 1U, &ReadFDS, nullptr, nullptr, &Timeout);
-#endif
-	if (RecvLenFirst > 0 && 
-		FD_ISSET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS) != 0)
+	while (!GlobalRunningStatus.IsNeedExit)
 	{
-	//Socket option check
-	//Select will set both reading and writing sets and set SO_ERROR to error code when connection was failed.
-		if (getsockopt(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&OptionValue), &OptionSize) == SOCKET_ERROR)
+	//Send all complete queries in buffer to request process.
+		while (RecvLen >= sizeof(uint16_t) && QueryNum < QueryMaxNum)
 		{
-//			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"TCP socket connecting error", WSAGetLastError(), nullptr, 0);
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-			return false;
-		}
-		else if (OptionValue > 0)
-		{
-//			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"TCP socket connecting error", OptionValue, nullptr, 0);
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		//Length check
+			const auto LengthValue = ntoh16(reinterpret_cast<const uint16_t *>(RecvBuffer.get())[0]);
+			if (LengthValue < DNS_PACKET_MINSIZE || LengthValue + sizeof(uint16_t) >= Parameter.LargeBufferSize)
+			{
+				std::lock_guard<std::mutex> SessionMutex(SessionData->SessionLock);
+				SessionData->IsFinished = true;
 
-			return false;
-		}
+				break;
+			}
+			else if (RecvLen < LengthValue + sizeof(uint16_t))
+			{
+				break;
+			}
 
-	//Receive data.
-		RecvLenFirst = recv(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, reinterpret_cast<char *>(RecvBuffer.get()), static_cast<const int>(Parameter.LargeBufferSize), 0);
+		//Wait for responses when the limit of pipelined queries is reached.
+			if (!TCP_SessionWait(*SessionData, TCP_SESSION_PIPELINE_MAXNUM - 1U) || 
+				!TCP_SessionRequest(MonitorQueryData, *SessionData, RecvBuffer.get() + sizeof(uint16_t), LengthValue, QueryBuffer.get(), SendBuffer.get(), OriginalRecv, RecvSize, QueryMaxNum == 1U))
+					break;
 
-	//Connection closed or SOCKET_ERROR
-		if (RecvLenFirst < static_cast<const ssize_t>(sizeof(uint16_t))) //Sender must send packet length value(16 bits) at first.
-		{
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-			return false;
-		}
-	}
-//Timeout or SOCKET_ERROR
-	else {
-		SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		return false;
-	}
-
-//Connection closed or SOCKET_ERROR
-	if (RecvLenFirst < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
-	{
-	//Select file descriptor set size and maximum socket index check(Part 2)
-		if (!SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr)
-		#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			|| MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket + 1U >= FD_SETSIZE
-		#endif
-			)
-		{
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-			return false;
+		//Remove query from buffer.
+			++QueryNum;
+			RecvLen -= LengthValue + sizeof(uint16_t);
+			if (RecvLen > 0)
+				memmove_s(RecvBuffer.get(), Parameter.LargeBufferSize, RecvBuffer.get() + LengthValue + sizeof(uint16_t), RecvLen);
 		}
 
-	//Socket selecting structure initialization(Part 2)
+	//Session status check and idle time calculation
+		std::unique_lock<std::mutex> SessionMutex(SessionData->SessionLock);
+		if (SessionData->IsFinished || SessionData->IsClosed || QueryNum >= QueryMaxNum)
+			break;
+		NowTime = GetCurrentSystemTime();
+		while (!SessionData->PendingList.empty() && SessionData->PendingList.front().second + TCP_SESSION_IDLE_TIME <= NowTime)
+			SessionData->PendingList.pop_front();
+		WaitTime = SessionData->LastActiveTime + TCP_SESSION_IDLE_TIME;
+		if (!SessionData->PendingList.empty() && SessionData->PendingList.front().second + TCP_SESSION_IDLE_TIME > WaitTime)
+			WaitTime = SessionData->PendingList.front().second + TCP_SESSION_IDLE_TIME;
+		SessionMutex.unlock();
+		if (WaitTime <= NowTime)
+			break;
+		WaitTime -= NowTime;
+		if (WaitTime > STANDARD_TIMEOUT)
+			WaitTime = STANDARD_TIMEOUT;
+
+	//Socket selecting structure initialization
 		memset(&ReadFDS, 0, sizeof(ReadFDS));
 		memset(&Timeout, 0, sizeof(Timeout));
-	#if defined(PLATFORM_WIN)
-		Timeout.tv_sec = Parameter.SocketTimeout_Reliable_Once / SECOND_TO_MILLISECOND;
-		Timeout.tv_usec = Parameter.SocketTimeout_Reliable_Once % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND;
-	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-		Timeout = Parameter.SocketTimeout_Reliable_Once;
-	#endif
+		Timeout.tv_sec = static_cast<const decltype(Timeout.tv_sec)>(WaitTime / SECOND_TO_MILLISECOND);
+		Timeout.tv_usec = static_cast<const decltype(Timeout.tv_usec)>(WaitTime % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND);
 		FD_ZERO(&ReadFDS);
-		FD_SET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS);
+		FD_SET(Socket, &ReadFDS);
 		OptionValue = 0;
 		OptionSize = sizeof(OptionValue);
 
 	//Wait for system calling.
 	#if defined(PLATFORM_WIN)
-		RecvLenSecond = select(0, &ReadFDS, nullptr, nullptr, &Timeout);
+		const auto SelectResult = select(0, &ReadFDS, nullptr, nullptr, &Timeout);
 	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-		RecvLenSecond = select(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket + 1U, &ReadFDS, nullptr, nullptr, &Timeout);
+		const auto SelectResult = select(Socket + 1U, &ReadFDS, nullptr, nullptr, &Timeout);
 	#endif
-		if (RecvLenSecond > 0 && 
-			FD_ISSET(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, &ReadFDS) != 0)
+		if (SelectResult > 0 && FD_ISSET(Socket, &ReadFDS) != 0)
 		{
 		//Socket option check
 		//Select will set both reading and writing sets and set SO_ERROR to error code when connection was failed.
-			if (getsockopt(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&OptionValue), &OptionSize) == SOCKET_ERROR)
-			{
-//				PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"TCP socket connecting error", WSAGetLastError(), nullptr, 0);
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-				return false;
-			}
-			else if (OptionValue > 0)
-			{
-//				PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"TCP socket connecting error", OptionValue, nullptr, 0);
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-				return false;
-			}
+			if (getsockopt(Socket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char *>(&OptionValue), &OptionSize) == SOCKET_ERROR || OptionValue > 0)
+				break;
 
-		//Receive data.
-			RecvLenSecond = recv(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, reinterpret_cast<char *>(RecvBuffer.get() + RecvLenFirst), static_cast<const int>(Parameter.LargeBufferSize - RecvLenFirst), 0);
+		//Receive data, connection closed or SOCKET_ERROR
+			const auto RecvResult = recv(Socket, reinterpret_cast<char *>(RecvBuffer.get() + RecvLen), static_cast<const int>(Parameter.LargeBufferSize - RecvLen), 0);
+			if (RecvResult <= 0)
+				break;
 
-		//Connection closed or SOCKET_ERROR
-			if (RecvLenSecond <= 0)
-			{
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-				return false;
-			}
+			RecvLen += RecvResult;
+			SessionMutex.lock();
+			SessionData->LastActiveTime = GetCurrentSystemTime();
+			SessionMutex.unlock();
 		}
-	//Timeout or SOCKET_ERROR
-		else {
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-			return false;
+	//SOCKET_ERROR
+		else if (SelectResult < 0)
+		{
+			break;
 		}
 	}
 
-//Length check
-	const auto LengthValue = ntoh16(reinterpret_cast<const uint16_t *>(RecvBuffer.get())[0]);
-	if (LengthValue >= DNS_PACKET_MINSIZE && LengthValue + sizeof(uint16_t) < Parameter.LargeBufferSize && 
-		((RecvLenFirst < static_cast<const ssize_t>(DNS_PACKET_MINSIZE) && RecvLenFirst + RecvLenSecond >= static_cast<const ssize_t>(LengthValue + sizeof(uint16_t))) || 
-		(RecvLenFirst >= static_cast<const ssize_t>(DNS_PACKET_MINSIZE) && RecvLenFirst >= static_cast<const ssize_t>(LengthValue + sizeof(uint16_t)))))
-	{
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = RecvBuffer.get() + sizeof(uint16_t);
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = LengthValue;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
-		memset(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_Location.clear();
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_Length.clear();
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original.clear();
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request.clear();
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
-
-	//Check DNS query data.
-		auto SendBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		if (!CheckQueryData(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET, SendBuffer.get(), Parameter.LargeBufferSize, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET))
-		{
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-			return false;
-		}
-		else {
-			SendBuffer.reset();
-		}
+//Wait for responses of all pending queries.
+	TCP_SessionWait(*SessionData, 0);
 
-	//Main request process
-		EnterRequestProcess(MonitorQueryData, OriginalRecv, RecvSize);
-	}
-	else {
-		SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		return false;
-	}
+//Stop sending responses and unregister session.
+	std::unique_lock<std::mutex> SessionMutex(SessionData->SessionLock);
+	SessionData->IsFinished = true;
+	SessionData->IsClosed = true;
+	SessionMutex.unlock();
+	SessionListMutex.lock();
+	const auto SessionItem = TCP_SessionList.find(Socket);
+	if (SessionItem != TCP_SessionList.end() && SessionItem->second == SessionData)
+		TCP_SessionList.erase(SessionItem);
+	SessionListMutex.unlock();
 
 //Block Port Unreachable messages of system.
-	shutdown(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SD_SEND);
+	shutdown(Socket, SD_SEND);
 #if defined(PLATFORM_WIN)
 	Sleep(Parameter.SocketTimeout_Reliable_Once);
 #elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
 	usleep(Parameter.SocketTimeout_Reliable_Once.tv_sec * SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND + Parameter.SocketTimeout_Reliable_Once.tv_usec);
 #endif
-	SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	SocketSetting(SessionData->SocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket = INVALID_SOCKET;
+
+	return QueryNum > 0;
+}
+
+//Send query in client TCP session to request process
+bool TCP_SessionRequest(
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
+	TCP_SESSION_DATA &SessionData, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	uint8_t * const QueryBuffer, 
+	uint8_t * const SendBuffer, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const bool IsSingleRequest)
+{
+//Register query to pending list, responses are matched by DNS header ID.
+	std::unique_lock<std::mutex> SessionMutex(SessionData.SessionLock);
+	if (SessionData.IsFinished || SessionData.IsClosed)
+		return false;
+	SessionData.PendingList.emplace_back(reinterpret_cast<const dns_hdr *>(Buffer)->ID, GetCurrentSystemTime());
+	SessionMutex.unlock();
+
+//Take a free descriptor, query is processed in session worker when it is too long or no descriptors are available.
+	size_t DescriptorIndex = 0;
+	auto QueryData = &MonitorQueryData;
+	if (!IsSingleRequest && Length <= PACKET_NORMAL_MAXSIZE && QueryDescriptorPool.Acquire(DescriptorIndex, false))
+	{
+		QueryData = &QueryDescriptorPool.Descriptor(DescriptorIndex);
+		QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = QueryDescriptorPool.PacketBuffer(DescriptorIndex);
+		QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = PACKET_NORMAL_MAXSIZE;
+		memset(QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, 0, PACKET_NORMAL_MAXSIZE + MEMORY_RESERVED_BYTES);
+	}
+	else {
+		QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = QueryBuffer;
+		QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = Parameter.LargeBufferSize;
+		memset(QueryBuffer, 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	}
+
+//Copy query and reset parameters.
+	memcpy_s(QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize, Buffer, Length);
+	QueryData->MONITOR_QUEUE_DATA_SOCKET = SessionData.SocketData;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Length = Length;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = IPPROTO_TCP;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
+	memset(&QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Num = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Location.clear();
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.Records_Length.clear();
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original[0] = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request[0] = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
+	QueryData->MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
+
+//Check DNS query data, session is finished when query is dropped without any responses.
+	memset(SendBuffer, 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	if (!CheckQueryData(&QueryData->MONITOR_QUEUE_DATA_DNS_PACKET, SendBuffer, Parameter.LargeBufferSize, QueryData->MONITOR_QUEUE_DATA_SOCKET))
+	{
+		if (QueryData != &MonitorQueryData)
+			QueryDescriptorPool.Release(DescriptorIndex);
+		auto SocketDataTemp = SessionData.SocketData;
+		TCP_SessionFinish(SocketDataTemp, Buffer);
+
+		return true;
+	}
+
+//Request process, descriptor belongs to worker from now on.
+	if (QueryData != &MonitorQueryData)
+	{
+		MonitorRequestProvider(DescriptorIndex);
+	}
+	else {
+		const auto BeginTime = std::chrono::steady_clock::now();
+		const auto ResponseNum = Statistics_GetCounter(STATISTICS_COUNTER_RESPONSE);
+		EnterRequestProcess(*QueryData, OriginalRecv, RecvSize);
+		if (Statistics_GetCounter(STATISTICS_COUNTER_RESPONSE) != ResponseNum)
+			Statistics_AddLatency(static_cast<const uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BeginTime).count()));
+	}
+
+	return true;
+}
+
+//Wait for responses until the number of pending queries in client TCP session is not more than limit
+bool TCP_SessionWait(
+	TCP_SESSION_DATA &SessionData, 
+	const size_t PendingNum)
+{
+	std::unique_lock<std::mutex> SessionMutex(SessionData.SessionLock);
+	while (!GlobalRunningStatus.IsNeedExit && !SessionData.IsClosed)
+	{
+	//Queries without any responses are dropped after idle time limit.
+		const auto NowTime = GetCurrentSystemTime();
+		while (!SessionData.PendingList.empty() && SessionData.PendingList.front().second + TCP_SESSION_IDLE_TIME <= NowTime)
+			SessionData.PendingList.pop_front();
+		if (SessionData.PendingList.size() <= PendingNum)
+			return true;
+
+	//Wait for responses.
+		SessionData.SessionCondition.wait_for(SessionMutex, std::chrono::milliseconds(SessionData.PendingList.front().second + TCP_SESSION_IDLE_TIME - NowTime));
+	}
+
+	return false;
+}
+
+//Find client TCP session of requester
+std::shared_ptr<TCP_SESSION_DATA> TCP_SessionFind(
+	const SOCKET_DATA &LocalSocketData)
+{
+//Socket value may be reused by new connection, requester address must be the same.
+	std::lock_guard<std::mutex> SessionListMutex(TCP_SessionListLock);
+	const auto SessionItem = TCP_SessionList.find(LocalSocketData.Socket);
+	if (SessionItem != TCP_SessionList.end() && SessionItem->second->SocketData.AddrLen == LocalSocketData.AddrLen && 
+		memcmp(&SessionItem->second->SocketData.SockAddr, &LocalSocketData.SockAddr, LocalSocketData.AddrLen) == 0)
+			return SessionItem->second;
+
+	return nullptr;
+}
+
+//Send response to client TCP session
+bool TCP_SessionResponse(
+	SOCKET_DATA &LocalSocketData, 
+	const uint8_t * const Buffer, 
+	const size_t Length)
+{
+//Socket belongs to session, requester socket data can not be used after response.
+	const auto SessionData = TCP_SessionFind(LocalSocketData);
+	LocalSocketData.Socket = INVALID_SOCKET;
+	if (SessionData == nullptr || Length < sizeof(uint16_t) + DNS_PACKET_MINSIZE)
+		return false;
+
+//Response of query which is not pending is dropped.
+	std::lock_guard<std::mutex> SessionMutex(SessionData->SessionLock);
+	if (SessionData->IsClosed)
+		return false;
+	const auto ID = reinterpret_cast<const dns_hdr *>(Buffer + sizeof(uint16_t))->ID;
+	auto PendingItem = SessionData->PendingList.begin();
+	for (;PendingItem != SessionData->PendingList.end();++PendingItem)
+	{
+		if (PendingItem->first == ID)
+			break;
+	}
+	if (PendingItem == SessionData->PendingList.end())
+		return false;
+	SessionData->PendingList.erase(PendingItem);
+	SessionData->SessionCondition.notify_all();
+
+//Send response, responses are not mixed with each other.
+	for (size_t SentLen = 0;SentLen < Length;)
+	{
+		const auto SendLen = send(SessionData->SocketData.Socket, reinterpret_cast<const char *>(Buffer + SentLen), static_cast<const int>(Length - SentLen), 0);
+		if (SendLen <= 0)
+		{
+			SessionData->IsFinished = true;
+			SessionData->IsClosed = true;
+
+			return false;
+		}
+
+		SentLen += SendLen;
+	}
+
+//Finished session is shut down when all responses are sent.
+	SessionData->LastActiveTime = GetCurrentSystemTime();
+	if (SessionData->IsFinished && SessionData->PendingList.empty())
+	{
+		shutdown(SessionData->SocketData.Socket, SD_SEND);
+		SessionData->IsClosed = true;
+	}
 
 	return true;
 }
 
+//Finish client TCP session when query is dropped without any responses
+void TCP_SessionFinish(
+	SOCKET_DATA &LocalSocketData, 
+	const uint8_t * const Buffer)
+{
+//Socket belongs to session, requester socket data can not be used after finishing.
+	const auto SessionData = TCP_SessionFind(LocalSocketData);
+	LocalSocketData.Socket = INVALID_SOCKET;
+	if (SessionData == nullptr || Buffer == nullptr)
+		return;
+
+//Query is removed from pending list, nothing is changed when its response was sent.
+	std::lock_guard<std::mutex> SessionMutex(SessionData->SessionLock);
+	const auto ID = reinterpret_cast<const dns_hdr *>(Buffer)->ID;
+	for (auto PendingItem = SessionData->PendingList.begin();PendingItem != SessionData->PendingList.end();++PendingItem)
+	{
+		if (PendingItem->first == ID)
+		{
+			SessionData->PendingList.erase(PendingItem);
+			SessionData->IsFinished = true;
+			SessionData->SessionCondition.notify_all();
+
+		//Requester is notified by shutdown when all responses are sent.
+			if (!SessionData->IsClosed && SessionData->PendingList.empty())
+			{
+				shutdown(SessionData->SocketData.Socket, SD_SEND);
+				SessionData->IsClosed = true;
+			}
+
+			break;
+		}
+	}
+
+	return;
+}
+
 //Alternate DNS servers switcher
 void AlternateServerSwitcher(
 	void)
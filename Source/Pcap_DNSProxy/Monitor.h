@@ -26,6 +26,10 @@
 extern CONFIGURATION_TABLE Parameter, ParameterModificating;
 extern GLOBAL_STATUS GlobalRunningStatus;
 extern ALTERNATE_SWAP_TABLE AlternateSwapList;
+extern TASK_EXECUTOR_TABLE TaskExecutor;
+extern QUERY_DESCRIPTOR_POOL_TABLE &QueryDescriptorPool;
+extern std::unordered_map<SYSTEM_SOCKET, std::shared_ptr<TCP_SESSION_DATA>> TCP_SessionList;
+extern std::mutex TCP_SessionListLock;
 #if defined(ENABLE_LIBSODIUM)
 extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter, DNSCurveParameterModificating;
 #endif
@@ -41,6 +45,21 @@ bool ListenMonitor_UDP(
 	SOCKET_DATA LocalSocketData);
 bool ListenMonitor_TCP(
 	SOCKET_DATA LocalSocketData);
+bool TCP_SessionRequest(
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
+	TCP_SESSION_DATA &SessionData, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	uint8_t * const QueryBuffer, 
+	uint8_t * const SendBuffer, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const bool IsSingleRequest);
+bool TCP_SessionWait(
+	TCP_SESSION_DATA &SessionData, 
+	const size_t PendingNum);
+std::shared_ptr<TCP_SESSION_DATA> TCP_SessionFind(
+	const SOCKET_DATA &LocalSocketData);
 void AlternateServerSwitcher(
 	void);
 #if defined(PLATFORM_WIN)
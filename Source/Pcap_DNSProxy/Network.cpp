@@ -279,6 +279,36 @@ bool SocketSetting(
 				return false;
 			}
 		}break;
+	//Socket attribute setting(TCP deferred accepting)
+		case SOCKET_SETTING_TYPE::TCP_DEFERRED_ACCEPT:
+		{
+		//Linux: Connections are passed to accept only when the first data arrived, data in SYN of TCP Fast Open is also included. Timeout is in seconds.
+		//FreeBSD: Accept filter must be set after listening, it needs accf_data kernel module and listening without it is also allowed.
+		//Windows and macOS: Not supported.
+		#if defined(PLATFORM_LINUX)
+			errno = 0;
+			int OptionValue = static_cast<const int>(Parameter.SocketTimeout_Reliable_Once.tv_sec);
+			if (Parameter.SocketTimeout_Reliable_Once.tv_usec > 0)
+				++OptionValue;
+			if (setsockopt(Socket, SOL_TCP, TCP_DEFER_ACCEPT, reinterpret_cast<const char *>(&OptionValue), sizeof(OptionValue)) == SOCKET_ERROR)
+			{
+				if (IsPrintError)
+					PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"Socket TCP deferred accepting settings error", errno, nullptr, 0);
+				shutdown(Socket, SHUT_RDWR);
+				close(Socket);
+				Socket = INVALID_SOCKET;
+
+				return false;
+			}
+		#elif defined(PLATFORM_FREEBSD)
+			errno = 0;
+			accept_filter_arg FilterArgument;
+			memset(&FilterArgument, 0, sizeof(FilterArgument));
+			memcpy_s(FilterArgument.af_name, sizeof(FilterArgument.af_name), "dataready", strlen("dataready"));
+			if (setsockopt(Socket, SOL_SOCKET, SO_ACCEPTFILTER, reinterpret_cast<const char *>(&FilterArgument), sizeof(FilterArgument)) == SOCKET_ERROR && IsPrintError)
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"Socket TCP deferred accepting settings error", errno, nullptr, 0);
+		#endif
+		}break;
 	//Socket attribute setting(TFO/TCP Fast Open, normal version)
 		case SOCKET_SETTING_TYPE::TCP_FAST_OPEN_NORMAL:
 		{
@@ -2390,6 +2420,7 @@ ssize_t SocketSelectingOnce(
 					return RecvLen;
 			}
 
+			Statistics_AddCounter(STATISTICS_COUNTER_UPSTREAM_TIMEOUT);
 			if (ErrorCode != nullptr)
 				*ErrorCode = WSAETIMEDOUT;
 
@@ -2483,9 +2514,11 @@ ssize_t SelectingResultOnce(
 				}
 
 			//Decrypt or get packet data(DNSCurve).
+				DNS_MESSAGE_INDEX MessageIndex;
+				MessageIndex.Length = 0;
 				if (RequestType == REQUEST_PROCESS_TYPE::DNSCURVE_MAIN)
 				{
-					RecvLen = DNSCurve_PacketDecryption(DNSCurveSocketSelectingDataList->at(Index).ReceiveMagicNumber, DNSCurveSocketSelectingDataList->at(Index).PrecomputationKey, DNSCurveSocketSelectingDataList->at(Index).RecvBuffer.get(), RecvSize, RecvLen);
+					RecvLen = DNSCurve_PacketDecryption(DNSCurveSocketSelectingDataList->at(Index).ReceiveMagicNumber, DNSCurveSocketSelectingDataList->at(Index).PrecomputationKey, DNSCurveSocketSelectingDataList->at(Index).RecvBuffer.get(), RecvSize, RecvLen, &MessageIndex);
 					if (RecvLen < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
 					{
 						SocketSetting(SocketDataList.at(Index).Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
@@ -2538,7 +2571,7 @@ ssize_t SelectingResultOnce(
 
 			//Mark domain cache.
 				if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-					MarkDomainCache(OriginalRecv, RecvLen, LocalSocketData);
+					MarkDomainCache(OriginalRecv, RecvLen, &MessageIndex, LocalSocketData);
 
 				return RecvLen;
 			}
@@ -2579,13 +2612,15 @@ ssize_t SelectingResultOnce(
 				}
 
 			//Receive from buffer list.
+				DNS_MESSAGE_INDEX MessageIndex;
 				RecvLen = CheckResponseData(
 					RequestType, 
 					SocketSelectingDataList->at(Index).RecvBuffer.get(), 
 					RecvLen, 
 					RecvSize, 
 					nullptr, 
-					nullptr);
+					nullptr, 
+					&MessageIndex);
 				if (RecvLen < static_cast<const ssize_t>(DNS_PACKET_MINSIZE))
 				{
 					SocketSetting(SocketDataList.at(Index).Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
@@ -2637,7 +2672,7 @@ ssize_t SelectingResultOnce(
 
 			//Mark domain cache.
 				if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-					MarkDomainCache(OriginalRecv, RecvLen, LocalSocketData);
+					MarkDomainCache(OriginalRecv, RecvLen, &MessageIndex, LocalSocketData);
 
 				return RecvLen;
 			}
@@ -3042,8 +3077,9 @@ void RegisterPortToList(
 	const uint16_t Protocol, 
 	const SOCKET_DATA * const LocalSocketData, 
 	std::vector<SOCKET_DATA> &SocketDataList, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request
+	const uint16_t DNS_ID, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request
 //	size_t *EDNS_Length
 )
 {
@@ -3055,15 +3091,16 @@ void RegisterPortToList(
 	if (LocalSocketData != nullptr && Protocol > 0)
 	{
 		SOCKET_DATA SocketDataTemp;
-		OUTPUT_PACKET_TABLE OutputPacketListTemp;
+		const auto OutputPacketListTemp = std::make_shared<OUTPUT_PACKET_TABLE>();
 		memset(&SocketDataTemp, 0, sizeof(SocketDataTemp));
 		SocketDataTemp.Socket = INVALID_SOCKET;
 
 	//Register system connection data.
-		OutputPacketListTemp.SocketData_Input = *LocalSocketData;
+		OutputPacketListTemp->SocketData_Input = *LocalSocketData;
+		OutputPacketListTemp->DNS_ID = DNS_ID;
 /* EDNS Label operations are different between DNS servers.
 		if (Parameter.PacketCheck_DNS && EDNS_Length != nullptr)
-			OutputPacketListTemp.EDNS_Length = *EDNS_Length;
+			OutputPacketListTemp->EDNS_Length = *EDNS_Length;
 */
 
 	//Register sending connection data.
@@ -3102,63 +3139,39 @@ void RegisterPortToList(
 				continue;
 			}
 
-			OutputPacketListTemp.SocketData_Output.push_back(SocketDataTemp);
+			OutputPacketListTemp->SocketData_Output.push_back(SocketDataTemp);
 		}
 
 	//Register send time.
-		OutputPacketListTemp.Protocol_Network = Protocol;
+		OutputPacketListTemp->Protocol_Network = Protocol;
+		OutputPacketListTemp->SendTime = std::chrono::steady_clock::now();
 		if (Protocol == IPPROTO_TCP)
 		{
 		#if defined(PLATFORM_WIN)
-			OutputPacketListTemp.ClearPortTime = GetCurrentSystemTime() + Parameter.SocketTimeout_Reliable_Once;
+			OutputPacketListTemp->ClearPortTime = GetCurrentSystemTime() + Parameter.SocketTimeout_Reliable_Once;
 		#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			OutputPacketListTemp.ClearPortTime = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Reliable_Once);
+			OutputPacketListTemp->ClearPortTime = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Reliable_Once);
 		#endif
 		}
 		else if (Protocol == IPPROTO_UDP)
 		{
 		#if defined(PLATFORM_WIN)
-			OutputPacketListTemp.ClearPortTime = GetCurrentSystemTime() + Parameter.SocketTimeout_Unreliable_Once;
+			OutputPacketListTemp->ClearPortTime = GetCurrentSystemTime() + Parameter.SocketTimeout_Unreliable_Once;
 		#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			OutputPacketListTemp.ClearPortTime = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Unreliable_Once);
+			OutputPacketListTemp->ClearPortTime = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Unreliable_Once);
 		#endif
 		}
 		else {
 			return;
 		}
 
-	//Clear expired data.
-		std::lock_guard<std::mutex> OutputPacketListMutex(OutputPacketListLock);
-		while (!OutputPacketList.empty() && OutputPacketList.front().ClearPortTime <= GetCurrentSystemTime())
-		{
-		//Register timeout.
-			if (OutputPacketList.front().ClearPortTime > 0)
-			{
-				if (OutputPacketList.front().Protocol_Network == AF_INET6)
-				{
-					if (OutputPacketList.front().Protocol_Transport == IPPROTO_TCP)
-						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV6);
-					else if (OutputPacketList.front().Protocol_Transport == IPPROTO_UDP)
-						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV6);
-				}
-				else if (OutputPacketList.front().Protocol_Network == AF_INET)
-				{
-					if (OutputPacketList.front().Protocol_Transport == IPPROTO_TCP)
-						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_TCP_IPV4);
-					else if (OutputPacketList.front().Protocol_Transport == IPPROTO_UDP)
-						++AlternateSwapList.TimeoutTimes.at(ALTERNATE_SWAP_TYPE_MAIN_UDP_IPV4);
-				}
-			}
-
-			OutputPacketList.pop_front();
-		}
-
-	//Register to global list.
+	//Register to global list and clear expired data.
 		if (DomainString_Original != nullptr)
-			OutputPacketListTemp.DomainString_Original = *DomainString_Original;
+			memcpy_s(OutputPacketListTemp->DomainString_Original, DOMAIN_MAXSIZE, DomainString_Original, DOMAIN_MAXSIZE);
 		if (DomainString_Request != nullptr)
-			OutputPacketListTemp.DomainString_Request = *DomainString_Request;
-		OutputPacketList.push_back(OutputPacketListTemp);
+			memcpy_s(OutputPacketListTemp->DomainString_Request, DOMAIN_MAXSIZE, DomainString_Request, DOMAIN_MAXSIZE);
+		OutputPacketList.Register(OutputPacketListTemp);
+		OutputPacketList.ClearExpired();
 	}
 
 //Block Port Unreachable messages of system or close the TCP request connections.
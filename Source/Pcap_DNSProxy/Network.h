@@ -31,8 +31,7 @@ extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter;
 #endif
 extern std::deque<SOCKET_REGISTER_DATA> SocketRegisterList;
 #if defined(ENABLE_PCAP)
-extern std::deque<OUTPUT_PACKET_TABLE> OutputPacketList;
-extern std::mutex OutputPacketListLock;
+extern OUTPUT_PACKET_PORT_TABLE OutputPacketList;
 #endif
 extern std::mutex SocketRegisterLock;
 
@@ -76,45 +76,181 @@ uint32_t GetFCS(
 }
 */
 
-//Get Internet checksum
-uint16_t GetChecksum_Internet(
-	const uint16_t *Buffer, 
-	const size_t Length)
+//Accumulate 16-bit words of buffer to ones' complement partial sum
+//Words are summed in memory order, start alignment of buffer does not matter because all loads are unaligned loads.
+uint64_t GetChecksum_Accumulate(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	uint64_t ResultValue)
+{
+	size_t Index = 0;
+
+//Sum vector blocks by the widest instruction set which is supported by processor.
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+	ResultValue = GetChecksum_Block(Buffer, Length, Index, ResultValue);
+#endif
+
+//Sum remaining 32-bit words, folding of 32-bit words is the same as adding both 16-bit halves.
+	for (;Length - Index >= sizeof(uint32_t);Index += sizeof(uint32_t))
+	{
+		uint32_t Word = 0;
+		memcpy(&Word, Buffer + Index, sizeof(Word));
+		ResultValue += Word;
+	}
+
+//Sum remaining 16-bit word and odd byte, odd byte is padded with zero.
+	if (Length - Index >= sizeof(uint16_t))
+	{
+		uint16_t Word = 0;
+		memcpy(&Word, Buffer + Index, sizeof(Word));
+		ResultValue += Word;
+		Index += sizeof(uint16_t);
+	}
+	if (Length > Index)
+	{
+		uint16_t Word = 0;
+		memcpy(&Word, Buffer + Index, sizeof(uint8_t));
+		ResultValue += Word;
+	}
+
+	return ResultValue;
+}
+
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+//Select function of summing vector blocks of checksum
+CHECKSUM_BLOCK_FUNCTION GetChecksum_BlockSelect(
+	void)
+{
+#if defined(ENABLE_SIMD_AVX2)
+	if (CheckProcessorFeature_AVX2())
+		return GetChecksum_Block_AVX2;
+#endif
+
+	return GetChecksum_Block_Vector;
+}
+
+#if defined(ENABLE_SIMD_AVX2)
+//Sum AVX2 vector blocks of checksum, each 16-bit word is widened to 32-bit lanes which are flushed to result before they may overflow.
+//Low and high words are summed in separate lanes to keep additions independent, and index is kept in register.
+SIMD_TARGET_AVX2 uint64_t GetChecksum_Block_AVX2(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	size_t &Index, 
+	uint64_t ResultValue)
 {
-	uint32_t ResultValue = CHECKSUM_SUCCESS;
-	auto LoopLength = Length;
-	while (LoopLength > 1U)
+	const auto ZeroVector = _mm256_setzero_si256();
+	auto BlockIndex = Index;
+	while (Length - BlockIndex >= sizeof(__m256i))
 	{
-		ResultValue += *Buffer++;
-		LoopLength -= sizeof(uint16_t);
+		auto BlockNum = (Length - BlockIndex) / sizeof(__m256i);
+		if (BlockNum > CHECKSUM_SIMD_FLUSH_BLOCKS)
+			BlockNum = CHECKSUM_SIMD_FLUSH_BLOCKS;
+		auto SumVector_Low = _mm256_setzero_si256(), SumVector_High = _mm256_setzero_si256();
+		for (;BlockNum > 0;--BlockNum, BlockIndex += sizeof(__m256i))
+		{
+			const auto Block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(Buffer + BlockIndex));
+			SumVector_Low = _mm256_add_epi32(SumVector_Low, _mm256_unpacklo_epi16(Block, ZeroVector));
+			SumVector_High = _mm256_add_epi32(SumVector_High, _mm256_unpackhi_epi16(Block, ZeroVector));
+		}
+
+		uint32_t SumLane[sizeof(__m256i) / sizeof(uint32_t) * 2U]{0};
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(SumLane), SumVector_Low);
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(SumLane) + 1U, SumVector_High);
+		for (const auto &LaneIter:SumLane)
+			ResultValue += LaneIter;
 	}
 
-	if (LoopLength)
-		ResultValue += *reinterpret_cast<const uint8_t *>(Buffer);
-	ResultValue = (ResultValue >> (sizeof(uint16_t) * BYTES_TO_BITS)) + (ResultValue & UINT16_MAX);
-	ResultValue += (ResultValue >> (sizeof(uint16_t) * BYTES_TO_BITS));
+	Index = BlockIndex;
+	return GetChecksum_Block_Vector(Buffer, Length, Index, ResultValue);
+}
+#endif
+
+//Sum 128 bits vector blocks of checksum, each 16-bit word is widened to 32-bit lanes which are flushed to result before they may overflow.
+uint64_t GetChecksum_Block_Vector(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	size_t &Index, 
+	uint64_t ResultValue)
+{
+	auto BlockIndex = Index;
+#if defined(ENABLE_SIMD_SSE2)
+	const auto ZeroVector = _mm_setzero_si128();
+	while (Length - BlockIndex >= sizeof(__m128i))
+	{
+		auto BlockNum = (Length - BlockIndex) / sizeof(__m128i);
+		if (BlockNum > CHECKSUM_SIMD_FLUSH_BLOCKS)
+			BlockNum = CHECKSUM_SIMD_FLUSH_BLOCKS;
+		auto SumVector_Low = _mm_setzero_si128(), SumVector_High = _mm_setzero_si128();
+		for (;BlockNum > 0;--BlockNum, BlockIndex += sizeof(__m128i))
+		{
+			const auto Block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(Buffer + BlockIndex));
+			SumVector_Low = _mm_add_epi32(SumVector_Low, _mm_unpacklo_epi16(Block, ZeroVector));
+			SumVector_High = _mm_add_epi32(SumVector_High, _mm_unpackhi_epi16(Block, ZeroVector));
+		}
+
+		uint32_t SumLane[sizeof(__m128i) / sizeof(uint32_t) * 2U]{0};
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(SumLane), SumVector_Low);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(SumLane) + 1U, SumVector_High);
+		for (const auto &LaneIter:SumLane)
+			ResultValue += LaneIter;
+	}
+#elif defined(ENABLE_SIMD_NEON)
+	while (Length - BlockIndex >= sizeof(uint16x8_t))
+	{
+		auto BlockNum = (Length - BlockIndex) / sizeof(uint16x8_t);
+		if (BlockNum > CHECKSUM_SIMD_FLUSH_BLOCKS)
+			BlockNum = CHECKSUM_SIMD_FLUSH_BLOCKS;
+		auto SumVector = vdupq_n_u32(0);
+		for (;BlockNum > 0;--BlockNum, BlockIndex += sizeof(uint16x8_t))
+			SumVector = vpadalq_u16(SumVector, vreinterpretq_u16_u8(vld1q_u8(Buffer + BlockIndex)));
+
+		uint32_t SumLane[sizeof(uint32x4_t) / sizeof(uint32_t)]{0};
+		vst1q_u32(SumLane, SumVector);
+		for (const auto &LaneIter:SumLane)
+			ResultValue += LaneIter;
+	}
+#endif
+
+	Index = BlockIndex;
+	return ResultValue;
+}
+#endif
+
+//Fold ones' complement partial sum to checksum
+uint16_t GetChecksum_Fold(
+	uint64_t ResultValue)
+{
+	while (ResultValue > UINT16_MAX)
+		ResultValue = (ResultValue >> (sizeof(uint16_t) * BYTES_TO_BITS)) + (ResultValue & UINT16_MAX);
 
 	return static_cast<const uint16_t>(~ResultValue);
 }
 
+//Get Internet checksum
+uint16_t GetChecksum_Internet(
+	const uint16_t *Buffer, 
+	const size_t Length)
+{
+	return GetChecksum_Fold(GetChecksum_Accumulate(reinterpret_cast<const uint8_t *>(Buffer), Length, CHECKSUM_SUCCESS));
+}
+
 //Get ICMPv6 checksum
 uint16_t GetChecksum_ICMPv6(
 	const ipv6_hdr * const IPv6_Header, 
 	const uint8_t * const Buffer, 
 	const size_t Length)
 {
-//Initialization
-	const auto Validation = std::make_unique<uint8_t[]>(sizeof(ipv6_psd_hdr) + Length + MEMORY_RESERVED_BYTES);
-	memset(Validation.get(), 0, sizeof(ipv6_psd_hdr) + Length + MEMORY_RESERVED_BYTES);
+//Pseudo header is summed separately, length of it is even and payload does not need to be copied.
+	ipv6_psd_hdr PseudoHeader;
+	memset(&PseudoHeader, 0, sizeof(PseudoHeader));
+	PseudoHeader.Destination = IPv6_Header->Destination;
+	PseudoHeader.Source = IPv6_Header->Source;
+	PseudoHeader.Length = hton32(static_cast<const uint32_t>(Length));
+	PseudoHeader.NextHeader = IPPROTO_ICMPV6;
 
 //Get checksum.
-	reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Destination = IPv6_Header->Destination;
-	reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Source = IPv6_Header->Source;
-	reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Length = hton32(static_cast<const uint32_t>(Length));
-	reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->NextHeader = IPPROTO_ICMPV6;
-	memcpy_s(Validation.get() + sizeof(ipv6_psd_hdr), Length, Buffer, Length);
-
-	return GetChecksum_Internet(reinterpret_cast<const uint16_t *>(Validation.get()), sizeof(ipv6_psd_hdr) + Length);
+	const auto ResultValue = GetChecksum_Accumulate(reinterpret_cast<const uint8_t *>(&PseudoHeader), sizeof(PseudoHeader), CHECKSUM_SUCCESS);
+	return GetChecksum_Fold(GetChecksum_Accumulate(Buffer, Length, ResultValue));
 }
 
 //Get TCP or UDP checksum
@@ -128,28 +264,28 @@ uint16_t GetChecksum_TCP_UDP(
 //IPv6
 	if (Protocol_Network == AF_INET6)
 	{
-		const auto Validation = std::make_unique<uint8_t[]>(sizeof(ipv6_psd_hdr) + Length - DataOffset + MEMORY_RESERVED_BYTES);
-		memset(Validation.get(), 0, sizeof(ipv6_psd_hdr) + Length - DataOffset + MEMORY_RESERVED_BYTES);
-		reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Destination = reinterpret_cast<const ipv6_hdr *>(Buffer)->Destination;
-		reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Source = reinterpret_cast<const ipv6_hdr *>(Buffer)->Source;
-		reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->Length = hton32(static_cast<const uint32_t>(Length - DataOffset));
-		reinterpret_cast<ipv6_psd_hdr *>(Validation.get())->NextHeader = static_cast<const uint8_t>(Protocol_Transport);
-		memcpy_s(Validation.get() + sizeof(ipv6_psd_hdr), Length - DataOffset, Buffer + sizeof(ipv6_hdr) + DataOffset, Length - DataOffset);
-
-		return GetChecksum_Internet(reinterpret_cast<const uint16_t *>(Validation.get()), sizeof(ipv6_psd_hdr) + Length - DataOffset);
+		ipv6_psd_hdr PseudoHeader;
+		memset(&PseudoHeader, 0, sizeof(PseudoHeader));
+		PseudoHeader.Destination = reinterpret_cast<const ipv6_hdr *>(Buffer)->Destination;
+		PseudoHeader.Source = reinterpret_cast<const ipv6_hdr *>(Buffer)->Source;
+		PseudoHeader.Length = hton32(static_cast<const uint32_t>(Length - DataOffset));
+		PseudoHeader.NextHeader = static_cast<const uint8_t>(Protocol_Transport);
+
+		const auto ResultValue = GetChecksum_Accumulate(reinterpret_cast<const uint8_t *>(&PseudoHeader), sizeof(PseudoHeader), CHECKSUM_SUCCESS);
+		return GetChecksum_Fold(GetChecksum_Accumulate(Buffer + sizeof(ipv6_hdr) + DataOffset, Length - DataOffset, ResultValue));
 	}
 //IPv4
 	else if (Protocol_Network == AF_INET)
 	{
-		const auto Validation = std::make_unique<uint8_t[]>(sizeof(ipv4_psd_hdr) + Length + MEMORY_RESERVED_BYTES);
-		memset(Validation.get(), 0, sizeof(ipv4_psd_hdr) + Length + MEMORY_RESERVED_BYTES);
-		reinterpret_cast<ipv4_psd_hdr *>(Validation.get())->Destination = reinterpret_cast<const ipv4_hdr *>(Buffer)->Destination;
-		reinterpret_cast<ipv4_psd_hdr *>(Validation.get())->Source = reinterpret_cast<const ipv4_hdr *>(Buffer)->Source;
-		reinterpret_cast<ipv4_psd_hdr *>(Validation.get())->Length = hton16(static_cast<const uint16_t>(Length));
-		reinterpret_cast<ipv4_psd_hdr *>(Validation.get())->Protocol = static_cast<const uint8_t>(Protocol_Transport);
-		memcpy_s(Validation.get() + sizeof(ipv4_psd_hdr), Length, Buffer + static_cast<const size_t>(reinterpret_cast<const ipv4_hdr *>(Buffer)->IHL) * IPV4_IHL_BYTES_SET, Length);
-
-		return GetChecksum_Internet(reinterpret_cast<const uint16_t *>(Validation.get()), sizeof(ipv4_psd_hdr) + Length);
+		ipv4_psd_hdr PseudoHeader;
+		memset(&PseudoHeader, 0, sizeof(PseudoHeader));
+		PseudoHeader.Destination = reinterpret_cast<const ipv4_hdr *>(Buffer)->Destination;
+		PseudoHeader.Source = reinterpret_cast<const ipv4_hdr *>(Buffer)->Source;
+		PseudoHeader.Length = hton16(static_cast<const uint16_t>(Length));
+		PseudoHeader.Protocol = static_cast<const uint8_t>(Protocol_Transport);
+
+		const auto ResultValue = GetChecksum_Accumulate(reinterpret_cast<const uint8_t *>(&PseudoHeader), sizeof(PseudoHeader), CHECKSUM_SUCCESS);
+		return GetChecksum_Fold(GetChecksum_Accumulate(Buffer + static_cast<const size_t>(reinterpret_cast<const ipv4_hdr *>(Buffer)->IHL) * IPV4_IHL_BYTES_SET, Length, ResultValue));
 	}
 
 	return EXIT_FAILURE;
@@ -445,7 +581,9 @@ bool Move_EDNS_LabelToEnd(
 		return true;
 
 //Packet with EDNS Label, but it's already stored at the end of packet.
-	if (PacketStructure->EDNS_Location == PacketStructure->Records_Location.back())
+	if (PacketStructure->Records_Num == 0)
+		return false;
+	else if (PacketStructure->EDNS_Location == PacketStructure->Records_Location[PacketStructure->Records_Num - 1U])
 	{
 	//EDNS version check
 		if (reinterpret_cast<const edns_header *>(PacketStructure->Buffer + PacketStructure->EDNS_Location)->Version != EDNS_VERSION_ZERO)
@@ -455,9 +593,9 @@ bool Move_EDNS_LabelToEnd(
 	}
 
 //Packet with EDNS Label, but it's not stored at the end of packet.
-	for (size_t Index = 0;Index < PacketStructure->Records_Location.size();++Index)
+	for (size_t Index = 0;Index < PacketStructure->Records_Num;++Index)
 	{
-		if (PacketStructure->Records_Location.at(Index) == PacketStructure->EDNS_Location)
+		if (PacketStructure->Records_Location[Index] == PacketStructure->EDNS_Location)
 		{
 		//EDNS version check
 			if (reinterpret_cast<const edns_header *>(PacketStructure->Buffer + PacketStructure->EDNS_Location)->Version != EDNS_VERSION_ZERO)
@@ -493,12 +631,15 @@ bool Move_EDNS_LabelToEnd(
 			memcpy_s(PacketStructure->Buffer, PacketStructure->Length, BufferTemp.get(), PacketStructure->Length);
 
 		//Move EDNS Label item.
-			for (size_t InnerIndex = Index;InnerIndex < PacketStructure->Records_Length.size();++InnerIndex)
-				PacketStructure->Records_Length.at(InnerIndex) -= PacketStructure->EDNS_Length;
-			PacketStructure->Records_Location.erase(PacketStructure->Records_Location.begin() + Index);
-			PacketStructure->Records_Length.erase(PacketStructure->Records_Length.begin() + Index);
-			PacketStructure->Records_Location.push_back(PacketStructure->Length - PacketStructure->EDNS_Length);
-			PacketStructure->Records_Length.push_back(PacketStructure->EDNS_Length);
+			for (size_t InnerIndex = Index;InnerIndex < PacketStructure->Records_Num;++InnerIndex)
+				PacketStructure->Records_Length[InnerIndex] -= PacketStructure->EDNS_Length;
+			for (size_t InnerIndex = Index;InnerIndex + 1U < PacketStructure->Records_Num;++InnerIndex)
+			{
+				PacketStructure->Records_Location[InnerIndex] = PacketStructure->Records_Location[InnerIndex + 1U];
+				PacketStructure->Records_Length[InnerIndex] = PacketStructure->Records_Length[InnerIndex + 1U];
+			}
+			PacketStructure->Records_Location[PacketStructure->Records_Num - 1U] = PacketStructure->Length - PacketStructure->EDNS_Length;
+			PacketStructure->Records_Length[PacketStructure->Records_Num - 1U] = PacketStructure->EDNS_Length;
 			PacketStructure->EDNS_Location = PacketStructure->Length - PacketStructure->EDNS_Length;
 
 			break;
@@ -709,6 +850,7 @@ bool Add_EDNS_LabelToPacket(
 		PacketStructure->EDNS_Length = sizeof(edns_header);
 		PacketStructure->Records_Location.push_back(PacketStructure->Length);
 		PacketStructure->Records_Length.push_back(sizeof(edns_header));
+		++PacketStructure->Records_Num;
 		PacketStructure->Length += sizeof(edns_header);
 
 	//Rebuild DNS header counts.
@@ -738,7 +880,7 @@ bool Add_EDNS_LabelToPacket(
 		EDNS_CookiesHeader->Length = hton16(static_cast<const uint16_t>(ntoh16(EDNS_CookiesHeader->Length) + sizeof(EDNS_CookiesHeader->ClientCookie)));
 		EDNS_Header->DataLength = hton16(static_cast<const uint16_t>(ntoh16(EDNS_Header->DataLength) + sizeof(edns_cookies)));
 		PacketStructure->Length += sizeof(edns_cookies);
-		PacketStructure->Records_Length.back() += sizeof(edns_cookies);
+		PacketStructure->Records_Length[PacketStructure->Records_Num - 1U] += sizeof(edns_cookies);
 		PacketStructure->EDNS_Length += sizeof(edns_cookies);
 	}
 */
@@ -797,7 +939,7 @@ bool Add_EDNS_LabelToPacket(
 				EDNS_ClientSubnetHeader->Length = hton16(static_cast<const uint16_t>(ntoh16(EDNS_ClientSubnetHeader->Length) + sizeof(EDNS_ClientSubnetHeader->Family) + sizeof(EDNS_ClientSubnetHeader->Netmask_Source) + sizeof(EDNS_ClientSubnetHeader->Netmask_Scope) + PrefixBytes));
 				EDNS_Header->DataLength = hton16(static_cast<const uint16_t>(ntoh16(EDNS_Header->DataLength) + sizeof(edns_client_subnet) + PrefixBytes));
 				PacketStructure->Length += sizeof(edns_client_subnet) + PrefixBytes;
-				PacketStructure->Records_Length.back() += sizeof(edns_client_subnet) + PrefixBytes;
+				PacketStructure->Records_Length[PacketStructure->Records_Num - 1U] += sizeof(edns_client_subnet) + PrefixBytes;
 				PacketStructure->EDNS_Length += sizeof(edns_client_subnet) + PrefixBytes;
 			}
 		}
@@ -848,7 +990,7 @@ bool Add_EDNS_LabelToPacket(
 				EDNS_ClientSubnetHeader->Length = hton16(static_cast<const uint16_t>(ntoh16(EDNS_ClientSubnetHeader->Length) + sizeof(EDNS_ClientSubnetHeader->Family) + sizeof(EDNS_ClientSubnetHeader->Netmask_Source) + sizeof(EDNS_ClientSubnetHeader->Netmask_Scope) + PrefixBytes));
 				EDNS_Header->DataLength = hton16(static_cast<const uint16_t>(ntoh16(EDNS_Header->DataLength) + sizeof(edns_client_subnet) + PrefixBytes));
 				PacketStructure->Length += sizeof(edns_client_subnet) + PrefixBytes;
-				PacketStructure->Records_Length.back() += sizeof(edns_client_subnet) + PrefixBytes;
+				PacketStructure->Records_Length[PacketStructure->Records_Num - 1U] += sizeof(edns_client_subnet) + PrefixBytes;
 				PacketStructure->EDNS_Length += sizeof(edns_client_subnet) + PrefixBytes;
 			}
 		}
@@ -990,6 +1132,7 @@ size_t MakeCompressionPointerMutation(
 bool MarkDomainCache(
 	const uint8_t * const Buffer, 
 	const size_t Length, 
+	const DNS_MESSAGE_INDEX * const MessageIndex, 
 	const SOCKET_DATA * const LocalSocketData)
 {
 //Check conditions.
@@ -1011,51 +1154,42 @@ bool MarkDomainCache(
 		(ntoh16(DNS_Header->Flags) & DNS_FLAG_GET_BIT_RCODE) != DNS_RCODE_NXDOMAIN))
 			return false;
 
+//Build message index if it is not available.
+	DNS_MESSAGE_INDEX MessageIndexTemp;
+	auto MessageIndexPointer = MessageIndex;
+	if (MessageIndexPointer == nullptr || MessageIndexPointer->Length != Length)
+	{
+		if (!BuildMessageIndex(Buffer, Length, MessageIndexTemp))
+			return false;
+		else 
+			MessageIndexPointer = &MessageIndexTemp;
+	}
+
 //Initialization(A part)
 	DNS_CACHE_DATA DNSCacheDataTemp;
 	DNSCacheDataTemp.Length = 0;
 	DNSCacheDataTemp.ClearCacheTime = 0;
-	DNSCacheDataTemp.RecordType = reinterpret_cast<const dns_qry *>(Buffer + DNS_PACKET_QUERY_LOCATE(Buffer, Length))->Type;
+	DNSCacheDataTemp.RecordType = MessageIndexPointer->QueryType;
 	memset(&DNSCacheDataTemp.ForAddress, 0, sizeof(DNSCacheDataTemp.ForAddress));
 	uint32_t ResponseTTL = 0;
 
 //Mark DNS A records and AAAA records only.
 	if (DNSCacheDataTemp.RecordType == hton16(DNS_TYPE_AAAA) || DNSCacheDataTemp.RecordType == hton16(DNS_TYPE_A))
 	{
-		size_t DataLength = DNS_PACKET_RR_LOCATE(Buffer, Length), TTL_Counts = 0;
+		size_t TTL_Counts = 0;
 
 	//Scan all Answers resource records.
-		for (size_t Index = 0;Index < ntoh16(DNS_Header->Answer);++Index)
+		for (size_t Index = 0;Index < MessageIndexPointer->Records_AnswerCount;++Index)
 		{
-		//Domain pointer check
-			if (DataLength + sizeof(uint16_t) < Length && Buffer[DataLength] >= DNS_POINTER_8_BITS)
-			{
-				const uint16_t DNS_Pointer = ntoh16(*reinterpret_cast<const uint16_t *>(Buffer + DataLength)) & DNS_POINTER_BIT_GET_LOCATE;
-				if (DNS_Pointer >= Length || DNS_Pointer < sizeof(dns_hdr) || DNS_Pointer == DataLength || DNS_Pointer == DataLength + 1U)
-					return false;
-			}
-
-		//Resource records domain name check
-			DataLength += CheckQueryNameLength(Buffer + DataLength, Length - DataLength) + NULL_TERMINATE_LENGTH;
-			if (DataLength + sizeof(dns_record_standard) > Length)
-				break;
-
-		//Standard resource record length check
-			auto DNS_Record_Standard = reinterpret_cast<const dns_record_standard *>(Buffer + DataLength);
-			DataLength += sizeof(dns_record_standard);
-			if (DataLength > Length || DataLength + ntoh16(DNS_Record_Standard->Length) > Length)
-				break;
-
 		//Resource records data check
+			const auto DNS_Record_Standard = reinterpret_cast<const dns_record_standard *>(Buffer + MessageIndexPointer->Records_StandardLocation[Index]);
 			if (DNS_Record_Standard->TTL > 0 && 
-				((ntoh16(DNS_Record_Standard->Type) == DNS_TYPE_AAAA && ntoh16(DNS_Record_Standard->Length) == sizeof(in6_addr)) || 
-				(ntoh16(DNS_Record_Standard->Type) == DNS_TYPE_A && ntoh16(DNS_Record_Standard->Length) == sizeof(in_addr))))
+				((MessageIndexPointer->Records_Type[Index] == DNS_TYPE_AAAA && ntoh16(DNS_Record_Standard->Length) == sizeof(in6_addr)) || 
+				(MessageIndexPointer->Records_Type[Index] == DNS_TYPE_A && ntoh16(DNS_Record_Standard->Length) == sizeof(in_addr))))
 			{
 				ResponseTTL += ntoh32(DNS_Record_Standard->TTL);
 				++TTL_Counts;
 			}
-
-			DataLength += ntoh16(DNS_Record_Standard->Length);
 		}
 
 	//Calculate average TTL.
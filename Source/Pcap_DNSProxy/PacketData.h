@@ -30,6 +30,11 @@ typedef enum _cpm_pointer_type_
 	CPM_POINTER_TYPE_ADDITIONAL
 }CPM_POINTER_TYPE;
 
+//Function pointer of summing vector blocks of checksum
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+typedef uint64_t(*CHECKSUM_BLOCK_FUNCTION)(const uint8_t * const, const size_t, size_t &, uint64_t);
+#endif
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
@@ -40,4 +45,23 @@ extern std::mutex DNSCacheListLock;
 //Functions
 void RemoveExpiredDomainCache(
 	void);
+#if (defined(ENABLE_SIMD_SSE2) || defined(ENABLE_SIMD_NEON))
+CHECKSUM_BLOCK_FUNCTION GetChecksum_BlockSelect(
+	void);
+#if defined(ENABLE_SIMD_AVX2)
+SIMD_TARGET_AVX2 uint64_t GetChecksum_Block_AVX2(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	size_t &Index, 
+	uint64_t ResultValue);
+#endif
+uint64_t GetChecksum_Block_Vector(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	size_t &Index, 
+	uint64_t ResultValue);
+
+//Function of summing vector blocks of checksum, it is selected by processor at startup.
+CHECKSUM_BLOCK_FUNCTION GetChecksum_Block = GetChecksum_BlockSelect();
+#endif
 #endif
@@ -366,6 +366,28 @@
 #include <unordered_map>           //Unordered_map and unordered_multimap container support
 #include <unordered_set>           //Unordered_set and unordered_multiset container support
 
+//SIMD intrinsics headers, SSE2/SSSE3/NEON are selected by target instruction set at compile time.
+#if defined(__SSSE3__)
+	#define ENABLE_SIMD_SSSE3
+#endif
+#if (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define ENABLE_SIMD_SSE2
+	#include <immintrin.h>             //x86 SSE2/SSSE3/AVX2 intrinsics support
+
+//AVX2 functions are always compiled and they are only called when processor supports AVX2 at runtime.
+	#if defined(_MSC_VER)
+		#define ENABLE_SIMD_AVX2
+		#define SIMD_TARGET_AVX2
+		#include <intrin.h>                //x86 CPUID instruction support
+	#elif (defined(__GNUC__) || defined(__clang__))
+		#define ENABLE_SIMD_AVX2
+		#define SIMD_TARGET_AVX2           __attribute__((target("avx2")))
+	#endif
+#elif (defined(__ARM_NEON) || defined(__ARM_NEON__))
+	#define ENABLE_SIMD_NEON
+	#include <arm_neon.h>              //ARM NEON intrinsics support
+#endif
+
 #if defined(PLATFORM_WIN)
 //LibEvent header, always enabled
 	#include "..\\Dependency\\LibEvent\\Include_Windows\\event2\\event.h"
@@ -488,12 +510,15 @@
 	#include <sys/stat.h>                  //Getting information about files attributes support
 	#include <sys/time.h>                  //Date and time support
 	#include <sys/types.h>                 //Types support
+	#include <sys/un.h>                    //Unix domain socket support
 #if defined(PLATFORM_FREEBSD)
 	#include <netinet/in.h>                //Internet Protocol family support
 	#include <sys/endian.h>                //Endian support
 	#include <sys/socket.h>                //Main sockets header support
 #elif defined(PLATFORM_LINUX)
 	#include <endian.h>                    //Endian support
+	#include <net/if.h>                    //Network interface support
+	#include <linux/if_packet.h>           //Packet socket and fanout support
 #elif defined(PLATFORM_MACOS)
 	#define __LITTLE_ENDIAN                1234                         //Little Endian
 	#define __BIG_ENDIAN                   4321                         //Big Endian
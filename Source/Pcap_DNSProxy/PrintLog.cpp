@@ -31,11 +31,173 @@ bool PrintError(
 //Print log level check, parameter check, message check and file name check
 	if (Parameter.PrintLogLevel == LOG_LEVEL_TYPE::LEVEL_0 || Message == nullptr || ErrorLevel > Parameter.PrintLogLevel)
 		return false;
-	std::wstring ErrorMessage(Message);
-	if (ErrorMessage.length() >= ERROR_MESSAGE_MINSIZE)
-		ErrorMessage.clear();
+	const auto MessageLength = wcsnlen_s(Message, LOG_EVENT_MESSAGE_MAXSIZE);
+	if (MessageLength < ERROR_MESSAGE_MINSIZE)
+		return false;
+
+//Block error messages when getting Network Unreachable and Host Unreachable error.
+	if (ErrorType == LOG_ERROR_TYPE::NETWORK && 
+		(Parameter.PrintLogLevel == LOG_LEVEL_TYPE::LEVEL_1 || Parameter.PrintLogLevel == LOG_LEVEL_TYPE::LEVEL_2) && 
+		(ErrorCode == WSAENETUNREACH || ErrorCode == WSAEHOSTUNREACH))
+			return true;
+
+//Queue message to log writer, formatting and writing are all done in log writer thread.
+//Messages before log writer started, fatal messages, messages with file names and long messages are written directly.
+	if (IsLogWriterRunning.load(std::memory_order_acquire) && ErrorLevel != LOG_LEVEL_TYPE::LEVEL_1 && 
+		FileName == nullptr && MessageLength < LOG_EVENT_MESSAGE_MAXSIZE)
+			return PrintLog_PushEvent(ErrorType, Message, ErrorCode, Line);
 	else 
+		return PrintLog_WriteError(ErrorType, Message, ErrorCode, FileName, Line, time(nullptr));
+}
+
+//Push log message to ring of current thread
+bool PrintLog_PushEvent(
+	const LOG_ERROR_TYPE ErrorType, 
+	const wchar_t * const Message, 
+	const ssize_t ErrorCode, 
+	const size_t Line)
+{
+//Register ring of current thread at its first queued message.
+	if (!LogEventRing_Local)
+	{
+		LogEventRing_Local = std::make_shared<LOG_EVENT_RING>();
+		LogEventRing_Local->ReadIndex.store(0, std::memory_order_relaxed);
+		LogEventRing_Local->WriteIndex.store(0, std::memory_order_relaxed);
+		LogEventRing_Local->RateTime = 0;
+		LogEventRing_Local->RateNum = 0;
+		std::lock_guard<std::mutex> LogEventRingMutex(LogEventRingLock);
+		LogEventRingList.push_back(LogEventRing_Local);
+	}
+
+//Rate limit and ring space check
+	auto &EventRing = *LogEventRing_Local;
+	const auto TimeValue = time(nullptr);
+	if (EventRing.RateTime != TimeValue)
+	{
+		EventRing.RateTime = TimeValue;
+		EventRing.RateNum = 0;
+	}
+	const auto WriteIndex = EventRing.WriteIndex.load(std::memory_order_relaxed);
+	if (EventRing.RateNum >= LOG_EVENT_RATE_MAXNUM || 
+		WriteIndex - EventRing.ReadIndex.load(std::memory_order_acquire) >= LOG_EVENT_RING_MAXNUM)
+	{
+		LogEventDropNum.fetch_add(1U, std::memory_order_relaxed);
 		return false;
+	}
+	else {
+		++EventRing.RateNum;
+	}
+
+//Copy message to ring, message is formatted later.
+	auto &EventItem = EventRing.EventList.at(WriteIndex % LOG_EVENT_RING_MAXNUM);
+	EventItem.TimeValue = TimeValue;
+	EventItem.ErrorType = ErrorType;
+	EventItem.ErrorCode = ErrorCode;
+	EventItem.Line = Line;
+	wcsncpy_s(EventItem.Message, LOG_EVENT_MESSAGE_MAXSIZE, Message, LOG_EVENT_MESSAGE_MAXSIZE - 1U);
+	EventItem.Message[LOG_EVENT_MESSAGE_MAXSIZE - 1U] = 0;
+	EventRing.WriteIndex.store(WriteIndex + 1U, std::memory_order_release);
+
+	return true;
+}
+
+//Log writer, write all queued log messages
+void PrintLogWriter(
+	void)
+{
+	IsLogWriterRunning.store(true, std::memory_order_release);
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		PrintLogFlush();
+		Sleep(LOG_EVENT_WRITE_INTERVAL_TIME);
+	}
+
+//Messages are written directly after exiting, exiting process waits for this flag before global objects are destroyed.
+	PrintLogFlush();
+	IsLogWriterRunning.store(false, std::memory_order_release);
+
+	return;
+}
+
+//Wait for log writer to exit and write all queued log messages
+void PrintLogWriterStop(
+	void)
+{
+//Log writer must not write any messages when global objects are being destroyed.
+	const auto TimeLimit = GetCurrentSystemTime() + STANDARD_THREAD_TIMEOUT;
+	while (IsLogWriterRunning.load(std::memory_order_acquire) && GetCurrentSystemTime() < TimeLimit)
+		Sleep(LOOP_INTERVAL_TIME_DELAY);
+	PrintLogFlush();
+
+	return;
+}
+
+//Write all queued log messages and report dropped messages
+void PrintLogFlush(
+	void)
+{
+//Only one flushing is allowed at the same time, flushing is skipped if log writer is writing.
+	std::unique_lock<std::mutex> LogWriterMutex(LogWriterLock, std::try_to_lock);
+	if (!LogWriterMutex.owns_lock())
+		return;
+
+//Copy ring list and remove all empty rings whose threads are exited.
+	std::vector<std::shared_ptr<LOG_EVENT_RING>> RingList;
+	std::unique_lock<std::mutex> LogEventRingMutex(LogEventRingLock);
+	for (auto RingItem = LogEventRingList.begin();RingItem != LogEventRingList.end();)
+	{
+		if (RingItem->use_count() == 1 && 
+			(*RingItem)->ReadIndex.load(std::memory_order_relaxed) == (*RingItem)->WriteIndex.load(std::memory_order_acquire))
+		{
+			RingItem = LogEventRingList.erase(RingItem);
+		}
+		else {
+			RingList.push_back(*RingItem);
+			++RingItem;
+		}
+	}
+	LogEventRingMutex.unlock();
+
+//Format and write all messages in rings.
+	for (auto &RingItem:RingList)
+	{
+		auto ReadIndex = RingItem->ReadIndex.load(std::memory_order_relaxed);
+		const auto WriteIndex = RingItem->WriteIndex.load(std::memory_order_acquire);
+		while (ReadIndex != WriteIndex)
+		{
+			const auto &EventItem = RingItem->EventList.at(ReadIndex % LOG_EVENT_RING_MAXNUM);
+			PrintLog_WriteError(EventItem.ErrorType, EventItem.Message, EventItem.ErrorCode, nullptr, EventItem.Line, EventItem.TimeValue);
+			++ReadIndex;
+			RingItem->ReadIndex.store(ReadIndex, std::memory_order_release);
+		}
+	}
+
+//Report dropped messages.
+	static time_t LastReportTime = 0;
+	const auto TimeValue = time(nullptr);
+	if ((TimeValue >= LastReportTime + static_cast<const time_t>(LOG_EVENT_DROP_INTERVAL_TIME) || !IsLogWriterRunning.load(std::memory_order_acquire)) && 
+		LogEventDropNum.load(std::memory_order_relaxed) > 0)
+	{
+		LastReportTime = TimeValue;
+		std::wstring Message(L"[Notice] ");
+		Message.append(std::to_wstring(LogEventDropNum.exchange(0, std::memory_order_relaxed)));
+		Message.append(L" log messages were dropped.\n");
+		WriteMessageToStream(Message, 0, 0, TimeValue);
+	}
+
+	return;
+}
+
+//Format and write log message
+bool PrintLog_WriteError(
+	const LOG_ERROR_TYPE ErrorType, 
+	const wchar_t * const Message, 
+	const ssize_t ErrorCode, 
+	const wchar_t * const FileName, 
+	const size_t Line, 
+	const time_t TimeValue)
+{
+	std::wstring ErrorMessage;
 
 //Log type
 	switch (ErrorType)
@@ -70,12 +232,7 @@ bool PrintError(
 	//About Windows Sockets error codes, please visit https://msdn.microsoft.com/en-us/library/windows/desktop/ms740668(v=vs.85).aspx.
 		case LOG_ERROR_TYPE::NETWORK:
 		{
-		//Block error messages when getting Network Unreachable and Host Unreachable error.
-			if ((Parameter.PrintLogLevel == LOG_LEVEL_TYPE::LEVEL_1 || Parameter.PrintLogLevel == LOG_LEVEL_TYPE::LEVEL_2) && 
-				(ErrorCode == WSAENETUNREACH || ErrorCode == WSAEHOSTUNREACH))
-					return true;
-			else 
-				ErrorMessage.append(L"[Network Error] ");
+			ErrorMessage.append(L"[Network Error] ");
 		}break;
 	//WinPcap and LibPcap Error
 	//About WinPcap/LibPcap error codes, please visit https://www.winpcap.org/docs/docs_40_2/html/group__wpcapfunc.html.
@@ -87,7 +244,7 @@ bool PrintError(
 			ErrorMessage.append(Message);
 			ErrorMessage.append(L"\n");
 
-			return WriteMessageToStream(ErrorMessage, ErrorCode, Line);
+			return WriteMessageToStream(ErrorMessage, ErrorCode, Line, TimeValue);
 		}break;
 	#endif
 	//DNSCurve Error
@@ -157,14 +314,15 @@ bool PrintError(
 
 //Print error log.
 	ErrorMessage.append(L".\n");
-	return WriteMessageToStream(ErrorMessage, ErrorCode, Line);
+	return WriteMessageToStream(ErrorMessage, ErrorCode, Line, TimeValue);
 }
 
 //Write message to stream
 bool WriteMessageToStream(
 	const std::wstring &Message, 
 	const ssize_t ErrorCode, 
-	const size_t Line)
+	const size_t Line, 
+	const time_t TimeValue)
 {
 //Buffer initialization
 	auto MessageBuffer = std::make_unique<wchar_t[]>(ERROR_MESSAGE_MAXSIZE + MEMORY_RESERVED_BYTES);
@@ -174,8 +332,7 @@ bool WriteMessageToStream(
 	std::wstring CurrentTimeString;
 	if (CurrentTimeString.empty())
 	{
-	//Get current time.
-		const auto TimeValue = time(nullptr);
+	//Get message time.
 		tm TimeStructure;
 		memset(&TimeStructure, 0, sizeof(TimeStructure));
 		if (TimeValue <= 0
@@ -212,16 +369,16 @@ bool WriteMessageToStream(
 	if (GlobalRunningStatus.StartupTime > 0)
 	{
 	//Copy startup time and reset global value.
-		const auto TimeValue = GlobalRunningStatus.StartupTime;
+		const auto StartupTime = GlobalRunningStatus.StartupTime;
 		GlobalRunningStatus.StartupTime = 0;
 
 	//Get log startup time.
 		tm TimeStructure;
 		memset(&TimeStructure, 0, sizeof(TimeStructure));
 	#if defined(PLATFORM_WIN)
-		if (localtime_s(&TimeStructure, &TimeValue) != 0)
+		if (localtime_s(&TimeStructure, &StartupTime) != 0)
 	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-		if (localtime_r(&TimeValue, &TimeStructure) == nullptr)
+		if (localtime_r(&StartupTime, &TimeStructure) == nullptr)
 	#endif
 			return false;
 
@@ -31,12 +31,51 @@ extern std::vector<FILE_DATA> FileList_DNSCurveDatabase;
 #endif
 extern std::mutex ScreenLock;
 
+//Structure definitions
+//Log message which is queued to log writer, it will be formatted by log writer.
+typedef struct _log_event_data_
+{
+	time_t                                                TimeValue;
+	LOG_ERROR_TYPE                                        ErrorType;
+	ssize_t                                               ErrorCode;
+	size_t                                                Line;
+	wchar_t                                               Message[LOG_EVENT_MESSAGE_MAXSIZE];
+}LogEventData, LOG_EVENT_DATA;
+
+//Log message ring of each thread, only its own thread writes and only log writer reads.
+typedef struct _log_event_ring_
+{
+	std::array<LOG_EVENT_DATA, LOG_EVENT_RING_MAXNUM>     EventList;
+	std::atomic<size_t>                                   ReadIndex;
+	std::atomic<size_t>                                   WriteIndex;
+	time_t                                                RateTime;
+	size_t                                                RateNum;
+}LogEventRing, LOG_EVENT_RING;
+
 //Local variables
 std::mutex ErrorLogLock;
+std::atomic<bool> IsLogWriterRunning(false);
+std::atomic<size_t> LogEventDropNum(0);
+std::vector<std::shared_ptr<LOG_EVENT_RING>> LogEventRingList;
+std::mutex LogEventRingLock, LogWriterLock;
+thread_local std::shared_ptr<LOG_EVENT_RING> LogEventRing_Local;
 
 //Functions
+bool PrintLog_PushEvent(
+	const LOG_ERROR_TYPE ErrorType, 
+	const wchar_t * const Message, 
+	const ssize_t ErrorCode, 
+	const size_t Line);
+bool PrintLog_WriteError(
+	const LOG_ERROR_TYPE ErrorType, 
+	const wchar_t * const Message, 
+	const ssize_t ErrorCode, 
+	const wchar_t * const FileName, 
+	const size_t Line, 
+	const time_t TimeValue);
 bool WriteMessageToStream(
 	const std::wstring &Message, 
 	const ssize_t ErrorCode, 
-	const size_t Line);
+	const size_t Line, 
+	const time_t TimeValue);
 #endif
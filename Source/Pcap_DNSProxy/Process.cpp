@@ -21,27 +21,23 @@
 
 //Montior request provider
 void MonitorRequestProvider(
-	const MONITOR_QUEUE_DATA &MonitorQueryData)
+	const size_t DescriptorIndex)
 {
-//Add to blocking queue.
-	MonitorBlockingQueue.push(MonitorQueryData);
-
-//Thread pool check
-	if (Parameter.ThreadPoolBaseNum > 0 && GlobalRunningStatus.ThreadRunningFreeNum->load() == 0 && 
-		GlobalRunningStatus.ThreadRunningNum->load() < Parameter.ThreadPoolMaxNum)
+//Submit descriptor index to task executor.
+	if (!TaskExecutor.Submit(std::bind(MonitorRequestConsumer, DescriptorIndex, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3)))
 	{
-		auto ThreadIncreaseNum = Parameter.ThreadPoolBaseNum;
-		if (GlobalRunningStatus.ThreadRunningNum->load() + Parameter.ThreadPoolBaseNum > Parameter.ThreadPoolMaxNum)
-			ThreadIncreaseNum = Parameter.ThreadPoolMaxNum - GlobalRunningStatus.ThreadRunningNum->load();
-		(*GlobalRunningStatus.ThreadRunningNum) += ThreadIncreaseNum;
-		(*GlobalRunningStatus.ThreadRunningFreeNum) += ThreadIncreaseNum;
-
-	//Start threads.
-		for (size_t Index = 0;Index < ThreadIncreaseNum;++Index)
+	//Close accepted socket or finish its session when executor is not available.
+		auto &MonitorQueryData = QueryDescriptorPool.Descriptor(DescriptorIndex);
+		if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP)
 		{
-			std::thread Thread_MonitorConsumer(std::bind(MonitorRequestConsumer));
-			Thread_MonitorConsumer.detach();
+			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length == 0)
+				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+			else 
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 		}
+
+	//Return descriptor to pool.
+		QueryDescriptorPool.Release(DescriptorIndex);
 	}
 
 	return;
@@ -49,75 +45,39 @@ void MonitorRequestProvider(
 
 //Monitor request consumer
 void MonitorRequestConsumer(
-	void)
+	const size_t DescriptorIndex, 
+	uint8_t * const SendBuffer, 
+	uint8_t * const RecvBuffer, 
+	const size_t BufferSize)
 {
-//Initialization
-	MONITOR_QUEUE_DATA MonitorQueryData;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = nullptr;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = 0;
-	memset(&MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, 0, sizeof(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget));
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalRequest = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.IsLocalInWhite = false;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_QuestionLen = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AnswerCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AuthorityCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Records_AdditionalCount = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location = 0;
-	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length = 0;
-	const auto SendBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	const auto RecvBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	memset(RecvBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-	size_t LastActiveTime = 0;
-
-//Start request Monitor consumer.
-	while (!GlobalRunningStatus.IsNeedExit)
+//Copy request to worker buffer.
+	auto &MonitorQueryData = QueryDescriptorPool.Descriptor(DescriptorIndex);
+	if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer != nullptr && MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length > 0)
+		memcpy_s(SendBuffer, BufferSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length);
+	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = SendBuffer;
+	MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = BufferSize;
+
+//Handle process, queries in client TCP sessions are processed like UDP queries.
+	if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length == 0)
+		TCP_AcceptProcess(MonitorQueryData, RecvBuffer, BufferSize);
+	else if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP || MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_UDP)
 	{
-	//Reset parameters.
-		memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		memset(RecvBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		if (Parameter.ThreadPoolBaseNum > 0)
-			LastActiveTime = static_cast<const size_t>(GetCurrentSystemTime());
-
-	//Pop from blocking queue.
-		MonitorBlockingQueue.pop(MonitorQueryData);
-		if (Parameter.ThreadPoolBaseNum > 0 && GlobalRunningStatus.ThreadRunningFreeNum->load() > 0)
-			--(*GlobalRunningStatus.ThreadRunningFreeNum);
-
-	//Handle process
-		memcpy_s(SendBuffer.get(), Parameter.LargeBufferSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length);
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer = SendBuffer.get();
-		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize = Parameter.LargeBufferSize;
-		if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP)
-			TCP_AcceptProcess(MonitorQueryData, RecvBuffer.get(), Parameter.LargeBufferSize);
-		else if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_UDP)
-			EnterRequestProcess(MonitorQueryData, RecvBuffer.get(), Parameter.LargeBufferSize);
-
-	//Thread pool check
-		if (Parameter.ThreadPoolBaseNum > 0)
-		{
-			if (static_cast<const uint64_t>(LastActiveTime) + static_cast<const uint64_t>(Parameter.ThreadPoolResetTime) <= GetCurrentSystemTime() && 
-				GlobalRunningStatus.ThreadRunningNum->load() > Parameter.ThreadPoolBaseNum && 
-				GlobalRunningStatus.ThreadRunningFreeNum->load() > 0)
-			{
-				--(*GlobalRunningStatus.ThreadRunningNum);
-				break;
-			}
-			else {
-				++(*GlobalRunningStatus.ThreadRunningFreeNum);
-			}
-		}
+	//Duration is only recorded when response is sent by current thread, responses matched by Pcap Capture are recorded by capture threads.
+		const auto BeginTime = std::chrono::steady_clock::now();
+		const auto ResponseNum = Statistics_GetCounter(STATISTICS_COUNTER_RESPONSE);
+		EnterRequestProcess(MonitorQueryData, RecvBuffer, BufferSize);
+		if (Statistics_GetCounter(STATISTICS_COUNTER_RESPONSE) != ResponseNum)
+			Statistics_AddLatency(static_cast<const uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - BeginTime).count()));
 	}
 
+//Return descriptor to pool.
+	QueryDescriptorPool.Release(DescriptorIndex);
 	return;
 }
 
 //Independent request process
 bool EnterRequestProcess(
-	MONITOR_QUEUE_DATA MonitorQueryData, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	uint8_t *RecvBuffer, 
 	size_t RecvSize)
 {
@@ -169,6 +129,12 @@ bool EnterRequestProcess(
 			Parameter.LocalProtocol_Transport == REQUEST_MODE_TRANSPORT::FORCE_TCP || Parameter.LocalProtocol_Transport == REQUEST_MODE_TRANSPORT::TCP || //Local request
 			(Parameter.SOCKS_Proxy && Parameter.SOCKS_Protocol_Transport == REQUEST_MODE_TRANSPORT::TCP) || //SOCKS TCP request
 			Parameter.HTTP_CONNECT_Proxy //HTTP CONNECT Proxy request
+		#if defined(ENABLE_TLS)
+		#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+			|| Parameter.IsDNS_TLS //DNS over TLS request
+			|| Parameter.IsDNS_HTTPS //DNS over HTTPS request
+		#endif
+		#endif
 		#if defined(ENABLE_LIBSODIUM)
 			|| (Parameter.IsDNSCurve && 
 			(DNSCurveParameter.DNSCurveProtocol_Transport == REQUEST_MODE_TRANSPORT::FORCE_TCP || DNSCurveParameter.DNSCurveProtocol_Transport == REQUEST_MODE_TRANSPORT::TCP)) //DNSCurve TCP request
@@ -212,7 +178,7 @@ bool EnterRequestProcess(
 		{
 		//Fin TCP request connection.
 			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 			return ResultValue;
 		}
@@ -227,7 +193,7 @@ bool EnterRequestProcess(
 		if (DataLength > MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length)
 		{
 			MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length = DataLength;
-			MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request.clear();
+			MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request[0] = 0;
 		}
 	}
 
@@ -243,7 +209,7 @@ bool EnterRequestProcess(
 		{
 		//Fin TCP request connection.
 			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 			return true;
 		}
@@ -261,18 +227,58 @@ bool EnterRequestProcess(
 		{
 		//Fin TCP request connection.
 			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 			return true;
 		}
 	}
 
+//DNS over TLS request process
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (Parameter.IsDNS_TLS)
+	{
+	//DNS over TLS request
+		if (TLS_RequestProcess(REQUEST_PROCESS_TYPE::DNS_TLS_MAIN, MonitorQueryData, RecvBuffer, RecvSize, EDNS_Buffer))
+			return true;
+
+	//DNS over TLS Only mode
+		if (Parameter.DNS_TLS_Only)
+		{
+		//Fin TCP request connection.
+			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
+
+			return true;
+		}
+	}
+
+//DNS over HTTPS request process
+	if (Parameter.IsDNS_HTTPS)
+	{
+	//DNS over HTTPS request
+		if (TLS_RequestProcess(REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN, MonitorQueryData, RecvBuffer, RecvSize, EDNS_Buffer))
+			return true;
+
+	//DNS over HTTPS Only mode
+		if (Parameter.DNS_HTTPS_Only)
+		{
+		//Fin TCP request connection.
+			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
+
+			return true;
+		}
+	}
+#endif
+#endif
+
 //Direct Request request process
 	if (Parameter.DirectRequest_Protocol != REQUEST_MODE_DIRECT::NONE && DirectRequestProcess(MonitorQueryData, RecvBuffer, RecvSize, EDNS_Buffer, false))
 	{
 	//Fin TCP request connection.
 		if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+			TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 		return true;
 	}
@@ -294,7 +300,7 @@ bool EnterRequestProcess(
 		{
 		//Fin TCP request connection.
 			if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-				SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+				TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 			return true;
 		}
@@ -319,7 +325,7 @@ SkipProcess_DNSCurve:
 
 	//Fin TCP request connection.
 		if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-			SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+			TCP_SessionFinish(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer);
 
 		return true;
 #if defined(ENABLE_PCAP)
@@ -438,7 +444,7 @@ size_t CheckHostsProcess(
 			return EXIT_SUCCESS;
 	}
 //Request check
-	else if (CheckQueryNameLength(PacketStructure->Buffer + sizeof(dns_hdr), PacketStructure->BufferSize - sizeof(dns_hdr)) + NULL_TERMINATE_LENGTH < DOMAIN_MAXSIZE)
+	else if (PacketStructure->Records_QuestionLen > sizeof(dns_qry) && PacketStructure->Records_QuestionLen - sizeof(dns_qry) < DOMAIN_MAXSIZE)
 	{
 		DataLength = PacketQueryToString(PacketStructure->Buffer + sizeof(dns_hdr), PacketStructure->BufferSize - sizeof(dns_hdr), OriginalDomain);
 		if (DataLength <= DOMAIN_MINSIZE || DataLength >= DOMAIN_MAXSIZE || OriginalDomain.empty())
@@ -872,9 +878,14 @@ size_t CheckHostsProcess(
 			//Check white and banned hosts list, empty record type list check
 				DataLength = CheckWhiteBannedHostsProcess(PacketStructure->Length, HostsTableItem, DNS_Header, PacketStructure->QueryType);
 				if (DataLength >= DNS_PACKET_MINSIZE)
+				{
+					Statistics_AddCounter(STATISTICS_COUNTER_HOSTS_HIT);
 					return DataLength;
+				}
 				else if (DataLength == EXIT_FAILURE)
+				{
 					goto StopLoop_NormalHosts;
+				}
 
 			//Initialization
 				size_t RandomValue = 0, Index = 0;
@@ -944,6 +955,8 @@ size_t CheckHostsProcess(
 				//Rebuild DNS header counts.
 					DNS_Header->Answer = hton16(static_cast<const uint16_t>(Index));
 					DNS_Header->Authority = 0;
+					Statistics_AddCounter(STATISTICS_COUNTER_HOSTS_HIT);
+
 					return DataLength;
 				}
 			//A record
@@ -1011,6 +1024,8 @@ size_t CheckHostsProcess(
 				//Rebuild DNS header counts.
 					DNS_Header->Answer = hton16(static_cast<const uint16_t>(Index));
 					DNS_Header->Authority = 0;
+					Statistics_AddCounter(STATISTICS_COUNTER_HOSTS_HIT);
+
 					return DataLength;
 				}
 			}
@@ -1029,7 +1044,13 @@ StopLoop_NormalHosts:
 	{
 		DataLength = CheckDomainCache(ResultBuffer, ResultSize, OriginalDomain, PacketStructure->QueryType, LocalSocketData);
 		if (DataLength >= DNS_PACKET_MINSIZE)
+		{
+			Statistics_AddCounter(STATISTICS_COUNTER_CACHE_HIT);
 			return DataLength;
+		}
+		else {
+			Statistics_AddCounter(STATISTICS_COUNTER_CACHE_MISS);
+		}
 	}
 
 //Local Hosts check
@@ -1061,11 +1082,18 @@ StopLoop_NormalHosts:
 			//Check white and banned hosts list.
 				DataLength = CheckWhiteBannedHostsProcess(PacketStructure->Length, HostsTableItem, DNS_Header, PacketStructure->QueryType);
 				if (DataLength >= DNS_PACKET_MINSIZE)
+				{
+					Statistics_AddCounter(STATISTICS_COUNTER_HOSTS_HIT);
 					return DataLength;
+				}
 				else if (DataLength == EXIT_FAILURE)
+				{
 					PacketStructure->IsLocalRequest = false;
+				}
 				else if (DataLength == EXIT_SUCCESS)
+				{
 					PacketStructure->IsLocalRequest = true;
+				}
 
 			//Mark Local server target.
 				if (PacketStructure->IsLocalRequest && !HostsTableItem.AddrOrTargetList.empty())
@@ -1085,9 +1113,11 @@ StopLoop_LocalHosts:
 	if (Parameter.DomainCaseConversion)
 	{
 		MakeDomainCaseConversion(PacketStructure->Buffer + sizeof(dns_hdr), PacketStructure->BufferSize - sizeof(dns_hdr));
-		PacketStructure->DomainString_Request = reinterpret_cast<const char *>(PacketStructure->Buffer) + sizeof(dns_hdr);
-		if (PacketStructure->DomainString_Request.length() != PacketStructure->DomainString_Original.length())
+		const auto DomainLength = strnlen_s(reinterpret_cast<const char *>(PacketStructure->Buffer) + sizeof(dns_hdr), DOMAIN_MAXSIZE);
+		if (DomainLength >= DOMAIN_MAXSIZE || DomainLength != strnlen_s(reinterpret_cast<const char *>(PacketStructure->DomainString_Original), DOMAIN_MAXSIZE))
 			return EXIT_FAILURE;
+		memcpy_s(PacketStructure->DomainString_Request, DOMAIN_MAXSIZE, PacketStructure->Buffer + sizeof(dns_hdr), DomainLength);
+		PacketStructure->DomainString_Request[DomainLength] = 0;
 	}
 
 	return EXIT_SUCCESS;
@@ -1141,7 +1171,7 @@ bool LocalRequestProcess(
 	//Send response.
 		if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 		{
-			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 			return true;
 		}
 
@@ -1154,7 +1184,7 @@ bool LocalRequestProcess(
 	DataLength = UDP_CompleteRequestSingle(RequestType, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.LocalTarget, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 	if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1218,7 +1248,7 @@ bool SOCKS_RequestProcess(
 	//Send response.
 		if (RecvBuffer && RecvSize >= DNS_PACKET_MINSIZE && DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 		{
-			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 			return true;
 		}
 		else {
@@ -1237,7 +1267,7 @@ bool SOCKS_RequestProcess(
 //Send response.
 	if (RecvBuffer && RecvSize >= DNS_PACKET_MINSIZE && DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1296,7 +1326,69 @@ bool HTTP_CONNECT_RequestProcess(
 //Send response.
 	if (RecvBuffer && RecvSize >= DNS_PACKET_MINSIZE && DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, RecvBuffer.get(), DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		return true;
+	}
+
+//EDNS switching(Part 2)
+	if (IsNeedStoreEDNS)
+	{
+	//Copy back EDNS Label.
+		memcpy_s(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer + MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.BufferSize - MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location, EDNS_Buffer.get(), MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length);
+		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length += MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length;
+
+	//Rebuild DNS header counts.
+		reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags = EDNS_Packet_Flags;
+		reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Additional = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Additional) + 1U);
+	}
+
+	return false;
+}
+
+//Request Process(DNS over TLS and DNS over HTTPS part)
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+bool TLS_RequestProcess(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	std::unique_ptr<uint8_t[]> &EDNS_Buffer)
+{
+//EDNS switching(Part 1)
+	const auto EDNS_Packet_Flags = reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags;
+	auto IsNeedStoreEDNS = false;
+	if (Parameter.EDNS_Label && !Parameter.EDNS_Switch_TCP && MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location > 0 && MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length > 0)
+		IsNeedStoreEDNS = true;
+	if (IsNeedStoreEDNS)
+	{
+	//Store EDNS Label temporary.
+		if (!EDNS_Buffer)
+		{
+			auto BufferTemp = std::make_unique<uint8_t[]>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length + MEMORY_RESERVED_BYTES);
+			memset(BufferTemp.get(), 0, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length + MEMORY_RESERVED_BYTES);
+			memcpy_s(BufferTemp.get(), MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer + MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length);
+			EDNS_Buffer.swap(BufferTemp);
+		}
+
+	//Remove EDNS Label.
+		memset(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer + MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Location, 0, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length);
+		MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length -= MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length;
+
+	//Build DNS header counts.
+		reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags) & (~DNS_FLAG_GET_BIT_AD));
+		reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Flags) & (~DNS_FLAG_GET_BIT_CD));
+		if (reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Additional > 0)
+			reinterpret_cast<dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Additional = hton16(ntoh16(reinterpret_cast<const dns_hdr *>(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer)->Additional) - 1U);
+	}
+
+//DNS over TLS or DNS over HTTPS request
+	const auto DataLength = TLS_RequestSingle(RequestType, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+
+//Send response.
+	if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
+	{
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1314,6 +1406,8 @@ bool HTTP_CONNECT_RequestProcess(
 
 	return false;
 }
+#endif
+#endif
 
 //Request Process(Direct connections part)
 bool DirectRequestProcess(
@@ -1373,7 +1467,7 @@ bool DirectRequestProcess(
 	//Send response.
 		if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 		{
-			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 			return true;
 		}
 
@@ -1391,7 +1485,7 @@ bool DirectRequestProcess(
 //Send response.
 	if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1455,6 +1549,9 @@ bool DNSCurveRequestProcess(
 	//Multiple request process
 		if (Parameter.AlternateMultipleRequest || Parameter.MultipleRequestTimes > 1U)
 			DataLength = DNSCurve_TCP_RequestMultiple(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+	//Persistent transport process
+		else if (DNSCurveParameter.IsEncryption)
+			DataLength = DNSCurve_TransportRequest(IPPROTO_TCP, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 	//Normal request process
 		else 
 			DataLength = DNSCurve_TCP_RequestSingle(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
@@ -1462,7 +1559,7 @@ bool DNSCurveRequestProcess(
 	//Send response.
 		if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 		{
-			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+			SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 			return true;
 		}
 
@@ -1474,13 +1571,15 @@ bool DNSCurveRequestProcess(
 //UDP request
 	if (Parameter.AlternateMultipleRequest || Parameter.MultipleRequestTimes > 1U) //Multiple request process
 		DataLength = DNSCurve_UDP_RequestMultiple(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+	else if (DNSCurveParameter.IsEncryption) //Persistent transport process
+		DataLength = DNSCurve_TransportRequest(IPPROTO_UDP, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 	else //Normal request process
 		DataLength = DNSCurve_UDP_RequestSingle(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, OriginalRecv, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 
 //Send response.
 	if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1548,7 +1647,7 @@ bool TCP_RequestProcess(
 //Send response.
 	if (DataLength >= DNS_PACKET_MINSIZE && DataLength < RecvSize)
 	{
-		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
+		SendToRequester(MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, OriginalRecv, DataLength, RecvSize, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET);
 		return true;
 	}
 
@@ -1601,14 +1700,12 @@ void UDP_RequestProcess(
 
 //Multiple request process
 	if (Parameter.AlternateMultipleRequest || Parameter.MultipleRequestTimes > 1U)
-		UDP_RequestMultiple(REQUEST_PROCESS_TYPE::UDP_NORMAL, 0, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET /* , &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length */ );
+		UDP_RequestMultiple(REQUEST_PROCESS_TYPE::UDP_NORMAL, 0, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET /* , &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length */ );
 //Normal request process
 	else 
-		UDP_RequestSingle(REQUEST_PROCESS_TYPE::UDP_NORMAL, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET /* , &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length */ );
+		UDP_RequestSingle(REQUEST_PROCESS_TYPE::UDP_NORMAL, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Buffer, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Length, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.QueryType, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Original, MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.DomainString_Request, &MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET /* , &MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.EDNS_Length */ );
 
-//Fin TCP request connection.
-	if (MonitorQueryData.MONITOR_QUEUE_DATA_DNS_PACKET.Protocol == IPPROTO_TCP && SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-		SocketSetting(MonitorQueryData.MONITOR_QUEUE_DATA_SOCKET.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+//TCP request connection is kept open, response from capture module is sent to client TCP session.
 
 /* UDP_RequestProcess is the last process, no need to restore the packet.
 //EDNS switching(Part 2)
@@ -1634,8 +1731,8 @@ bool SendToRequester(
 	uint8_t * const RecvBuffer, 
 	const size_t RecvSize, 
 	const size_t BufferSize, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	SOCKET_DATA &LocalSocketData)
 {
 //Response check
@@ -1651,20 +1748,21 @@ bool SendToRequester(
 	{
 		return false;
 	}
-	else if (QuestionLen > DOMAIN_MINSIZE && DomainString_Original != nullptr && !DomainString_Original->empty())
+	else if (QuestionLen > DOMAIN_MINSIZE && DomainString_Original != nullptr && DomainString_Original[0] != 0)
 	{
 	//Request domain check
-		if (DomainString_Request != nullptr && !DomainString_Request->empty())
+		const auto OriginalLength = strnlen_s(reinterpret_cast<const char *>(DomainString_Original), DOMAIN_MAXSIZE);
+		if (DomainString_Request != nullptr && DomainString_Request[0] != 0)
 		{
 		//Original and request domain length check
-			if (DomainString_Request->length() != DomainString_Original->length())
+			if (strnlen_s(reinterpret_cast<const char *>(DomainString_Request), DOMAIN_MAXSIZE) != OriginalLength)
 				return false;
 
 		//Request domain data check and restore original domain.
-			if (QuestionLen == DomainString_Request->length())
+			if (QuestionLen == OriginalLength)
 			{
-				if (memcmp(RecvBuffer + sizeof(dns_hdr), DomainString_Request->c_str(), DomainString_Request->length()) == 0)
-					memcpy_s(RecvBuffer + sizeof(dns_hdr), RecvSize - sizeof(dns_hdr), DomainString_Original->c_str(), DomainString_Original->length());
+				if (memcmp(RecvBuffer + sizeof(dns_hdr), DomainString_Request, OriginalLength) == 0)
+					memcpy_s(RecvBuffer + sizeof(dns_hdr), RecvSize - sizeof(dns_hdr), DomainString_Original, OriginalLength);
 				else 
 					return false;
 			}
@@ -1679,8 +1777,8 @@ bool SendToRequester(
 				if (RecvBuffer[Index] == 0)
 				{
 				//Restore the original domain.
-					if (QuestionLen == DomainString_Original->length())
-						memcpy_s(RecvBuffer + sizeof(dns_hdr), RecvSize - sizeof(dns_hdr), DomainString_Original->c_str(), DomainString_Original->length());
+					if (QuestionLen == OriginalLength)
+						memcpy_s(RecvBuffer + sizeof(dns_hdr), RecvSize - sizeof(dns_hdr), DomainString_Original, OriginalLength);
 
 					break;
 				}
@@ -1697,12 +1795,13 @@ bool SendToRequester(
 	{
 		if (AddLengthDataToHeader(RecvBuffer, RecvSize, BufferSize) == EXIT_FAILURE)
 		{
-			SocketSetting(LocalSocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+			TCP_SessionFinish(LocalSocketData, RecvBuffer);
 			return false;
 		}
-		else {
-			send(LocalSocketData.Socket, reinterpret_cast<const char *>(RecvBuffer), static_cast<const int>(RecvSize + sizeof(uint16_t)), 0);
-			SocketSetting(LocalSocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	//Client TCP connection is kept open for next queries.
+		else if (!TCP_SessionResponse(LocalSocketData, RecvBuffer, RecvSize + sizeof(uint16_t)))
+		{
+			return false;
 		}
 	}
 //UDP protocol
@@ -1714,5 +1813,6 @@ bool SendToRequester(
 		return false;
 	}
 
+	Statistics_AddCounter(STATISTICS_COUNTER_RESPONSE);
 	return true;
 }
@@ -25,7 +25,8 @@
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
-extern BLOCKING_QUEUE<MONITOR_QUEUE_DATA> MonitorBlockingQueue;
+extern TASK_EXECUTOR_TABLE TaskExecutor;
+extern QUERY_DESCRIPTOR_POOL_TABLE &QueryDescriptorPool;
 #if defined(ENABLE_LIBSODIUM)
 extern DNSCURVE_CONFIGURATION_TABLE DNSCurveParameter;
 #endif
@@ -46,6 +47,16 @@ bool SOCKS_RequestProcess(
 bool HTTP_CONNECT_RequestProcess(
 	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	std::unique_ptr<uint8_t[]> &EDNS_Buffer);
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+bool TLS_RequestProcess(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	MONITOR_QUEUE_DATA &MonitorQueryData, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	std::unique_ptr<uint8_t[]> &EDNS_Buffer);
+#endif
+#endif
 bool DirectRequestProcess(
 	MONITOR_QUEUE_DATA &MonitorQueryData, 
 	uint8_t * const OriginalRecv, 
@@ -808,6 +808,92 @@ size_t CheckQueryNameLength(
 	return Index;
 }
 
+//Build DNS message index in one pass
+bool BuildMessageIndex(
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	DNS_MESSAGE_INDEX &MessageIndex)
+{
+//Initialization
+	MessageIndex.Length = 0;
+	MessageIndex.Records_QuestionNameLen = 0;
+	MessageIndex.QueryType = 0;
+	MessageIndex.Records_Num = 0;
+	MessageIndex.EDNS_Location = 0;
+	MessageIndex.EDNS_Length = 0;
+	if (Buffer == nullptr || Length < sizeof(dns_hdr) || Length > UINT16_MAX)
+		return false;
+	const auto DNS_Header = reinterpret_cast<const dns_hdr *>(Buffer);
+	MessageIndex.Records_AnswerCount = ntoh16(DNS_Header->Answer);
+	MessageIndex.Records_AuthorityCount = ntoh16(DNS_Header->Authority);
+	MessageIndex.Records_AdditionalCount = ntoh16(DNS_Header->Additional);
+
+//Each resource record has one byte of name and standard header at least.
+	const auto RecordsCount = MessageIndex.Records_AnswerCount + MessageIndex.Records_AuthorityCount + MessageIndex.Records_AdditionalCount;
+	if (RecordsCount * (NULL_TERMINATE_LENGTH + sizeof(dns_record_standard)) > Length - sizeof(dns_hdr))
+		return false;
+	MessageIndex.Records_Location.resize(RecordsCount);
+	MessageIndex.Records_StandardLocation.resize(RecordsCount);
+	MessageIndex.Records_Type.resize(RecordsCount);
+
+//Question
+	size_t DataLength = sizeof(dns_hdr);
+	if (DNS_Header->Question != 0)
+	{
+		MessageIndex.Records_QuestionNameLen = CheckQueryNameLength(Buffer + sizeof(dns_hdr), Length - sizeof(dns_hdr));
+		DataLength += MessageIndex.Records_QuestionNameLen + NULL_TERMINATE_LENGTH;
+		if (MessageIndex.Records_QuestionNameLen >= DOMAIN_MAXSIZE || DataLength + sizeof(dns_qry) > Length)
+			return false;
+
+		MessageIndex.QueryType = reinterpret_cast<const dns_qry *>(Buffer + DataLength)->Type;
+		DataLength += sizeof(dns_qry);
+	}
+
+//Scan all resource records.
+	for (size_t Index = 0;Index < RecordsCount;++Index)
+	{
+	//Domain pointer check
+		if (DataLength + sizeof(uint16_t) >= Length)
+		{
+			return false;
+		}
+		else if (Buffer[DataLength] >= DNS_POINTER_8_BITS)
+		{
+			const uint16_t DNS_Pointer = ntoh16(*reinterpret_cast<const uint16_t *>(Buffer + DataLength)) & DNS_POINTER_BIT_GET_LOCATE;
+			if (DNS_Pointer >= Length || DNS_Pointer < sizeof(dns_hdr) || DNS_Pointer == DataLength || DNS_Pointer == DataLength + NULL_TERMINATE_LENGTH)
+				return false;
+		}
+
+	//Resource records name check
+		MessageIndex.Records_Location[Index] = static_cast<const uint16_t>(DataLength);
+		DataLength += CheckQueryNameLength(Buffer + DataLength, Length - DataLength) + NULL_TERMINATE_LENGTH;
+		if (DataLength + sizeof(dns_record_standard) > Length)
+			return false;
+
+	//Standard resource records check
+		const auto DNS_Record_Standard = reinterpret_cast<const dns_record_standard *>(Buffer + DataLength);
+		MessageIndex.Records_StandardLocation[Index] = static_cast<const uint16_t>(DataLength);
+		MessageIndex.Records_Type[Index] = ntoh16(DNS_Record_Standard->Type);
+		DataLength += sizeof(dns_record_standard);
+		if (DataLength + ntoh16(DNS_Record_Standard->Length) > Length)
+			return false;
+		else 
+			DataLength += ntoh16(DNS_Record_Standard->Length);
+
+	//Mark first EDNS Label location.
+		if (MessageIndex.Records_Type[Index] == DNS_TYPE_OPT && MessageIndex.EDNS_Length == 0)
+		{
+			MessageIndex.EDNS_Location = MessageIndex.Records_Location[Index];
+			MessageIndex.EDNS_Length = DataLength - MessageIndex.EDNS_Location;
+		}
+
+		++MessageIndex.Records_Num;
+	}
+
+	MessageIndex.Length = Length;
+	return true;
+}
+
 //Check DNS query data
 bool CheckQueryData(
 	DNS_PACKET_DATA * const PacketStructure, 
@@ -838,6 +924,10 @@ bool CheckQueryData(
 //Check address only.
 	if (PacketStructure == nullptr || SendBuffer == nullptr || PacketStructure->Protocol == 0 || PacketStructure->Length < DNS_PACKET_MINSIZE)
 		return true;
+	else if (PacketStructure->Protocol == IPPROTO_TCP)
+		Statistics_AddCounter(STATISTICS_COUNTER_QUERY_TCP);
+	else 
+		Statistics_AddCounter(STATISTICS_COUNTER_QUERY_UDP);
 
 //Check request packet data.
 	const auto DNS_Header = reinterpret_cast<dns_hdr *>(PacketStructure->Buffer);
@@ -917,7 +1007,10 @@ bool CheckQueryData(
 		else {
 			PacketIndex = strnlen_s(reinterpret_cast<const char *>(PacketStructure->Buffer) + sizeof(dns_hdr), PacketStructure->Length);
 			if (PacketIndex < PacketStructure->Length && PacketIndex < DOMAIN_MAXSIZE && PacketIndex + NULL_TERMINATE_LENGTH + sizeof(dns_qry) == PacketStructure->Records_QuestionLen)
-				PacketStructure->DomainString_Original = reinterpret_cast<const char *>(PacketStructure->Buffer) + sizeof(dns_hdr);
+			{
+				memcpy_s(PacketStructure->DomainString_Original, DOMAIN_MAXSIZE, PacketStructure->Buffer + sizeof(dns_hdr), PacketIndex);
+				PacketStructure->DomainString_Original[PacketIndex] = 0;
+			}
 		}
 	}
 
@@ -994,6 +1087,7 @@ bool CheckQueryData(
 		RecordLength += sizeof(dns_record_standard) + ntoh16(DNS_Record_Standard->Length);
 		PacketStructure->Records_Location.push_back(PacketIndex);
 		PacketStructure->Records_Length.push_back(RecordLength);
+		++PacketStructure->Records_Num;
 		PacketIndex += RecordLength;
 
 	//Mark counts.
@@ -1031,7 +1125,7 @@ bool CheckQueryData(
 
 //Mark DNS query type.
 	if (PacketStructure->Records_QuestionLen != 0)
-		PacketStructure->QueryType = reinterpret_cast<const dns_qry *>(PacketStructure->Buffer + DNS_PACKET_QUERY_LOCATE(PacketStructure->Buffer, PacketStructure->BufferSize))->Type;
+		PacketStructure->QueryType = reinterpret_cast<const dns_qry *>(PacketStructure->Buffer + sizeof(dns_hdr) + PacketStructure->Records_QuestionLen - sizeof(dns_qry))->Type;
 
 //EDNS Label
 	auto IsNeedTruncated = false;
@@ -1064,6 +1158,7 @@ bool CheckQueryData(
 	const auto DataLength = CheckHostsProcess(PacketStructure, SendBuffer, SendSize, LocalSocketData);
 	if (DataLength >= DNS_PACKET_MINSIZE)
 	{
+		Statistics_AddCounter(STATISTICS_COUNTER_LOCAL_ANSWER);
 		SendToRequester(PacketStructure->Protocol, SendBuffer, DataLength, SendSize, nullptr, nullptr, LocalSocketData);
 		return false;
 	}
@@ -1109,6 +1204,7 @@ bool CheckConnectionStreamFin(
 	//HTTP version 2 response
 		else if (Length >= sizeof(http2_frame_hdr))
 		{
+			size_t DataLength = 0, MessageLength = 0;
 			for (size_t Index = 0;Index < Length;)
 			{
 			//Frame check
@@ -1135,6 +1231,16 @@ bool CheckConnectionStreamFin(
 					(FrameHeader->Type == HTTP_2_FRAME_TYPE_CONTINUATION && (FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_END_HEADERS) != 0))
 						return true;
 
+			//DATA frames in persistent tunnel stream are finished when they contain whole DNS message with length header.
+				if (FrameHeader->Type == HTTP_2_FRAME_TYPE_DATA && FrameHeader->Length_Low > 0)
+				{
+					if (DataLength == 0 && ntoh16(FrameHeader->Length_Low) >= sizeof(uint16_t))
+						MessageLength = ntoh16(*reinterpret_cast<const uint16_t *>(Stream + Index + sizeof(http2_frame_hdr)));
+					DataLength += ntoh16(FrameHeader->Length_Low);
+					if (MessageLength >= DNS_PACKET_MINSIZE && DataLength >= sizeof(uint16_t) + MessageLength)
+						return true;
+				}
+
 			//Length check
 				if (Index + sizeof(http2_frame_hdr) + ntoh16(FrameHeader->Length_Low) == Length)
 					break;
@@ -1401,7 +1507,8 @@ size_t CheckResponseData(
 	const size_t Length, 
 	const size_t BufferSize, 
 	size_t * const PacketEDNS_Offset, 
-	size_t * const PacketEDNS_Length)
+	size_t * const PacketEDNS_Length, 
+	DNS_MESSAGE_INDEX * const MessageIndex)
 {
 //DNS Options part
 	const auto DNS_Header = reinterpret_cast<dns_hdr *>(Buffer);
@@ -1450,6 +1557,10 @@ size_t CheckResponseData(
 		(ResponseType == REQUEST_PROCESS_TYPE::DIRECT && Parameter.EDNS_Switch_Direct) || //Direct Request
 	#if defined(ENABLE_LIBSODIUM)
 		(ResponseType == REQUEST_PROCESS_TYPE::DNSCURVE_MAIN && Parameter.EDNS_Switch_DNSCurve) || //DNSCurve
+	#endif
+	#if defined(ENABLE_TLS)
+		(ResponseType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN && Parameter.EDNS_Switch_TCP) || //DNS over TLS
+		(ResponseType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && Parameter.EDNS_Switch_TCP) || //DNS over HTTPS
 	#endif
 		(ResponseType == REQUEST_PROCESS_TYPE::TCP_NORMAL && Parameter.EDNS_Switch_TCP) || //TCP
 		(ResponseType == REQUEST_PROCESS_TYPE::UDP_NORMAL && Parameter.EDNS_Switch_UDP))) //UDP
@@ -1462,6 +1573,12 @@ size_t CheckResponseData(
 		IsNeedCheck_EDNS && DNS_Header->Additional == 0)
 			return EXIT_FAILURE;
 
+//Build message index, all resource records are located only once.
+	DNS_MESSAGE_INDEX MessageIndexTemp;
+	auto &MessageIndexData = MessageIndex != nullptr ? *MessageIndex : MessageIndexTemp;
+	if (!BuildMessageIndex(Buffer, Length, MessageIndexData))
+		return EXIT_FAILURE;
+
 //Domain pointer check
 	if (Parameter.PacketCheck_DNS && 
 	//Ignore DNSCurve Signature packet.
@@ -1471,19 +1588,18 @@ size_t CheckResponseData(
 		DNS_Header->Question != 0)
 	{
 	//Find compression pointer in domain.
-		for (auto Index = sizeof(dns_hdr);Index < DNS_PACKET_QUERY_LOCATE(Buffer, BufferSize);++Index)
+		for (auto Index = sizeof(dns_hdr);Index < sizeof(dns_hdr) + MessageIndexData.Records_QuestionNameLen + NULL_TERMINATE_LENGTH;++Index)
 		{
 			if (*(Buffer + Index) == static_cast<const uint8_t>(DNS_POINTER_8_BIT_STRING))
 				return EXIT_FAILURE;
 		}
 
 	//Check repeat DNS domain without compression.
-		if (ntoh16(DNS_Header->Answer) == UINT16_NUM_ONE && DNS_Header->Authority == 0 && DNS_Header->Additional == 0 && 
-			CheckQueryNameLength(Buffer + sizeof(dns_hdr), BufferSize - sizeof(dns_hdr)) == CheckQueryNameLength(Buffer + DNS_PACKET_RR_LOCATE(Buffer, BufferSize), BufferSize - sizeof(dns_hdr)))
+		if (MessageIndexData.Records_AnswerCount == UINT16_NUM_ONE && MessageIndexData.Records_AuthorityCount == 0 && MessageIndexData.Records_AdditionalCount == 0 && 
+			static_cast<const size_t>(MessageIndexData.Records_StandardLocation[0] - MessageIndexData.Records_Location[0]) == static_cast<const size_t>(MessageIndexData.Records_QuestionNameLen + NULL_TERMINATE_LENGTH))
 		{
-			if ((ntoh16(reinterpret_cast<const dns_record_standard *>(Buffer + DNS_PACKET_RR_LOCATE(Buffer, BufferSize) + CheckQueryNameLength(Buffer + sizeof(dns_hdr), BufferSize - sizeof(dns_hdr)) + NULL_TERMINATE_LENGTH)->Type) == DNS_TYPE_A || 
-				ntoh16(reinterpret_cast<const dns_record_standard *>(Buffer + DNS_PACKET_RR_LOCATE(Buffer, BufferSize) + CheckQueryNameLength(Buffer + sizeof(dns_hdr), BufferSize - sizeof(dns_hdr)) + NULL_TERMINATE_LENGTH)->Type) == DNS_TYPE_AAAA) && 
-				memcmp(Buffer + sizeof(dns_hdr), Buffer + DNS_PACKET_RR_LOCATE(Buffer, BufferSize), CheckQueryNameLength(Buffer + sizeof(dns_hdr), BufferSize - sizeof(dns_hdr)) + NULL_TERMINATE_LENGTH) == 0)
+			if ((MessageIndexData.Records_Type[0] == DNS_TYPE_A || MessageIndexData.Records_Type[0] == DNS_TYPE_AAAA) && 
+				memcmp(Buffer + sizeof(dns_hdr), Buffer + MessageIndexData.Records_Location[0], MessageIndexData.Records_QuestionNameLen + NULL_TERMINATE_LENGTH) == 0)
 					return EXIT_FAILURE;
 		}
 	}
@@ -1506,54 +1622,19 @@ size_t CheckResponseData(
 	}
 
 //Initialization(Part 2)
-	uint16_t QueryType = 0;
-	size_t DataLength = 0, EDNS_Location = 0, EDNS_Length = 0, Index = 0;
-	if (DNS_Header->Question != 0) //DNS Cookies request
-	{
-		QueryType = reinterpret_cast<const dns_qry *>(Buffer + DNS_PACKET_QUERY_LOCATE(Buffer, BufferSize))->Type;
-		DataLength = DNS_PACKET_RR_LOCATE(Buffer, BufferSize);
-	}
-	else {
-		DataLength = sizeof(dns_hdr);
-	}
-	std::vector<std::pair<size_t, size_t>> RecordList_Answer;
+	const auto QueryType = MessageIndexData.QueryType;
+	const auto EDNS_Location = MessageIndexData.EDNS_Location, EDNS_Length = MessageIndexData.EDNS_Length;
+	size_t DataLength = 0, Index = 0;
 	uint16_t PreviousType = 0;
 	uint32_t AddressRecord_TTL = 0;
 	auto IsFound_EDNS = false, IsFound_DNSSEC = false, IsFound_AddressRecord = false;
 
 //Scan all resource records to check.
-	for (Index = 0;Index < static_cast<const size_t>(ntoh16(DNS_Header->Answer)) + static_cast<const size_t>(ntoh16(DNS_Header->Authority)) + static_cast<const size_t>(ntoh16(DNS_Header->Additional));++Index)
+	for (Index = 0;Index < MessageIndexData.Records_Num;++Index)
 	{
-	//Domain pointer check
-		if (DataLength >= Length || DataLength + sizeof(uint16_t) >= Length)
-		{
-			return EXIT_FAILURE;
-		}
-		else if (Buffer[DataLength] >= DNS_POINTER_8_BITS)
-		{
-			const uint16_t DNS_Pointer = ntoh16(*reinterpret_cast<const uint16_t *>(Buffer + DataLength)) & DNS_POINTER_BIT_GET_LOCATE;
-			if (DNS_Pointer >= Length || DNS_Pointer < sizeof(dns_hdr) || DNS_Pointer == DataLength || DNS_Pointer == DataLength + NULL_TERMINATE_LENGTH)
-				return EXIT_FAILURE;
-		}
-
-	//Mark CNAME Answer records location.
-		if (Index < ntoh16(DNS_Header->Answer))
-			RecordList_Answer.push_back(std::make_pair(DataLength, 0));
-
-	//Mark EDNS Label location(Part 1).
-		if (EDNS_Length == 0)
-			EDNS_Location = DataLength;
-
-	//Resource records name check
-		DataLength += CheckQueryNameLength(Buffer + DataLength, BufferSize - DataLength) + NULL_TERMINATE_LENGTH;
-		if (DataLength + sizeof(dns_record_standard) > Length)
-			return EXIT_FAILURE;
-
 	//Standard resource records
-		const auto DNS_Record_Standard = reinterpret_cast<const dns_record_standard *>(Buffer + DataLength);
-		DataLength += sizeof(dns_record_standard);
-		if (DataLength > Length || DataLength + ntoh16(DNS_Record_Standard->Length) > Length)
-			return EXIT_FAILURE;
+		const auto DNS_Record_Standard = reinterpret_cast<const dns_record_standard *>(Buffer + MessageIndexData.Records_StandardLocation[Index]);
+		DataLength = MessageIndexData.Records_StandardLocation[Index] + sizeof(dns_record_standard);
 
 	//Strict resource record TTL check when enforce strict RFC 2181(https://tools.ietf.org/html/rfc2181) compliance(Part 1)
 	//TTL in resource records must less than 2 ^ 31(2147483647).
@@ -1590,9 +1671,6 @@ size_t CheckResponseData(
 			//Set DNSSEC record found flag.
 				IsFound_DNSSEC = true;
 			}
-
-		//Mark EDNS Label location(Part 2).
-			EDNS_Length = DataLength + ntoh16(DNS_Record_Standard->Length) - EDNS_Location;
 		}
 
 	//Read resource records data.
@@ -1681,17 +1759,6 @@ size_t CheckResponseData(
 			Parameter.EDNS_Label && Parameter.DNSSEC_Request)
 				PreviousType = DNS_Record_Standard->Type;
 
-	//Mark record length.
-		DataLength += ntoh16(DNS_Record_Standard->Length);
-
-	//Mark CNAME Answer records length.
-		if (Index < ntoh16(DNS_Header->Answer) && RecordList_Answer.size() > Index)
-		{
-			if (ntoh16(DNS_Record_Standard->Type) == DNS_TYPE_CNAME)
-				RecordList_Answer.at(Index).second = DataLength - RecordList_Answer.at(Index).first;
-			else 
-				RecordList_Answer.at(Index).first = 0;
-		}
 	}
 
 //Whole DNS packet resource records check
@@ -1721,7 +1788,7 @@ size_t CheckResponseData(
 		}
 
 	//Store EDNS Label if any Answer records exist.
-		if (!RecordList_Answer.empty())
+		if (MessageIndexData.Records_AnswerCount > 0)
 		{
 			auto EDNS_BufferTemp = std::make_unique<uint8_t[]>(EDNS_Length + MEMORY_RESERVED_BYTES);
 			memset(EDNS_BufferTemp.get(), 0, EDNS_Length + MEMORY_RESERVED_BYTES);
@@ -1731,21 +1798,24 @@ size_t CheckResponseData(
 	}
 
 //Scan all resource records to CNAME Hosts.
-	for (Index = 0;Index < RecordList_Answer.size();++Index)
+	for (Index = 0;Index < MessageIndexData.Records_AnswerCount;++Index)
 	{
 	//CNAME Answer records
-		if (RecordList_Answer.at(Index).first > 0)
+		if (MessageIndexData.Records_Type[Index] == DNS_TYPE_CNAME)
 		{
-		//Resource records name length check.
-			DataLength = CheckQueryNameLength(Buffer + RecordList_Answer.at(Index).first, BufferSize - RecordList_Answer.at(Index).first) + NULL_TERMINATE_LENGTH;
-			if (RecordList_Answer.at(Index).second > DataLength + sizeof(dns_record_standard) + DOMAIN_MINSIZE || 
-				RecordList_Answer.at(Index).second < DataLength + sizeof(dns_record_standard) + DOMAIN_MAXSIZE)
+		//Resource records data length check.
+			DataLength = MessageIndexData.Records_StandardLocation[Index] + sizeof(dns_record_standard);
+			const size_t RecordDataLength = ntoh16(reinterpret_cast<const dns_record_standard *>(Buffer + MessageIndexData.Records_StandardLocation[Index])->Length);
+			if (RecordDataLength > DOMAIN_MINSIZE || RecordDataLength < DOMAIN_MAXSIZE)
 			{
 			//CNAME Hosts check
 				size_t IncreaseCount = 0;
-				DataLength = CheckResponse_CNAME(Buffer, Length, BufferSize, RecordList_Answer.at(Index).first + DataLength + sizeof(dns_record_standard), RecordList_Answer.at(Index).second - DataLength - sizeof(dns_record_standard), IncreaseCount);
+				DataLength = CheckResponse_CNAME(Buffer, Length, BufferSize, DataLength, RecordDataLength, IncreaseCount);
 				if (DataLength >= DNS_PACKET_MINSIZE && IncreaseCount > 0)
 				{
+				//Packet is rebuilt, message index is not available.
+					MessageIndexData.Length = 0;
+
 				//Set DNS resource record counts.
 					DNS_Header->Answer = hton16(static_cast<const uint16_t>(Index + 1U + IncreaseCount));
 
@@ -171,73 +171,35 @@ size_t SOCKS_TCP_Request(
 	std::vector<SOCKET_DATA> SocketDataList(1U);
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> SocketSelectingDataList(1U);
 	std::vector<ssize_t> ErrorCodeList(1U);
+	SOCKS_TUNNEL_DATA TunnelData;
 	memset(&SocketDataList.front(), 0, sizeof(SocketDataList.front()));
+	memset(&TunnelData, 0, sizeof(TunnelData));
 	SocketDataList.front().Socket = INVALID_SOCKET;
+	TunnelData.TCP_SocketData.Socket = INVALID_SOCKET;
+	TunnelData.UDP_SocketData.Socket = INVALID_SOCKET;
 	ErrorCodeList.front() = 0;
 	const auto NetworkSpecific = SelectProtocol_Network(Parameter.SOCKS_Protocol_Network, Parameter.SOCKS_Address_IPv6.Storage.ss_family, Parameter.SOCKS_Address_IPv4.Storage.ss_family, Parameter.SOCKS_Protocol_IsAccordingType, QueryType, &LocalSocketData);
+	auto IsReusedTunnel = SOCKS_TakeTunnel(IPPROTO_TCP, NetworkSpecific, TunnelData);
 
-//Socket initialization
-	if (NetworkSpecific == AF_INET6)
-	{
-		SocketDataList.front().SockAddr.ss_family = AF_INET6;
-		reinterpret_cast<sockaddr_in6 *>(&SocketDataList.front().SockAddr)->sin6_addr = Parameter.SOCKS_Address_IPv6.IPv6.sin6_addr;
-		reinterpret_cast<sockaddr_in6 *>(&SocketDataList.front().SockAddr)->sin6_port = Parameter.SOCKS_Address_IPv6.IPv6.sin6_port;
-		SocketDataList.front().AddrLen = sizeof(sockaddr_in6);
-		SocketDataList.front().Socket = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
-	}
-	else if (NetworkSpecific == AF_INET)
-	{
-		SocketDataList.front().SockAddr.ss_family = AF_INET;
-		reinterpret_cast<sockaddr_in *>(&SocketDataList.front().SockAddr)->sin_addr = Parameter.SOCKS_Address_IPv4.IPv4.sin_addr;
-		reinterpret_cast<sockaddr_in *>(&SocketDataList.front().SockAddr)->sin_port = Parameter.SOCKS_Address_IPv4.IPv4.sin_port;
-		SocketDataList.front().AddrLen = sizeof(sockaddr_in);
-		SocketDataList.front().Socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
-	}
-	else {
-		return EXIT_FAILURE;
-	}
+//Jump here to restart.
+JumpTo_Restart:
 
-//Socket check
-	if (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
-	{
-		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"SOCKS socket initialization error", 0, nullptr, 0);
+//Use established tunnel in pool, or connect to SOCKS server and request a new tunnel.
+	if (IsReusedTunnel)
+		SocketDataList.front() = TunnelData.TCP_SocketData;
+	else if (!SOCKS_TCP_TunnelConnect(NetworkSpecific, SocketDataList, SocketSelectingDataList, ErrorCodeList))
 		return EXIT_FAILURE;
-	}
-
-//Socket attribute settings
-	if (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::NON_BLOCKING_MODE, true, nullptr) || 
-		!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::TCP_FAST_OPEN_NORMAL, true, nullptr) || 
-		(SocketDataList.front().SockAddr.ss_family == AF_INET6 && !SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV6, true, nullptr)) || 
-		(SocketDataList.front().SockAddr.ss_family == AF_INET && (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV4, true, nullptr))))
-	{
-		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		return EXIT_FAILURE;
-	}
-
-//Selection exchange process
-	if (Parameter.SOCKS_Version == SOCKS_VERSION_5 && !SOCKS_SelectionExchange(SocketDataList, SocketSelectingDataList, ErrorCodeList))
-	{
-		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		return EXIT_FAILURE;
-	}
-
-//Client command request process
-	if (!SOCKS_ClientCommandRequest(IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList, nullptr))
-	{
-		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		return EXIT_FAILURE;
-	}
 
 //Add length of request packet.
 	if (SocketSelectingDataList.front().SendSize <= SendSize + sizeof(uint16_t))
 	{
 		auto SendBuffer = std::make_unique<uint8_t[]>(SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
 		memset(SendBuffer.get(), 0, SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
-		memcpy_s(SendBuffer.get(), SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES, OriginalSend, SendSize);
 		std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
 		SocketSelectingDataList.front().SendSize = SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES;
-		SocketSelectingDataList.front().SendLen = SendSize;
 	}
+	memcpy_s(SocketSelectingDataList.front().SendBuffer.get(), SocketSelectingDataList.front().SendSize, OriginalSend, SendSize);
+	SocketSelectingDataList.front().SendLen = SendSize;
 	auto RecvLen = AddLengthDataToHeader(SocketSelectingDataList.front().SendBuffer.get(), SocketSelectingDataList.front().SendLen, SocketSelectingDataList.front().SendSize);
 	if (RecvLen < DNS_PACKET_MINSIZE)
 	{
@@ -253,33 +215,49 @@ size_t SOCKS_TCP_Request(
 	SocketSelectingDataList.front().RecvSize = 0;
 	SocketSelectingDataList.front().RecvLen = 0;
 	RecvLen = SocketSelectingSerial(REQUEST_PROCESS_TYPE::SOCKS_MAIN, IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList);
-	SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 	SocketSelectingDataList.front().SendBuffer.reset();
 	SocketSelectingDataList.front().SendSize = 0;
 	SocketSelectingDataList.front().SendLen = 0;
 	if (RecvLen != EXIT_FAILURE && 
 		SocketSelectingDataList.front().RecvLen >= DNS_PACKET_MINSIZE && 
 		ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]) >= DNS_PACKET_MINSIZE && 
-		SocketSelectingDataList.front().RecvLen >= sizeof(uint16_t) + ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]))
+		SocketSelectingDataList.front().RecvLen >= sizeof(uint16_t) + ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]) && 
+		reinterpret_cast<const dns_hdr *>(SocketSelectingDataList.front().RecvBuffer.get() + sizeof(uint16_t))->ID == reinterpret_cast<const dns_hdr *>(OriginalSend)->ID)
 	{
 		RecvLen = ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]);
+
+	//Tunnel is put back to pool when nothing is left in stream after response.
+		if (SocketSelectingDataList.front().RecvLen == sizeof(uint16_t) + RecvLen)
+		{
+			TunnelData.Protocol = IPPROTO_TCP;
+			TunnelData.NetworkSpecific = NetworkSpecific;
+			TunnelData.TCP_SocketData = SocketDataList.front();
+			SOCKS_ReturnTunnel(TunnelData);
+		}
+		else {
+			SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		}
+
+	//Remove length of response packet.
 		memmove_s(SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvSize, SocketSelectingDataList.front().RecvBuffer.get() + sizeof(uint16_t), RecvLen);
 		memset(SocketSelectingDataList.front().RecvBuffer.get() + RecvLen, 0, SocketSelectingDataList.front().RecvSize - RecvLen);
 
 	//Response check
+		DNS_MESSAGE_INDEX MessageIndex;
 		RecvLen = CheckResponseData(
 			REQUEST_PROCESS_TYPE::SOCKS_MAIN, 
 			SocketSelectingDataList.front().RecvBuffer.get(), 
 			RecvLen, 
 			SocketSelectingDataList.front().RecvSize, 
 			nullptr, 
-			nullptr);
+			nullptr, 
+			&MessageIndex);
 		if (RecvLen < DNS_PACKET_MINSIZE)
 			return EXIT_FAILURE;
 
 	//Mark domain cache.
 		if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-			MarkDomainCache(SocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &LocalSocketData);
+			MarkDomainCache(SocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &MessageIndex, &LocalSocketData);
 
 	//Swap buffer.
 		std::swap(OriginalRecv, SocketSelectingDataList.front().RecvBuffer);
@@ -287,6 +265,14 @@ size_t SOCKS_TCP_Request(
 		return RecvLen;
 	}
 
+//Tunnel in pool may be closed by SOCKS server, restart with a new tunnel.
+	SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	if (IsReusedTunnel && !GlobalRunningStatus.IsNeedExit)
+	{
+		IsReusedTunnel = false;
+		goto JumpTo_Restart;
+	}
+
 	return EXIT_FAILURE;
 }
 
@@ -300,19 +286,314 @@ size_t SOCKS_UDP_Request(
 	const SOCKET_DATA &LocalSocketData)
 {
 //Initialization
-	std::vector<SOCKET_DATA> TCPSocketDataList(1U), UDPSocketDataList(1U), LocalSocketDataList(1U);
-	std::vector<SOCKET_SELECTING_SERIAL_DATA> TCPSocketSelectingDataList(1U), UDPSocketSelectingDataList(1U), LocalSocketSelectingDataList(1U);
-	std::vector<ssize_t> TCPErrorCodeList(1U), UDPErrorCodeList(1U), LocalErrorCodeList(1U);
+	std::vector<SOCKET_DATA> TCPSocketDataList(1U), UDPSocketDataList(1U);
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> TCPSocketSelectingDataList(1U), UDPSocketSelectingDataList(1U);
+	std::vector<ssize_t> TCPErrorCodeList(1U), UDPErrorCodeList(1U);
+	SOCKS_TUNNEL_DATA TunnelData;
 	memset(&TCPSocketDataList.front(), 0, sizeof(TCPSocketDataList.front()));
 	memset(&UDPSocketDataList.front(), 0, sizeof(UDPSocketDataList.front()));
-	memset(&LocalSocketDataList.front(), 0, sizeof(LocalSocketDataList.front()));
+	memset(&TunnelData, 0, sizeof(TunnelData));
 	TCPSocketDataList.front().Socket = INVALID_SOCKET;
 	UDPSocketDataList.front().Socket = INVALID_SOCKET;
-	LocalSocketDataList.front().Socket = INVALID_SOCKET;
+	TunnelData.TCP_SocketData.Socket = INVALID_SOCKET;
+	TunnelData.UDP_SocketData.Socket = INVALID_SOCKET;
 	TCPErrorCodeList.front() = 0;
 	UDPErrorCodeList.front() = 0;
-	LocalErrorCodeList.front() = 0;
 	const auto NetworkSpecific = SelectProtocol_Network(Parameter.SOCKS_Protocol_Network, Parameter.SOCKS_Address_IPv6.Storage.ss_family, Parameter.SOCKS_Address_IPv4.Storage.ss_family, Parameter.SOCKS_Protocol_IsAccordingType, QueryType, &LocalSocketData);
+	auto IsReusedTunnel = SOCKS_TakeTunnel(IPPROTO_UDP, NetworkSpecific, TunnelData);
+
+//Jump here to restart.
+JumpTo_Restart:
+
+//Use established UDP ASSOCIATE session in pool, or connect to SOCKS server and request a new session.
+	if (IsReusedTunnel)
+	{
+		TCPSocketDataList.front() = TunnelData.TCP_SocketData;
+		UDPSocketDataList.front() = TunnelData.UDP_SocketData;
+	}
+	else if (!SOCKS_UDP_TunnelConnect(NetworkSpecific, TCPSocketDataList, UDPSocketDataList, TCPSocketSelectingDataList, TCPErrorCodeList))
+	{
+		return EXIT_FAILURE;
+	}
+
+//Buffer initialization(Part 1)
+	if (UDPSocketSelectingDataList.front().SendSize <= Parameter.LargeBufferSize)
+	{
+		auto SendBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+		std::swap(UDPSocketSelectingDataList.front().SendBuffer, SendBuffer);
+		UDPSocketSelectingDataList.front().SendSize = Parameter.LargeBufferSize;
+		UDPSocketSelectingDataList.front().SendLen = 0;
+	}
+
+//SOCKS UDP relay header
+	size_t RecvLen = 0;
+	if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET6) //IPv6
+	{
+	//Address type
+		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_IPV6;
+		RecvLen = sizeof(socks_udp_relay_request);
+
+	//Address
+		*reinterpret_cast<in6_addr *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv6.sin6_addr;
+		RecvLen += sizeof(in6_addr);
+
+	//Port
+		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv6.sin6_port;
+		RecvLen += sizeof(uint16_t);
+	}
+	else if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET) //IPv4
+	{
+	//Address type
+		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_IPV4;
+		RecvLen = sizeof(socks_udp_relay_request);
+
+	//Address
+		*reinterpret_cast<in_addr *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv4.sin_addr;
+		RecvLen += sizeof(in_addr);
+
+	//Port
+		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv4.sin_port;
+		RecvLen += sizeof(uint16_t);
+	}
+	else if (Parameter.SOCKS_TargetDomain != nullptr && !Parameter.SOCKS_TargetDomain->empty()) //Domain
+	{
+	//Address type
+		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_DOMAIN;
+		RecvLen = sizeof(socks_udp_relay_request);
+
+	//Domain
+		*reinterpret_cast<uint8_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = static_cast<const uint8_t>(Parameter.SOCKS_TargetDomain->length());
+		RecvLen += sizeof(uint8_t);
+		memcpy_s(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen, UDPSocketSelectingDataList.front().SendSize - RecvLen, Parameter.SOCKS_TargetDomain->c_str(), Parameter.SOCKS_TargetDomain->length());
+		RecvLen += Parameter.SOCKS_TargetDomain->length();
+
+	//Port
+		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetDomain_Port;
+		RecvLen += sizeof(uint16_t);
+	}
+	else {
+		SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		if (!Parameter.SOCKS_UDP_NoHandshake)
+			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+
+		return EXIT_FAILURE;
+	}
+
+//Buffer initialization(Part 2)
+	memcpy_s(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen, UDPSocketSelectingDataList.front().SendSize - RecvLen, OriginalSend, SendSize);
+	RecvLen += SendSize;
+	UDPSocketSelectingDataList.front().SendLen = RecvLen;
+
+//Request exchange and response check
+	UDPSocketSelectingDataList.front().RecvBuffer.reset();
+	UDPSocketSelectingDataList.front().RecvSize = 0;
+	UDPSocketSelectingDataList.front().RecvLen = 0;
+	RecvLen = SocketSelectingSerial(REQUEST_PROCESS_TYPE::SOCKS_MAIN, IPPROTO_UDP, UDPSocketDataList, UDPSocketSelectingDataList, UDPErrorCodeList);
+	UDPSocketSelectingDataList.front().SendBuffer.reset();
+	UDPSocketSelectingDataList.front().SendSize = 0;
+	UDPSocketSelectingDataList.front().SendLen = 0;
+	if (RecvLen != EXIT_FAILURE && UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + DNS_PACKET_MINSIZE && 
+		SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+	{
+	//UDP ASSOCIATE session is put back to pool and shared with other requests only after matching response was received.
+		TunnelData.Protocol = IPPROTO_UDP;
+		TunnelData.NetworkSpecific = NetworkSpecific;
+		TunnelData.TCP_SocketData = TCPSocketDataList.front();
+		TunnelData.UDP_SocketData = UDPSocketDataList.front();
+	#if defined(PLATFORM_WIN)
+		const auto ReceiveTimeLimit = GetCurrentSystemTime() + Parameter.SocketTimeout_Unreliable_Serial;
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		const auto ReceiveTimeLimit = IncreaseMillisecondTime(GetCurrentSystemTime(), Parameter.SocketTimeout_Unreliable_Serial);
+	#endif
+
+	//Jump here to check next response.
+	JumpTo_Response:
+
+	//Remove SOCKS UDP relay header
+		if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET6 && //IPv6
+			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV6 && //Address type
+			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //IPv6 address length check
+			memcmp(reinterpret_cast<const in6_addr *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request)), &Parameter.SOCKS_TargetServer.IPv6.sin6_addr, sizeof(in6_addr)) == 0 && //Address
+			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr)) == Parameter.SOCKS_TargetServer.IPv6.sin6_port) //Port
+		{
+			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t)));
+			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t);
+		}
+		else if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET && //IPv4
+			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV4 && //Address type
+			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //IPv4 address length check
+			(*reinterpret_cast<const in_addr *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request))).s_addr == Parameter.SOCKS_TargetServer.IPv4.sin_addr.s_addr && //Address
+			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr)) == Parameter.SOCKS_TargetServer.IPv4.sin_port) //Port
+		{
+			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t)));
+			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t);
+		}
+		else if (Parameter.SOCKS_TargetDomain != nullptr && !Parameter.SOCKS_TargetDomain->empty() //Domain
+/* SOCKS server will reply IPv4 or IPv6 address of domain.
+			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_DOMAIN && //Address type
+			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //Domain length check
+			*reinterpret_cast<const uint8_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request)) == Parameter.SOCKS_TargetDomain->length() && 
+			memcmp(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t), Parameter.SOCKS_TargetDomain->c_str(), Parameter.SOCKS_TargetDomain->length()) == 0 && //Domain
+			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length()) == Parameter.SOCKS_TargetDomain_Port //Port
+*/
+			)
+		{
+		//IPv6
+			if (reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV6 && //Address type
+				UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE) //Length check
+			{
+				memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t)));
+				UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t);
+			}
+		//IPv4
+			else if (reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV4 && //Address type
+				UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE) //Length check
+			{
+				memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t)));
+				UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t);
+			}
+
+/* SOCKS server will reply IPv4 or IPv6 address of domain.
+			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t)));
+			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t);
+*/
+		}
+
+	//Late response of other request in shared session must be dropped, keep receiving until timeout.
+		if (reinterpret_cast<const dns_hdr *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->ID != reinterpret_cast<const dns_hdr *>(OriginalSend)->ID)
+		{
+			if (SOCKS_UDP_ReceiveResponse(UDPSocketDataList.front(), UDPSocketSelectingDataList.front(), ReceiveTimeLimit))
+				goto JumpTo_Response;
+
+			SOCKS_CloseTunnel(TunnelData);
+			return EXIT_FAILURE;
+		}
+
+	//Response check
+		DNS_MESSAGE_INDEX MessageIndex;
+		RecvLen = CheckResponseData(
+			REQUEST_PROCESS_TYPE::SOCKS_MAIN, 
+			UDPSocketSelectingDataList.front().RecvBuffer.get(), 
+			UDPSocketSelectingDataList.front().RecvLen, 
+			UDPSocketSelectingDataList.front().RecvSize, 
+			nullptr, 
+			nullptr, 
+			&MessageIndex);
+		if (RecvLen < DNS_PACKET_MINSIZE)
+		{
+			SOCKS_CloseTunnel(TunnelData);
+			return EXIT_FAILURE;
+		}
+		else {
+			SOCKS_ReturnTunnel(TunnelData);
+		}
+
+	//Mark domain cache.
+		if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
+			MarkDomainCache(UDPSocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &MessageIndex, &LocalSocketData);
+
+	//Swap buffer.
+		std::swap(OriginalRecv, UDPSocketSelectingDataList.front().RecvBuffer);
+		RecvSize = UDPSocketSelectingDataList.front().RecvSize;
+		return RecvLen;
+	}
+
+//Session in pool may be closed by SOCKS server, restart with a new session.
+	SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	if (!Parameter.SOCKS_UDP_NoHandshake)
+		SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	if (IsReusedTunnel && !GlobalRunningStatus.IsNeedExit)
+	{
+		IsReusedTunnel = false;
+		goto JumpTo_Restart;
+	}
+
+	return EXIT_FAILURE;
+}
+
+//Connect to SOCKS server and request TCP CONNECT tunnel
+bool SOCKS_TCP_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &SocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
+	std::vector<ssize_t> &ErrorCodeList)
+{
+//Socket initialization
+	memset(&SocketDataList.front(), 0, sizeof(SocketDataList.front()));
+	SocketDataList.front().Socket = INVALID_SOCKET;
+	ErrorCodeList.front() = 0;
+	if (NetworkSpecific == AF_INET6)
+	{
+		SocketDataList.front().SockAddr.ss_family = AF_INET6;
+		reinterpret_cast<sockaddr_in6 *>(&SocketDataList.front().SockAddr)->sin6_addr = Parameter.SOCKS_Address_IPv6.IPv6.sin6_addr;
+		reinterpret_cast<sockaddr_in6 *>(&SocketDataList.front().SockAddr)->sin6_port = Parameter.SOCKS_Address_IPv6.IPv6.sin6_port;
+		SocketDataList.front().AddrLen = sizeof(sockaddr_in6);
+		SocketDataList.front().Socket = socket(AF_INET6, SOCK_STREAM, IPPROTO_TCP);
+	}
+	else if (NetworkSpecific == AF_INET)
+	{
+		SocketDataList.front().SockAddr.ss_family = AF_INET;
+		reinterpret_cast<sockaddr_in *>(&SocketDataList.front().SockAddr)->sin_addr = Parameter.SOCKS_Address_IPv4.IPv4.sin_addr;
+		reinterpret_cast<sockaddr_in *>(&SocketDataList.front().SockAddr)->sin_port = Parameter.SOCKS_Address_IPv4.IPv4.sin_port;
+		SocketDataList.front().AddrLen = sizeof(sockaddr_in);
+		SocketDataList.front().Socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	}
+	else {
+		return false;
+	}
+
+//Socket check
+	if (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::NETWORK, L"SOCKS socket initialization error", 0, nullptr, 0);
+		return false;
+	}
+
+//Socket attribute settings
+	if (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::NON_BLOCKING_MODE, true, nullptr) || 
+		!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::TCP_FAST_OPEN_NORMAL, true, nullptr) || 
+		(SocketDataList.front().SockAddr.ss_family == AF_INET6 && !SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV6, true, nullptr)) || 
+		(SocketDataList.front().SockAddr.ss_family == AF_INET && (!SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::HOP_LIMITS_IPV4, true, nullptr))))
+	{
+		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		return false;
+	}
+
+//Selection exchange process
+	if (Parameter.SOCKS_Version == SOCKS_VERSION_5 && !SOCKS_SelectionExchange(SocketDataList, SocketSelectingDataList, ErrorCodeList))
+	{
+		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		return false;
+	}
+
+//Client command request process
+	if (!SOCKS_ClientCommandRequest(IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList, nullptr))
+	{
+		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		return false;
+	}
+
+	return true;
+}
+
+//Connect to SOCKS server and request UDP ASSOCIATE session
+bool SOCKS_UDP_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &TCPSocketDataList, 
+	std::vector<SOCKET_DATA> &UDPSocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &TCPSocketSelectingDataList, 
+	std::vector<ssize_t> &TCPErrorCodeList)
+{
+//Initialization
+	std::vector<SOCKET_DATA> LocalSocketDataList(1U);
+	memset(&TCPSocketDataList.front(), 0, sizeof(TCPSocketDataList.front()));
+	memset(&UDPSocketDataList.front(), 0, sizeof(UDPSocketDataList.front()));
+	memset(&LocalSocketDataList.front(), 0, sizeof(LocalSocketDataList.front()));
+	TCPSocketDataList.front().Socket = INVALID_SOCKET;
+	UDPSocketDataList.front().Socket = INVALID_SOCKET;
+	LocalSocketDataList.front().Socket = INVALID_SOCKET;
+	TCPErrorCodeList.front() = 0;
 
 //Socket initialization
 	if (NetworkSpecific == AF_INET6) //IPv6
@@ -365,7 +646,7 @@ size_t SOCKS_UDP_Request(
 		UDPSocketDataList.front().Socket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
 	}
 	else {
-		return EXIT_FAILURE;
+		return false;
 	}
 
 //Socket attribute settings
@@ -383,7 +664,7 @@ size_t SOCKS_UDP_Request(
 		if (!Parameter.SOCKS_UDP_NoHandshake)
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
-		return EXIT_FAILURE;
+		return false;
 	}
 
 //Socket attribute setting(Non-blocking mode)
@@ -394,7 +675,7 @@ size_t SOCKS_UDP_Request(
 		if (!Parameter.SOCKS_UDP_NoHandshake)
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
-		return EXIT_FAILURE;
+		return false;
 	}
 
 //UDP transmission of standard SOCKS protocol must connect with TCP to server at first.
@@ -406,7 +687,7 @@ size_t SOCKS_UDP_Request(
 			SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
-			return EXIT_FAILURE;
+			return false;
 		}
 
 	//UDP connecting and get UDP socket infomation.
@@ -417,7 +698,7 @@ size_t SOCKS_UDP_Request(
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"SOCKS connecting error", 0, nullptr, 0);
 
-			return EXIT_FAILURE;
+			return false;
 		}
 
 	//Client command request process
@@ -427,7 +708,7 @@ size_t SOCKS_UDP_Request(
 			SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
-			return EXIT_FAILURE;
+			return false;
 		}
 		else {
 		//Copy network infomation from server message.
@@ -446,169 +727,181 @@ size_t SOCKS_UDP_Request(
 			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
 		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"SOCKS connecting error", 0, nullptr, 0);
-		return EXIT_FAILURE;
+		return false;
 	}
 
-//Buffer initialization(Part 1)
-	if (UDPSocketSelectingDataList.front().SendSize <= Parameter.LargeBufferSize)
+	return true;
+}
+
+//Take established SOCKS tunnel from pool
+bool SOCKS_TakeTunnel(
+	const uint16_t Protocol, 
+	const uint16_t NetworkSpecific, 
+	SOCKS_TUNNEL_DATA &TunnelData)
+{
+//Remove expired tunnels, tunnels are sorted by time which are put back to pool and the oldest are at the end of list.
+	std::unique_lock<std::mutex> SOCKS_TunnelMutex(SOCKS_TunnelLock);
+	const auto CurrentTime = GetCurrentSystemTime();
+	while (!SOCKS_TunnelList.empty() && SOCKS_TunnelList.back().ClearTime <= CurrentTime)
 	{
-		auto SendBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		memset(SendBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
-		std::swap(UDPSocketSelectingDataList.front().SendBuffer, SendBuffer);
-		UDPSocketSelectingDataList.front().SendSize = Parameter.LargeBufferSize;
-		UDPSocketSelectingDataList.front().SendLen = 0;
+		SOCKS_CloseTunnel(SOCKS_TunnelList.back());
+		SOCKS_TunnelList.pop_back();
 	}
 
-//SOCKS UDP relay header
-	size_t RecvLen = 0;
-	if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET6) //IPv6
+//Take the latest tunnel which is matched.
+	for (auto TunnelItem = SOCKS_TunnelList.begin();TunnelItem != SOCKS_TunnelList.end();)
 	{
-	//Address type
-		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_IPV6;
-		RecvLen = sizeof(socks_udp_relay_request);
+		if (TunnelItem->Protocol == Protocol && TunnelItem->NetworkSpecific == NetworkSpecific)
+		{
+			TunnelData = *TunnelItem;
+			TunnelItem = SOCKS_TunnelList.erase(TunnelItem);
 
-	//Address
-		*reinterpret_cast<in6_addr *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv6.sin6_addr;
-		RecvLen += sizeof(in6_addr);
+		//Tunnel which is closed by SOCKS server must be dropped.
+			if ((Protocol == IPPROTO_UDP && !SOCKS_CheckTunnelSocket(IPPROTO_UDP, TunnelData.UDP_SocketData.Socket)) || 
+				(!(Protocol == IPPROTO_UDP && Parameter.SOCKS_UDP_NoHandshake) && !SOCKS_CheckTunnelSocket(IPPROTO_TCP, TunnelData.TCP_SocketData.Socket)))
+			{
+				SOCKS_CloseTunnel(TunnelData);
+				continue;
+			}
 
-	//Port
-		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv6.sin6_port;
-		RecvLen += sizeof(uint16_t);
+			return true;
+		}
+		else {
+			++TunnelItem;
+		}
 	}
-	else if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET) //IPv4
-	{
-	//Address type
-		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_IPV4;
-		RecvLen = sizeof(socks_udp_relay_request);
 
-	//Address
-		*reinterpret_cast<in_addr *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv4.sin_addr;
-		RecvLen += sizeof(in_addr);
+	return false;
+}
 
-	//Port
-		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetServer.IPv4.sin_port;
-		RecvLen += sizeof(uint16_t);
-	}
-	else if (Parameter.SOCKS_TargetDomain != nullptr && !Parameter.SOCKS_TargetDomain->empty()) //Domain
+//Put SOCKS tunnel back to pool
+void SOCKS_ReturnTunnel(
+	SOCKS_TUNNEL_DATA &TunnelData)
+{
+	std::unique_lock<std::mutex> SOCKS_TunnelMutex(SOCKS_TunnelLock);
+	if (!GlobalRunningStatus.IsNeedExit && SOCKS_TunnelList.size() < SOCKS_TUNNEL_POOL_MAXNUM)
 	{
-	//Address type
-		reinterpret_cast<socks_udp_relay_request *>(UDPSocketSelectingDataList.front().SendBuffer.get())->Address_Type = SOCKS_5_ADDRESS_DOMAIN;
-		RecvLen = sizeof(socks_udp_relay_request);
-
-	//Domain
-		*reinterpret_cast<uint8_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = static_cast<const uint8_t>(Parameter.SOCKS_TargetDomain->length());
-		RecvLen += sizeof(uint8_t);
-		memcpy_s(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen, UDPSocketSelectingDataList.front().SendSize - RecvLen, Parameter.SOCKS_TargetDomain->c_str(), Parameter.SOCKS_TargetDomain->length());
-		RecvLen += Parameter.SOCKS_TargetDomain->length();
-
-	//Port
-		*reinterpret_cast<uint16_t *>(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen) = Parameter.SOCKS_TargetDomain_Port;
-		RecvLen += sizeof(uint16_t);
+		TunnelData.ClearTime = GetCurrentSystemTime() + SOCKS_TUNNEL_IDLE_TIME;
+		SOCKS_TunnelList.push_front(TunnelData);
 	}
 	else {
-		SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		if (!Parameter.SOCKS_UDP_NoHandshake)
-			SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-		return EXIT_FAILURE;
+		SOCKS_TunnelMutex.unlock();
+		SOCKS_CloseTunnel(TunnelData);
 	}
 
-//Buffer initialization(Part 2)
-	memcpy_s(UDPSocketSelectingDataList.front().SendBuffer.get() + RecvLen, UDPSocketSelectingDataList.front().SendSize - RecvLen, OriginalSend, SendSize);
-	RecvLen += SendSize;
-	UDPSocketSelectingDataList.front().SendLen = RecvLen;
+	return;
+}
 
-//Request exchange and response check
-	TCPSocketSelectingDataList.front().RecvBuffer.reset();
-	UDPSocketSelectingDataList.front().RecvBuffer.reset();
-	LocalSocketSelectingDataList.front().RecvBuffer.reset();
-	TCPSocketSelectingDataList.front().RecvSize = 0;
-	UDPSocketSelectingDataList.front().RecvSize = 0;
-	LocalSocketSelectingDataList.front().RecvSize = 0;
-	TCPSocketSelectingDataList.front().RecvLen = 0;
-	UDPSocketSelectingDataList.front().RecvLen = 0;
-	LocalSocketSelectingDataList.front().RecvLen = 0;
-	RecvLen = SocketSelectingSerial(REQUEST_PROCESS_TYPE::SOCKS_MAIN, IPPROTO_UDP, UDPSocketDataList, UDPSocketSelectingDataList, UDPErrorCodeList);
-	SocketSetting(UDPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-	if (!Parameter.SOCKS_UDP_NoHandshake)
-		SocketSetting(TCPSocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-	UDPSocketSelectingDataList.front().SendBuffer.reset();
-	UDPSocketSelectingDataList.front().SendSize = 0;
-	UDPSocketSelectingDataList.front().SendLen = 0;
-	if (RecvLen != EXIT_FAILURE && UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + DNS_PACKET_MINSIZE)
-	{
-	//Remove SOCKS UDP relay header
-		if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET6 && //IPv6
-			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV6 && //Address type
-			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //IPv6 address length check
-			memcmp(reinterpret_cast<const in6_addr *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request)), &Parameter.SOCKS_TargetServer.IPv6.sin6_addr, sizeof(in6_addr)) == 0 && //Address
-			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr)) == Parameter.SOCKS_TargetServer.IPv6.sin6_port) //Port
+//Check idle socket of SOCKS tunnel
+bool SOCKS_CheckTunnelSocket(
+	const uint16_t Protocol, 
+	SYSTEM_SOCKET &Socket)
+{
+//Socket check
+	if (!SocketSetting(Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+		return false;
+
+//Idle TCP tunnel must not receive any data or shutdown notification, and late responses in UDP session are dropped.
+	std::array<uint8_t, PACKET_NORMAL_MAXSIZE> RecvBuffer{};
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		if (recv(Socket, reinterpret_cast<char *>(RecvBuffer.data()), static_cast<const int>(RecvBuffer.size()), 0) == SOCKET_ERROR)
 		{
-			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t)));
-			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t);
+			const auto ErrorCode = WSAGetLastError();
+		#if defined(PLATFORM_WIN)
+			return ErrorCode == WSAEWOULDBLOCK;
+		#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+			return ErrorCode == EAGAIN || ErrorCode == EINPROGRESS;
+		#endif
 		}
-		else if (Parameter.SOCKS_TargetServer.Storage.ss_family == AF_INET && //IPv4
-			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV4 && //Address type
-			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //IPv4 address length check
-			(*reinterpret_cast<const in_addr *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request))).s_addr == Parameter.SOCKS_TargetServer.IPv4.sin_addr.s_addr && //Address
-			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr)) == Parameter.SOCKS_TargetServer.IPv4.sin_port) //Port
+		else if (Protocol == IPPROTO_TCP)
 		{
-			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t)));
-			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t);
+			return false;
 		}
-		else if (Parameter.SOCKS_TargetDomain != nullptr && !Parameter.SOCKS_TargetDomain->empty() //Domain
-/* SOCKS server will reply IPv4 or IPv6 address of domain.
-			reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_DOMAIN && //Address type
-			UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t) + DNS_PACKET_MINSIZE && //Domain length check
-			*reinterpret_cast<const uint8_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request)) == Parameter.SOCKS_TargetDomain->length() && 
-			memcmp(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t), Parameter.SOCKS_TargetDomain->c_str(), Parameter.SOCKS_TargetDomain->length()) == 0 && //Domain
-			*reinterpret_cast<const uint16_t *>(UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length()) == Parameter.SOCKS_TargetDomain_Port //Port
-*/
-			)
-		{
-		//IPv6
-			if (reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV6 && //Address type
-				UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE) //Length check
-			{
-				memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t)));
-				UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in6_addr) + sizeof(uint16_t);
-			}
-		//IPv4
-			else if (reinterpret_cast<const socks_udp_relay_request *>(UDPSocketSelectingDataList.front().RecvBuffer.get())->Address_Type == SOCKS_5_ADDRESS_IPV4 && //Address type
-				UDPSocketSelectingDataList.front().RecvLen >= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t) + DNS_PACKET_MINSIZE) //Length check
-			{
-				memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t)));
-				UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(in_addr) + sizeof(uint16_t);
-			}
+	}
 
-/* SOCKS server will reply IPv4 or IPv6 address of domain.
-			memmove_s(UDPSocketSelectingDataList.front().RecvBuffer.get(), UDPSocketSelectingDataList.front().RecvSize, UDPSocketSelectingDataList.front().RecvBuffer.get() + sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t), UDPSocketSelectingDataList.front().RecvLen - (sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t)));
-			UDPSocketSelectingDataList.front().RecvLen -= sizeof(socks_udp_relay_request) + sizeof(uint8_t) + Parameter.SOCKS_TargetDomain->length() + sizeof(uint16_t);
-*/
-		}
+	return false;
+}
 
-	//Response check
-		RecvLen = CheckResponseData(
-			REQUEST_PROCESS_TYPE::SOCKS_MAIN, 
-			UDPSocketSelectingDataList.front().RecvBuffer.get(), 
-			UDPSocketSelectingDataList.front().RecvLen, 
-			UDPSocketSelectingDataList.front().RecvSize, 
-			nullptr, 
-			nullptr);
-		if (RecvLen < DNS_PACKET_MINSIZE)
-			return EXIT_FAILURE;
+//Receive next response from UDP ASSOCIATE session
+bool SOCKS_UDP_ReceiveResponse(
+	SOCKET_DATA &SocketData, 
+	SOCKET_SELECTING_SERIAL_DATA &SocketSelectingData, 
+	const uint64_t ReceiveTimeLimit)
+{
+//Socket and buffer check
+	if (!SocketSelectingData.RecvBuffer || SocketSelectingData.RecvSize == 0 || 
+		!SocketSetting(SocketData.Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr)
+	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		|| SocketData.Socket + 1U >= FD_SETSIZE
+	#endif
+		)
+	{
+		return false;
+	}
 
-	//Mark domain cache.
-		if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-			MarkDomainCache(UDPSocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &LocalSocketData);
+//Initialization
+	fd_set ReadFDS;
+	timeval Timeout;
+	memset(&ReadFDS, 0, sizeof(ReadFDS));
+	memset(&Timeout, 0, sizeof(Timeout));
+	ssize_t SelectResult = 0, RecvLen = 0;
+	uint64_t CurrentTime = 0;
+
+//Receive until time limit.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Remaining time check
+		CurrentTime = GetCurrentSystemTime();
+		if (CurrentTime >= ReceiveTimeLimit)
+			break;
+		Timeout.tv_sec = static_cast<const decltype(Timeout.tv_sec)>((ReceiveTimeLimit - CurrentTime) / SECOND_TO_MILLISECOND);
+		Timeout.tv_usec = static_cast<const decltype(Timeout.tv_usec)>((ReceiveTimeLimit - CurrentTime) % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND);
+
+	//Wait for system calling.
+		FD_ZERO(&ReadFDS);
+		FD_SET(SocketData.Socket, &ReadFDS);
+	#if defined(PLATFORM_WIN)
+		SelectResult = select(0, &ReadFDS, nullptr, nullptr, &Timeout);
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		SelectResult = select(SocketData.Socket + 1U, &ReadFDS, nullptr, nullptr, &Timeout);
+	#endif
+		if (SelectResult == 0)
+			break;
+		else if (SelectResult == SOCKET_ERROR)
+			return false;
 
-	//Swap buffer.
-		std::swap(OriginalRecv, UDPSocketSelectingDataList.front().RecvBuffer);
-		RecvSize = UDPSocketSelectingDataList.front().RecvSize;
-		return RecvLen;
+	//Receive data.
+		RecvLen = recv(SocketData.Socket, reinterpret_cast<char *>(SocketSelectingData.RecvBuffer.get()), static_cast<const int>(SocketSelectingData.RecvSize), 0);
+		if (RecvLen == SOCKET_ERROR)
+		{
+		#if defined(PLATFORM_WIN)
+			if (WSAGetLastError() != WSAEWOULDBLOCK)
+		#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+			if (errno != EAGAIN && errno != EINTR)
+		#endif
+				return false;
+		}
+		else if (static_cast<const size_t>(RecvLen) >= sizeof(socks_udp_relay_request) + DNS_PACKET_MINSIZE)
+		{
+			SocketSelectingData.RecvLen = RecvLen;
+			return true;
+		}
 	}
 
-	return EXIT_FAILURE;
+	return false;
+}
+
+//Close all sockets of SOCKS tunnel, only sockets which belong to protocol of tunnel are closed.
+void SOCKS_CloseTunnel(
+	SOCKS_TUNNEL_DATA &TunnelData)
+{
+	if (TunnelData.Protocol == IPPROTO_UDP)
+		SocketSetting(TunnelData.UDP_SocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	if (!(TunnelData.Protocol == IPPROTO_UDP && Parameter.SOCKS_UDP_NoHandshake))
+		SocketSetting(TunnelData.TCP_SocketData.Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+
+	return;
 }
 
 //SOCKS selection exchange process
@@ -2023,119 +2316,469 @@ size_t HTTP_CONNECT_TCP_Request(
 
 //Initialization
 	std::vector<SOCKET_DATA> SocketDataList(1U);
-	std::vector<SOCKET_SELECTING_SERIAL_DATA> SocketSelectingDataList(1U);
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> SocketSelectingDataList(1U);
+	std::vector<ssize_t> ErrorCodeList(1U);
+	const auto NetworkSpecific = SelectProtocol_Network(Parameter.HTTP_CONNECT_Protocol, Parameter.HTTP_CONNECT_Address_IPv6.Storage.ss_family, Parameter.HTTP_CONNECT_Address_IPv4.Storage.ss_family, Parameter.HTTP_CONNECT_IsAccordingType, QueryType, &LocalSocketData);
+	auto TunnelData = HTTP_CONNECT_TakeTunnel(NetworkSpecific);
+	auto IsReusedTunnel = static_cast<bool>(TunnelData);
+	size_t RecvLen = 0;
+
+//Jump here to restart.
+JumpTo_Restart:
+	memset(&SocketDataList.front(), 0, sizeof(SocketDataList.front()));
+	SocketDataList.front().Socket = INVALID_SOCKET;
+	ErrorCodeList.front() = 0;
+	SocketSelectingDataList.front().SendBuffer.reset();
+	SocketSelectingDataList.front().SendSize = 0;
+	SocketSelectingDataList.front().SendLen = 0;
+
+//Established tunnel in pool
+	if (TunnelData)
+	{
+		SocketDataList.front() = TunnelData->SocketData;
+
+	//Pending control frames of HTTP version 2 are sent together with request.
+		if (!TunnelData->ControlFrameList.empty())
+		{
+			auto SendBuffer = std::make_unique<uint8_t[]>(TunnelData->ControlFrameList.size() + MEMORY_RESERVED_BYTES);
+			memset(SendBuffer.get(), 0, TunnelData->ControlFrameList.size() + MEMORY_RESERVED_BYTES);
+			memcpy_s(SendBuffer.get(), TunnelData->ControlFrameList.size() + MEMORY_RESERVED_BYTES, TunnelData->ControlFrameList.data(), TunnelData->ControlFrameList.size());
+			std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
+			SocketSelectingDataList.front().SendSize = TunnelData->ControlFrameList.size() + MEMORY_RESERVED_BYTES;
+			SocketSelectingDataList.front().SendLen = TunnelData->ControlFrameList.size();
+			TunnelData->ControlFrameList.clear();
+		}
+	}
+//Connect to HTTP CONNECT server and request a new tunnel.
+	else {
+		TunnelData = HTTP_CONNECT_TunnelConnect(NetworkSpecific, SocketDataList, SocketSelectingDataList, ErrorCodeList, QueryType, LocalSocketData);
+		if (!TunnelData)
+			return EXIT_FAILURE;
+	}
+
+//HTTP version 1.x packet
+	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
+	{
+	//Buffer initialization
+		if (SocketSelectingDataList.front().SendSize <= SendSize + sizeof(uint16_t))
+		{
+			auto SendBuffer = std::make_unique<uint8_t[]>(SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
+			memset(SendBuffer.get(), 0, SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
+			memcpy_s(SendBuffer.get(), SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES, OriginalSend, SendSize);
+			std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
+			SocketSelectingDataList.front().SendSize = SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES;
+		}
+
+	//Write request to buffer.
+		RecvLen = AddLengthDataToHeader(SocketSelectingDataList.front().SendBuffer.get(), SendSize, SocketSelectingDataList.front().SendSize);
+	}
+//HTTP version 2 packet
+	else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
+	{
+	//Flow control, tunnel which runs out of send window is replaced by a new tunnel.
+		if (TunnelData->SendWindow_Connection < static_cast<const int64_t>(SendSize + sizeof(uint16_t)) || 
+			TunnelData->SendWindow_Stream < static_cast<const int64_t>(SendSize + sizeof(uint16_t)))
+		{
+			HTTP_CONNECT_CloseTunnel(*TunnelData, false);
+			TunnelData.reset();
+			if (IsReusedTunnel)
+			{
+				IsReusedTunnel = false;
+				goto JumpTo_Restart;
+			}
+
+			return EXIT_FAILURE;
+		}
+		else {
+			TunnelData->SendWindow_Connection -= SendSize + sizeof(uint16_t);
+			TunnelData->SendWindow_Stream -= SendSize + sizeof(uint16_t);
+		}
+
+	//Buffer initialization
+		if (SocketSelectingDataList.front().SendSize <= SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize)
+		{
+			auto SendBuffer = std::make_unique<uint8_t[]>(SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
+			memset(SendBuffer.get(), 0, SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
+			memcpy_s(SendBuffer.get(), SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_RESERVED_BYTES, SocketSelectingDataList.front().SendBuffer.get(), SocketSelectingDataList.front().SendLen);
+			std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
+			SocketSelectingDataList.front().SendSize = SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_RESERVED_BYTES;
+		}
+
+	//DATA frame, END_STREAM flag is not set because the stream is kept open and shared by the following requests.
+		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->Length_Low = hton16(static_cast<const uint16_t>(SendSize + sizeof(uint16_t)));
+		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->Type = HTTP_2_FRAME_TYPE_DATA;
+		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->StreamIdentifier = hton32(HTTP_2_FRAME_INIT_STREAM_ID);
+		SocketSelectingDataList.front().SendLen += sizeof(http2_frame_hdr);
+
+	//Write request to buffer.
+		memcpy_s(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen, SocketSelectingDataList.front().SendSize - SocketSelectingDataList.front().SendLen, OriginalSend, SendSize);
+		RecvLen = AddLengthDataToHeader(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen, SendSize, SocketSelectingDataList.front().SendSize - SocketSelectingDataList.front().SendLen);
+	}
+	else {
+		HTTP_CONNECT_CloseTunnel(*TunnelData, true);
+		return EXIT_FAILURE;
+	}
+
+//Add length of request packet.
+	if (RecvLen < DNS_PACKET_MINSIZE)
+	{
+		HTTP_CONNECT_CloseTunnel(*TunnelData, true);
+		return EXIT_FAILURE;
+	}
+	else {
+		SocketSelectingDataList.front().SendLen += RecvLen;
+	}
+
+//HTTP CONNECT exchange
+	DNS_MESSAGE_INDEX MessageIndex;
+	MessageIndex.Length = 0;
+	RecvLen = HTTP_CONNECT_Transport(SocketDataList, SocketSelectingDataList, ErrorCodeList, *TunnelData, MessageIndex);
+	TunnelData->SocketData = SocketDataList.front();
+	if (RecvLen >= DNS_PACKET_MINSIZE)
+	{
+	//Put tunnel back to pool.
+		HTTP_CONNECT_ReturnTunnel(TunnelData);
+
+	//Mark domain cache.
+		if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
+			MarkDomainCache(SocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &MessageIndex, &LocalSocketData);
+
+	//Swap buffer.
+		std::swap(OriginalRecv, SocketSelectingDataList.front().RecvBuffer);
+		RecvSize = SocketSelectingDataList.front().RecvSize;
+		return RecvLen;
+	}
+	else {
+		HTTP_CONNECT_CloseTunnel(*TunnelData, true);
+		TunnelData.reset();
+
+	//Tunnel in pool may be closed or sent GOAWAY by HTTP CONNECT server, try again with a new tunnel.
+		if (IsReusedTunnel && !GlobalRunningStatus.IsNeedExit)
+		{
+			IsReusedTunnel = false;
+			goto JumpTo_Restart;
+		}
+	}
+
+	return EXIT_FAILURE;
+}
+
+//Connect to HTTP CONNECT server and request a new tunnel
+std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> HTTP_CONNECT_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &SocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
+	std::vector<ssize_t> &ErrorCodeList, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData)
+{
+//Tunnel initialization
+	auto TunnelData = std::make_unique<HTTP_CONNECT_TUNNEL_DATA>();
+	TunnelData->NetworkSpecific = NetworkSpecific;
+	TunnelData->SocketData.Socket = INVALID_SOCKET;
+	TunnelData->TLS_Context = nullptr;
+	TunnelData->SendWindow_Connection = HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE;
+	TunnelData->SendWindow_Stream = HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE;
+	TunnelData->InitialWindowSize = HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE;
+	TunnelData->ReceiveWindowUsed = 0;
+	TunnelData->IsShutdown = false;
+	TunnelData->ClearTime = 0;
+
+//TLS initialization
+#if defined(ENABLE_TLS)
+	if (Parameter.HTTP_CONNECT_TLS_Handshake)
+	#if defined(PLATFORM_WIN)
+		TunnelData->TLS_Context = &TunnelData->SSPI_Handle;
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		TunnelData->TLS_Context = &TunnelData->OpenSSL_CTX;
+	#endif
+#endif
+
+//HTTP CONNECT handshake
+	if (!HTTP_CONNECT_Handshake(SocketDataList, SocketSelectingDataList, ErrorCodeList, QueryType, LocalSocketData, TunnelData->TLS_Context))
+		return nullptr;
+	else 
+		TunnelData->SocketData = SocketDataList.front();
+
+//Window sizes in handshake response of HTTP version 2, SETTINGS and PING frames are already acknowledged by handshake.
+	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2 && SocketSelectingDataList.front().RecvBuffer)
+	{
+		std::vector<uint8_t> DataList;
+		HTTP_CONNECT_2_TunnelFrameProcess(*TunnelData, SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvLen, true, DataList);
+	}
+
+	return TunnelData;
+}
+
+//Take established HTTP CONNECT tunnel connection from pool, it is used exclusively until it is put back.
+std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> HTTP_CONNECT_TakeTunnel(
+	const uint16_t NetworkSpecific)
+{
+	std::list<std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA>> ExpiredList;
+	std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> TunnelData(nullptr);
+	std::unique_lock<std::mutex> HTTP_CONNECT_TunnelMutex(HTTP_CONNECT_TunnelLock);
+
+//Remove expired tunnels, tunnels are sorted by time which are put back to pool and the oldest are at the end of list.
+	const auto CurrentTime = GetCurrentSystemTime();
+	while (!HTTP_CONNECT_TunnelList.empty() && HTTP_CONNECT_TunnelList.back()->ClearTime <= CurrentTime)
+		ExpiredList.splice(ExpiredList.end(), HTTP_CONNECT_TunnelList, std::prev(HTTP_CONNECT_TunnelList.end()));
+
+//Take the latest tunnel which is matched.
+	for (auto TunnelItem = HTTP_CONNECT_TunnelList.begin();TunnelItem != HTTP_CONNECT_TunnelList.end();++TunnelItem)
+	{
+		if ((*TunnelItem)->NetworkSpecific == NetworkSpecific)
+		{
+			TunnelData = std::move(*TunnelItem);
+			HTTP_CONNECT_TunnelList.erase(TunnelItem);
+			break;
+		}
+	}
+
+//Shutdown frames are sent to server, it must be done without lock.
+	HTTP_CONNECT_TunnelMutex.unlock();
+	for (auto &TunnelItem:ExpiredList)
+		HTTP_CONNECT_CloseTunnel(*TunnelItem, false);
+
+//Tunnel which is closed by HTTP CONNECT server must be dropped.
+	if (TunnelData && !HTTP_CONNECT_CheckTunnelSocket(*TunnelData))
+	{
+		HTTP_CONNECT_CloseTunnel(*TunnelData, false);
+		TunnelData.reset();
+	}
+
+	return TunnelData;
+}
+
+//Put HTTP CONNECT tunnel back to pool
+void HTTP_CONNECT_ReturnTunnel(
+	std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> &TunnelData)
+{
+	if (!TunnelData->IsShutdown)
+	{
+		std::lock_guard<std::mutex> HTTP_CONNECT_TunnelMutex(HTTP_CONNECT_TunnelLock);
+		if (!GlobalRunningStatus.IsNeedExit && HTTP_CONNECT_TunnelList.size() < HTTP_CONNECT_TUNNEL_POOL_MAXNUM)
+		{
+			TunnelData->ClearTime = GetCurrentSystemTime() + HTTP_CONNECT_TUNNEL_IDLE_TIME;
+			HTTP_CONNECT_TunnelList.push_front(std::move(TunnelData));
+
+			return;
+		}
+	}
+
+//Tunnel which is not reusable or out of pool is closed.
+	HTTP_CONNECT_CloseTunnel(*TunnelData, false);
+	TunnelData.reset();
+
+	return;
+}
+
+//Check idle socket of HTTP CONNECT tunnel
+bool HTTP_CONNECT_CheckTunnelSocket(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData)
+{
+//Socket check
+	auto Socket = TunnelData.SocketData.Socket;
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (TunnelData.TLS_Context != nullptr)
+		Socket = TunnelData.OpenSSL_CTX.Socket;
+#endif
+#endif
+	if (!SocketSetting(Socket, SOCKET_SETTING_TYPE::INVALID_CHECK, false, nullptr))
+		return false;
+
+//Data is only peeked, HTTP version 2 frames and TLS records which are sent by server when tunnel is idle are processed by next exchange.
+	uint8_t RecvBuffer = 0;
+	const auto RecvLen = recv(Socket, reinterpret_cast<char *>(&RecvBuffer), sizeof(RecvBuffer), MSG_PEEK);
+	if (RecvLen == SOCKET_ERROR)
+	{
+		const auto ErrorCode = WSAGetLastError();
+	#if defined(PLATFORM_WIN)
+		return ErrorCode == WSAEWOULDBLOCK;
+	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+		return ErrorCode == EAGAIN || ErrorCode == EINPROGRESS;
+	#endif
+	}
+//Shutdown notification, or unexpected data in idle HTTP version 1.x tunnel
+	else if (RecvLen == 0 || (TunnelData.TLS_Context == nullptr && Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+//Close HTTP CONNECT tunnel
+void HTTP_CONNECT_CloseTunnel(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const bool IsError)
+{
+//Initialization
+	std::vector<SOCKET_DATA> SocketDataList(1U);
 	std::vector<ssize_t> ErrorCodeList(1U);
-	memset(&SocketDataList.front(), 0, sizeof(SocketDataList.front()));
-	SocketDataList.front().Socket = INVALID_SOCKET;
+	SocketDataList.front() = TunnelData.SocketData;
 	ErrorCodeList.front() = 0;
-	size_t RecvLen = 0;
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (TunnelData.TLS_Context != nullptr)
+		SocketDataList.front().Socket = TunnelData.OpenSSL_CTX.Socket;
+#endif
+#endif
 
-//TLS initialization
-	void *TLS_Context = nullptr;
+//HTTP version 2 shutdown connection.
+	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
+	{
+		if (IsError)
+			HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_RST_STREAM, HTTP_2_ERROR_INTERNAL_ERROR, TunnelData.TLS_Context);
+		else 
+			HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_GOAWAY, HTTP_2_ERROR_NO_ERROR, TunnelData.TLS_Context);
+	}
+
+//TLS shutdown connection.
 #if defined(ENABLE_TLS)
+	if (TunnelData.TLS_Context != nullptr)
 #if defined(PLATFORM_WIN)
-	SSPI_HANDLE_TABLE SSPI_Handle;
-	if (Parameter.HTTP_CONNECT_TLS_Handshake)
-		TLS_Context = &SSPI_Handle;
+		SSPI_ShutdownConnection(TunnelData.SSPI_Handle, SocketDataList, ErrorCodeList);
 #elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-	OPENSSL_CONTEXT_TABLE OpenSSL_CTX;
-	if (Parameter.HTTP_CONNECT_TLS_Handshake)
-		TLS_Context = &OpenSSL_CTX;
+		OpenSSL_ShutdownConnection(TunnelData.OpenSSL_CTX);
+	else 
 #endif
 #endif
+//Normal shutdown connection.
+		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
 
-//HTTP CONNECT handshake
-	if (!HTTP_CONNECT_Handshake(SocketDataList, SocketSelectingDataList, ErrorCodeList, QueryType, LocalSocketData, TLS_Context))
-		return EXIT_FAILURE;
+	TunnelData.SocketData.Socket = INVALID_SOCKET;
+	TunnelData.IsShutdown = true;
+	return;
+}
 
-//HTTP version 1.x packet
-	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
+//HTTP CONNECT process frames in HTTP version 2 tunnel
+bool HTTP_CONNECT_2_TunnelFrameProcess(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	const bool IsHandshake, 
+	std::vector<uint8_t> &DataList)
+{
+	for (size_t Index = 0;Index < Length;)
 	{
-	//Buffer initialization
-		if (SocketSelectingDataList.front().SendSize <= SendSize + sizeof(uint16_t))
+	//Frame check
+		const auto FrameHeader = reinterpret_cast<const http2_frame_hdr *>(Buffer + Index);
+		if (Index + sizeof(http2_frame_hdr) > Length || FrameHeader->Length_High > 0 || 
+			Index + sizeof(http2_frame_hdr) + ntoh16(FrameHeader->Length_Low) > Length)
+				return false;
+		const auto FrameData = Buffer + Index + sizeof(http2_frame_hdr);
+		const size_t FrameLength = ntoh16(FrameHeader->Length_Low);
+		Index += sizeof(http2_frame_hdr) + FrameLength;
+
+	//DATA frame of tunnel stream, flow control counts the whole frame payload including padding.
+		if (FrameHeader->Type == HTTP_2_FRAME_TYPE_DATA)
 		{
-			auto SendBuffer = std::make_unique<uint8_t[]>(SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
-			memset(SendBuffer.get(), 0, SendSize + sizeof(uint16_t) + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
-			memcpy_s(SendBuffer.get(), SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES, OriginalSend, SendSize);
-			std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
-			SocketSelectingDataList.front().SendSize = SendSize + sizeof(uint16_t) + MEMORY_RESERVED_BYTES;
-		}
+			if (IsHandshake || ntoh32(FrameHeader->StreamIdentifier) != HTTP_2_FRAME_INIT_STREAM_ID)
+				return false;
+			TunnelData.ReceiveWindowUsed += FrameLength;
 
-	//Write request to buffer.
-		RecvLen = AddLengthDataToHeader(SocketSelectingDataList.front().SendBuffer.get(), SendSize, SocketSelectingDataList.front().SendSize);
-	}
-//HTTP version 2 packet
-	else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-	{
-	//Buffer initialization
-		if (SocketSelectingDataList.front().SendSize <= SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize)
+		//Padding data is removed.
+			if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_PADDED) != 0)
+			{
+				if (FrameLength == 0 || static_cast<const size_t>(*FrameData) + sizeof(uint8_t) > FrameLength)
+					return false;
+				else 
+					DataList.insert(DataList.end(), FrameData + sizeof(uint8_t), FrameData + FrameLength - *FrameData);
+			}
+			else {
+				DataList.insert(DataList.end(), FrameData, FrameData + FrameLength);
+			}
+
+		//Stream is closed by server.
+			if ((FrameHeader->Flags & HTTP_2_DATA_FLAGS_END_STREAM) != 0)
+				TunnelData.IsShutdown = true;
+		}
+	//RST_STREAM frame of tunnel stream
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_RST_STREAM)
 		{
-			auto SendBuffer = std::make_unique<uint8_t[]>(SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
-			memset(SendBuffer.get(), 0, SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_BUFFER_EXPAND_BYTES + MEMORY_RESERVED_BYTES);
-			memcpy_s(SendBuffer.get(), SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_RESERVED_BYTES, SocketSelectingDataList.front().SendBuffer.get(), SocketSelectingDataList.front().SendLen);
-			std::swap(SocketSelectingDataList.front().SendBuffer, SendBuffer);
-			SocketSelectingDataList.front().SendSize = SocketSelectingDataList.front().SendLen + sizeof(http2_frame_hdr) + sizeof(uint16_t) + SendSize + MEMORY_RESERVED_BYTES;
+			if (ntoh32(FrameHeader->StreamIdentifier) == HTTP_2_FRAME_INIT_STREAM_ID)
+			{
+				TunnelData.IsShutdown = true;
+				return false;
+			}
 		}
+	//SETTINGS frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_SETTINGS && (FrameHeader->Flags & HTTP_2_SETTINGS_FLAGS_ACK) == 0)
+		{
+		//Change of initial window size is applied to send window of tunnel stream.
+			for (size_t SettingsIndex = 0;SettingsIndex + sizeof(http2_settings_frame) <= FrameLength;SettingsIndex += sizeof(http2_settings_frame))
+			{
+				const auto SettingsFrame = reinterpret_cast<const http2_settings_frame *>(FrameData + SettingsIndex);
+				if (ntoh16(SettingsFrame->Identifier) == HTTP_2_SETTINGS_TYPE_INITIAL_WINDOW_SIZE)
+				{
+					TunnelData.SendWindow_Stream += static_cast<const int64_t>(ntoh32(SettingsFrame->Value)) - TunnelData.InitialWindowSize;
+					TunnelData.InitialWindowSize = ntoh32(SettingsFrame->Value);
+				}
+			}
 
-	//DATA frame
-		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->Length_Low = hton16(static_cast<const uint16_t>(SendSize + sizeof(uint16_t)));
-		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->Type = HTTP_2_FRAME_TYPE_DATA;
-		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->Flags = HTTP_2_DATA_FLAGS_END_STREAM;
-		reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen)->StreamIdentifier = hton32(HTTP_2_FRAME_INIT_STREAM_ID);
-		SocketSelectingDataList.front().SendLen += sizeof(http2_frame_hdr);
-
-	//Write request to buffer.
-		memcpy_s(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen, SocketSelectingDataList.front().SendSize - SocketSelectingDataList.front().SendLen, OriginalSend, SendSize);
-		RecvLen = AddLengthDataToHeader(SocketSelectingDataList.front().SendBuffer.get() + SocketSelectingDataList.front().SendLen, SendSize, SocketSelectingDataList.front().SendSize - SocketSelectingDataList.front().SendLen);
-	}
-	else {
-		return EXIT_FAILURE;
+		//SETTINGS frame response
+			if (!IsHandshake)
+				HTTP_CONNECT_2_ControlFrameWrite(TunnelData, HTTP_2_FRAME_TYPE_SETTINGS, HTTP_2_SETTINGS_FLAGS_ACK, 0, nullptr, 0);
+		}
+	//PING frame response
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_PING && (FrameHeader->Flags & HTTP_2_PING_FLAGS_ACK) == 0)
+		{
+			if (!IsHandshake)
+				HTTP_CONNECT_2_ControlFrameWrite(TunnelData, HTTP_2_FRAME_TYPE_PING, HTTP_2_PING_FLAGS_ACK, 0, FrameData, FrameLength);
+		}
+	//GOAWAY frame, the tunnel stream is still alive and tunnel is replaced after this exchange.
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_GOAWAY)
+		{
+			TunnelData.IsShutdown = true;
+		}
+	//WINDOW_UPDATE frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_WINDOW_UPDATE && FrameLength >= sizeof(http2_window_update_frame))
+		{
+			const auto WindowSizeIncrement = ntoh32(reinterpret_cast<const http2_window_update_frame *>(FrameData)->WindowSizeIncrement) & 0x7FFFFFFF;
+			if (ntoh32(FrameHeader->StreamIdentifier) == 0)
+				TunnelData.SendWindow_Connection += WindowSizeIncrement;
+			else if (ntoh32(FrameHeader->StreamIdentifier) == HTTP_2_FRAME_INIT_STREAM_ID)
+				TunnelData.SendWindow_Stream += WindowSizeIncrement;
+		}
 	}
 
-//Add length of request packet.
-	if (RecvLen < DNS_PACKET_MINSIZE)
+//Received DATA frames are acknowledged by WINDOW_UPDATE frames of connection and tunnel stream.
+	if (!IsHandshake && TunnelData.ReceiveWindowUsed > 0)
 	{
-	//HTTP version 2 shutdown connection.
-		if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-			HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_RST_STREAM, HTTP_2_ERROR_INTERNAL_ERROR, TLS_Context);
-
-	//TLS shutdown connection.
-	#if defined(ENABLE_TLS)
-		if (TLS_Context != nullptr)
-	#if defined(PLATFORM_WIN)
-			SSPI_ShutdownConnection(*static_cast<SSPI_HANDLE_TABLE *>(TLS_Context), SocketDataList, ErrorCodeList);
-	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			OpenSSL_ShutdownConnection(*static_cast<OPENSSL_CONTEXT_TABLE *>(TLS_Context));
-		else 
-	#endif
-	#endif
-	//Normal shutdown connection.
-			SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-		return EXIT_FAILURE;
-	}
-	else {
-		SocketSelectingDataList.front().SendLen += RecvLen;
+		http2_window_update_frame WindowUpdateFrame;
+		WindowUpdateFrame.WindowSizeIncrement = hton32(static_cast<const uint32_t>(TunnelData.ReceiveWindowUsed));
+		HTTP_CONNECT_2_ControlFrameWrite(TunnelData, HTTP_2_FRAME_TYPE_WINDOW_UPDATE, 0, 0, reinterpret_cast<const uint8_t *>(&WindowUpdateFrame), sizeof(WindowUpdateFrame));
+		HTTP_CONNECT_2_ControlFrameWrite(TunnelData, HTTP_2_FRAME_TYPE_WINDOW_UPDATE, 0, HTTP_2_FRAME_INIT_STREAM_ID, reinterpret_cast<const uint8_t *>(&WindowUpdateFrame), sizeof(WindowUpdateFrame));
+		TunnelData.ReceiveWindowUsed = 0;
 	}
 
-//HTTP CONNECT exchange
-	RecvLen = HTTP_CONNECT_Transport(SocketDataList, SocketSelectingDataList, ErrorCodeList, TLS_Context);
-	if (RecvLen >= DNS_PACKET_MINSIZE)
-	{
-	//Mark domain cache.
-		if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
-			MarkDomainCache(SocketSelectingDataList.front().RecvBuffer.get(), RecvLen, &LocalSocketData);
+	return true;
+}
 
-	//Swap buffer.
-		std::swap(OriginalRecv, SocketSelectingDataList.front().RecvBuffer);
-		RecvSize = SocketSelectingDataList.front().RecvSize;
-		return RecvLen;
-	}
-	else {
-		return EXIT_FAILURE;
-	}
+//HTTP CONNECT write pending control frame of HTTP version 2 tunnel
+void HTTP_CONNECT_2_ControlFrameWrite(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const uint8_t Type, 
+	const uint8_t Flags, 
+	const uint32_t StreamIdentifier, 
+	const uint8_t * const Payload, 
+	const size_t Length)
+{
+//Frame header
+	http2_frame_hdr FrameHeader;
+	memset(&FrameHeader, 0, sizeof(FrameHeader));
+	FrameHeader.Length_Low = hton16(static_cast<const uint16_t>(Length));
+	FrameHeader.Type = Type;
+	FrameHeader.Flags = Flags;
+	FrameHeader.StreamIdentifier = hton32(StreamIdentifier);
+	TunnelData.ControlFrameList.insert(TunnelData.ControlFrameList.end(), reinterpret_cast<const uint8_t *>(&FrameHeader), reinterpret_cast<const uint8_t *>(&FrameHeader) + sizeof(FrameHeader));
+
+//Frame payload
+	if (Payload != nullptr && Length > 0)
+		TunnelData.ControlFrameList.insert(TunnelData.ControlFrameList.end(), Payload, Payload + Length);
 
-	return EXIT_SUCCESS;
+	return;
 }
 
 //Handshake of HTTP CONNECT protocol
@@ -2538,234 +3181,83 @@ size_t HTTP_CONNECT_Transport(
 	std::vector<SOCKET_DATA> &SocketDataList, 
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
 	std::vector<ssize_t> &ErrorCodeList, 
-	void *TLS_Context)
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	DNS_MESSAGE_INDEX &MessageIndex)
 {
 //Socket data check
-	if (SocketDataList.empty())
-	{
+	if (SocketDataList.empty() || SocketSelectingDataList.empty() || ErrorCodeList.empty())
 		return EXIT_FAILURE;
+
+//Request type and packet minimum size initialization
+	auto RequestType = REQUEST_PROCESS_TYPE::NONE;
+	size_t PacketMinSize = DNS_PACKET_MINSIZE;
+	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
+	{
+		RequestType = REQUEST_PROCESS_TYPE::TCP_NORMAL;
 	}
-	if (SocketSelectingDataList.empty() || ErrorCodeList.empty())
+	else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
 	{
-	//HTTP version 2 shutdown connection.
-		if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-			HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_RST_STREAM, HTTP_2_ERROR_INTERNAL_ERROR, TLS_Context);
-
-	//TLS shutdown connection.
-	#if defined(ENABLE_TLS)
-		if (TLS_Context != nullptr)
-	#if defined(PLATFORM_WIN)
-			SSPI_ShutdownConnection(*static_cast<SSPI_HANDLE_TABLE *>(TLS_Context), SocketDataList, ErrorCodeList);
-	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-			OpenSSL_ShutdownConnection(*static_cast<OPENSSL_CONTEXT_TABLE *>(TLS_Context));
-		else 
-	#endif
-	#endif
-	//Normal shutdown connection.
-			SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
+		RequestType = REQUEST_PROCESS_TYPE::HTTP_CONNECT_2;
+		PacketMinSize += sizeof(http2_frame_hdr);
+	}
+	else {
 		return EXIT_FAILURE;
 	}
 
-//Request exchange
-	size_t RecvLen = 0;
-	if (TLS_Context != nullptr)
+//Request exchange, connection is not closed here and it is shared with other requests.
+	if (TunnelData.TLS_Context != nullptr)
 	{
-	//Request type and packet minimum size initialization
-		auto RequestType = REQUEST_PROCESS_TYPE::NONE;
-		size_t PacketMinSize = DNS_PACKET_MINSIZE;
-		if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
-		{
-			RequestType = REQUEST_PROCESS_TYPE::TCP_NORMAL;
-		}
-		else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-		{
-			RequestType = REQUEST_PROCESS_TYPE::HTTP_CONNECT_2;
-			PacketMinSize += sizeof(http2_frame_hdr);
-		}
-		else {
-			return EXIT_FAILURE;
-		}
-
-	//TLS process
 	#if defined(ENABLE_TLS)
 	#if defined(PLATFORM_WIN)
-		if (!TLS_TransportSerial(RequestType, PacketMinSize, *static_cast<SSPI_HANDLE_TABLE *>(TLS_Context), SocketDataList, SocketSelectingDataList, ErrorCodeList))
-		{
-		//HTTP version 2 shutdown connection.
-			if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-				HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_RST_STREAM, HTTP_2_ERROR_INTERNAL_ERROR, TLS_Context);
-
-		//TLS shutdown connection.
-			SSPI_ShutdownConnection(*static_cast<SSPI_HANDLE_TABLE *>(TLS_Context), SocketDataList, ErrorCodeList);
-
-		//Normal shutdown connection.
-			SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-			return EXIT_FAILURE;
-		}
-		else {
-		//HTTP version 2 shutdown connection.
-			if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-				HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_GOAWAY, HTTP_2_ERROR_NO_ERROR, TLS_Context);
-
-		//TLS shutdown connection.
-			SSPI_ShutdownConnection(*static_cast<SSPI_HANDLE_TABLE *>(TLS_Context), SocketDataList, ErrorCodeList);
-
-		//Normal shutdown connection.
-			SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-		}
+		if (!TLS_TransportSerial(RequestType, PacketMinSize, TunnelData.SSPI_Handle, SocketDataList, SocketSelectingDataList, ErrorCodeList))
 	#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
-		if (!TLS_TransportSerial(RequestType, PacketMinSize, *static_cast<OPENSSL_CONTEXT_TABLE *>(TLS_Context), SocketSelectingDataList))
-		{
-		//HTTP version 2 shutdown connection.
-			if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-				HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_RST_STREAM, HTTP_2_ERROR_INTERNAL_ERROR, TLS_Context);
-
-		//TLS shutdown connection.
-			OpenSSL_ShutdownConnection(*static_cast<OPENSSL_CONTEXT_TABLE *>(TLS_Context));
-
-			return EXIT_FAILURE;
-		}
-		else {
-		//HTTP version 2 shutdown connection.
-			if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-				HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_GOAWAY, HTTP_2_ERROR_NO_ERROR, TLS_Context);
-
-		//TLS shutdown connection.
-			OpenSSL_ShutdownConnection(*static_cast<OPENSSL_CONTEXT_TABLE *>(TLS_Context));
-		}
+		if (!TLS_TransportSerial(RequestType, PacketMinSize, TunnelData.OpenSSL_CTX, SocketSelectingDataList))
 	#endif
+			return EXIT_FAILURE;
 	#endif
 	}
 	else {
-	//Send process.
 		SocketSelectingDataList.front().RecvBuffer.reset();
 		SocketSelectingDataList.front().RecvSize = 0;
 		SocketSelectingDataList.front().RecvLen = 0;
-		if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
-		{
-			RecvLen = SocketSelectingSerial(REQUEST_PROCESS_TYPE::HTTP_CONNECT_2, IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList);
-
-		//HTTP version 2 shutdown connection.
-			HTTP_CONNECT_2_ShutdownConnection(SocketDataList, ErrorCodeList, HTTP_2_FRAME_TYPE_GOAWAY, HTTP_2_ERROR_NO_ERROR, TLS_Context);
-		}
-		else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
-		{
-			RecvLen = SocketSelectingSerial(REQUEST_PROCESS_TYPE::TCP_NORMAL, IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList);
-		}
-		else {
-			return EXIT_FAILURE;
-		}
-
-	//Normal shutdown connection.
-		SocketSetting(SocketDataList.front().Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
-
-	//Receive process
+		const auto RecvLen = SocketSelectingSerial(RequestType, IPPROTO_TCP, SocketDataList, SocketSelectingDataList, ErrorCodeList);
 		SocketSelectingDataList.front().SendBuffer.reset();
 		SocketSelectingDataList.front().SendSize = 0;
 		SocketSelectingDataList.front().SendLen = 0;
-		if (RecvLen == EXIT_FAILURE || 
-			(Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1 && SocketSelectingDataList.front().RecvLen < DNS_PACKET_MINSIZE) || 
-			(Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2 && SocketSelectingDataList.front().RecvLen < sizeof(http2_frame_hdr) + DNS_PACKET_MINSIZE))
+		if (RecvLen == EXIT_FAILURE || SocketSelectingDataList.front().RecvLen < PacketMinSize)
 		{
 			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"HTTP CONNECT request error", ErrorCodeList.front(), nullptr, 0);
 			return EXIT_FAILURE;
 		}
 	}
 
-//HTTP version 2 response check
-	auto IsGotResponseResult = true;
+//HTTP version 2 response
 	if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
 	{
-	//Initialization
-		std::unique_ptr<uint8_t[]> DataBlockBuffer(nullptr);
-		size_t DataBlockSize = 0, DataBlockLength = 0;
-		uint32_t DataIdentifier = 0;
-		IsGotResponseResult = false;
-
-	//HTTP version 2 response
-		for (size_t Index = 0;Index < SocketSelectingDataList.front().RecvLen;)
+		std::vector<uint8_t> DataList;
+		if (!SocketSelectingDataList.front().RecvBuffer || 
+			!HTTP_CONNECT_2_TunnelFrameProcess(TunnelData, SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvLen, false, DataList) || 
+			DataList.size() < sizeof(uint16_t) || DataList.size() < sizeof(uint16_t) + ntoh16(*reinterpret_cast<const uint16_t *>(DataList.data())) || 
+			DataList.size() > SocketSelectingDataList.front().RecvSize)
 		{
-		//Frame check
-			const auto FrameHeader = reinterpret_cast<http2_frame_hdr *>(SocketSelectingDataList.front().RecvBuffer.get() + Index);
-			if (Index + sizeof(http2_frame_hdr) + ntoh16(FrameHeader->Length_Low) > SocketSelectingDataList.front().RecvLen)
-			{
-				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"HTTP CONNECT response error", ErrorCodeList.front(), nullptr, 0);
-				return EXIT_FAILURE;
-			}
-
-		//DATA frame
-			if (FrameHeader->Type == HTTP_2_FRAME_TYPE_DATA)
-			{
-			//Data identifier check
-				if (DataIdentifier == 0)
-				{
-					DataIdentifier = ntoh32(FrameHeader->StreamIdentifier);
-				}
-				else if (DataIdentifier != ntoh32(FrameHeader->StreamIdentifier))
-				{
-					PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"HTTP CONNECT response error", ErrorCodeList.front(), nullptr, 0);
-					return EXIT_FAILURE;
-				}
-
-			//Data process
-				if (FrameHeader->Length_Low > 0)
-				{
-				//Buffer initialization
-					if (DataBlockSize <= DataBlockLength + ntoh16(FrameHeader->Length_Low))
-					{
-						auto DataBuffer = std::make_unique<uint8_t[]>(DataBlockSize + ntoh16(FrameHeader->Length_Low) + MEMORY_RESERVED_BYTES);
-						memset(DataBuffer.get(), 0, DataBlockSize + ntoh16(FrameHeader->Length_Low) + MEMORY_RESERVED_BYTES);
-						if (DataBlockBuffer)
-							memcpy_s(DataBuffer.get(), DataBlockSize + ntoh16(FrameHeader->Length_Low) + MEMORY_RESERVED_BYTES, DataBlockBuffer.get(), DataBlockLength);
-						std::swap(DataBlockBuffer, DataBuffer);
-						DataBlockSize += static_cast<const size_t>(ntoh16(FrameHeader->Length_Low)) + MEMORY_RESERVED_BYTES;
-					}
-
-				//Write to buffer.
-					if (DataBlockBuffer)
-					{
-						memcpy_s(DataBlockBuffer.get() + DataBlockLength, DataBlockSize - DataBlockLength, reinterpret_cast<const uint8_t *>(FrameHeader) + sizeof(http2_frame_hdr), ntoh16(FrameHeader->Length_Low));
-						DataBlockLength += ntoh16(FrameHeader->Length_Low);
-
-					//Whole packet check
-//						if ((FrameHeader->Flags & HTTP_2_DATA_FLAGS_END_STREAM) != 0) //It seems that proxy server is not set END_STREAM flag although transmission has been completed.
-						if (DataBlockLength >= sizeof(uint16_t) && 
-							ntoh16(*reinterpret_cast<const uint16_t *>(DataBlockBuffer.get())) >= DNS_PACKET_MINSIZE && 
-							sizeof(uint16_t) + ntoh16(*reinterpret_cast<const uint16_t *>(DataBlockBuffer.get())) <= DataBlockLength)
-						{
-							if (DataBlockLength <= SocketSelectingDataList.front().RecvSize)
-							{
-								memset(SocketSelectingDataList.front().RecvBuffer.get(), 0, SocketSelectingDataList.front().RecvSize);
-								memcpy_s(SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvSize, DataBlockBuffer.get(), DataBlockLength);
-								IsGotResponseResult = true;
-							}
-
-							break;
-						}
-					}
-					else {
-						PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"HTTP CONNECT response error", ErrorCodeList.front(), nullptr, 0);
-						return EXIT_FAILURE;
-					}
-				}
-			}
-
-		//Length check
-			if (Index + ntoh16(FrameHeader->Length_Low) == SocketSelectingDataList.front().RecvLen)
-				break;
-			else 
-				Index += ntoh16(FrameHeader->Length_Low);
+			PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NETWORK, L"HTTP CONNECT response error", ErrorCodeList.front(), nullptr, 0);
+			return EXIT_FAILURE;
 		}
+
+	//Write whole DNS message to buffer.
+		memset(SocketSelectingDataList.front().RecvBuffer.get(), 0, SocketSelectingDataList.front().RecvSize);
+		memcpy_s(SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvSize, DataList.data(), DataList.size());
+		SocketSelectingDataList.front().RecvLen = DataList.size();
 	}
 
 //HTTP CONNECT response check
-	if (IsGotResponseResult && 
-		SocketSelectingDataList.front().RecvLen >= DNS_PACKET_MINSIZE && ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]) >= DNS_PACKET_MINSIZE && 
+	if (SocketSelectingDataList.front().RecvLen >= DNS_PACKET_MINSIZE && ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]) >= DNS_PACKET_MINSIZE && 
 		SocketSelectingDataList.front().RecvLen >= sizeof(uint16_t) + ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]))
 	{
-		RecvLen = ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]);
+	//Tunnel which contains more data than one response is out of step with requests and it must not be reused.
+		size_t RecvLen = ntoh16((reinterpret_cast<const uint16_t *>(SocketSelectingDataList.front().RecvBuffer.get()))[0]);
+		if (SocketSelectingDataList.front().RecvLen > sizeof(uint16_t) + RecvLen)
+			TunnelData.IsShutdown = true;
 		memmove_s(SocketSelectingDataList.front().RecvBuffer.get(), SocketSelectingDataList.front().RecvSize, SocketSelectingDataList.front().RecvBuffer.get() + sizeof(uint16_t), RecvLen);
 		memset(SocketSelectingDataList.front().RecvBuffer.get() + RecvLen, 0, SocketSelectingDataList.front().RecvSize - RecvLen);
 
@@ -2776,7 +3268,8 @@ size_t HTTP_CONNECT_Transport(
 			RecvLen, 
 			SocketSelectingDataList.front().RecvSize, 
 			nullptr, 
-			nullptr);
+			nullptr, 
+			&MessageIndex);
 		if (RecvLen >= DNS_PACKET_MINSIZE)
 			return RecvLen;
 	}
@@ -22,11 +22,77 @@
 
 #include "Include.h"
 
+//Structure definitions
+//Established SOCKS tunnel in pool
+typedef struct _socks_tunnel_data_
+{
+	uint16_t                             Protocol;
+	uint16_t                             NetworkSpecific;
+	SOCKET_DATA                          TCP_SocketData;
+	SOCKET_DATA                          UDP_SocketData;
+	uint64_t                             ClearTime;
+}SOCKSTunnelData, SOCKS_TUNNEL_DATA;
+
+//Established HTTP CONNECT tunnel in connection pool, window sizes and pending control frames are only used by HTTP version 2.
+//Each pooled connection is taken by one request and carries one exchange at a time, CONNECT streams are not multiplexed in a connection.
+typedef struct _http_connect_tunnel_data_
+{
+	uint16_t                             NetworkSpecific;
+	SOCKET_DATA                          SocketData;
+#if defined(ENABLE_TLS)
+#if defined(PLATFORM_WIN)
+	SSPI_HANDLE_TABLE                    SSPI_Handle;
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	OPENSSL_CONTEXT_TABLE                OpenSSL_CTX;
+#endif
+#endif
+	void                                 *TLS_Context;
+	std::vector<uint8_t>                 ControlFrameList;
+	int64_t                              SendWindow_Connection;
+	int64_t                              SendWindow_Stream;
+	int64_t                              InitialWindowSize;
+	size_t                               ReceiveWindowUsed;
+	bool                                 IsShutdown;
+	uint64_t                             ClearTime;
+}HTTPConnectTunnelData, HTTP_CONNECT_TUNNEL_DATA;
+
 //Global variables
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
 
+//Local variables
+std::list<SOCKS_TUNNEL_DATA> SOCKS_TunnelList;
+std::mutex SOCKS_TunnelLock;
+std::list<std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA>> HTTP_CONNECT_TunnelList;
+std::mutex HTTP_CONNECT_TunnelLock;
+
 //Functions
+bool SOCKS_TCP_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &SocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
+	std::vector<ssize_t> &ErrorCodeList);
+bool SOCKS_UDP_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &TCPSocketDataList, 
+	std::vector<SOCKET_DATA> &UDPSocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &TCPSocketSelectingDataList, 
+	std::vector<ssize_t> &TCPErrorCodeList);
+bool SOCKS_UDP_ReceiveResponse(
+	SOCKET_DATA &SocketData, 
+	SOCKET_SELECTING_SERIAL_DATA &SocketSelectingData, 
+	const uint64_t ReceiveTimeLimit);
+bool SOCKS_TakeTunnel(
+	const uint16_t Protocol, 
+	const uint16_t NetworkSpecific, 
+	SOCKS_TUNNEL_DATA &TunnelData);
+void SOCKS_ReturnTunnel(
+	SOCKS_TUNNEL_DATA &TunnelData);
+bool SOCKS_CheckTunnelSocket(
+	const uint16_t Protocol, 
+	SYSTEM_SOCKET &Socket);
+void SOCKS_CloseTunnel(
+	SOCKS_TUNNEL_DATA &TunnelData);
 bool SOCKS_SelectionExchange(
 	std::vector<SOCKET_DATA> &SocketDataList, 
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
@@ -41,9 +107,6 @@ bool SOCKS_ClientCommandRequest(
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
 	std::vector<ssize_t> &ErrorCodeList, 
 	SOCKET_DATA * const UDP_ASSOCIATE_Address);
-void HTTP_CONNECT_2_IntegerEncoding(
-	std::vector<uint8_t> &BytesList, 
-	size_t IntegerValue);
 void HTTP_CONNECT_2_SETTINGS_WriteBytes(
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
 	const uint16_t Identifier, 
@@ -63,10 +126,6 @@ bool HTTP_CONNECT_2_HEADERS_WriteBytes(
 	const uint8_t *Buffer, 
 	const size_t Length, 
 	const bool IsLiteralFlag);
-bool HTTP_CONNECT_2_HEADERS_ReadBytes(
-	std::vector<std::string> &HeaderList, 
-	const uint8_t *Buffer, 
-	const size_t Length);
 bool HTTP_CONNECT_ResponseBytesCheck(
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
 	const bool IsPrintError);
@@ -76,6 +135,35 @@ bool HTTP_CONNECT_2_ShutdownConnection(
 	const size_t Type, 
 	const size_t ErrorCode, 
 	void *TLS_Context);
+std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> HTTP_CONNECT_TunnelConnect(
+	const uint16_t NetworkSpecific, 
+	std::vector<SOCKET_DATA> &SocketDataList, 
+	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
+	std::vector<ssize_t> &ErrorCodeList, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData);
+std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> HTTP_CONNECT_TakeTunnel(
+	const uint16_t NetworkSpecific);
+void HTTP_CONNECT_ReturnTunnel(
+	std::unique_ptr<HTTP_CONNECT_TUNNEL_DATA> &TunnelData);
+bool HTTP_CONNECT_CheckTunnelSocket(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData);
+void HTTP_CONNECT_CloseTunnel(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const bool IsError);
+bool HTTP_CONNECT_2_TunnelFrameProcess(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	const bool IsHandshake, 
+	std::vector<uint8_t> &DataList);
+void HTTP_CONNECT_2_ControlFrameWrite(
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	const uint8_t Type, 
+	const uint8_t Flags, 
+	const uint32_t StreamIdentifier, 
+	const uint8_t * const Payload, 
+	const size_t Length);
 bool HTTP_CONNECT_Handshake(
 	std::vector<SOCKET_DATA> &SocketDataList, 
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
@@ -92,5 +180,6 @@ size_t HTTP_CONNECT_Transport(
 	std::vector<SOCKET_DATA> &SocketDataList, 
 	std::vector<SOCKET_SELECTING_SERIAL_DATA> &SocketSelectingDataList, 
 	std::vector<ssize_t> &ErrorCodeList, 
-	void *TLS_Context);
+	HTTP_CONNECT_TUNNEL_DATA &TunnelData, 
+	DNS_MESSAGE_INDEX &MessageIndex);
 #endif
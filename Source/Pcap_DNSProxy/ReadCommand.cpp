@@ -161,6 +161,9 @@ bool ReadCommand(
 
 //Read commands.
 	auto IsRewriteLogFile = false;
+#if defined(ENABLE_PCAP)
+	std::string ReplayFileName;
+#endif
 	for (size_t Index = 1U;static_cast<const int>(Index) < argc;++Index)
 	{
 	//Case insensitive
@@ -242,11 +245,15 @@ bool ReadCommand(
 			PrintToScreen(false, false, L"   --log-file stderr/out: Set output log to stderr or stdout.\n");
 			PrintToScreen(false, false, L"   --flush-dns:           Flush all domain cache in program and system immediately.\n");
 			PrintToScreen(false, false, L"   --flush-dns Domain:    Flush cache of Domain in program and all in system immediately.\n");
+			PrintToScreen(false, false, L"   --stats:               Print statistics of running program on screen.\n");
 		#if defined(PLATFORM_WIN)
 			PrintToScreen(false, false, L"   --first-setup:         Test local firewall.\n");
 		#endif
 			PrintToScreen(false, false, L"   --config-path Path:    Set path of configuration file.\n");
 			PrintToScreen(false, false, L"   --keypair-generator:   Generate a DNSCurve(DNSCrypt) keypair.\n");
+		#if defined(ENABLE_PCAP)
+			PrintToScreen(false, false, L"   --replay-pcap File:    Replay capture file through capture module and print statistics.\n");
+		#endif
 		#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX))
 			PrintToScreen(false, false, L"   --disable-daemon:      Disable daemon mode.\n");
 		#endif
@@ -343,6 +350,12 @@ bool ReadCommand(
 			#endif
 			}
 
+			return false;
+		}
+	//Print statistics of running process.
+		else if (InsensitiveString == COMMAND_STATISTICS)
+		{
+			Statistics_Sender();
 			return false;
 		}
 	//DNSCurve(DNSCrypt) KeyPairGenerator
@@ -491,6 +504,33 @@ bool ReadCommand(
 
 			return false;
 		}
+	#if defined(ENABLE_PCAP)
+	//Replay offline capture file.
+		else if (InsensitiveString == COMMAND_REPLAY_PCAP)
+		{
+		//Commands check
+			if (static_cast<const int>(Index) + 1 >= argc)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Commands error", 0, nullptr, 0);
+				return false;
+			}
+			else {
+				++Index;
+
+			//Mark file name.
+			#if defined(PLATFORM_WIN)
+				if (!WCS_To_MBS_String(argv[Index], FILE_BUFFER_SIZE, ReplayFileName))
+			#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+				ReplayFileName = argv[Index];
+				if (ReplayFileName.empty() || ReplayFileName.length() >= PATH_MAX + NAME_MAX)
+			#endif
+				{
+					PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::SYSTEM, L"Commands error", 0, nullptr, 0);
+					return false;
+				}
+			}
+		}
+	#endif
 	#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX))
 	//Set system daemon.
 		else if (InsensitiveString == COMMAND_DISABLE_DAEMON)
@@ -512,6 +552,17 @@ bool ReadCommand(
 	#endif
 	}
 
+//Replay offline capture file with configuration and exit, all other monitors are not launched.
+#if defined(ENABLE_PCAP)
+	if (!ReplayFileName.empty())
+	{
+		if (ReadParameter(true))
+			Capture_ReplayProcess(ReplayFileName);
+
+		return false;
+	}
+#endif
+
 //Set system daemon.
 #if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX))
 	if (GlobalRunningStatus.IsDaemon && daemon(0, 0) == RETURN_ERROR)
@@ -759,7 +759,7 @@ bool Parameter_CheckSetting(
 				Parameter.HTTP_CONNECT_TLS_AddressString_IPv4 = nullptr;
 
 			//Free all OpenSSL libraries.
-				if (GlobalRunningStatus.IsInitialized_OpenSSL)
+				if (GlobalRunningStatus.IsInitialized_OpenSSL && !Parameter.IsDNS_TLS && !Parameter.IsDNS_HTTPS)
 				{
 					OpenSSL_LibraryInit(false);
 					GlobalRunningStatus.IsInitialized_OpenSSL = false;
@@ -857,7 +857,7 @@ bool Parameter_CheckSetting(
 		Parameter.HTTP_CONNECT_TLS_AddressString_IPv4 = nullptr;
 
 	//Free all OpenSSL libraries.
-		if (GlobalRunningStatus.IsInitialized_OpenSSL)
+		if (GlobalRunningStatus.IsInitialized_OpenSSL && !Parameter.IsDNS_TLS && !Parameter.IsDNS_HTTPS)
 		{
 			OpenSSL_LibraryInit(false);
 			GlobalRunningStatus.IsInitialized_OpenSSL = false;
@@ -866,6 +866,104 @@ bool Parameter_CheckSetting(
 	#endif
 	}
 
+//DNS over TLS check
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (IsFirstRead)
+	{
+		if (Parameter.IsDNS_TLS)
+		{
+		//DNS over TLS target check
+			if (Parameter.DNS_TLS_Address_IPv6.Storage.ss_family == 0 && Parameter.DNS_TLS_Address_IPv4.Storage.ss_family == 0)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::TLS, L"DNS over TLS address error", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				return false;
+			}
+		//DNS over TLS Protocol
+		//IPv6
+			else if (Parameter.DNS_TLS_Address_IPv6.Storage.ss_family == 0 && Parameter.DNS_TLS_Protocol == REQUEST_MODE_NETWORK::IPV6)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NOTICE, L"IPv6 Request Mode require IPv6 DNS server", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				Parameter.DNS_TLS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+			}
+		//DNS over TLS Protocol
+		//IPv4
+			else if (Parameter.DNS_TLS_Address_IPv4.Storage.ss_family == 0 && Parameter.DNS_TLS_Protocol == REQUEST_MODE_NETWORK::IPV4)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NOTICE, L"IPv4 Request Mode require IPv4 DNS server", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				Parameter.DNS_TLS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+			}
+
+		//TLS Server Name Indication/SNI check
+			if (Parameter.DNS_TLS_SNI_MBS->empty())
+			{
+				delete Parameter.DNS_TLS_SNI_MBS;
+				Parameter.DNS_TLS_SNI_MBS = nullptr;
+			}
+		}
+		else {
+			delete Parameter.DNS_TLS_AddressString_IPv6;
+			delete Parameter.DNS_TLS_AddressString_IPv4;
+			delete Parameter.DNS_TLS_SNI_MBS;
+			Parameter.DNS_TLS_AddressString_IPv6 = nullptr;
+			Parameter.DNS_TLS_AddressString_IPv4 = nullptr;
+			Parameter.DNS_TLS_SNI_MBS = nullptr;
+			Parameter.DNS_TLS_Only = false;
+		}
+	}
+#endif
+#endif
+
+//DNS over HTTPS check
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	if (IsFirstRead)
+	{
+		if (Parameter.IsDNS_HTTPS)
+		{
+		//DNS over HTTPS target check
+			if (Parameter.DNS_HTTPS_Address_IPv6.Storage.ss_family == 0 && Parameter.DNS_HTTPS_Address_IPv4.Storage.ss_family == 0)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::TLS, L"DNS over HTTPS address error", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				return false;
+			}
+		//DNS over HTTPS Protocol
+		//IPv6
+			else if (Parameter.DNS_HTTPS_Address_IPv6.Storage.ss_family == 0 && Parameter.DNS_HTTPS_Protocol == REQUEST_MODE_NETWORK::IPV6)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NOTICE, L"IPv6 Request Mode require IPv6 DNS server", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				Parameter.DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+			}
+		//DNS over HTTPS Protocol
+		//IPv4
+			else if (Parameter.DNS_HTTPS_Address_IPv4.Storage.ss_family == 0 && Parameter.DNS_HTTPS_Protocol == REQUEST_MODE_NETWORK::IPV4)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::NOTICE, L"IPv4 Request Mode require IPv4 DNS server", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				Parameter.DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+			}
+
+		//TLS Server Name Indication/SNI is also the authority of request, it is required.
+			if (Parameter.DNS_HTTPS_SNI_MBS->empty())
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_1, LOG_ERROR_TYPE::TLS, L"DNS over HTTPS Server Name Indication error", 0, FileList_Config.at(FileIndex).FileName.c_str(), 0);
+				return false;
+			}
+		}
+		else {
+			delete Parameter.DNS_HTTPS_AddressString_IPv6;
+			delete Parameter.DNS_HTTPS_AddressString_IPv4;
+			delete Parameter.DNS_HTTPS_SNI_MBS;
+			delete Parameter.DNS_HTTPS_Path;
+			Parameter.DNS_HTTPS_AddressString_IPv6 = nullptr;
+			Parameter.DNS_HTTPS_AddressString_IPv4 = nullptr;
+			Parameter.DNS_HTTPS_SNI_MBS = nullptr;
+			Parameter.DNS_HTTPS_Path = nullptr;
+			Parameter.DNS_HTTPS_Only = false;
+		}
+	}
+#endif
+#endif
+
 //[DNSCurve] block
 #if defined(ENABLE_LIBSODIUM)
 	if (Parameter.IsDNSCurve)
@@ -1785,6 +1883,22 @@ bool ReadParameterData_Whole(
 	else if (IsPassRemainingBlock)
 		return true;
 
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//[DNS over TLS] block
+	if (!ReadParameterData_DNS_TLS(Data, FileIndex, IsFirstRead, Line, /* ParameterPointer, */ IsPassRemainingBlock))
+		return false;
+	else if (IsPassRemainingBlock)
+		return true;
+
+//[DNS over HTTPS] block
+	if (!ReadParameterData_DNS_HTTPS(Data, FileIndex, IsFirstRead, Line, /* ParameterPointer, */ IsPassRemainingBlock))
+		return false;
+	else if (IsPassRemainingBlock)
+		return true;
+#endif
+#endif
+
 #if defined(ENABLE_LIBSODIUM)
 //[DNSCurve] block
 	if (!ReadParameterData_DNSCurve_Main(Data, FileIndex, IsFirstRead, Line, /* ParameterPointer, */ DNSCurveParameterPointer, IsPassRemainingBlock))
@@ -4031,6 +4145,201 @@ PrintDataFormatError:
 	return false;
 }
 
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//Read parameter data from files(DNS over TLS block)
+bool ReadParameterData_DNS_TLS(
+	const std::string &Data, 
+	const size_t FileIndex, 
+	const bool IsFirstRead, 
+	const size_t Line, 
+//	CONFIGURATION_TABLE * const ParameterPointer, 
+	bool &IsFoundParameter)
+{
+//[DNS over TLS] block
+	if (IsFirstRead)
+	{
+		if (Data.compare(0, strlen("DNSoverTLS=1"), "DNSoverTLS=1") == 0)
+		{
+			Parameter.IsDNS_TLS = true;
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSProtocol="), "DNSoverTLSProtocol=") == 0)
+		{
+			std::string InnerData(Data);
+			CaseConvert(InnerData, true);
+
+		//Network layer
+			if (InnerData.find("IPV6") != std::string::npos && InnerData.find("IPV4") == std::string::npos)
+				Parameter.DNS_TLS_Protocol = REQUEST_MODE_NETWORK::IPV6;
+			else if (InnerData.find("IPV4") != std::string::npos && InnerData.find("IPV6") == std::string::npos)
+				Parameter.DNS_TLS_Protocol = REQUEST_MODE_NETWORK::IPV4;
+			else 
+				Parameter.DNS_TLS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+
+		//According type
+			if (InnerData.find("TYPE") != std::string::npos)
+				Parameter.DNS_TLS_IsAccordingType = true;
+
+		//Mark parameter found.
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSOnly=1"), "DNSoverTLSOnly=1") == 0)
+		{
+			Parameter.DNS_TLS_Only = true;
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSIPv4Address="), "DNSoverTLSIPv4Address=") == 0 && 
+			Data.length() > strlen("DNSoverTLSIPv4Address="))
+		{
+			std::vector<DNS_SERVER_DATA> DNSServerDataTemp;
+			if (!ReadSupport_MultipleAddresses(AF_INET, Data, strlen("DNSoverTLSIPv4Address="), &DNSServerDataTemp, READ_TEXT_TYPE::PARAMETER_NORMAL, FileIndex, Line) || DNSServerDataTemp.empty())
+			{
+				return false;
+			}
+			else {
+				Parameter.DNS_TLS_Address_IPv4 = DNSServerDataTemp.front().AddressData;
+				Parameter.DNS_TLS_AddressString_IPv4->clear();
+				Parameter.DNS_TLS_AddressString_IPv4->append(Data, strlen("DNSoverTLSIPv4Address="), Data.length() - strlen("DNSoverTLSIPv4Address="));
+				IsFoundParameter = true;
+			}
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSIPv6Address="), "DNSoverTLSIPv6Address=") == 0 && 
+			Data.length() > strlen("DNSoverTLSIPv6Address="))
+		{
+			std::vector<DNS_SERVER_DATA> DNSServerDataTemp;
+			if (!ReadSupport_MultipleAddresses(AF_INET6, Data, strlen("DNSoverTLSIPv6Address="), &DNSServerDataTemp, READ_TEXT_TYPE::PARAMETER_NORMAL, FileIndex, Line) || DNSServerDataTemp.empty())
+			{
+				return false;
+			}
+			else {
+				Parameter.DNS_TLS_Address_IPv6 = DNSServerDataTemp.front().AddressData;
+				Parameter.DNS_TLS_AddressString_IPv6->clear();
+				Parameter.DNS_TLS_AddressString_IPv6->append(Data, strlen("DNSoverTLSIPv6Address="), Data.length() - strlen("DNSoverTLSIPv6Address="));
+				IsFoundParameter = true;
+			}
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSServerNameIndication="), "DNSoverTLSServerNameIndication=") == 0 && 
+			Data.length() > strlen("DNSoverTLSServerNameIndication=") + DOMAIN_MINSIZE)
+		{
+			Parameter.DNS_TLS_SNI_MBS->clear();
+			Parameter.DNS_TLS_SNI_MBS->append(Data, strlen("DNSoverTLSServerNameIndication="), Data.length() - strlen("DNSoverTLSServerNameIndication="));
+
+		//Mark parameter found.
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverTLSValidation=1"), "DNSoverTLSValidation=1") == 0)
+		{
+			Parameter.DNS_TLS_Validation = true;
+			IsFoundParameter = true;
+		}
+	}
+
+	return true;
+}
+
+//Read parameter data from files(DNS over HTTPS block)
+bool ReadParameterData_DNS_HTTPS(
+	const std::string &Data, 
+	const size_t FileIndex, 
+	const bool IsFirstRead, 
+	const size_t Line, 
+//	CONFIGURATION_TABLE * const ParameterPointer, 
+	bool &IsFoundParameter)
+{
+//[DNS over HTTPS] block
+	if (IsFirstRead)
+	{
+		if (Data.compare(0, strlen("DNSoverHTTPS=1"), "DNSoverHTTPS=1") == 0)
+		{
+			Parameter.IsDNS_HTTPS = true;
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSProtocol="), "DNSoverHTTPSProtocol=") == 0)
+		{
+			std::string InnerData(Data);
+			CaseConvert(InnerData, true);
+
+		//Network layer
+			if (InnerData.find("IPV6") != std::string::npos && InnerData.find("IPV4") == std::string::npos)
+				Parameter.DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::IPV6;
+			else if (InnerData.find("IPV4") != std::string::npos && InnerData.find("IPV6") == std::string::npos)
+				Parameter.DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::IPV4;
+			else 
+				Parameter.DNS_HTTPS_Protocol = REQUEST_MODE_NETWORK::BOTH;
+
+		//According type
+			if (InnerData.find("TYPE") != std::string::npos)
+				Parameter.DNS_HTTPS_IsAccordingType = true;
+
+		//Mark parameter found.
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSOnly=1"), "DNSoverHTTPSOnly=1") == 0)
+		{
+			Parameter.DNS_HTTPS_Only = true;
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSIPv4Address="), "DNSoverHTTPSIPv4Address=") == 0 && 
+			Data.length() > strlen("DNSoverHTTPSIPv4Address="))
+		{
+			std::vector<DNS_SERVER_DATA> DNSServerDataTemp;
+			if (!ReadSupport_MultipleAddresses(AF_INET, Data, strlen("DNSoverHTTPSIPv4Address="), &DNSServerDataTemp, READ_TEXT_TYPE::PARAMETER_NORMAL, FileIndex, Line) || DNSServerDataTemp.empty())
+			{
+				return false;
+			}
+			else {
+				Parameter.DNS_HTTPS_Address_IPv4 = DNSServerDataTemp.front().AddressData;
+				Parameter.DNS_HTTPS_AddressString_IPv4->clear();
+				Parameter.DNS_HTTPS_AddressString_IPv4->append(Data, strlen("DNSoverHTTPSIPv4Address="), Data.length() - strlen("DNSoverHTTPSIPv4Address="));
+				IsFoundParameter = true;
+			}
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSIPv6Address="), "DNSoverHTTPSIPv6Address=") == 0 && 
+			Data.length() > strlen("DNSoverHTTPSIPv6Address="))
+		{
+			std::vector<DNS_SERVER_DATA> DNSServerDataTemp;
+			if (!ReadSupport_MultipleAddresses(AF_INET6, Data, strlen("DNSoverHTTPSIPv6Address="), &DNSServerDataTemp, READ_TEXT_TYPE::PARAMETER_NORMAL, FileIndex, Line) || DNSServerDataTemp.empty())
+			{
+				return false;
+			}
+			else {
+				Parameter.DNS_HTTPS_Address_IPv6 = DNSServerDataTemp.front().AddressData;
+				Parameter.DNS_HTTPS_AddressString_IPv6->clear();
+				Parameter.DNS_HTTPS_AddressString_IPv6->append(Data, strlen("DNSoverHTTPSIPv6Address="), Data.length() - strlen("DNSoverHTTPSIPv6Address="));
+				IsFoundParameter = true;
+			}
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSServerNameIndication="), "DNSoverHTTPSServerNameIndication=") == 0 && 
+			Data.length() > strlen("DNSoverHTTPSServerNameIndication=") + DOMAIN_MINSIZE)
+		{
+			Parameter.DNS_HTTPS_SNI_MBS->clear();
+			Parameter.DNS_HTTPS_SNI_MBS->append(Data, strlen("DNSoverHTTPSServerNameIndication="), Data.length() - strlen("DNSoverHTTPSServerNameIndication="));
+
+		//Mark parameter found.
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSPath=/"), "DNSoverHTTPSPath=/") == 0 && 
+			Data.length() < strlen("DNSoverHTTPSPath=") + HTTP_2_DNS_PATH_MAXSIZE)
+		{
+			Parameter.DNS_HTTPS_Path->clear();
+			Parameter.DNS_HTTPS_Path->append(Data, strlen("DNSoverHTTPSPath="), Data.length() - strlen("DNSoverHTTPSPath="));
+
+		//Mark parameter found.
+			IsFoundParameter = true;
+		}
+		else if (Data.compare(0, strlen("DNSoverHTTPSValidation=1"), "DNSoverHTTPSValidation=1") == 0)
+		{
+			Parameter.DNS_HTTPS_Validation = true;
+			IsFoundParameter = true;
+		}
+	}
+
+	return true;
+}
+#endif
+#endif
+
 #if defined(ENABLE_LIBSODIUM)
 //Read parameter data from files(DNSCurve block)
 bool ReadParameterData_DNSCurve_Main(
@@ -1175,6 +1175,940 @@ size_t TCP_RequestMultiple(
 	return RecvLen;
 }
 
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//Transmission and reception of DNS over TLS and DNS over HTTPS protocol
+size_t TLS_RequestSingle(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	const uint16_t QueryType, 
+	const SOCKET_DATA &LocalSocketData)
+{
+//Initialization
+	memset(OriginalRecv, 0, RecvSize);
+	uint16_t NetworkSpecific = 0;
+	if (RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN)
+		NetworkSpecific = SelectProtocol_Network(Parameter.DNS_TLS_Protocol, Parameter.DNS_TLS_Address_IPv6.Storage.ss_family, Parameter.DNS_TLS_Address_IPv4.Storage.ss_family, Parameter.DNS_TLS_IsAccordingType, QueryType, &LocalSocketData);
+	else if (RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+		NetworkSpecific = SelectProtocol_Network(Parameter.DNS_HTTPS_Protocol, Parameter.DNS_HTTPS_Address_IPv6.Storage.ss_family, Parameter.DNS_HTTPS_Address_IPv4.Storage.ss_family, Parameter.DNS_HTTPS_IsAccordingType, QueryType, &LocalSocketData);
+	if (SendSize < DNS_PACKET_MINSIZE || (NetworkSpecific != AF_INET6 && NetworkSpecific != AF_INET))
+		return EXIT_FAILURE;
+	auto IsNeedRetry = true;
+
+//Jump here to restart.
+JumpTo_Restart:
+	auto IsReused = false, IsShutdown = false;
+	const auto ConnectionData = StreamConnection_Take(RequestType, NetworkSpecific, IsReused);
+	if (!ConnectionData)
+		return EXIT_FAILURE;
+
+//Request exchange
+	auto RecvLen = StreamConnection_Exchange(*ConnectionData, OriginalSend, SendSize, OriginalRecv, RecvSize, IsShutdown);
+	StreamConnection_Return(ConnectionData, !IsShutdown);
+	if (RecvLen >= DNS_PACKET_MINSIZE)
+	{
+	//Restore ID of request.
+		reinterpret_cast<dns_hdr *>(OriginalRecv)->ID = reinterpret_cast<const dns_hdr *>(OriginalSend)->ID;
+
+	//Response check
+		DNS_MESSAGE_INDEX MessageIndex;
+		RecvLen = CheckResponseData(
+			RequestType, 
+			OriginalRecv, 
+			RecvLen, 
+			RecvSize, 
+			nullptr, 
+			nullptr, 
+			&MessageIndex);
+		if (RecvLen >= DNS_PACKET_MINSIZE)
+		{
+		//Mark domain cache.
+			if (Parameter.DNS_CacheType != DNS_CACHE_TYPE::NONE)
+				MarkDomainCache(OriginalRecv, RecvLen, &MessageIndex, &LocalSocketData);
+
+			return RecvLen;
+		}
+	}
+//Connection in pool may be closed by server, try again with a new connection.
+	else if (IsShutdown && IsReused && IsNeedRetry && !GlobalRunningStatus.IsNeedExit)
+	{
+		IsNeedRetry = false;
+		goto JumpTo_Restart;
+	}
+
+	memset(OriginalRecv, 0, RecvSize);
+	return EXIT_FAILURE;
+}
+
+//Take persistent stream connection from pool
+std::shared_ptr<STREAM_CONNECTION_DATA> StreamConnection_Take(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint16_t Protocol_Network, 
+	bool &IsReused)
+{
+	std::list<std::shared_ptr<STREAM_CONNECTION_DATA>> ExpiredList;
+	std::shared_ptr<STREAM_CONNECTION_DATA> ConnectionData(nullptr);
+	const auto ConnectionKey = std::make_pair(RequestType, Protocol_Network);
+	const auto TimeoutTime = GetCurrentSystemTime() + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_sec) * SECOND_TO_MILLISECOND + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_usec) / MICROSECOND_TO_MILLISECOND;
+	auto IsPending = false;
+	IsReused = false;
+	std::unique_lock<std::mutex> StreamConnectionMutex(StreamConnectionLock);
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		ConnectionData.reset();
+
+	//Remove expired idle connections.
+		const auto CurrentTime = GetCurrentSystemTime();
+		for (auto ConnectionItem = StreamConnectionList.begin();ConnectionItem != StreamConnectionList.end();)
+		{
+			if ((*ConnectionItem)->RequestNum == 0 && (*ConnectionItem)->ClearTime <= CurrentTime)
+				ExpiredList.splice(ExpiredList.end(), StreamConnectionList, ConnectionItem++);
+			else 
+				++ConnectionItem;
+		}
+
+	//Select the matched connection which has the fewest pipelined requests, connections which are connecting also take slots of pool.
+		size_t ConnectionNum = std::count(StreamConnectionPendingList.begin(), StreamConnectionPendingList.end(), ConnectionKey);
+		for (const auto &ConnectionItem:StreamConnectionList)
+		{
+			if (ConnectionItem->RequestType == RequestType && ConnectionItem->Protocol_Network == Protocol_Network)
+			{
+				++ConnectionNum;
+				if (ConnectionItem->RequestMaxNum > 0 && (!ConnectionData || ConnectionItem->RequestNum < ConnectionData->RequestNum))
+					ConnectionData = ConnectionItem;
+			}
+		}
+
+	//New connection is established only when all connections are full of pipelined requests and pool is not full.
+	//Concurrent streams limit of DNS over HTTPS server must not be exceeded, requests wait for free streams when pool is full.
+		if (ConnectionData && (ConnectionData->RequestNum < ConnectionData->RequestMaxNum || 
+			(ConnectionNum >= STREAM_CONNECTION_MAXNUM && RequestType != REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)))
+		{
+			++ConnectionData->RequestNum;
+			IsReused = true;
+
+			break;
+		}
+		else if (ConnectionNum < STREAM_CONNECTION_MAXNUM)
+		{
+			StreamConnectionPendingList.push_back(ConnectionKey);
+			IsPending = true;
+
+			break;
+		}
+	//All slots of pool are connecting or full, wait for them.
+		else if (CurrentTime >= TimeoutTime)
+		{
+			break;
+		}
+		else {
+			StreamConnectionCondition.wait_for(StreamConnectionMutex, std::chrono::milliseconds(TimeoutTime - CurrentTime));
+		}
+	}
+
+//Expired connections must be closed without lock.
+	StreamConnectionMutex.unlock();
+	for (auto &ConnectionItem:ExpiredList)
+		StreamConnection_Close(*ConnectionItem);
+	if (IsReused || !IsPending)
+		return ConnectionData;
+
+//Connect to server, handshake must be done without lock.
+	ConnectionData = StreamConnection_Connect(RequestType, Protocol_Network);
+	StreamConnectionMutex.lock();
+	StreamConnectionPendingList.erase(std::find(StreamConnectionPendingList.begin(), StreamConnectionPendingList.end(), ConnectionKey));
+	if (ConnectionData && !GlobalRunningStatus.IsNeedExit)
+		StreamConnectionList.push_front(ConnectionData);
+	StreamConnectionCondition.notify_all();
+
+	return ConnectionData;
+}
+
+//Connect to server and establish a new persistent stream connection
+std::shared_ptr<STREAM_CONNECTION_DATA> StreamConnection_Connect(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint16_t Protocol_Network)
+{
+//Connection initialization
+	auto ConnectionData = std::make_shared<STREAM_CONNECTION_DATA>();
+	ConnectionData->RequestType = RequestType;
+	ConnectionData->Protocol_Network = Protocol_Network;
+	ConnectionData->SequenceID = 0;
+	ConnectionData->RequestMaxNum = STREAM_CONNECTION_PIPELINE_MAXNUM;
+	ConnectionData->RequestNum = 1U;
+	ConnectionData->IsReading = false;
+	ConnectionData->IsWriting = false;
+	ConnectionData->IsShutdown = false;
+	ConnectionData->ClearTime = 0;
+	ConnectionData->SendWindow_Connection = HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE;
+	ConnectionData->SendWindow_Stream = HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE;
+	ConnectionData->ReceiveWindowUsed = 0;
+	ConnectionData->HeaderTableSize = HTTP_2_SETTINGS_INIT_HEADERS_TABLE_SIZE;
+	ConnectionData->IsHeaderIndexed = false;
+	ConnectionData->IsHeaderTableUpdate = false;
+	ConnectionData->IsSettingsReceived = false;
+	ConnectionData->IsGoawayReceived = false;
+
+//Server address initialization
+	if (RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN && Protocol_Network == AF_INET6 && Parameter.DNS_TLS_AddressString_IPv6 != nullptr && !Parameter.DNS_TLS_AddressString_IPv6->empty())
+		ConnectionData->OpenSSL_CTX.AddressString = *Parameter.DNS_TLS_AddressString_IPv6;
+	else if (RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN && Protocol_Network == AF_INET && Parameter.DNS_TLS_AddressString_IPv4 != nullptr && !Parameter.DNS_TLS_AddressString_IPv4->empty())
+		ConnectionData->OpenSSL_CTX.AddressString = *Parameter.DNS_TLS_AddressString_IPv4;
+	else if (RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && Protocol_Network == AF_INET6 && Parameter.DNS_HTTPS_AddressString_IPv6 != nullptr && !Parameter.DNS_HTTPS_AddressString_IPv6->empty())
+		ConnectionData->OpenSSL_CTX.AddressString = *Parameter.DNS_HTTPS_AddressString_IPv6;
+	else if (RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && Protocol_Network == AF_INET && Parameter.DNS_HTTPS_AddressString_IPv4 != nullptr && !Parameter.DNS_HTTPS_AddressString_IPv4->empty())
+		ConnectionData->OpenSSL_CTX.AddressString = *Parameter.DNS_HTTPS_AddressString_IPv4;
+	else 
+		return nullptr;
+	ConnectionData->OpenSSL_CTX.RequestType = RequestType;
+	ConnectionData->OpenSSL_CTX.Protocol_Network = Protocol_Network;
+	ConnectionData->OpenSSL_CTX.Protocol_Transport = IPPROTO_TCP;
+
+//TLS handshake
+	if (!OpenSSL_CTX_Initializtion(ConnectionData->OpenSSL_CTX) || 
+		!OpenSSL_BIO_Initializtion(ConnectionData->OpenSSL_CTX) || 
+		!OpenSSL_Handshake(ConnectionData->OpenSSL_CTX))
+			return nullptr;
+
+//HTTP version 2 connection initialization
+	if (RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && !DNS_HTTPS_ConnectionInit(*ConnectionData))
+		return nullptr;
+
+	return ConnectionData;
+}
+
+//Put persistent stream connection back to pool
+void StreamConnection_Return(
+	const std::shared_ptr<STREAM_CONNECTION_DATA> &ConnectionData, 
+	const bool IsKeep)
+{
+	std::lock_guard<std::mutex> StreamConnectionMutex(StreamConnectionLock);
+	if (ConnectionData->RequestNum > 0)
+		--ConnectionData->RequestNum;
+	if (ConnectionData->RequestNum == 0)
+		ConnectionData->ClearTime = GetCurrentSystemTime() + STREAM_CONNECTION_IDLE_TIME;
+
+//Connection which is not reusable is removed from pool, it is closed when the last request releases it.
+	if (!IsKeep || GlobalRunningStatus.IsNeedExit)
+		StreamConnectionList.remove(ConnectionData);
+	StreamConnectionCondition.notify_all();
+
+	return;
+}
+
+//Close persistent stream connection
+void StreamConnection_Close(
+	STREAM_CONNECTION_DATA &ConnectionData)
+{
+	std::lock_guard<std::mutex> ConnectionMutex(ConnectionData.ConnectionLock);
+
+//Send "Close Notify" to server, socket is closed by destructor.
+	if (!ConnectionData.IsShutdown && ConnectionData.OpenSSL_CTX.SessionData != nullptr)
+		SSL_shutdown(ConnectionData.OpenSSL_CTX.SessionData);
+	ConnectionData.IsShutdown = true;
+	ConnectionData.ConnectionCondition.notify_all();
+
+	return;
+}
+
+//Exchange request and response in persistent stream connection
+size_t StreamConnection_Exchange(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	bool &IsShutdown)
+{
+//Initialization
+	std::unique_lock<std::mutex> ConnectionMutex(ConnectionData.ConnectionLock);
+	if (ConnectionData.IsShutdown || ConnectionData.RequestMaxNum == 0)
+	{
+		IsShutdown = true;
+		return EXIT_FAILURE;
+	}
+	const auto TimeoutTime = GetCurrentSystemTime() + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_sec) * SECOND_TO_MILLISECOND + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_usec) / MICROSECOND_TO_MILLISECOND;
+	size_t RecvLen = EXIT_FAILURE;
+	std::vector<uint8_t> SendList;
+	uint32_t RequestID = 0;
+
+//DNS over HTTPS request is sent in a new stream, connection which can not open new stream is not reusable.
+	if (ConnectionData.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+	{
+	//Request waits for WINDOW_UPDATE frame when flow control window of server is exhausted temporarily.
+		while (static_cast<const int64_t>(SendSize) > ConnectionData.SendWindow_Connection || static_cast<const int64_t>(SendSize) > ConnectionData.SendWindow_Stream)
+		{
+			const auto CurrentTime = GetCurrentSystemTime();
+			if (ConnectionData.IsShutdown || ConnectionData.RequestMaxNum == 0)
+			{
+				IsShutdown = true;
+				return EXIT_FAILURE;
+			}
+			else if (GlobalRunningStatus.IsNeedExit || CurrentTime >= TimeoutTime)
+			{
+				return EXIT_FAILURE;
+			}
+			else {
+				StreamConnection_Wait(ConnectionData, ConnectionMutex, TimeoutTime - CurrentTime);
+			}
+		}
+
+	//Stream identifiers are exhausted.
+		if (!DNS_HTTPS_RequestWrite(ConnectionData, OriginalSend, SendSize, SendList, RequestID))
+		{
+			ConnectionData.IsShutdown = true;
+			ConnectionData.ConnectionCondition.notify_all();
+			IsShutdown = true;
+
+			return EXIT_FAILURE;
+		}
+	}
+	else {
+	//Request ID must be unique in connection, ID of response is restored by caller.
+		do {
+			++ConnectionData.SequenceID;
+			RequestID = hton16(static_cast<const uint16_t>(ConnectionData.SequenceID));
+		} while (ConnectionData.ResponseList.count(RequestID) > 0);
+
+	//Add length of request packet.
+		SendList.resize(sizeof(uint16_t) + SendSize);
+		*reinterpret_cast<uint16_t *>(SendList.data()) = hton16(static_cast<const uint16_t>(SendSize));
+		memcpy_s(SendList.data() + sizeof(uint16_t), SendSize, OriginalSend, SendSize);
+		reinterpret_cast<dns_hdr *>(SendList.data() + sizeof(uint16_t))->ID = static_cast<const uint16_t>(RequestID);
+	}
+
+//Send process
+	ConnectionData.ResponseList[RequestID].clear();
+	if (!StreamConnection_Write(ConnectionData, ConnectionMutex, SendList.data(), SendList.size(), TimeoutTime))
+	{
+		ConnectionData.ResponseList.erase(RequestID);
+		IsShutdown = true;
+
+		return EXIT_FAILURE;
+	}
+
+//Receive process, only one request reads from connection at the same time and the others wait for their responses.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Request is failed by server.
+		const auto ResponseItem = ConnectionData.ResponseList.find(RequestID);
+		if (ResponseItem == ConnectionData.ResponseList.end())
+		{
+			break;
+		}
+	//Response of request is found.
+		else if (!ResponseItem->second.empty())
+		{
+			if (ResponseItem->second.size() < RecvSize)
+			{
+				memcpy_s(OriginalRecv, RecvSize, ResponseItem->second.data(), ResponseItem->second.size());
+				RecvLen = ResponseItem->second.size();
+			}
+
+			break;
+		}
+
+	//Connection is closed or request is timeout.
+		const auto CurrentTime = GetCurrentSystemTime();
+		if (ConnectionData.IsShutdown || CurrentTime >= TimeoutTime)
+			break;
+		else 
+			StreamConnection_Wait(ConnectionData, ConnectionMutex, TimeoutTime - CurrentTime);
+	}
+
+//Remove request from connection, connection which is going away is not reusable.
+	ConnectionData.ResponseList.erase(RequestID);
+	ConnectionData.StreamDataList.erase(RequestID);
+	IsShutdown = ConnectionData.IsShutdown || ConnectionData.RequestMaxNum == 0;
+	return RecvLen;
+}
+
+//Wait for data in persistent stream connection, only one request reads from connection at the same time and the others wait for it.
+void StreamConnection_Wait(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex, 
+	const uint64_t WaitTime)
+{
+//Wait for the request which is reading.
+	if (ConnectionData.IsReading)
+	{
+		ConnectionData.ConnectionCondition.wait_for(ConnectionMutex, std::chrono::milliseconds(WaitTime));
+		return;
+	}
+
+//Wait for readable socket without lock.
+	ConnectionData.IsReading = true;
+	ConnectionMutex.unlock();
+	StreamConnection_Select(ConnectionData, false, WaitTime);
+	ConnectionMutex.lock();
+
+//Read all data in connection and wake up the others.
+	ConnectionData.IsReading = false;
+	StreamConnection_ReceiveProcess(ConnectionData, ConnectionMutex);
+	ConnectionData.ConnectionCondition.notify_all();
+
+	return;
+}
+
+//Write data to persistent stream connection, only one request writes to connection at the same time and the others put their data in queue.
+bool StreamConnection_Write(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint64_t TimeoutTime)
+{
+//Data in queue is sent by the request which is writing.
+	ConnectionData.SendQueue.insert(ConnectionData.SendQueue.end(), Buffer, Buffer + Length);
+	if (ConnectionData.IsWriting)
+		return true;
+	ConnectionData.IsWriting = true;
+
+//Data which is being written must not be moved until it is sent completely, so queue is swapped out before writing.
+	std::vector<uint8_t> SendList;
+	while (!ConnectionData.SendQueue.empty())
+	{
+		SendList.clear();
+		SendList.swap(ConnectionData.SendQueue);
+		for (;;)
+		{
+			const ssize_t ResultValue = BIO_write(ConnectionData.OpenSSL_CTX.SessionBIO, SendList.data(), static_cast<const int>(SendList.size()));
+			if (ResultValue >= static_cast<const ssize_t>(SendList.size()))
+				break;
+
+		//Wait for writable socket without lock, the others can read responses or put data in queue at the same time.
+			const auto CurrentTime = GetCurrentSystemTime();
+			if (!ConnectionData.IsShutdown && CurrentTime < TimeoutTime && BIO_should_retry(ConnectionData.OpenSSL_CTX.SessionBIO))
+			{
+				const auto IsWrite = !BIO_should_read(ConnectionData.OpenSSL_CTX.SessionBIO);
+				ConnectionMutex.unlock();
+				StreamConnection_Select(ConnectionData, IsWrite, TimeoutTime - CurrentTime);
+				ConnectionMutex.lock();
+			}
+			else {
+				ConnectionData.SendQueue.clear();
+				ConnectionData.IsWriting = false;
+				ConnectionData.IsShutdown = true;
+				ConnectionData.ConnectionCondition.notify_all();
+
+				return false;
+			}
+		}
+	}
+
+	ConnectionData.IsWriting = false;
+	return true;
+}
+
+//Wait for readable or writable persistent stream connection
+void StreamConnection_Select(
+	const STREAM_CONNECTION_DATA &ConnectionData, 
+	const bool IsWrite, 
+	const uint64_t WaitTime)
+{
+	fd_set SocketFDS;
+	timeval Timeout;
+	memset(&SocketFDS, 0, sizeof(SocketFDS));
+	memset(&Timeout, 0, sizeof(Timeout));
+	FD_ZERO(&SocketFDS);
+	FD_SET(ConnectionData.OpenSSL_CTX.Socket, &SocketFDS);
+	Timeout.tv_sec = static_cast<const time_t>(WaitTime / SECOND_TO_MILLISECOND);
+	Timeout.tv_usec = static_cast<const suseconds_t>(WaitTime % SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND);
+	if (IsWrite)
+		select(ConnectionData.OpenSSL_CTX.Socket + 1U, nullptr, &SocketFDS, nullptr, &Timeout);
+	else 
+		select(ConnectionData.OpenSSL_CTX.Socket + 1U, &SocketFDS, nullptr, nullptr, &Timeout);
+
+	return;
+}
+
+//Receive and match responses in persistent stream connection
+void StreamConnection_ReceiveProcess(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex)
+{
+//Read all data which are available in connection.
+	auto RecvBuffer = std::make_unique<uint8_t[]>(Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	memset(RecvBuffer.get(), 0, Parameter.LargeBufferSize + MEMORY_RESERVED_BYTES);
+	for (;;)
+	{
+		const ssize_t RecvLen = BIO_read(ConnectionData.OpenSSL_CTX.SessionBIO, RecvBuffer.get(), static_cast<const int>(Parameter.LargeBufferSize));
+		if (RecvLen > 0)
+		{
+			ConnectionData.ReceiveBuffer.insert(ConnectionData.ReceiveBuffer.end(), RecvBuffer.get(), RecvBuffer.get() + RecvLen);
+		}
+		else {
+		//Connection is closed by server.
+			if (!BIO_should_retry(ConnectionData.OpenSSL_CTX.SessionBIO))
+				ConnectionData.IsShutdown = true;
+
+			break;
+		}
+	}
+
+//HTTP version 2 frames of DNS over HTTPS
+	if (ConnectionData.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+	{
+		DNS_HTTPS_FrameProcess(ConnectionData);
+
+	//Send control frames which are generated by server frames, lock may be released when writing.
+		if (!ConnectionData.ControlFrameList.empty())
+		{
+			std::vector<uint8_t> FrameList;
+			FrameList.swap(ConnectionData.ControlFrameList);
+			if (!ConnectionData.IsShutdown)
+				StreamConnection_Write(ConnectionData, ConnectionMutex, FrameList.data(), FrameList.size(), GetCurrentSystemTime() + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_sec) * SECOND_TO_MILLISECOND + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_usec) / MICROSECOND_TO_MILLISECOND);
+		}
+
+		return;
+	}
+
+//Responses may be out of order, they are matched by IDs.
+	size_t DataOffset = 0;
+	while (ConnectionData.ReceiveBuffer.size() >= DataOffset + sizeof(uint16_t))
+	{
+		const size_t DataLength = ntoh16(*reinterpret_cast<const uint16_t *>(ConnectionData.ReceiveBuffer.data() + DataOffset));
+		if (ConnectionData.ReceiveBuffer.size() < DataOffset + sizeof(uint16_t) + DataLength)
+			break;
+
+	//Response which is not requested in connection or timeout is dropped.
+		if (DataLength >= DNS_PACKET_MINSIZE)
+		{
+			const auto ResponseItem = ConnectionData.ResponseList.find(reinterpret_cast<const dns_hdr *>(ConnectionData.ReceiveBuffer.data() + DataOffset + sizeof(uint16_t))->ID);
+			if (ResponseItem != ConnectionData.ResponseList.end() && ResponseItem->second.empty())
+				ResponseItem->second.assign(ConnectionData.ReceiveBuffer.begin() + DataOffset + sizeof(uint16_t), ConnectionData.ReceiveBuffer.begin() + DataOffset + sizeof(uint16_t) + DataLength);
+		}
+
+		DataOffset += sizeof(uint16_t) + DataLength;
+	}
+	if (DataOffset > 0)
+		ConnectionData.ReceiveBuffer.erase(ConnectionData.ReceiveBuffer.begin(), ConnectionData.ReceiveBuffer.begin() + DataOffset);
+
+	return;
+}
+
+//Initialize HTTP version 2 connection of DNS over HTTPS
+bool DNS_HTTPS_ConnectionInit(
+	STREAM_CONNECTION_DATA &ConnectionData)
+{
+//Server must select HTTP version 2("h2") by ALPN.
+	const unsigned char *ALPN_Data = nullptr;
+	unsigned int ALPN_Length = 0;
+	SSL_get0_alpn_selected(ConnectionData.OpenSSL_CTX.SessionData, &ALPN_Data, &ALPN_Length);
+	if (ALPN_Data == nullptr || ALPN_Length != strlen("h2") || memcmp(ALPN_Data, "h2", ALPN_Length) != 0)
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::TLS, L"DNS over HTTPS server does not support HTTP version 2", 0, nullptr, 0);
+		return false;
+	}
+
+//Connection preface and SETTINGS frame, dynamic table of responses and server push are disabled.
+	std::vector<uint8_t> FrameList(HTTP_2_CONNECTION_CLIENT_PREFACE, HTTP_2_CONNECTION_CLIENT_PREFACE + strlen(HTTP_2_CONNECTION_CLIENT_PREFACE));
+	std::array<http2_settings_frame, 2U> SettingsList;
+	memset(SettingsList.data(), 0, sizeof(http2_settings_frame) * SettingsList.size());
+	SettingsList.at(0).Identifier = hton16(HTTP_2_SETTINGS_TYPE_HEADERS_TABLE_SIZE);
+	SettingsList.at(1U).Identifier = hton16(HTTP_2_SETTINGS_TYPE_ENABLE_PUSH);
+	DNS_HTTPS_FrameWrite(FrameList, HTTP_2_FRAME_TYPE_SETTINGS, 0, 0, reinterpret_cast<const uint8_t *>(SettingsList.data()), sizeof(http2_settings_frame) * SettingsList.size());
+	const auto TimeoutTime = GetCurrentSystemTime() + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_sec) * SECOND_TO_MILLISECOND + static_cast<const uint64_t>(Parameter.SocketTimeout_Reliable_Once.tv_usec) / MICROSECOND_TO_MILLISECOND;
+	std::unique_lock<std::mutex> ConnectionMutex(ConnectionData.ConnectionLock);
+	if (!StreamConnection_Write(ConnectionData, ConnectionMutex, FrameList.data(), FrameList.size(), TimeoutTime))
+		return false;
+
+//Requests are sent after SETTINGS frame of server is received.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+		StreamConnection_ReceiveProcess(ConnectionData, ConnectionMutex);
+		const auto CurrentTime = GetCurrentSystemTime();
+		if (ConnectionData.IsSettingsReceived || ConnectionData.IsShutdown || CurrentTime >= TimeoutTime)
+			break;
+		else 
+			StreamConnection_Select(ConnectionData, false, TimeoutTime - CurrentTime);
+	}
+	if (!ConnectionData.IsSettingsReceived || ConnectionData.IsShutdown)
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::TLS, L"DNS over HTTPS connection initialization error", 0, nullptr, 0);
+		return false;
+	}
+
+	return true;
+}
+
+//Write request of DNS over HTTPS in a new stream
+bool DNS_HTTPS_RequestWrite(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	std::vector<uint8_t> &SendList, 
+	uint32_t &StreamID)
+{
+//Stream identifiers of client are odd and can not be reused, the highest bit is reserved.
+	if (ConnectionData.SequenceID > (UINT32_MAX >> 2U))
+		return false;
+	StreamID = ConnectionData.SequenceID * 2U + HTTP_2_FRAME_INIT_STREAM_ID;
+	++ConnectionData.SequenceID;
+
+//Dynamic table of server must be shrunk before it is used.
+	std::vector<uint8_t> HeaderBlock;
+	if (ConnectionData.IsHeaderTableUpdate)
+	{
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_TABLE_SIZE_UPDATE);
+		ConnectionData.HeaderTableSize = 0;
+		ConnectionData.IsHeaderIndexed = false;
+		ConnectionData.IsHeaderTableUpdate = false;
+	}
+
+//Pseudo header fields and header fields, all of them are the same in connection.
+	HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_INDEXED_METHOD_POST);
+	HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_INDEXED_SCHEME_HTTPS);
+	if (ConnectionData.IsHeaderIndexed)
+	{
+	//Fields in dynamic table are indexed in reverse order of insertion.
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_HIGH_1_BITS | (HTTP_2_HEADERS_DYNAMIC_INDEX_MIN + 3U));
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_HIGH_1_BITS | (HTTP_2_HEADERS_DYNAMIC_INDEX_MIN + 2U));
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_HIGH_1_BITS | (HTTP_2_HEADERS_DYNAMIC_INDEX_MIN + 1U));
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_HIGH_1_BITS | HTTP_2_HEADERS_DYNAMIC_INDEX_MIN);
+	}
+	else {
+	//Fields are added to dynamic table of server only when all of them can be stored.
+		const auto IsIndexing = ConnectionData.HeaderTableSize >= 
+			strlen(":path") + Parameter.DNS_HTTPS_Path->length() + 
+			strlen(":authority") + Parameter.DNS_HTTPS_SNI_MBS->length() + 
+			strlen("content-type") + strlen(HTTP_2_DNS_MESSAGE_TYPE) + 
+			strlen("accept") + strlen(HTTP_2_DNS_MESSAGE_TYPE) + 
+			HTTP_2_HEADERS_ENTRY_OVERHEAD * 4U;
+		DNS_HTTPS_HeaderWrite(HeaderBlock, HTTP_2_HEADERS_STATIC_INDEX_PATH, *Parameter.DNS_HTTPS_Path, IsIndexing);
+		DNS_HTTPS_HeaderWrite(HeaderBlock, HTTP_2_HEADERS_STATIC_INDEX_AUTHORITY, *Parameter.DNS_HTTPS_SNI_MBS, IsIndexing);
+		DNS_HTTPS_HeaderWrite(HeaderBlock, HTTP_2_HEADERS_STATIC_INDEX_CONTENT_TYPE, HTTP_2_DNS_MESSAGE_TYPE, IsIndexing);
+		DNS_HTTPS_HeaderWrite(HeaderBlock, HTTP_2_HEADERS_STATIC_INDEX_ACCEPT, HTTP_2_DNS_MESSAGE_TYPE, IsIndexing);
+		ConnectionData.IsHeaderIndexed = IsIndexing;
+	}
+	DNS_HTTPS_FrameWrite(SendList, HTTP_2_FRAME_TYPE_HEADERS, HTTP_2_HEADERS_FLAGS_END_HEADERS, StreamID, HeaderBlock.data(), HeaderBlock.size());
+
+//DNS message in DATA frames, ID should be 0 to make responses cache friendly.
+	std::vector<uint8_t> DataList(OriginalSend, OriginalSend + SendSize);
+	reinterpret_cast<dns_hdr *>(DataList.data())->ID = 0;
+	for (size_t Index = 0;Index < DataList.size();Index += HTTP_2_FREAM_MAXSIZE)
+	{
+		const auto DataLength = DataList.size() - Index < HTTP_2_FREAM_MAXSIZE ? DataList.size() - Index : HTTP_2_FREAM_MAXSIZE;
+		DNS_HTTPS_FrameWrite(SendList, HTTP_2_FRAME_TYPE_DATA, Index + DataLength == DataList.size() ? HTTP_2_DATA_FLAGS_END_STREAM : 0, StreamID, DataList.data() + Index, DataLength);
+	}
+	ConnectionData.SendWindow_Connection -= static_cast<const int64_t>(SendSize);
+
+	return true;
+}
+
+//Write header field of DNS over HTTPS request with indexed name
+void DNS_HTTPS_HeaderWrite(
+	std::vector<uint8_t> &HeaderBlock, 
+	const uint8_t NameIndex, 
+	const std::string &ValueString, 
+	const bool IsIndexing)
+{
+//Literal Header Field with Incremental Indexing -- Indexed Name
+	if (IsIndexing)
+	{
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_INCREMENTAL_INDEXED | NameIndex);
+	}
+//Literal Header Field without Indexing -- Indexed Name
+	else if (NameIndex < HTTP_2_HEADERS_LITERAL_LOW_4_BITS)
+	{
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_WITHOUT_INDEXED | NameIndex);
+	}
+	else {
+		HeaderBlock.push_back(HTTP_2_HEADERS_LITERAL_WITHOUT_INDEXED | HTTP_2_HEADERS_LITERAL_LOW_4_BITS);
+		HeaderBlock.push_back(NameIndex - HTTP_2_HEADERS_LITERAL_LOW_4_BITS);
+	}
+
+//String literal of value
+	std::vector<uint8_t> IntegerList;
+	HTTP_CONNECT_2_IntegerEncoding(IntegerList, ValueString.length());
+	HeaderBlock.insert(HeaderBlock.end(), IntegerList.begin(), IntegerList.end());
+	HeaderBlock.insert(HeaderBlock.end(), ValueString.begin(), ValueString.end());
+
+	return;
+}
+
+//Write HTTP version 2 frame of DNS over HTTPS
+void DNS_HTTPS_FrameWrite(
+	std::vector<uint8_t> &FrameList, 
+	const uint8_t Type, 
+	const uint8_t Flags, 
+	const uint32_t StreamID, 
+	const uint8_t * const Payload, 
+	const size_t Length)
+{
+//Length of all frames are less than default maximum frame size.
+	http2_frame_hdr FrameHeader;
+	memset(&FrameHeader, 0, sizeof(FrameHeader));
+	FrameHeader.Length_Low = hton16(static_cast<const uint16_t>(Length));
+	FrameHeader.Type = Type;
+	FrameHeader.Flags = Flags;
+	FrameHeader.StreamIdentifier = hton32(StreamID);
+	FrameList.insert(FrameList.end(), reinterpret_cast<const uint8_t *>(&FrameHeader), reinterpret_cast<const uint8_t *>(&FrameHeader) + sizeof(FrameHeader));
+	if (Payload != nullptr && Length > 0)
+		FrameList.insert(FrameList.end(), Payload, Payload + Length);
+
+	return;
+}
+
+//Process HTTP version 2 frames of DNS over HTTPS, responses are matched by stream identifiers.
+void DNS_HTTPS_FrameProcess(
+	STREAM_CONNECTION_DATA &ConnectionData)
+{
+	size_t DataOffset = 0;
+	while (ConnectionData.ReceiveBuffer.size() >= DataOffset + sizeof(http2_frame_hdr))
+	{
+	//Frame which is larger than maximum frame size is a connection error.
+		const auto FrameHeader = reinterpret_cast<const http2_frame_hdr *>(ConnectionData.ReceiveBuffer.data() + DataOffset);
+		const size_t FrameLength = ntoh16(FrameHeader->Length_Low);
+		if (FrameHeader->Length_High > 0 || FrameLength > HTTP_2_SETTINGS_INIT_MAX_FRAME_SIZE)
+		{
+			ConnectionData.IsShutdown = true;
+			break;
+		}
+		else if (ConnectionData.ReceiveBuffer.size() < DataOffset + sizeof(http2_frame_hdr) + FrameLength)
+		{
+			break;
+		}
+		const auto FrameData = ConnectionData.ReceiveBuffer.data() + DataOffset + sizeof(http2_frame_hdr);
+		const auto StreamID = ntoh32(FrameHeader->StreamIdentifier) & (UINT32_MAX >> 1U);
+		DataOffset += sizeof(http2_frame_hdr) + FrameLength;
+
+	//DATA frame
+		if (FrameHeader->Type == HTTP_2_FRAME_TYPE_DATA)
+		{
+			ConnectionData.ReceiveWindowUsed += FrameLength;
+			size_t DataIndex = 0, DataLength = FrameLength;
+			if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_PADDED) != 0)
+			{
+				if (FrameLength == 0 || *FrameData >= FrameLength)
+				{
+					ConnectionData.IsShutdown = true;
+					break;
+				}
+
+				DataIndex = sizeof(uint8_t);
+				DataLength -= sizeof(uint8_t) + *FrameData;
+			}
+
+		//Data of stream which is not requested or failed is dropped.
+			const auto StreamItem = ConnectionData.StreamDataList.find(StreamID);
+			if (StreamItem != ConnectionData.StreamDataList.end())
+				StreamItem->second.insert(StreamItem->second.end(), FrameData + DataIndex, FrameData + DataIndex + DataLength);
+			if ((FrameHeader->Flags & HTTP_2_DATA_FLAGS_END_STREAM) != 0)
+				DNS_HTTPS_StreamClose(ConnectionData, StreamID, true);
+		}
+	//HEADERS frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_HEADERS)
+		{
+		//Header block of response is smaller than maximum frame size, so it is not split by CONTINUATION frames.
+			size_t BlockIndex = 0, BlockLength = FrameLength;
+			if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_PADDED) != 0)
+			{
+				if (FrameLength == 0 || *FrameData >= FrameLength)
+				{
+					ConnectionData.IsShutdown = true;
+					break;
+				}
+
+				BlockIndex = sizeof(uint8_t);
+				BlockLength -= sizeof(uint8_t) + *FrameData;
+			}
+			if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_PRIORITY) != 0)
+			{
+				if (BlockLength < sizeof(http2_priority_frame))
+				{
+					ConnectionData.IsShutdown = true;
+					break;
+				}
+
+				BlockIndex += sizeof(http2_priority_frame);
+				BlockLength -= sizeof(http2_priority_frame);
+			}
+			if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_END_HEADERS) == 0)
+			{
+				ConnectionData.IsShutdown = true;
+				break;
+			}
+
+		//Trailer fields after response body
+			if (ConnectionData.StreamDataList.count(StreamID) > 0)
+			{
+				if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_END_STREAM) != 0)
+					DNS_HTTPS_StreamClose(ConnectionData, StreamID, true);
+			}
+		//Response must be status code 200 with response body.
+			else if ((FrameHeader->Flags & HTTP_2_HEADERS_FLAGS_END_STREAM) == 0 && ConnectionData.ResponseList.count(StreamID) > 0 && 
+				DNS_HTTPS_StatusCheck(FrameData + BlockIndex, BlockLength))
+			{
+				ConnectionData.StreamDataList[StreamID].clear();
+			}
+			else {
+				DNS_HTTPS_StreamClose(ConnectionData, StreamID, false);
+			}
+		}
+	//RST_STREAM frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_RST_STREAM)
+		{
+			DNS_HTTPS_StreamClose(ConnectionData, StreamID, false);
+		}
+	//SETTINGS frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_SETTINGS && (FrameHeader->Flags & HTTP_2_SETTINGS_FLAGS_ACK) == 0)
+		{
+			for (size_t Index = 0;Index + sizeof(http2_settings_frame) <= FrameLength;Index += sizeof(http2_settings_frame))
+			{
+				const auto SettingsItem = reinterpret_cast<const http2_settings_frame *>(FrameData + Index);
+				const auto SettingsValue = ntoh32(SettingsItem->Value);
+
+			//Dynamic table is disabled when it becomes smaller.
+				if (ntoh16(SettingsItem->Identifier) == HTTP_2_SETTINGS_TYPE_HEADERS_TABLE_SIZE)
+				{
+					if (SettingsValue < ConnectionData.HeaderTableSize)
+						ConnectionData.IsHeaderTableUpdate = true;
+				}
+			//Pipelined requests in connection are limited by concurrent streams of server, connection which is going away can not open new stream.
+				else if (ntoh16(SettingsItem->Identifier) == HTTP_2_SETTINGS_TYPE_MAX_CONCURRENT_STREAMS && !ConnectionData.IsGoawayReceived)
+				{
+					if (SettingsValue == 0)
+						ConnectionData.RequestMaxNum = 1U;
+					else if (SettingsValue < STREAM_CONNECTION_PIPELINE_MAXNUM)
+						ConnectionData.RequestMaxNum = SettingsValue;
+					else 
+						ConnectionData.RequestMaxNum = STREAM_CONNECTION_PIPELINE_MAXNUM;
+				}
+				else if (ntoh16(SettingsItem->Identifier) == HTTP_2_SETTINGS_TYPE_INITIAL_WINDOW_SIZE)
+				{
+					ConnectionData.SendWindow_Stream = SettingsValue;
+				}
+			}
+
+			DNS_HTTPS_FrameWrite(ConnectionData.ControlFrameList, HTTP_2_FRAME_TYPE_SETTINGS, HTTP_2_SETTINGS_FLAGS_ACK, 0, nullptr, 0);
+			ConnectionData.IsSettingsReceived = true;
+		}
+	//PING frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_PING && (FrameHeader->Flags & HTTP_2_PING_FLAGS_ACK) == 0)
+		{
+			DNS_HTTPS_FrameWrite(ConnectionData.ControlFrameList, HTTP_2_FRAME_TYPE_PING, HTTP_2_PING_FLAGS_ACK, 0, FrameData, FrameLength);
+		}
+	//WINDOW_UPDATE frame
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_WINDOW_UPDATE && StreamID == 0 && FrameLength >= sizeof(http2_window_update_frame))
+		{
+			ConnectionData.SendWindow_Connection += ntoh32(reinterpret_cast<const http2_window_update_frame *>(FrameData)->WindowSizeIncrement) & (UINT32_MAX >> 1U);
+		}
+	//GOAWAY frame, streams which are not processed by server are failed and the others are still completed in connection.
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_GOAWAY && StreamID == 0 && FrameLength >= sizeof(http2_goaway_frame))
+		{
+			const auto LastStreamID = ntoh32(reinterpret_cast<const http2_goaway_frame *>(FrameData)->LastStreamID) & (UINT32_MAX >> 1U);
+			std::vector<uint32_t> StreamList;
+			for (const auto &ResponseItem:ConnectionData.ResponseList)
+			{
+				if (ResponseItem.first > LastStreamID)
+					StreamList.push_back(ResponseItem.first);
+			}
+			for (const auto &StreamItem:StreamList)
+				DNS_HTTPS_StreamClose(ConnectionData, StreamItem, false);
+			ConnectionData.RequestMaxNum = 0;
+			ConnectionData.IsGoawayReceived = true;
+		}
+	//PUSH_PROMISE frame which is not allowed and GOAWAY frame which is malformed
+		else if (FrameHeader->Type == HTTP_2_FRAME_TYPE_GOAWAY || FrameHeader->Type == HTTP_2_FRAME_TYPE_PUSH_PROMISE)
+		{
+			ConnectionData.IsShutdown = true;
+			break;
+		}
+	}
+	if (DataOffset > 0)
+		ConnectionData.ReceiveBuffer.erase(ConnectionData.ReceiveBuffer.begin(), ConnectionData.ReceiveBuffer.begin() + DataOffset);
+
+//Connection flow control window of server is restored when half of it is used.
+	if (ConnectionData.ReceiveWindowUsed >= HTTP_2_SETTINGS_INIT_INITIAL_WINDOW_SIZE / 2U)
+	{
+		http2_window_update_frame WindowUpdate;
+		memset(&WindowUpdate, 0, sizeof(WindowUpdate));
+		WindowUpdate.WindowSizeIncrement = hton32(static_cast<const uint32_t>(ConnectionData.ReceiveWindowUsed));
+		DNS_HTTPS_FrameWrite(ConnectionData.ControlFrameList, HTTP_2_FRAME_TYPE_WINDOW_UPDATE, 0, 0, reinterpret_cast<const uint8_t *>(&WindowUpdate), sizeof(WindowUpdate));
+		ConnectionData.ReceiveWindowUsed = 0;
+	}
+
+	return;
+}
+
+//Check status code of DNS over HTTPS response
+bool DNS_HTTPS_StatusCheck(
+	const uint8_t * const Buffer, 
+	const size_t Length)
+{
+//Status code 200 is always in static table.
+	if (Length > 0 && *Buffer == HTTP_2_HEADERS_LITERAL_INDEXED_STATUS_200)
+		return true;
+
+//Read all header fields.
+	std::vector<std::string> HeaderList;
+	if (!HTTP_CONNECT_2_HEADERS_ReadBytes(HeaderList, Buffer, Length))
+	{
+		PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::TLS, L"DNS over HTTPS server response error", 0, nullptr, 0);
+		return false;
+	}
+
+//Fixed header :status field
+	auto IsStatusField = false;
+	for (const auto &StringIter:HeaderList)
+	{
+		if (StringIter == (":status"))
+		{
+			IsStatusField = true;
+		}
+		else if (IsStatusField)
+		{
+		//Status code 200
+			if (StringIter == ("200"))
+				return true;
+
+		//Other status code
+			std::wstring InnerMessage;
+			if (!MBS_To_WCS_String(reinterpret_cast<const uint8_t *>(StringIter.c_str()), StringIter.length(), InnerMessage))
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Convert multiple byte or wide char string error", 0, nullptr, 0);
+			}
+			else {
+				std::wstring Message(L"DNS over HTTPS server response error: ");
+				Message.append(InnerMessage);
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::TLS, Message.c_str(), 0, nullptr, 0);
+			}
+
+			break;
+		}
+	}
+
+	return false;
+}
+
+//Close stream of DNS over HTTPS request
+void DNS_HTTPS_StreamClose(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint32_t StreamID, 
+	const bool IsComplete)
+{
+//Response body is moved to response list, request which is failed is removed and its waiting will stop.
+	const auto StreamItem = ConnectionData.StreamDataList.find(StreamID);
+	const auto ResponseItem = ConnectionData.ResponseList.find(StreamID);
+	if (ResponseItem != ConnectionData.ResponseList.end() && ResponseItem->second.empty())
+	{
+		if (IsComplete && StreamItem != ConnectionData.StreamDataList.end() && StreamItem->second.size() >= DNS_PACKET_MINSIZE)
+			ResponseItem->second.swap(StreamItem->second);
+		else 
+			ConnectionData.ResponseList.erase(ResponseItem);
+	}
+	if (StreamItem != ConnectionData.StreamDataList.end())
+		ConnectionData.StreamDataList.erase(StreamItem);
+
+	return;
+}
+#endif
+#endif
+
 //Transmission of UDP protocol
 #if defined(ENABLE_PCAP)
 size_t UDP_RequestSingle(
@@ -1183,8 +2117,8 @@ size_t UDP_RequestSingle(
 	const uint8_t * const OriginalSend, 
 	const size_t SendSize, 
 	const uint16_t QueryType, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	const SOCKET_DATA * const LocalSocketData
 //	size_t *EDNS_Length
 )
@@ -1223,7 +2157,7 @@ size_t UDP_RequestSingle(
 	}
 
 //Mark port to list.
-	RegisterPortToList(Protocol, LocalSocketData, UDPSocketDataList, DomainString_Original, DomainString_Request /* , EDNS_Length */ );
+	RegisterPortToList(Protocol, LocalSocketData, UDPSocketDataList, reinterpret_cast<const dns_hdr *>(OriginalSend)->ID, DomainString_Original, DomainString_Request /* , EDNS_Length */ );
 	return EXIT_SUCCESS;
 }
 
@@ -1235,8 +2169,8 @@ size_t UDP_RequestMultiple(
 	const uint8_t * const OriginalSend, 
 	const size_t SendSize, 
 	const uint16_t QueryType, 
-	const std::string * const DomainString_Original, 
-	const std::string * const DomainString_Request, 
+	const uint8_t * const DomainString_Original, 
+	const uint8_t * const DomainString_Request, 
 	const SOCKET_DATA * const LocalSocketData
 //	size_t *EDNS_Length
 )
@@ -1257,7 +2191,7 @@ size_t UDP_RequestMultiple(
 	}
 
 //Mark port to list.
-	RegisterPortToList(Protocol_Transport, LocalSocketData, UDPSocketDataList, DomainString_Original, DomainString_Request /* , EDNS_Length */ );
+	RegisterPortToList(Protocol_Transport, LocalSocketData, UDPSocketDataList, reinterpret_cast<const dns_hdr *>(OriginalSend)->ID, DomainString_Original, DomainString_Request /* , EDNS_Length */ );
 	return EXIT_SUCCESS;
 }
 #endif
@@ -26,4 +26,114 @@
 extern CONFIGURATION_TABLE Parameter;
 extern GLOBAL_STATUS GlobalRunningStatus;
 extern ALTERNATE_SWAP_TABLE AlternateSwapList;
+
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//Structure definitions
+//Persistent stream connection, requests are pipelined and responses are matched by their IDs or HTTP version 2 stream identifiers.
+//Pool only carries DNS over TLS and DNS over HTTPS connections, plain TCP requests still use a connection for each request.
+typedef struct _stream_connection_data_
+{
+	REQUEST_PROCESS_TYPE                                   RequestType;
+	uint16_t                                               Protocol_Network;
+	OPENSSL_CONTEXT_TABLE                                  OpenSSL_CTX;
+	std::mutex                                             ConnectionLock;
+	std::condition_variable                                ConnectionCondition;
+	std::unordered_map<uint32_t, std::vector<uint8_t>>     ResponseList;
+	std::vector<uint8_t>                                   ReceiveBuffer;
+	std::vector<uint8_t>                                   SendQueue;
+	uint32_t                                               SequenceID;
+	std::atomic<size_t>                                    RequestMaxNum;
+	size_t                                                 RequestNum;
+	bool                                                   IsReading;
+	bool                                                   IsWriting;
+	bool                                                   IsShutdown;
+	uint64_t                                               ClearTime;
+//HTTP version 2 connection states of DNS over HTTPS
+	std::unordered_map<uint32_t, std::vector<uint8_t>>     StreamDataList;
+	std::vector<uint8_t>                                   ControlFrameList;
+	int64_t                                                SendWindow_Connection;
+	int64_t                                                SendWindow_Stream;
+	size_t                                                 ReceiveWindowUsed;
+	size_t                                                 HeaderTableSize;
+	bool                                                   IsHeaderIndexed;
+	bool                                                   IsHeaderTableUpdate;
+	bool                                                   IsSettingsReceived;
+	bool                                                   IsGoawayReceived;
+}StreamConnectionData, STREAM_CONNECTION_DATA;
+
+//Local variables
+std::list<std::shared_ptr<STREAM_CONNECTION_DATA>> StreamConnectionList;
+std::list<std::pair<REQUEST_PROCESS_TYPE, uint16_t>> StreamConnectionPendingList;
+std::mutex StreamConnectionLock;
+std::condition_variable StreamConnectionCondition;
+
+//Functions
+std::shared_ptr<STREAM_CONNECTION_DATA> StreamConnection_Take(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint16_t Protocol_Network, 
+	bool &IsReused);
+std::shared_ptr<STREAM_CONNECTION_DATA> StreamConnection_Connect(
+	const REQUEST_PROCESS_TYPE RequestType, 
+	const uint16_t Protocol_Network);
+void StreamConnection_Return(
+	const std::shared_ptr<STREAM_CONNECTION_DATA> &ConnectionData, 
+	const bool IsKeep);
+void StreamConnection_Close(
+	STREAM_CONNECTION_DATA &ConnectionData);
+size_t StreamConnection_Exchange(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	uint8_t * const OriginalRecv, 
+	const size_t RecvSize, 
+	bool &IsShutdown);
+bool StreamConnection_Write(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex, 
+	const uint8_t * const Buffer, 
+	const size_t Length, 
+	const uint64_t TimeoutTime);
+void StreamConnection_Wait(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex, 
+	const uint64_t WaitTime);
+void StreamConnection_Select(
+	const STREAM_CONNECTION_DATA &ConnectionData, 
+	const bool IsWrite, 
+	const uint64_t WaitTime);
+void StreamConnection_ReceiveProcess(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	std::unique_lock<std::mutex> &ConnectionMutex);
+bool DNS_HTTPS_ConnectionInit(
+	STREAM_CONNECTION_DATA &ConnectionData);
+bool DNS_HTTPS_RequestWrite(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint8_t * const OriginalSend, 
+	const size_t SendSize, 
+	std::vector<uint8_t> &SendList, 
+	uint32_t &StreamID);
+void DNS_HTTPS_HeaderWrite(
+	std::vector<uint8_t> &HeaderBlock, 
+	const uint8_t NameIndex, 
+	const std::string &ValueString, 
+	const bool IsIndexing);
+void DNS_HTTPS_FrameWrite(
+	std::vector<uint8_t> &FrameList, 
+	const uint8_t Type, 
+	const uint8_t Flags, 
+	const uint32_t StreamID, 
+	const uint8_t * const Payload, 
+	const size_t Length);
+void DNS_HTTPS_FrameProcess(
+	STREAM_CONNECTION_DATA &ConnectionData);
+bool DNS_HTTPS_StatusCheck(
+	const uint8_t * const Buffer, 
+	const size_t Length);
+void DNS_HTTPS_StreamClose(
+	STREAM_CONNECTION_DATA &ConnectionData, 
+	const uint32_t StreamID, 
+	const bool IsComplete);
+#endif
+#endif
 #endif
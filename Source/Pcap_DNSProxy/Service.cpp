@@ -162,6 +162,9 @@ BOOL WINAPI SignalHandler(
 		GlobalRunningStatus.IsInitialized_WinSock = false;
 	}
 
+//Wait for log writer and write all queued log messages.
+	PrintLogWriterStop();
+
 //Close all file handles.
 	_fcloseall();
 
@@ -674,6 +677,9 @@ bool CheckProcessExists(
 void SignalHandler(
 	const int Signal)
 {
+//Set need exit signal.
+	GlobalRunningStatus.IsNeedExit = true;
+
 //Mutex handle cleanup
 	if (GlobalRunningStatus.Initialized_MutexHandle != 0 && GlobalRunningStatus.Initialized_MutexHandle != RETURN_ERROR)
 	{
@@ -694,6 +700,9 @@ void SignalHandler(
 //Print to screen.
 	PrintToScreen(true, false, L"[Notice] Get closing signal.\n");
 
+//Wait for log writer and write all queued log messages.
+	PrintLogWriterStop();
+
 //Close all file handles.
 #if (defined(PLATFORM_FREEBSD) || (defined(PLATFORM_LINUX) && !defined(PLATFORM_OPENWRT)))
 	fcloseall();
@@ -0,0 +1,482 @@
+﻿// This code is part of Pcap_DNSProxy
+// Pcap_DNSProxy, a local DNS server based on WinPcap and LibPcap
+// Copyright (C) 2012-2019 Chengr28
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either
+// version 2 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+
+#include "Statistics.h"
+
+//Get statistics counters of current thread
+STATISTICS_COUNTER_TABLE &Statistics_LocalTable(
+	void)
+{
+//Register counters of current thread at its first counting.
+	if (!StatisticsCounter_Local)
+	{
+		StatisticsCounter_Local = std::make_shared<STATISTICS_COUNTER_TABLE>();
+		for (auto &CounterItem:StatisticsCounter_Local->CounterList)
+			CounterItem.store(0, std::memory_order_relaxed);
+		for (auto &BucketItem:StatisticsCounter_Local->LatencyBucketList)
+			BucketItem.store(0, std::memory_order_relaxed);
+		StatisticsCounter_Local->LatencySum.store(0, std::memory_order_relaxed);
+		std::lock_guard<std::mutex> StatisticsCounterMutex(StatisticsCounterLock);
+		StatisticsCounterList.push_back(StatisticsCounter_Local);
+	}
+
+	return *StatisticsCounter_Local;
+}
+
+//Add statistics counter of current thread
+void Statistics_AddCounter(
+	const STATISTICS_COUNTER_TYPE CounterType)
+{
+//Only current thread writes its own counters, no any atomic read-modify-write operations are needed.
+	auto &CounterItem = Statistics_LocalTable().CounterList.at(CounterType);
+	CounterItem.store(CounterItem.load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+
+	return;
+}
+
+//Get statistics counter of current thread
+uint64_t Statistics_GetCounter(
+	const STATISTICS_COUNTER_TYPE CounterType)
+{
+	return Statistics_LocalTable().CounterList.at(CounterType).load(std::memory_order_relaxed);
+}
+
+//Add request process duration to histogram of current thread, duration is in microseconds.
+void Statistics_AddLatency(
+	const uint64_t Latency)
+{
+//Locate bucket, upper bound of each bucket is double of the previous one.
+	size_t Index = 0;
+	for (uint64_t BucketBound = MICROSECOND_TO_MILLISECOND;Index + 1U < STATISTICS_LATENCY_BUCKET_NUM && Latency > BucketBound;++Index)
+		BucketBound <<= 1U;
+
+//Add duration to histogram.
+	auto &CounterTable = Statistics_LocalTable();
+	CounterTable.LatencyBucketList.at(Index).store(CounterTable.LatencyBucketList.at(Index).load(std::memory_order_relaxed) + 1U, std::memory_order_relaxed);
+	CounterTable.LatencySum.store(CounterTable.LatencySum.load(std::memory_order_relaxed) + Latency, std::memory_order_relaxed);
+
+	return;
+}
+
+//Export all statistics in Prometheus text format
+void Statistics_Export(
+	std::string &Message)
+{
+//Merge and remove counters of exited threads.
+	std::unique_lock<std::mutex> StatisticsCounterMutex(StatisticsCounterLock);
+	for (auto CounterTableItem = StatisticsCounterList.begin();CounterTableItem != StatisticsCounterList.end();)
+	{
+		if (CounterTableItem->use_count() == 1)
+		{
+			for (size_t Index = 0;Index < STATISTICS_COUNTER_NUM;++Index)
+				StatisticsCounter_Exited.at(Index) += (*CounterTableItem)->CounterList.at(Index).load(std::memory_order_relaxed);
+			for (size_t Index = 0;Index < STATISTICS_LATENCY_BUCKET_NUM;++Index)
+				StatisticsLatencyBucket_Exited.at(Index) += (*CounterTableItem)->LatencyBucketList.at(Index).load(std::memory_order_relaxed);
+			StatisticsLatencySum_Exited += (*CounterTableItem)->LatencySum.load(std::memory_order_relaxed);
+			CounterTableItem = StatisticsCounterList.erase(CounterTableItem);
+		}
+		else {
+			++CounterTableItem;
+		}
+	}
+
+//Sum counters of all running threads.
+	auto CounterList = StatisticsCounter_Exited;
+	auto LatencyBucketList = StatisticsLatencyBucket_Exited;
+	auto LatencySum = StatisticsLatencySum_Exited;
+	for (const auto &CounterTableItem:StatisticsCounterList)
+	{
+		for (size_t Index = 0;Index < STATISTICS_COUNTER_NUM;++Index)
+			CounterList.at(Index) += CounterTableItem->CounterList.at(Index).load(std::memory_order_relaxed);
+		for (size_t Index = 0;Index < STATISTICS_LATENCY_BUCKET_NUM;++Index)
+			LatencyBucketList.at(Index) += CounterTableItem->LatencyBucketList.at(Index).load(std::memory_order_relaxed);
+		LatencySum += CounterTableItem->LatencySum.load(std::memory_order_relaxed);
+	}
+	StatisticsCounterMutex.unlock();
+
+//Get status of task executor, query descriptors, client TCP sessions and DNS cache.
+	size_t WorkerRunningNum = 0, WorkerIdleNum = 0, TaskPendingNum = 0;
+	TaskExecutor.Status(WorkerRunningNum, WorkerIdleNum, TaskPendingNum);
+	const auto DescriptorUsedNum = QueryDescriptorPool.UsedNum();
+	std::unique_lock<std::mutex> TCP_SessionListMutex(TCP_SessionListLock);
+	const auto TCP_SessionNum = TCP_SessionList.size();
+	TCP_SessionListMutex.unlock();
+	std::unique_lock<std::mutex> DNSCacheListMutex(DNSCacheListLock);
+	const auto DNSCacheNum = DNSCacheList.size();
+	DNSCacheListMutex.unlock();
+
+//Counters
+	Message.clear();
+	Message.append("# HELP pcap_dnsproxy_queries_total Number of received queries.\n");
+	Message.append("# TYPE pcap_dnsproxy_queries_total counter\n");
+	Message.append("pcap_dnsproxy_queries_total{protocol=\"udp\"} ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_QUERY_UDP)));
+	Message.append("\npcap_dnsproxy_queries_total{protocol=\"tcp\"} ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_QUERY_TCP)));
+	Message.append("\n# HELP pcap_dnsproxy_responses_total Number of responses which are sent to requesters.\n");
+	Message.append("# TYPE pcap_dnsproxy_responses_total counter\n");
+	Message.append("pcap_dnsproxy_responses_total ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_RESPONSE)));
+	Message.append("\n# HELP pcap_dnsproxy_local_answers_total Number of queries which are answered by Hosts or DNS cache.\n");
+	Message.append("# TYPE pcap_dnsproxy_local_answers_total counter\n");
+	Message.append("pcap_dnsproxy_local_answers_total ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_LOCAL_ANSWER)));
+	Message.append("\n# HELP pcap_dnsproxy_hosts_hits_total Number of queries which are answered by Hosts.\n");
+	Message.append("# TYPE pcap_dnsproxy_hosts_hits_total counter\n");
+	Message.append("pcap_dnsproxy_hosts_hits_total ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_HOSTS_HIT)));
+	Message.append("\n# HELP pcap_dnsproxy_cache_lookups_total Number of DNS cache lookups.\n");
+	Message.append("# TYPE pcap_dnsproxy_cache_lookups_total counter\n");
+	Message.append("pcap_dnsproxy_cache_lookups_total{result=\"hit\"} ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_CACHE_HIT)));
+	Message.append("\npcap_dnsproxy_cache_lookups_total{result=\"miss\"} ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_CACHE_MISS)));
+	Message.append("\n# HELP pcap_dnsproxy_upstream_timeouts_total Number of requests to upstream servers which are timeout.\n");
+	Message.append("# TYPE pcap_dnsproxy_upstream_timeouts_total counter\n");
+	Message.append("pcap_dnsproxy_upstream_timeouts_total ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_UPSTREAM_TIMEOUT)));
+	Message.append("\n# HELP pcap_dnsproxy_capture_waiting_drops_total Number of responses which are dropped because receive waiting window is full.\n");
+	Message.append("# TYPE pcap_dnsproxy_capture_waiting_drops_total counter\n");
+	Message.append("pcap_dnsproxy_capture_waiting_drops_total ");
+	Message.append(std::to_string(CounterList.at(STATISTICS_COUNTER_CAPTURE_WAITING_DROP)));
+
+//Request process duration histogram, bounds are in seconds.
+	Message.append("\n# HELP pcap_dnsproxy_request_process_duration_seconds Duration of request process which sends response, responses matched by Pcap Capture are measured from sending request to upstream servers.\n");
+	Message.append("# TYPE pcap_dnsproxy_request_process_duration_seconds histogram\n");
+	uint64_t BucketCount = 0;
+	size_t BucketBound = 1U;
+	for (size_t Index = 0;Index < STATISTICS_LATENCY_BUCKET_NUM;++Index)
+	{
+		BucketCount += LatencyBucketList.at(Index);
+		Message.append("pcap_dnsproxy_request_process_duration_seconds_bucket{le=\"");
+		if (Index + 1U < STATISTICS_LATENCY_BUCKET_NUM)
+		{
+			Message.append(std::to_string(BucketBound / SECOND_TO_MILLISECOND));
+			Message.append(".");
+			Message.append(std::to_string(BucketBound % SECOND_TO_MILLISECOND + SECOND_TO_MILLISECOND), 1U, std::string::npos);
+			BucketBound <<= 1U;
+		}
+		else {
+			Message.append("+Inf");
+		}
+		Message.append("\"} ");
+		Message.append(std::to_string(BucketCount));
+		Message.append("\n");
+	}
+	Message.append("pcap_dnsproxy_request_process_duration_seconds_sum ");
+	Message.append(std::to_string(LatencySum / (SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND)));
+	Message.append(".");
+	Message.append(std::to_string(LatencySum % (SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND) + SECOND_TO_MILLISECOND * MICROSECOND_TO_MILLISECOND), 1U, std::string::npos);
+	Message.append("\npcap_dnsproxy_request_process_duration_seconds_count ");
+	Message.append(std::to_string(BucketCount));
+
+//Gauges
+	Message.append("\n# HELP pcap_dnsproxy_workers Number of workers in task executor.\n");
+	Message.append("# TYPE pcap_dnsproxy_workers gauge\n");
+	Message.append("pcap_dnsproxy_workers{state=\"running\"} ");
+	Message.append(std::to_string(WorkerRunningNum));
+	Message.append("\npcap_dnsproxy_workers{state=\"idle\"} ");
+	Message.append(std::to_string(WorkerIdleNum));
+	Message.append("\n# HELP pcap_dnsproxy_pending_tasks Number of tasks which are waiting in queues of task executor.\n");
+	Message.append("# TYPE pcap_dnsproxy_pending_tasks gauge\n");
+	Message.append("pcap_dnsproxy_pending_tasks ");
+	Message.append(std::to_string(TaskPendingNum));
+	Message.append("\n# HELP pcap_dnsproxy_query_descriptors Number of query descriptors which are in use.\n");
+	Message.append("# TYPE pcap_dnsproxy_query_descriptors gauge\n");
+	Message.append("pcap_dnsproxy_query_descriptors ");
+	Message.append(std::to_string(DescriptorUsedNum));
+	Message.append("\n# HELP pcap_dnsproxy_tcp_sessions Number of client TCP sessions.\n");
+	Message.append("# TYPE pcap_dnsproxy_tcp_sessions gauge\n");
+	Message.append("pcap_dnsproxy_tcp_sessions ");
+	Message.append(std::to_string(TCP_SessionNum));
+	Message.append("\n# HELP pcap_dnsproxy_cache_entries Number of entries in DNS cache.\n");
+	Message.append("# TYPE pcap_dnsproxy_cache_entries gauge\n");
+	Message.append("pcap_dnsproxy_cache_entries ");
+	Message.append(std::to_string(DNSCacheNum));
+	Message.append("\n");
+
+	return;
+}
+
+#if defined(PLATFORM_WIN)
+//Statistics named pipe listener, statistics are written to each connected client.
+bool Statistics_Listener(
+	void)
+{
+//Initialization
+	std::string Message;
+	HANDLE PipeHandle = INVALID_HANDLE_VALUE;
+	DWORD WrittenBytes = 0;
+
+//Start named pipe listener.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Create named pipe.
+		PipeHandle = CreateNamedPipeW(
+			STATISTICS_PIPE_NAME, 
+			PIPE_ACCESS_OUTBOUND, 
+			PIPE_TYPE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS, 
+			1U, 
+			DEFAULT_LARGE_BUFFER_SIZE, 
+			0, 
+			0, 
+			nullptr);
+		if (PipeHandle == INVALID_HANDLE_VALUE)
+		{
+			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Create statistics named pipe error", GetLastError(), nullptr, 0);
+			Sleep(Parameter.FileRefreshTime);
+
+			continue;
+		}
+
+	//Wait client and write statistics.
+		if (ConnectNamedPipe(
+				PipeHandle, 
+				nullptr) != 0 || 
+			GetLastError() == ERROR_PIPE_CONNECTED)
+		{
+			Statistics_Export(Message);
+			if (WriteFile(
+					PipeHandle, 
+					Message.c_str(), 
+					static_cast<const DWORD>(Message.length()), 
+					&WrittenBytes, 
+					nullptr) == 0)
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::SYSTEM, L"Statistics named pipe write messages error", GetLastError(), nullptr, 0);
+			else 
+				FlushFileBuffers(PipeHandle);
+
+			DisconnectNamedPipe(
+				PipeHandle);
+		}
+
+	//Close named pipe.
+		CloseHandle(
+			PipeHandle);
+		PipeHandle = INVALID_HANDLE_VALUE;
+	}
+
+//Listener terminated
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Statistics module listener terminated", 0, nullptr, 0);
+	return true;
+}
+
+//Statistics named pipe reader
+bool Statistics_Sender(
+	void)
+{
+//Open named pipe.
+	const auto PipeHandle = CreateFileW(
+		STATISTICS_PIPE_NAME, 
+		GENERIC_READ, 
+		0, 
+		nullptr, 
+		OPEN_EXISTING, 
+		FILE_ATTRIBUTE_NORMAL, 
+		nullptr);
+	if (PipeHandle == INVALID_HANDLE_VALUE)
+	{
+		std::wstring InnerMessage(L"[System Error] Statistics named pipe read messages error");
+		ErrorCodeToMessage(LOG_ERROR_TYPE::SYSTEM, GetLastError(), InnerMessage);
+		InnerMessage.append(L".\n");
+		PrintToScreen(true, false, InnerMessage.c_str(), GetLastError());
+
+		return false;
+	}
+
+//Read all statistics.
+	const auto Buffer = std::make_unique<uint8_t[]>(DEFAULT_LARGE_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	std::string Message;
+	DWORD ReadBytes = 0;
+	while (ReadFile(
+			PipeHandle, 
+			Buffer.get(), 
+			DEFAULT_LARGE_BUFFER_SIZE, 
+			&ReadBytes, 
+			nullptr) != 0 && 
+		ReadBytes > 0)
+			Message.append(reinterpret_cast<const char *>(Buffer.get()), ReadBytes);
+	CloseHandle(
+		PipeHandle);
+
+//Print statistics.
+	std::wstring InnerMessage;
+	if (!MBS_To_WCS_String(reinterpret_cast<const uint8_t *>(Message.c_str()), Message.length() + NULL_TERMINATE_LENGTH, InnerMessage))
+	{
+		PrintToScreen(true, false, L"[System Error] Statistics named pipe read messages error.\n");
+		return false;
+	}
+
+	PrintToScreen(true, true, L"%ls", InnerMessage.c_str());
+	return true;
+}
+#elif (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+//Statistics Unix domain socket listener, plain text requests and HTTP GET requests are both answered.
+//Socket is only accessible by owner and group.
+bool Statistics_Listener(
+	void)
+{
+//Initialization
+	const auto Buffer = std::make_unique<uint8_t[]>(DEFAULT_LARGE_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	memset(Buffer.get(), 0, DEFAULT_LARGE_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	std::string Message, HeaderString;
+	sockaddr_un SocketAddress;
+	timeval SocketTimeout;
+	memset(&SocketTimeout, 0, sizeof(SocketTimeout));
+	SocketTimeout.tv_usec = STATISTICS_CLIENT_TIMEOUT * MICROSECOND_TO_MILLISECOND;
+	SYSTEM_SOCKET ListenSocket = INVALID_SOCKET, ClientSocket = INVALID_SOCKET;
+	ssize_t RecvLen = 0, SendLen = 0;
+
+//Start Unix domain socket listener.
+	while (!GlobalRunningStatus.IsNeedExit)
+	{
+	//Create Unix domain socket.
+		unlink(STATISTICS_SOCKET_PATH_NAME);
+		memset(&SocketAddress, 0, sizeof(SocketAddress));
+		SocketAddress.sun_family = AF_UNIX;
+		strncpy(SocketAddress.sun_path, STATISTICS_SOCKET_PATH_NAME, sizeof(SocketAddress.sun_path) - NULL_TERMINATE_LENGTH);
+		errno = 0;
+		ListenSocket = socket(AF_UNIX, SOCK_STREAM, 0);
+		if (ListenSocket == INVALID_SOCKET || 
+			bind(ListenSocket, reinterpret_cast<const sockaddr *>(&SocketAddress), sizeof(SocketAddress)) == SOCKET_ERROR || 
+			chmod(STATISTICS_SOCKET_PATH_NAME, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP) == RETURN_ERROR || 
+			listen(ListenSocket, SOMAXCONN) == SOCKET_ERROR)
+		{
+			PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Create statistics socket error", errno, nullptr, 0);
+			SocketSetting(ListenSocket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+			Sleep(Parameter.FileRefreshTime);
+
+			continue;
+		}
+
+	//Accept clients and send statistics, socket is created again when accepting failed.
+		while (!GlobalRunningStatus.IsNeedExit)
+		{
+			errno = 0;
+			ClientSocket = accept(ListenSocket, nullptr, nullptr);
+			if (ClientSocket == INVALID_SOCKET)
+			{
+				PrintError(LOG_LEVEL_TYPE::LEVEL_3, LOG_ERROR_TYPE::SYSTEM, L"Statistics socket accepting error", errno, nullptr, 0);
+				break;
+			}
+			else if (!SocketSetting(ClientSocket, SOCKET_SETTING_TYPE::TIMEOUT, false, &SocketTimeout))
+			{
+				continue;
+			}
+
+		//Read request, HTTP GET requests are answered with HTTP header.
+		//Clients are served one by one, so reading and sending are limited by short timeout and clients which send nothing are also answered.
+			RecvLen = recv(ClientSocket, reinterpret_cast<char *>(Buffer.get()), DEFAULT_LARGE_BUFFER_SIZE, 0);
+			Statistics_Export(Message);
+			if (RecvLen >= static_cast<const ssize_t>(strlen("GET ")) && memcmp(Buffer.get(), "GET ", strlen("GET ")) == 0)
+			{
+				HeaderString = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: ";
+				HeaderString.append(std::to_string(Message.length()));
+				HeaderString.append("\r\nConnection: close\r\n\r\n");
+				Message.insert(0, HeaderString);
+			}
+
+		//Send statistics.
+			for (size_t Index = 0;Index < Message.length();Index += SendLen)
+			{
+				SendLen = send(ClientSocket, Message.c_str() + Index, Message.length() - Index, 0);
+				if (SendLen <= 0)
+					break;
+			}
+
+			SocketSetting(ClientSocket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		}
+
+	//Close Unix domain socket.
+		SocketSetting(ListenSocket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	}
+
+//Listener terminated
+	SocketSetting(ListenSocket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+	unlink(STATISTICS_SOCKET_PATH_NAME);
+	if (!GlobalRunningStatus.IsNeedExit)
+		PrintError(LOG_LEVEL_TYPE::LEVEL_2, LOG_ERROR_TYPE::SYSTEM, L"Statistics module listener terminated", 0, nullptr, 0);
+	return true;
+}
+
+//Statistics Unix domain socket reader
+bool Statistics_Sender(
+	void)
+{
+//Connect to Unix domain socket.
+	sockaddr_un SocketAddress;
+	memset(&SocketAddress, 0, sizeof(SocketAddress));
+	SocketAddress.sun_family = AF_UNIX;
+	strncpy(SocketAddress.sun_path, STATISTICS_SOCKET_PATH_NAME, sizeof(SocketAddress.sun_path) - NULL_TERMINATE_LENGTH);
+	timeval SocketTimeout;
+	memset(&SocketTimeout, 0, sizeof(SocketTimeout));
+	SocketTimeout.tv_sec = STANDARD_TIMEOUT / SECOND_TO_MILLISECOND;
+	errno = 0;
+	SYSTEM_SOCKET Socket = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (Socket == INVALID_SOCKET || 
+		!SocketSetting(Socket, SOCKET_SETTING_TYPE::TIMEOUT, false, &SocketTimeout) || 
+		connect(Socket, reinterpret_cast<const sockaddr *>(&SocketAddress), sizeof(SocketAddress)) == SOCKET_ERROR || 
+		send(Socket, STATISTICS_MESSAGE, strlen(STATISTICS_MESSAGE), 0) <= 0)
+	{
+		const auto ErrorCode = errno;
+		SocketSetting(Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+		std::wstring InnerMessage(L"[System Error] Statistics socket read messages error");
+		if (ErrorCode == 0)
+		{
+			InnerMessage.append(L".\n");
+			PrintToScreen(true, false, InnerMessage.c_str());
+		}
+		else {
+			ErrorCodeToMessage(LOG_ERROR_TYPE::SYSTEM, ErrorCode, InnerMessage);
+			InnerMessage.append(L".\n");
+			PrintToScreen(true, false, InnerMessage.c_str(), ErrorCode);
+		}
+
+		return false;
+	}
+
+//Read all statistics.
+	const auto Buffer = std::make_unique<uint8_t[]>(DEFAULT_LARGE_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	memset(Buffer.get(), 0, DEFAULT_LARGE_BUFFER_SIZE + MEMORY_RESERVED_BYTES);
+	std::string Message;
+	ssize_t RecvLen = 0;
+	shutdown(Socket, SHUT_WR);
+	for (;;)
+	{
+		RecvLen = recv(Socket, reinterpret_cast<char *>(Buffer.get()), DEFAULT_LARGE_BUFFER_SIZE, 0);
+		if (RecvLen <= 0)
+			break;
+		else 
+			Message.append(reinterpret_cast<const char *>(Buffer.get()), RecvLen);
+	}
+	SocketSetting(Socket, SOCKET_SETTING_TYPE::CLOSE, false, nullptr);
+
+//Print statistics.
+	std::wstring InnerMessage;
+	if (!MBS_To_WCS_String(reinterpret_cast<const uint8_t *>(Message.c_str()), Message.length() + NULL_TERMINATE_LENGTH, InnerMessage))
+	{
+		PrintToScreen(true, false, L"[System Error] Statistics socket read messages error.\n");
+		return false;
+	}
+
+	PrintToScreen(true, true, L"%ls", InnerMessage.c_str());
+	return true;
+}
+#endif
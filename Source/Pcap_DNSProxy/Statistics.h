@@ -0,0 +1,59 @@
+﻿// This code is part of Pcap_DNSProxy
+// Pcap_DNSProxy, a local DNS server based on WinPcap and LibPcap
+// Copyright (C) 2012-2019 Chengr28
+// 
+// This program is free software; you can redistribute it and/or
+// modify it under the terms of the GNU General Public License
+// as published by the Free Software Foundation; either
+// version 2 of the License, or (at your option) any later version.
+// 
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+// 
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, write to the Free Software
+// Foundation, Inc., 675 Mass Ave, Cambridge, MA 02139, USA.
+
+
+#ifndef PCAP_DNSPROXY_STATISTICS_H
+#define PCAP_DNSPROXY_STATISTICS_H
+
+#include "Include.h"
+
+//Structure definitions
+//Statistics counters of each thread, only its own thread writes and all counters are summed when reading.
+//Counters are padded on both sides to keep them away from cache lines of other threads.
+typedef struct _statistics_counter_table_
+{
+	uint8_t                                                            PaddingHead[STATISTICS_PADDING_SIZE];
+	std::array<std::atomic<uint64_t>, STATISTICS_COUNTER_NUM>          CounterList;
+	std::array<std::atomic<uint64_t>, STATISTICS_LATENCY_BUCKET_NUM>   LatencyBucketList;
+	std::atomic<uint64_t>                                              LatencySum;
+	uint8_t                                                            PaddingTail[STATISTICS_PADDING_SIZE];
+}StatisticsCounterTable, STATISTICS_COUNTER_TABLE;
+
+//Global variables
+extern CONFIGURATION_TABLE Parameter;
+extern GLOBAL_STATUS GlobalRunningStatus;
+extern TASK_EXECUTOR_TABLE TaskExecutor;
+extern QUERY_DESCRIPTOR_POOL_TABLE &QueryDescriptorPool;
+extern std::unordered_map<SYSTEM_SOCKET, std::shared_ptr<TCP_SESSION_DATA>> TCP_SessionList;
+extern std::list<DNS_CACHE_DATA> DNSCacheList;
+extern std::mutex TCP_SessionListLock, DNSCacheListLock;
+
+//Local variables
+std::vector<std::shared_ptr<STATISTICS_COUNTER_TABLE>> StatisticsCounterList;
+std::array<uint64_t, STATISTICS_COUNTER_NUM> StatisticsCounter_Exited;
+std::array<uint64_t, STATISTICS_LATENCY_BUCKET_NUM> StatisticsLatencyBucket_Exited;
+uint64_t StatisticsLatencySum_Exited = 0;
+std::mutex StatisticsCounterLock;
+thread_local std::shared_ptr<STATISTICS_COUNTER_TABLE> StatisticsCounter_Local;
+
+//Functions
+STATISTICS_COUNTER_TABLE &Statistics_LocalTable(
+	void);
+void Statistics_Export(
+	std::string &Message);
+#endif
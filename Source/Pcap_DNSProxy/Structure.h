@@ -3159,6 +3159,8 @@ typedef struct _socks_udp_relay_request_
 #define HTTP_2_FRAME_INIT_STREAM_ID                 1U
 #define HTTP_2_FREAM_MAXSIZE                        16383U
 #define HTTP_2_CONNECTION_CLIENT_PREFACE            ("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n")
+#define HTTP_2_DNS_DEFAULT_PATH                     ("/dns-query")                 //DNS Queries over HTTPS(RFC 8484)
+#define HTTP_2_DNS_MESSAGE_TYPE                     ("application/dns-message")
 typedef struct _http2_frame_hdr_
 {
 	uint8_t               Length_High;
@@ -3233,7 +3235,15 @@ typedef struct _http2_data_frame_hdr_
 #define HTTP_2_HEADERS_LITERAL_HIGH_2_BITS           0xC0
 #define HTTP_2_HEADERS_LITERAL_HIGH_3_BITS           0xE0
 #define HTTP_2_HEADERS_LITERAL_HIGH_4_BITS           0xF0
+#define HTTP_2_HEADERS_LITERAL_INDEXED_METHOD_POST   0x83
+#define HTTP_2_HEADERS_LITERAL_INDEXED_SCHEME_HTTPS  0x87
 #define HTTP_2_HEADERS_LITERAL_INDEXED_STATUS_200    0x88
+#define HTTP_2_HEADERS_STATIC_INDEX_AUTHORITY        1U
+#define HTTP_2_HEADERS_STATIC_INDEX_PATH             4U
+#define HTTP_2_HEADERS_STATIC_INDEX_ACCEPT           19U
+#define HTTP_2_HEADERS_STATIC_INDEX_CONTENT_TYPE     31U
+#define HTTP_2_HEADERS_DYNAMIC_INDEX_MIN             62U
+#define HTTP_2_HEADERS_ENTRY_OVERHEAD                32U
 #define HTTP_2_HEADERS_INTEGER_LOW_1_BITS            HTTP_2_HEADERS_LITERAL_LOW_1_BITS
 #define HTTP_2_HEADERS_INTEGER_LOW_2_BITS            HTTP_2_HEADERS_LITERAL_LOW_2_BITS
 #define HTTP_2_HEADERS_INTEGER_LOW_3_BITS            HTTP_2_HEADERS_LITERAL_LOW_3_BITS
@@ -3242,6 +3252,14 @@ typedef struct _http2_data_frame_hdr_
 #define HTTP_2_HEADERS_INTEGER_LOW_6_BITS            HTTP_2_HEADERS_LITERAL_LOW_6_BITS
 #define HTTP_2_HEADERS_INTEGER_LOW_7_BITS            HTTP_2_HEADERS_LITERAL_LOW_7_BITS
 #define HTTP_2_HEADERS_INTEGER_HIGH_1_BITS           HTTP_2_HEADERS_LITERAL_HIGH_1_BITS
+#define HTTP_2_HEADERS_HUFFMAN_EOS                   256U                         //EOS symbol of HPACK static huffman code
+#define HTTP_2_HEADERS_HUFFMAN_STATE_NUM             256U                         //Internal nodes of HPACK static huffman tree
+#define HTTP_2_HEADERS_HUFFMAN_NIBBLE_NUM            16U                          //4 bits are decoded in each state transition.
+#define HTTP_2_HEADERS_HUFFMAN_NIBBLE_BITS           4U
+#define HTTP_2_HEADERS_HUFFMAN_PADDING_MAXSIZE       7U                           //Padding is the most significant bits of EOS and must be less than 8 bits.
+#define HTTP_2_HEADERS_HUFFMAN_FLAGS_SYMBOL          0x01
+#define HTTP_2_HEADERS_HUFFMAN_FLAGS_ACCEPTED        0x02
+#define HTTP_2_HEADERS_HUFFMAN_FLAGS_FAILED          0x04
 /*
 typedef struct _http2_headers_frame_hdr_
 {
@@ -735,14 +735,40 @@ void OpenSSL_LibraryInit(
 		OPENSSL_config(nullptr);
 	#endif
 	}
-#if OPENSSL_VERSION_NUMBER < OPENSSL_VERSION_1_1_0 //OpenSSL version below 1.1.0
-//Unoad all OpenSSL libraries, algorithms and strings.
 	else {
+	#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+	//Free shared method contexts and client session cache.
+		std::lock_guard<std::mutex> OpenSSL_ContextMutex(OpenSSL_ContextLock);
+		for (auto &SessionItem:OpenSSL_SessionList)
+			SSL_SESSION_free(SessionItem.second);
+		OpenSSL_SessionList.clear();
+		if (OpenSSL_SharedContext_TCP != nullptr)
+		{
+			SSL_CTX_free(OpenSSL_SharedContext_TCP);
+			OpenSSL_SharedContext_TCP = nullptr;
+		}
+		if (OpenSSL_SharedContext_UDP != nullptr)
+		{
+			SSL_CTX_free(OpenSSL_SharedContext_UDP);
+			OpenSSL_SharedContext_UDP = nullptr;
+		}
+		if (OpenSSL_SharedContext_DNS_TLS != nullptr)
+		{
+			SSL_CTX_free(OpenSSL_SharedContext_DNS_TLS);
+			OpenSSL_SharedContext_DNS_TLS = nullptr;
+		}
+		if (OpenSSL_SharedContext_DNS_HTTPS != nullptr)
+		{
+			SSL_CTX_free(OpenSSL_SharedContext_DNS_HTTPS);
+			OpenSSL_SharedContext_DNS_HTTPS = nullptr;
+		}
+	#else //OpenSSL version below 1.1.0
+	//Unoad all OpenSSL libraries, algorithms and strings.
 		CONF_modules_unload(1); //All modules
 		ERR_free_strings();
 		EVP_cleanup();
+	#endif
 	}
-#endif
 
 	return;
 }
@@ -751,16 +777,93 @@ void OpenSSL_LibraryInit(
 bool OpenSSL_CTX_Initializtion(
 	OPENSSL_CONTEXT_TABLE &OpenSSL_CTX)
 {
+#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+//Method context is built only once, certificate store and settings are shared by all connections.
+	std::lock_guard<std::mutex> OpenSSL_ContextMutex(OpenSSL_ContextLock);
+	SSL_CTX **SharedContext = nullptr;
+	if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN && OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
+		SharedContext = &OpenSSL_SharedContext_DNS_TLS;
+	else if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
+		SharedContext = &OpenSSL_SharedContext_DNS_HTTPS;
+	else if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
+		SharedContext = &OpenSSL_SharedContext_TCP;
+	else if (OpenSSL_CTX.Protocol_Transport == IPPROTO_UDP)
+		SharedContext = &OpenSSL_SharedContext_UDP;
+	else 
+		return false;
+	if (*SharedContext == nullptr)
+	{
+		if (!OpenSSL_CTX_Creation(OpenSSL_CTX))
+			return false;
+
+	//Client session cache, new sessions are stored by callback and sessions are not stored in internal cache.
+		SSL_CTX_set_session_cache_mode(OpenSSL_CTX.MethodContext, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+		SSL_CTX_sess_set_new_cb(OpenSSL_CTX.MethodContext, OpenSSL_NewSessionCallback);
+		*SharedContext = OpenSSL_CTX.MethodContext;
+	}
+	else {
+		OpenSSL_CTX.MethodContext = *SharedContext;
+	}
+
+//Each connection holds a reference of shared method context, which is released by destructor.
+	SSL_CTX_up_ref(OpenSSL_CTX.MethodContext);
+	return true;
+#else //OpenSSL version below 1.1.0
+	return OpenSSL_CTX_Creation(OpenSSL_CTX);
+#endif
+}
+
+#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+//OpenSSL new client session callback
+int OpenSSL_NewSessionCallback(
+	SSL *SessionData, 
+	SSL_SESSION *Session)
+{
+//Session owner check
+	const auto OpenSSL_CTX = static_cast<const OPENSSL_CONTEXT_TABLE *>(SSL_get_app_data(SessionData));
+	if (OpenSSL_CTX == nullptr || OpenSSL_CTX->AddressString.empty())
+		return 0;
+
+//Session of the same server is replaced.
+	std::lock_guard<std::mutex> OpenSSL_ContextMutex(OpenSSL_ContextLock);
+	auto &SessionItem = OpenSSL_SessionList[OpenSSL_CTX->AddressString];
+	if (SessionItem != nullptr)
+		SSL_SESSION_free(SessionItem);
+	SessionItem = Session;
+
+//Return 1 to take the ownership of session.
+	return 1;
+}
+#endif
+
+//OpenSSL TLS CTX creation
+bool OpenSSL_CTX_Creation(
+	OPENSSL_CONTEXT_TABLE &OpenSSL_CTX)
+{
+//DNS over TLS and DNS over HTTPS always select version automatically, version below TLS 1.2 is not allowed by RFC 7858 and RFC 7540.
+	auto TLS_Version = Parameter.HTTP_CONNECT_TLS_Version;
+	auto IsValidation = Parameter.HTTP_CONNECT_TLS_Validation;
+	if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN)
+	{
+		TLS_Version = TLS_VERSION_SELECTION::VERSION_AUTO;
+		IsValidation = Parameter.DNS_TLS_Validation;
+	}
+	else if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+	{
+		TLS_Version = TLS_VERSION_SELECTION::VERSION_AUTO;
+		IsValidation = Parameter.DNS_HTTPS_Validation;
+	}
+
 //TLS version selection(Part 1)
 #if OPENSSL_VERSION_NUMBER < OPENSSL_VERSION_1_1_0 //OpenSSL version between 1.0.2 and 1.1.0
 	if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
 	{
 	//No TLS 1.3 and above support below 1.1.1
-		if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
+		if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(TLSv1_2_method());
-		else if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
+		else if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(TLSv1_1_method());
-		else if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
+		else if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(TLSv1_method());
 		else //Auto select
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(SSLv23_method());
@@ -768,10 +871,10 @@ bool OpenSSL_CTX_Initializtion(
 	else if (OpenSSL_CTX.Protocol_Transport == IPPROTO_UDP)
 	{
 	//No DTLS 1.3 and above support below 1.1.1
-		if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
+		if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(DTLSv1_2_method());
-		else if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1 || //DTLS has no any version 1.1.
-			Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
+		else if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1 || //DTLS has no any version 1.1.
+			TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
 				OpenSSL_CTX.MethodContext = SSL_CTX_new(DTLSv1_method());
 		else //Auto select
 			OpenSSL_CTX.MethodContext = SSL_CTX_new(DTLS_method());
@@ -800,7 +903,7 @@ bool OpenSSL_CTX_Initializtion(
 #if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
 	ssize_t InnerResultValue = OPENSSL_RETURN_SUCCESS;
 #if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_1 //OpenSSL version 1.1.1 and above
-	if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_3)
+	if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_3)
 	{
 		if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
 		{
@@ -818,7 +921,7 @@ bool OpenSSL_CTX_Initializtion(
 	}
 	else 
 #endif
-	if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
+	if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_2)
 	{
 		if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
 		{
@@ -834,7 +937,7 @@ bool OpenSSL_CTX_Initializtion(
 			return false;
 		}
 	}
-	else if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
+	else if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
 	{
 		if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
 		{
@@ -850,7 +953,7 @@ bool OpenSSL_CTX_Initializtion(
 			return false;
 		}
 	}
-	else if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
+	else if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0)
 	{
 		if (OpenSSL_CTX.Protocol_Transport == IPPROTO_TCP)
 		{
@@ -868,6 +971,8 @@ bool OpenSSL_CTX_Initializtion(
 	}
 	else { //Setting the minimum or maximum version to 0 will enable protocol versions down to the lowest version, or up to the highest version supported by the library, respectively.
 		ResultValue = SSL_CTX_set_max_proto_version(OpenSSL_CTX.MethodContext, 0);
+		if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN || OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+			InnerResultValue = SSL_CTX_set_min_proto_version(OpenSSL_CTX.MethodContext, TLS1_2_VERSION);
 	}
 
 //TLS selection check
@@ -893,7 +998,7 @@ bool OpenSSL_CTX_Initializtion(
 	SSL_CTX_set_options(OpenSSL_CTX.MethodContext, SSL_OP_SINGLE_DH_USE); //Always create a new key when using temporary/ephemeral DH parameters.
 
 //Set ciphers suites(TLS/DTLS 1.2 and below).
-	if (Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0 || Parameter.HTTP_CONNECT_TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
+	if (TLS_Version == TLS_VERSION_SELECTION::VERSION_1_0 || TLS_Version == TLS_VERSION_SELECTION::VERSION_1_1)
 		ResultValue = SSL_CTX_set_cipher_list(OpenSSL_CTX.MethodContext, OPENSSL_CIPHER_LIST_COMPATIBILITY);
 	else //Auto select and new TLS version
 		ResultValue = SSL_CTX_set_cipher_list(OpenSSL_CTX.MethodContext, OPENSSL_CIPHER_LIST_STRONG);
@@ -913,10 +1018,13 @@ bool OpenSSL_CTX_Initializtion(
 	}
 #endif
 
-//TLS ALPN extension settings
-	if (Parameter.HTTP_CONNECT_TLS_ALPN)
+//TLS ALPN extension settings, DNS over HTTPS always requires HTTP version 2.
+	if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN || 
+		(Parameter.HTTP_CONNECT_TLS_ALPN && OpenSSL_CTX.RequestType != REQUEST_PROCESS_TYPE::DNS_TLS_MAIN))
 	{
-		if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
+		if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+			ResultValue = SSL_CTX_set_alpn_protos(OpenSSL_CTX.MethodContext, HTTP_2_ALPN_List, sizeof(HTTP_2_ALPN_List));
+		else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_1)
 			ResultValue = SSL_CTX_set_alpn_protos(OpenSSL_CTX.MethodContext, HTTP_1_ALPN_List, sizeof(HTTP_1_ALPN_List));
 		else if (Parameter.HTTP_CONNECT_Version == HTTP_VERSION_SELECTION::VERSION_2)
 			ResultValue = SSL_CTX_set_alpn_protos(OpenSSL_CTX.MethodContext, HTTP_2_ALPN_List, sizeof(HTTP_2_ALPN_List));
@@ -933,7 +1041,7 @@ bool OpenSSL_CTX_Initializtion(
 	}
 
 //TLS certificate store location and verification settings
-	if (Parameter.HTTP_CONNECT_TLS_Validation)
+	if (IsValidation)
 	{
 	//Locate default certificate store.
 		ResultValue = SSL_CTX_set_default_verify_paths(OpenSSL_CTX.MethodContext);
@@ -994,11 +1102,44 @@ bool OpenSSL_BIO_Initializtion(
 	}
 
 //TLS Server Name Indication/SNI settings
-	if (Parameter.HTTP_CONNECT_TLS_SNI_MBS != nullptr && !Parameter.HTTP_CONNECT_TLS_SNI_MBS->empty())
-		SSL_set_tlsext_host_name(OpenSSL_CTX.SessionData, Parameter.HTTP_CONNECT_TLS_SNI_MBS->c_str());
+	auto SNI_String = Parameter.HTTP_CONNECT_TLS_SNI_MBS;
+	auto IsValidation = Parameter.HTTP_CONNECT_TLS_Validation;
+	if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN)
+	{
+		SNI_String = Parameter.DNS_TLS_SNI_MBS;
+		IsValidation = Parameter.DNS_TLS_Validation;
+	}
+	else if (OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN)
+	{
+		SNI_String = Parameter.DNS_HTTPS_SNI_MBS;
+		IsValidation = Parameter.DNS_HTTPS_Validation;
+	}
+	if (SNI_String != nullptr && !SNI_String->empty())
+		SSL_set_tlsext_host_name(OpenSSL_CTX.SessionData, SNI_String->c_str());
+
+//TLS session resumption
+#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+	SSL_set_app_data(OpenSSL_CTX.SessionData, &OpenSSL_CTX);
+	std::unique_lock<std::mutex> OpenSSL_ContextMutex(OpenSSL_ContextLock);
+	const auto SessionItem = OpenSSL_SessionList.find(OpenSSL_CTX.AddressString);
+	if (SessionItem != OpenSSL_SessionList.end())
+	{
+		SSL_set_session(OpenSSL_CTX.SessionData, SessionItem->second);
+
+	//TLS 1.3 session tickets should be used only once, new tickets are sent by server after handshake.
+	#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_1 //OpenSSL version 1.1.1 and above
+		if (SSL_SESSION_get_protocol_version(SessionItem->second) == TLS1_3_VERSION)
+		{
+			SSL_SESSION_free(SessionItem->second);
+			OpenSSL_SessionList.erase(SessionItem);
+		}
+	#endif
+	}
+	OpenSSL_ContextMutex.unlock();
+#endif
 
 //Built-in functionality for hostname checking and validation
-	if (Parameter.HTTP_CONNECT_TLS_Validation && Parameter.HTTP_CONNECT_TLS_SNI_MBS != nullptr && !Parameter.HTTP_CONNECT_TLS_SNI_MBS->empty())
+	if (IsValidation && SNI_String != nullptr && !SNI_String->empty())
 	{
 	//Get certificate paremeter.
 		auto X509_Param = SSL_get0_param(OpenSSL_CTX.SessionData);
@@ -1012,7 +1153,7 @@ bool OpenSSL_BIO_Initializtion(
 		X509_VERIFY_PARAM_set_hostflags(X509_Param, X509_CHECK_FLAG_NO_PARTIAL_WILDCARDS);
 //		X509_VERIFY_PARAM_set_hostflags(X509_Param, X509_CHECK_FLAG_MULTI_LABEL_WILDCARDS);
 		X509_VERIFY_PARAM_set_hostflags(X509_Param, X509_CHECK_FLAG_SINGLE_LABEL_SUBDOMAINS);
-		if (X509_VERIFY_PARAM_set1_host(X509_Param, Parameter.HTTP_CONNECT_TLS_SNI_MBS->c_str(), 0) == OPENSSL_RETURN_FAILURE)
+		if (X509_VERIFY_PARAM_set1_host(X509_Param, SNI_String->c_str(), 0) == OPENSSL_RETURN_FAILURE)
 		{
 			OpenSSL_PrintError(reinterpret_cast<const uint8_t *>(ERR_error_string(ERR_get_error(), nullptr)), L"OpenSSL hostname checking and validation ");
 			return false;
@@ -1085,7 +1226,10 @@ bool OpenSSL_Handshake(
 	}
 
 //Verify the result of chain verification, verification performed according to RFC 4158.
-	if (Parameter.HTTP_CONNECT_TLS_Validation && SSL_get_verify_result(OpenSSL_CTX.SessionData) != X509_V_OK)
+	if (((OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_TLS_MAIN && Parameter.DNS_TLS_Validation) || 
+		(OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::DNS_HTTPS_MAIN && Parameter.DNS_HTTPS_Validation) || 
+		(OpenSSL_CTX.RequestType == REQUEST_PROCESS_TYPE::HTTP_CONNECT_MAIN && Parameter.HTTP_CONNECT_TLS_Validation)) && 
+		SSL_get_verify_result(OpenSSL_CTX.SessionData) != X509_V_OK)
 	{
 		OpenSSL_PrintError(reinterpret_cast<const uint8_t *>(ERR_error_string(ERR_get_error(), nullptr)), L"OpenSSL verify result of chain verification ");
 		return false;
@@ -31,6 +31,14 @@ extern GLOBAL_STATUS GlobalRunningStatus;
 #if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
 static unsigned char HTTP_1_ALPN_List[] = HTTP_1_TLS_ALPN_STRING;
 static unsigned char HTTP_2_ALPN_List[] = HTTP_2_TLS_ALPN_STRING;
+#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+SSL_CTX *OpenSSL_SharedContext_TCP = nullptr;
+SSL_CTX *OpenSSL_SharedContext_UDP = nullptr;
+SSL_CTX *OpenSSL_SharedContext_DNS_TLS = nullptr;
+SSL_CTX *OpenSSL_SharedContext_DNS_HTTPS = nullptr;
+std::unordered_map<std::string, SSL_SESSION *> OpenSSL_SessionList;
+std::mutex OpenSSL_ContextLock;
+#endif
 #endif
 
 #if defined(PLATFORM_WIN)
@@ -52,6 +60,13 @@ bool SSPI_DecryptPacket(
 bool OpenSSL_PrintError(
 	const uint8_t *OpenSSL_ErrorMessage, 
 	const wchar_t *ErrorMessage);
+bool OpenSSL_CTX_Creation(
+	OPENSSL_CONTEXT_TABLE &OpenSSL_CTX);
+#if OPENSSL_VERSION_NUMBER >= OPENSSL_VERSION_1_1_0 //OpenSSL version 1.1.0 and above
+int OpenSSL_NewSessionCallback(
+	SSL *SessionData, 
+	SSL_SESSION *Session);
+#endif
 #endif
 #endif
 #endif
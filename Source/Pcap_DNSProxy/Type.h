@@ -100,6 +100,18 @@ typedef enum _alternate_swap_type_
 	ALTERNATE_SWAP_TYPE_DNSCURVE_UDP_IPV4
 #endif
 }ALTERNATE_SWAP_TYPE;
+typedef enum _statistics_counter_type_
+{
+	STATISTICS_COUNTER_QUERY_UDP, 
+	STATISTICS_COUNTER_QUERY_TCP, 
+	STATISTICS_COUNTER_RESPONSE, 
+	STATISTICS_COUNTER_LOCAL_ANSWER, 
+	STATISTICS_COUNTER_HOSTS_HIT, 
+	STATISTICS_COUNTER_CACHE_HIT, 
+	STATISTICS_COUNTER_CACHE_MISS, 
+	STATISTICS_COUNTER_UPSTREAM_TIMEOUT, 
+	STATISTICS_COUNTER_CAPTURE_WAITING_DROP
+}STATISTICS_COUNTER_TYPE;
 typedef enum class _dns_cache_type_
 {
 	NONE, 
@@ -177,6 +189,7 @@ typedef enum class _socket_setting_type
 	INVALID_CHECK, 
 	NON_BLOCKING_MODE, 
 	REUSE, 
+	TCP_DEFERRED_ACCEPT, 
 	TCP_FAST_OPEN_NORMAL, 
 /* Newer version of TCP Fast Open socket option
 #if defined(PLATFORM_LINUX)
@@ -208,6 +221,8 @@ typedef enum class _request_process_type_
 	TLS_HANDSHAKE, 
 	TLS_TRANSPORT, 
 	TLS_SHUTDOWN, 
+	DNS_TLS_MAIN, 
+	DNS_HTTPS_MAIN, 
 #endif
 #if defined(ENABLE_LIBSODIUM)
 	DNSCURVE_MAIN, 
@@ -369,18 +384,39 @@ typedef struct _dns_packet_data_
 	bool                                 IsLocalRequest;
 	bool                                 IsLocalInWhite;
 //Packet structure block
+//Records lists keep their capacity in pooled descriptors and grow only for queries with many records, domain strings are stored in buffers of descriptor pool.
 	size_t                               Records_QuestionLen;
 	size_t                               Records_AnswerCount;
 	size_t                               Records_AuthorityCount;
 	size_t                               Records_AdditionalCount;
+	size_t                               Records_Num;
 	std::vector<size_t>                  Records_Location;
 	std::vector<size_t>                  Records_Length;
-	std::string                          DomainString_Original;
-	std::string                          DomainString_Request;
+	uint8_t                              *DomainString_Original;
+	uint8_t                              *DomainString_Request;
 	size_t                               EDNS_Location;
 	size_t                               EDNS_Length;
 }DNSPacketData, DNS_PACKET_DATA;
 
+//DNS Message Index structure
+//All locations are offsets from the beginning of DNS header, TTL of each record is located in its standard header.
+//Records lists are sized from resource records counts in DNS header.
+typedef struct _dns_message_index_
+{
+	size_t                               Length;
+	size_t                               Records_QuestionNameLen;
+	uint16_t                             QueryType;
+	size_t                               Records_AnswerCount;
+	size_t                               Records_AuthorityCount;
+	size_t                               Records_AdditionalCount;
+	size_t                               Records_Num;
+	std::vector<uint16_t>                Records_Location;
+	std::vector<uint16_t>                Records_StandardLocation;
+	std::vector<uint16_t>                Records_Type;
+	size_t                               EDNS_Location;
+	size_t                               EDNS_Length;
+}DNSMessageIndex, DNS_MESSAGE_INDEX;
+
 //DNS Cache Data structure
 typedef struct _dns_cache_data_
 {
@@ -599,6 +635,37 @@ public:
 	std::vector<std::string>             *HTTP_CONNECT_HeaderField;
 	uint8_t                              *HTTP_CONNECT_ProxyAuthorization;
 	size_t                               HTTP_CONNECT_ProxyAuthorizationLength;
+//[DNS over TLS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	bool                                 IsDNS_TLS;
+	REQUEST_MODE_NETWORK                 DNS_TLS_Protocol;
+	bool                                 DNS_TLS_IsAccordingType;
+	bool                                 DNS_TLS_Only;
+	ADDRESS_UNION_DATA                   DNS_TLS_Address_IPv6;
+	ADDRESS_UNION_DATA                   DNS_TLS_Address_IPv4;
+	std::string                          *DNS_TLS_AddressString_IPv6;
+	std::string                          *DNS_TLS_AddressString_IPv4;
+	std::string                          *DNS_TLS_SNI_MBS;
+	bool                                 DNS_TLS_Validation;
+#endif
+#endif
+//[DNS over HTTPS] block
+#if defined(ENABLE_TLS)
+#if (defined(PLATFORM_FREEBSD) || defined(PLATFORM_LINUX) || defined(PLATFORM_MACOS))
+	bool                                 IsDNS_HTTPS;
+	REQUEST_MODE_NETWORK                 DNS_HTTPS_Protocol;
+	bool                                 DNS_HTTPS_IsAccordingType;
+	bool                                 DNS_HTTPS_Only;
+	ADDRESS_UNION_DATA                   DNS_HTTPS_Address_IPv6;
+	ADDRESS_UNION_DATA                   DNS_HTTPS_Address_IPv4;
+	std::string                          *DNS_HTTPS_AddressString_IPv6;
+	std::string                          *DNS_HTTPS_AddressString_IPv4;
+	std::string                          *DNS_HTTPS_SNI_MBS;
+	std::string                          *DNS_HTTPS_Path;
+	bool                                 DNS_HTTPS_Validation;
+#endif
+#endif
 
 //[DNSCurve] block
 #if defined(ENABLE_LIBSODIUM)
@@ -667,8 +734,6 @@ public:
 	bool                                 IsNeedExit;
 	std::vector<SYSTEM_SOCKET>           *LocalListeningSocket;
 	std::default_random_engine           *RandomEngine;
-	std::atomic<size_t>                  *ThreadRunningNum;
-	std::atomic<size_t>                  *ThreadRunningFreeNum;
 
 //Path list and file list status
 	std::vector<std::wstring>            *Path_Global;
@@ -715,6 +780,125 @@ public:
 //		const GlobalStatus &Reference);
 }GLOBAL_STATUS;
 
+//Task executor worker slot structure
+typedef std::function<void(uint8_t * const, uint8_t * const, const size_t)> EXECUTOR_TASK;
+typedef struct _executor_worker_slot_
+{
+	std::deque<EXECUTOR_TASK>            TaskQueue;
+	std::mutex                           TaskQueueLock;
+	std::atomic<size_t>                  TaskCount;
+	std::atomic<bool>                    IsRunning;
+	std::thread                          WorkerThread;
+}ExecutorWorkerSlot, EXECUTOR_WORKER_SLOT;
+
+//Task executor class
+//Base workers are always alive, each worker pops from the back of its own deque and steals from the front of others.
+//Extra workers are started when all workers are busy and stopped after Thread Pool Reset Time of idle.
+typedef class TaskExecutorTable
+{
+private:
+	std::unique_ptr<EXECUTOR_WORKER_SLOT[]>   WorkerSlotList;
+	size_t                               WorkerBaseNum;
+	size_t                               WorkerMaxNum;
+	size_t                               WorkerResetTime;
+	size_t                               WorkerBufferSize;
+	std::atomic<size_t>                  WorkerRunningNum;
+	std::atomic<size_t>                  WorkerIdleNum;
+	std::atomic<size_t>                  TaskPendingNum;
+	std::atomic<size_t>                  SubmitIndex;
+	std::atomic<bool>                    IsShutdown;
+	std::mutex                           WorkerIdleLock;
+	std::mutex                           WorkerExtraLock;
+	std::condition_variable              WorkerIdleCondition;
+
+public:
+//Redefine operator functions
+//	TaskExecutorTable() = default;
+	TaskExecutorTable(const TaskExecutorTable &) = delete;
+	TaskExecutorTable & operator=(const TaskExecutorTable &) = delete;
+
+//Member functions(Public)
+	TaskExecutorTable(
+		void);
+	bool Initialize(
+		const size_t BaseNum, 
+		const size_t MaxNum, 
+		const size_t ResetTime, 
+		const size_t BufferSize);
+	bool Submit(
+		EXECUTOR_TASK &&Task);
+	void Shutdown(
+		void);
+	void Status(
+		size_t &RunningNum, 
+		size_t &IdleNum, 
+		size_t &PendingNum);
+	~TaskExecutorTable(
+		void);
+
+//Member functions(Private)
+private:
+	bool StartWorker(
+		const size_t SlotIndex);
+	bool PopTask(
+		const size_t SlotIndex, 
+		EXECUTOR_TASK &Task, 
+		const bool IsBlockingSteal);
+	void WorkerProcess(
+		const size_t SlotIndex);
+}TASK_EXECUTOR_TABLE;
+
+//Query descriptor pool class
+//All descriptors, their packet buffers and domain buffers are allocated once, listeners pass descriptor index to workers instead of copying.
+typedef class QueryDescriptorPoolTable
+{
+private:
+	std::unique_ptr<MONITOR_QUEUE_DATA[]>   DescriptorList;
+	std::unique_ptr<uint8_t[]>           PacketBufferList;
+	std::unique_ptr<uint8_t[]>           DomainBufferList;
+	std::unique_ptr<size_t[]>            FreeIndexList;
+	size_t                               DescriptorNum;
+	size_t                               FreeIndexNum;
+	std::mutex                           FreeIndexLock;
+	std::condition_variable              FreeIndexCondition;
+
+public:
+//Redefine operator functions
+//	QueryDescriptorPoolTable() = default;
+	QueryDescriptorPoolTable(const QueryDescriptorPoolTable &) = delete;
+	QueryDescriptorPoolTable & operator=(const QueryDescriptorPoolTable &) = delete;
+
+//Member functions
+	QueryDescriptorPoolTable(
+		void);
+	bool Initialize(
+		const size_t Num);
+	bool Acquire(
+		size_t &Index, 
+		const bool IsWait);
+	void Release(
+		const size_t Index);
+	MONITOR_QUEUE_DATA &Descriptor(
+		const size_t Index);
+	uint8_t *PacketBuffer(
+		const size_t Index);
+	size_t UsedNum(
+		void);
+}QUERY_DESCRIPTOR_POOL_TABLE;
+
+//Client TCP session structure
+//Connection is owned by its accept worker, responses of pipelined queries are sent by any worker in order of completion.
+typedef struct _tcp_session_data_
+{
+	SOCKET_DATA                                   SocketData;
+	std::deque<std::pair<uint16_t, uint64_t>>     PendingList;
+	std::mutex                                    SessionLock;
+	std::condition_variable                       SessionCondition;
+	uint64_t                                      LastActiveTime;
+	bool                                          IsFinished;
+	bool                                          IsClosed;
+}TCPSessionData, TCP_SESSION_DATA;
+
 //IP address ranges class
 typedef class AddressRangeTable
 {
@@ -999,23 +1183,67 @@ typedef class OutputPacketTable
 public:
 	std::vector<SOCKET_DATA>             SocketData_Output;
 	SOCKET_DATA                          SocketData_Input;
-	size_t                               ReceiveIndex;
+	std::atomic<size_t>                  ReceiveIndex;
+	std::atomic<bool>                    IsMatched;
 	uint16_t                             Protocol_Network;
 	uint16_t                             Protocol_Transport;
+	uint16_t                             DNS_ID;
 	uint64_t                             ClearPortTime;
-	std::string                          DomainString_Original;
-	std::string                          DomainString_Request;
+	std::chrono::steady_clock::time_point SendTime;
+	uint8_t                              DomainString_Original[DOMAIN_MAXSIZE];
+	uint8_t                              DomainString_Request[DOMAIN_MAXSIZE];
 //	size_t                               EDNS_Length;
 
 //Redefine operator functions
 //	OutputPacketTable() = default;
-//	OutputPacketTable(const OutputPacketTable &) = delete;
-//	OutputPacketTable & operator=(const OutputPacketTable &) = delete;
+	OutputPacketTable(const OutputPacketTable &) = delete;
+	OutputPacketTable & operator=(const OutputPacketTable &) = delete;
 
 //Member functions
 	OutputPacketTable(
 		void);
 }OUTPUT_PACKET_TABLE;
+
+//Port hash table class, in-flight requests are indexed by family, local port and DNS ID and expired by a timer wheel.
+typedef class OutputPacketPortTable
+{
+private:
+	std::array<std::mutex, OUTPUT_PACKET_SHARD_NUM>                                                      ShardLock;
+	std::array<std::unordered_map<uint64_t, std::shared_ptr<OUTPUT_PACKET_TABLE>>, OUTPUT_PACKET_SHARD_NUM> ShardPortMap;
+	std::array<std::vector<std::shared_ptr<OUTPUT_PACKET_TABLE>>, OUTPUT_PACKET_TIMER_SLOT_NUM>           TimerWheel;
+	std::atomic<uint64_t>                                                                                TimerTick;
+	std::mutex                                                                                           TimerLock;
+
+//Private member functions
+	uint64_t GetPortKey(
+		const uint16_t Protocol, 
+		const uint16_t Port, 
+		const uint16_t DNS_ID);
+	size_t GetShardIndex(
+		const uint64_t PortKey);
+	void Unregister(
+		const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem);
+
+public:
+//Redefine operator functions
+//	OutputPacketPortTable() = default;
+	OutputPacketPortTable(const OutputPacketPortTable &) = delete;
+	OutputPacketPortTable & operator=(const OutputPacketPortTable &) = delete;
+
+//Member functions
+	OutputPacketPortTable(
+		void);
+	void Register(
+		const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem);
+	std::shared_ptr<OUTPUT_PACKET_TABLE> Match(
+		const uint16_t Protocol, 
+		const uint16_t Port, 
+		const uint16_t DNS_ID);
+	bool Take(
+		const std::shared_ptr<OUTPUT_PACKET_TABLE> &PortItem);
+	void ClearExpired(
+		void);
+}OUTPUT_PACKET_PORT_TABLE;
 #endif
 
 #if defined(ENABLE_LIBSODIUM)
@@ -1139,6 +1367,7 @@ public:
 	SSL_CTX                              *MethodContext;
 	BIO                                  *SessionBIO;
 	SSL                                  *SessionData;
+	REQUEST_PROCESS_TYPE                 RequestType;
 	uint16_t                             Protocol_Network;
 	uint16_t                             Protocol_Transport;
 	SYSTEM_SOCKET                        Socket;